@@ -112,6 +112,16 @@ macro(CassOptionalDependencies)
   if(CASS_USE_ZLIB)
     CassUseZlib()
   endif()
+
+  # LZ4
+  if(CASS_USE_LZ4)
+    CassUseLz4()
+  endif()
+
+  # Snappy
+  if(CASS_USE_SNAPPY)
+    CassUseSnappy()
+  endif()
 endmacro()
 
 #------------------------
@@ -337,7 +347,8 @@ endmacro()
 #
 # Add test subdirs for core driver to the build if testing is enabled.
 #
-# Input: CASS_BUILD_INTEGRATION_TESTS, CASS_BUILD_UNIT_TESTS, CASS_ROOT_DIR
+# Input: CASS_BUILD_INTEGRATION_TESTS, CASS_BUILD_UNIT_TESTS,
+#        CASS_BUILD_BENCHMARKS, CASS_ROOT_DIR
 #------------------------
 macro(CassConfigureTests)
   if(CASS_BUILD_INTEGRATION_TESTS)
@@ -347,7 +358,7 @@ macro(CassConfigureTests)
     add_subdirectory(${CASS_ROOT_DIR}/test/integration_tests)
   endif()
 
-  if (CASS_BUILD_INTEGRATION_TESTS OR CASS_BUILD_UNIT_TESTS)
+  if (CASS_BUILD_INTEGRATION_TESTS OR CASS_BUILD_UNIT_TESTS OR CASS_BUILD_BENCHMARKS)
     add_subdirectory(${CASS_ROOT_DIR}/gtests)
   endif()
 endmacro()
@@ -669,6 +680,72 @@ macro(CassUseZlib)
   endif()
 endmacro()
 
+#------------------------
+# CassUseLz4
+#
+# Add includes and libraries required for using LZ4 frame compression.
+#
+# Input: CASS_INCLUDES and CASS_LIBS
+# Output: CASS_INCLUDES, CASS_LIBS and HAVE_LZ4
+#------------------------
+macro(CassUseLz4)
+  set(_LZ4_ROOT_HINTS ${LZ4_ROOT_DIR} $ENV{LZ4_ROOT_DIR})
+  set(_LZ4_ROOT_PATHS "${PROJECT_SOURCE_DIR}/lib/lz4/")
+  find_path(LZ4_INCLUDE_DIR
+    NAMES lz4.h
+    HINTS ${_LZ4_ROOT_HINTS}
+    PATHS ${_LZ4_ROOT_PATHS}
+    PATH_SUFFIXES include)
+  find_library(LZ4_LIBRARY
+    NAMES lz4 liblz4
+    HINTS ${_LZ4_ROOT_HINTS}
+    PATHS ${_LZ4_ROOT_PATHS}
+    PATH_SUFFIXES lib lib/${CMAKE_LIBRARY_ARCHITECTURE})
+
+  if(LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+    message(STATUS "LZ4: ${LZ4_LIBRARY}")
+    set(CASS_INCLUDES ${CASS_INCLUDES} ${LZ4_INCLUDE_DIR})
+    set(CASS_LIBS ${CASS_LIBS} ${LZ4_LIBRARY})
+    set(HAVE_LZ4 1)
+  else()
+    message(WARNING "Could not find LZ4, try to set the path to LZ4 root folder in the system variable LZ4_ROOT_DIR")
+    message(WARNING "LZ4 frame compression will not be available")
+  endif()
+endmacro()
+
+#------------------------
+# CassUseSnappy
+#
+# Add includes and libraries required for using Snappy frame compression.
+#
+# Input: CASS_INCLUDES and CASS_LIBS
+# Output: CASS_INCLUDES, CASS_LIBS and HAVE_SNAPPY
+#------------------------
+macro(CassUseSnappy)
+  set(_SNAPPY_ROOT_HINTS ${SNAPPY_ROOT_DIR} $ENV{SNAPPY_ROOT_DIR})
+  set(_SNAPPY_ROOT_PATHS "${PROJECT_SOURCE_DIR}/lib/snappy/")
+  find_path(SNAPPY_INCLUDE_DIR
+    NAMES snappy-c.h
+    HINTS ${_SNAPPY_ROOT_HINTS}
+    PATHS ${_SNAPPY_ROOT_PATHS}
+    PATH_SUFFIXES include)
+  find_library(SNAPPY_LIBRARY
+    NAMES snappy libsnappy
+    HINTS ${_SNAPPY_ROOT_HINTS}
+    PATHS ${_SNAPPY_ROOT_PATHS}
+    PATH_SUFFIXES lib lib/${CMAKE_LIBRARY_ARCHITECTURE})
+
+  if(SNAPPY_INCLUDE_DIR AND SNAPPY_LIBRARY)
+    message(STATUS "Snappy: ${SNAPPY_LIBRARY}")
+    set(CASS_INCLUDES ${CASS_INCLUDES} ${SNAPPY_INCLUDE_DIR})
+    set(CASS_LIBS ${CASS_LIBS} ${SNAPPY_LIBRARY})
+    set(HAVE_SNAPPY 1)
+  else()
+    message(WARNING "Could not find Snappy, try to set the path to Snappy root folder in the system variable SNAPPY_ROOT_DIR")
+    message(WARNING "Snappy frame compression will not be available")
+  endif()
+endmacro()
+
 #-------------------
 # Compiler Flags
 #-------------------
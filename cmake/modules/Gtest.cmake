@@ -241,3 +241,49 @@ macro(GtestUnitTests project_name extra_files extra_includes excluded_test_files
       COMMAND ${UNIT_TESTS_NAME})
   set_tests_properties(${UNIT_TESTS_DISPLAY_NAME} PROPERTIES TIMEOUT 5)
 endmacro()
+
+#------------------------
+# GtestBenchmarks
+#
+# Configure the benchmarks to be built. The benchmarks use the in-process
+# server (mockssandra) from the unit tests.
+#
+# Arguments:
+#   project_name - Name of project that has benchmarks.
+#------------------------
+macro(GtestBenchmarks project_name)
+  set(BENCHMARKS_NAME "${project_name}-benchmarks")
+  set(BENCHMARKS_DISPLAY_NAME "Benchmarks (${project_name})")
+  set(BENCHMARKS_SOURCE_DIR "${TESTS_SOURCE_DIR}/benchmarks")
+  set(UNIT_TESTS_SOURCE_DIR "${TESTS_SOURCE_DIR}/unit")
+
+  file(GLOB BENCHMARKS_INCLUDE_FILES ${BENCHMARKS_SOURCE_DIR}/*.hpp)
+  file(GLOB BENCHMARKS_SOURCE_FILES ${BENCHMARKS_SOURCE_DIR}/*.cpp)
+  set(BENCHMARKS_MOCKSSANDRA_FILES ${UNIT_TESTS_SOURCE_DIR}/mockssandra.hpp
+                                   ${UNIT_TESTS_SOURCE_DIR}/mockssandra.cpp)
+  source_group("Header Files" FILES ${BENCHMARKS_INCLUDE_FILES})
+  source_group("Source Files" FILES ${BENCHMARKS_SOURCE_FILES})
+  source_group("Source Files\\mockssandra" FILES ${BENCHMARKS_MOCKSSANDRA_FILES})
+  add_executable(${BENCHMARKS_NAME}
+                 ${BENCHMARKS_SOURCE_FILES}
+                 ${BENCHMARKS_INCLUDE_FILES}
+                 ${BENCHMARKS_MOCKSSANDRA_FILES}
+                 ${CPP_DRIVER_SOURCE_FILES}
+                 ${CASS_API_HEADER_FILES}
+                 ${CPP_DRIVER_INCLUDE_FILES}
+                 ${CPP_DRIVER_HEADER_SOURCE_FILES}
+                 ${CPP_DRIVER_HEADER_SOURCE_ATOMIC_FILES})
+  if(CMAKE_VERSION VERSION_LESS "2.8.11")
+    include_directories(${BENCHMARKS_SOURCE_DIR} ${UNIT_TESTS_SOURCE_DIR})
+  else()
+    target_include_directories(${BENCHMARKS_NAME}
+                               PUBLIC ${BENCHMARKS_SOURCE_DIR}
+                                      ${UNIT_TESTS_SOURCE_DIR})
+  endif()
+  target_link_libraries(${BENCHMARKS_NAME}
+                        ${CASS_LIBS}
+                        ${PROJECT_LIB_NAME_TARGET})
+  set_property(TARGET ${BENCHMARKS_NAME} PROPERTY PROJECT_LABEL ${BENCHMARKS_DISPLAY_NAME})
+  set_property(TARGET ${BENCHMARKS_NAME} PROPERTY FOLDER "Tests")
+  set_property(TARGET ${BENCHMARKS_NAME} APPEND PROPERTY COMPILE_FLAGS ${TEST_CXX_FLAGS})
+endmacro()
@@ -0,0 +1,321 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "load_generator.hpp"
+
+#include "utils.hpp"
+
+#include <assert.h>
+#include <stdlib.h>
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#define NANOSECONDS_PER_SECOND (1000ULL * 1000ULL * 1000ULL)
+
+// Latencies larger than a minute are clamped
+#define HIGHEST_TRACKABLE_LATENCY_NS (60LL * 1000LL * 1000LL * 1000LL)
+
+namespace benchmarks {
+
+static cass::Atomic<bool> measuring_allocations__(false);
+static cass::Atomic<uint64_t> allocations__(0);
+static uv_key_t excluded_thread_key__;
+
+static void count_allocation() {
+  if (measuring_allocations__.load(cass::MEMORY_ORDER_RELAXED) &&
+      uv_key_get(&excluded_thread_key__) == NULL) {
+    allocations__.fetch_add(1, cass::MEMORY_ORDER_RELAXED);
+  }
+}
+
+static void* counting_malloc(size_t size) {
+  count_allocation();
+  return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+  count_allocation();
+  return realloc(ptr, size);
+}
+
+void LoadGenerator::install_allocation_hooks() {
+  uv_key_create(&excluded_thread_key__);
+  cass_alloc_set_functions(counting_malloc, counting_realloc, free);
+}
+
+void LoadGenerator::exclude_current_thread() {
+  uv_key_set(&excluded_thread_key__, &excluded_thread_key__);
+}
+
+void LoadGenerator::start_counting_allocations() {
+  allocations__.store(0);
+  measuring_allocations__.store(true);
+}
+
+uint64_t LoadGenerator::stop_counting_allocations() {
+  measuring_allocations__.store(false);
+  return allocations__.load();
+}
+
+static uint64_t cpu_time_ns() {
+  uv_rusage_t usage;
+  if (uv_getrusage(&usage) != 0) return 0;
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * NANOSECONDS_PER_SECOND +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void sleep_until(uint64_t time) {
+  uint64_t now = uv_hrtime();
+  if (now >= time) return;
+#if defined(_WIN32)
+  uv_sleep(static_cast<unsigned int>((time - now) / (1000 * 1000)));
+#else
+  // Sub-millisecond sleeps so that the fixed rate doesn't have to spin (and
+  // burn CPU that would be attributed to the driver).
+  struct timespec delay;
+  delay.tv_sec = static_cast<time_t>((time - now) / NANOSECONDS_PER_SECOND);
+  delay.tv_nsec = static_cast<long>((time - now) % NANOSECONDS_PER_SECOND);
+  nanosleep(&delay, NULL);
+#endif
+}
+
+LoadGenerator::LoadGenerator(CassSession* session,
+                             const CassStatement* statement,
+                             const LoadSettings& settings)
+  : session_(session)
+  , statement_(statement)
+  , settings_(settings)
+  , excluded_cpu_time_func_(NULL)
+  , excluded_cpu_time_data_(NULL)
+  , measure_start_time_(0)
+  , end_time_(0)
+  , outstanding_(0)
+  , requests_(0)
+  , errors_(0)
+  , total_requests_(0)
+  , thread_count_(0)
+  , slots_(settings.concurrency)
+  , histogram_count_(0)
+  , histograms_(settings.num_threads + settings.num_io_threads + 2, NULL) {
+  uv_key_create(&histogram_key_);
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    hdr_init(1, HIGHEST_TRACKABLE_LATENCY_NS, 3, &histograms_[i]);
+  }
+}
+
+LoadGenerator::~LoadGenerator() {
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    free(histograms_[i]);
+  }
+  uv_key_delete(&histogram_key_);
+}
+
+void LoadGenerator::run(LoadResults* results) {
+  uint64_t start_time = uv_hrtime();
+  measure_start_time_ = start_time + settings_.warmup_secs * NANOSECONDS_PER_SECOND;
+  end_time_ = measure_start_time_ + settings_.duration_secs * NANOSECONDS_PER_SECOND;
+
+  cass::Vector<uv_thread_t> threads;
+  if (settings_.burst_size > 0) {
+    threads.resize(settings_.num_threads);
+    for (size_t i = 0; i < threads.size(); ++i) {
+      uv_thread_create(&threads[i], run_bursts, this);
+    }
+  } else if (settings_.rate > 0.0) {
+    threads.resize(settings_.num_threads);
+    for (size_t i = 0; i < threads.size(); ++i) {
+      uv_thread_create(&threads[i], run_fixed_rate, this);
+    }
+  } else {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      Slot* slot = &slots_[i];
+      slot->generator = this;
+      slot->state.store(Slot::IDLE);
+      outstanding_.fetch_add(1);
+      execute(slot);
+    }
+  }
+
+  uint64_t excluded_cpu_start = 0, excluded_cpu_end = 0;
+
+  sleep_until(measure_start_time_);
+  if (excluded_cpu_time_func_) {
+    excluded_cpu_start = excluded_cpu_time_func_(excluded_cpu_time_data_);
+  }
+  uint64_t cpu_start = cpu_time_ns();
+  start_counting_allocations();
+
+  sleep_until(end_time_);
+  uint64_t allocations = stop_counting_allocations();
+  uint64_t cpu_end = cpu_time_ns();
+  if (excluded_cpu_time_func_) {
+    excluded_cpu_end = excluded_cpu_time_func_(excluded_cpu_time_data_);
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i) {
+    uv_thread_join(&threads[i]);
+  }
+  while (outstanding_.load() > 0) {
+    uv_sleep(1);
+  }
+
+  hdr_histogram* histogram;
+  hdr_init(1, HIGHEST_TRACKABLE_LATENCY_NS, 3, &histogram);
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    hdr_add(histogram, histograms_[i]);
+  }
+
+  results->requests = requests_.load();
+  results->errors = errors_.load();
+  results->elapsed_secs = settings_.duration_secs;
+  results->min = hdr_min(histogram);
+  results->mean = hdr_mean(histogram);
+  results->percentile_50th = hdr_value_at_percentile(histogram, 50.0);
+  results->percentile_90th = hdr_value_at_percentile(histogram, 90.0);
+  results->percentile_99th = hdr_value_at_percentile(histogram, 99.0);
+  results->percentile_999th = hdr_value_at_percentile(histogram, 99.9);
+  results->percentile_9999th = hdr_value_at_percentile(histogram, 99.99);
+  results->max = hdr_max(histogram);
+  results->allocations = allocations;
+  results->cpu_time_ns = cpu_end - cpu_start;
+  results->excluded_cpu_time_ns = excluded_cpu_end - excluded_cpu_start;
+  results->total_requests = total_requests_.load();
+
+  free(histogram);
+}
+
+void LoadGenerator::execute(Slot* slot) {
+  // A result can be delivered on this thread before the callback is set
+  // (e.g. an immediate error). Instead of recursing, the callback marks the
+  // slot to be executed again and the loop below does it.
+  for (;;) {
+    slot->state.store(Slot::EXECUTING);
+    slot->start_time = uv_hrtime();
+    CassFuture* future = cass_session_execute(session_, statement_);
+    cass_future_set_callback(future, on_closed_loop_result, slot);
+    cass_future_free(future);
+
+    int expected = Slot::EXECUTING;
+    if (slot->state.compare_exchange_strong(expected, Slot::IDLE)) break;
+  }
+}
+
+void LoadGenerator::on_closed_loop_result(CassFuture* future, void* data) {
+  Slot* slot = static_cast<Slot*>(data);
+  LoadGenerator* generator = slot->generator;
+  generator->record(future, slot->start_time);
+
+  if (uv_hrtime() >= generator->end_time_) {
+    generator->outstanding_.fetch_sub(1);
+    return;
+  }
+
+  int expected = Slot::EXECUTING;
+  if (!slot->state.compare_exchange_strong(expected, Slot::REEXECUTE)) {
+    generator->execute(slot);
+  }
+}
+
+void LoadGenerator::run_fixed_rate(void* arg) {
+  LoadGenerator* generator = static_cast<LoadGenerator*>(arg);
+  generator->maybe_pin_thread();
+  const uint64_t interval =
+      static_cast<uint64_t>(NANOSECONDS_PER_SECOND * generator->settings_.num_threads /
+                            generator->settings_.rate);
+
+  uint64_t next_time = uv_hrtime();
+  while (next_time < generator->end_time_) {
+    sleep_until(next_time);
+
+    generator->outstanding_.fetch_add(1);
+    CassFuture* future = cass_session_execute(generator->session_, generator->statement_);
+    cass_future_set_callback(future, on_fixed_rate_result,
+                             new Scheduled(generator, next_time));
+    cass_future_free(future);
+    next_time += interval;
+  }
+}
+
+void LoadGenerator::on_fixed_rate_result(CassFuture* future, void* data) {
+  Scheduled* scheduled = static_cast<Scheduled*>(data);
+  LoadGenerator* generator = scheduled->generator;
+  generator->record(future, scheduled->start_time);
+  delete scheduled;
+  generator->outstanding_.fetch_sub(1);
+}
+
+void LoadGenerator::run_bursts(void* arg) {
+  LoadGenerator* generator = static_cast<LoadGenerator*>(arg);
+  generator->maybe_pin_thread();
+  const size_t burst_size = generator->settings_.burst_size;
+  cass::Vector<const CassStatement*> statements(burst_size, generator->statement_);
+  cass::Vector<CassFuture*> futures(burst_size);
+
+  // Latencies are measured from the start of the burst
+  while (uv_hrtime() < generator->end_time_) {
+    uint64_t start_time = uv_hrtime();
+    if (generator->settings_.execute_many) {
+      cass_session_execute_many(generator->session_, &statements[0], burst_size, &futures[0]);
+    } else {
+      for (size_t i = 0; i < burst_size; ++i) {
+        futures[i] = cass_session_execute(generator->session_, statements[i]);
+      }
+    }
+    for (size_t i = 0; i < burst_size; ++i) {
+      cass_future_wait(futures[i]);
+      generator->record(futures[i], start_time);
+      cass_future_free(futures[i]);
+    }
+  }
+}
+
+void LoadGenerator::record(CassFuture* future, uint64_t start_time) {
+  total_requests_.fetch_add(1, cass::MEMORY_ORDER_RELAXED);
+  if (start_time < measure_start_time_ || start_time >= end_time_) return;
+
+  if (cass_future_error_code(future) != CASS_OK) {
+    errors_.fetch_add(1);
+    return;
+  }
+
+  requests_.fetch_add(1);
+  hdr_record_value(thread_histogram(),
+                   static_cast<int64_t>(uv_hrtime() - start_time));
+}
+
+void LoadGenerator::maybe_pin_thread() {
+  const cass::Vector<unsigned>& cpus = settings_.cpus;
+  if (cpus.empty()) return;
+  unsigned cpu = cpus[thread_count_.fetch_add(1) % cpus.size()];
+  if (!cass::set_thread_affinity(cpu)) {
+    fprintf(stderr, "Unable to pin application thread to CPU %u\n", cpu);
+  }
+}
+
+hdr_histogram* LoadGenerator::thread_histogram() {
+  // Each thread records into its own histogram. They're merged at the end.
+  void* index = uv_key_get(&histogram_key_);
+  if (index == NULL) {
+    index = reinterpret_cast<void*>(histogram_count_.fetch_add(1) + 1);
+    uv_key_set(&histogram_key_, index);
+  }
+  size_t i = reinterpret_cast<size_t>(index) - 1;
+  assert(i < histograms_.size());
+  return histograms_[i];
+}
+
+} // namespace benchmarks
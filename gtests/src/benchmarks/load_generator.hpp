@@ -0,0 +1,203 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __BENCHMARKS_LOAD_GENERATOR_HPP_INCLUDED__
+#define __BENCHMARKS_LOAD_GENERATOR_HPP_INCLUDED__
+
+#include "cassandra.h"
+
+#include "atomic.hpp"
+#include "memory.hpp"
+#include "vector.hpp"
+
+#include "third_party/hdr_histogram/hdr_histogram.hpp"
+
+#include <uv.h>
+
+namespace benchmarks {
+
+struct LoadSettings {
+  LoadSettings()
+    : concurrency(100)
+    , rate(0.0)
+    , num_threads(1)
+    , num_io_threads(1)
+    , burst_size(0)
+    , execute_many(true)
+    , duration_secs(10)
+    , warmup_secs(1) { }
+
+  unsigned concurrency;    // Outstanding requests (closed loop)
+  double rate;             // Requests per second, or 0 for closed loop
+  unsigned num_threads;    // Application threads issuing requests (fixed rate)
+  unsigned num_io_threads; // Driver I/O threads
+  unsigned burst_size;     // Requests submitted together by each thread, then
+                           // waited on; overrides the rate and concurrency
+  bool execute_many;       // Submit bursts using `cass_session_execute_many()`
+  unsigned duration_secs;
+  unsigned warmup_secs;
+  cass::Vector<unsigned> cpus; // CPUs that application threads are pinned to
+                               // (round-robin), or empty to not pin them
+};
+
+struct LoadResults {
+  uint64_t requests;
+  uint64_t errors;
+  double elapsed_secs;
+
+  // Latencies in nanoseconds
+  int64_t min;
+  double mean;
+  int64_t percentile_50th;
+  int64_t percentile_90th;
+  int64_t percentile_99th;
+  int64_t percentile_999th;
+  int64_t percentile_9999th;
+  int64_t max;
+
+  uint64_t allocations; // Driver allocations during the measurement
+  uint64_t cpu_time_ns; // Process CPU time during the measurement
+  uint64_t excluded_cpu_time_ns; // CPU time of excluded threads (if known)
+  uint64_t total_requests; // Requests that finished, including the warmup
+};
+
+typedef uint64_t (*CpuTimeFunc)(void* data);
+
+/**
+ * Drives a session with requests either at a fixed rate (open loop), with
+ * a fixed number of outstanding requests (closed loop) or in bursts that are
+ * submitted together and waited on, and measures request latency,
+ * allocations and CPU time.
+ *
+ * Latencies for the fixed rate are measured from when the request was
+ * scheduled, not when it was sent, so that a stalled driver doesn't hide
+ * its own latency (coordinated omission).
+ */
+class LoadGenerator {
+public:
+  LoadGenerator(CassSession* session,
+                const CassStatement* statement,
+                const LoadSettings& settings);
+  ~LoadGenerator();
+
+  /**
+   * Install the allocation hooks. This must be called before any driver
+   * objects are created.
+   */
+  static void install_allocation_hooks();
+
+  /**
+   * Don't count allocations made by the calling thread. This is used to
+   * exclude the in-process server.
+   */
+  static void exclude_current_thread();
+
+  /**
+   * Start counting driver allocations (from all threads that aren't
+   * excluded).
+   */
+  static void start_counting_allocations();
+
+  /**
+   * Stop counting driver allocations.
+   *
+   * @return The number of allocations since counting was started.
+   */
+  static uint64_t stop_counting_allocations();
+
+  /**
+   * Set a function that returns the CPU time used by threads that shouldn't
+   * count towards the driver's CPU time. It's called at the start and end of
+   * the measurement.
+   */
+  void set_excluded_cpu_time(CpuTimeFunc func, void* data) {
+    excluded_cpu_time_func_ = func;
+    excluded_cpu_time_data_ = data;
+  }
+
+  /**
+   * Run the load (blocking).
+   *
+   * @param results The results of the measurement after warmup.
+   */
+  void run(LoadResults* results);
+
+private:
+  struct Slot {
+    enum State {
+      IDLE,
+      EXECUTING,
+      REEXECUTE
+    };
+
+    Slot()
+      : generator(NULL)
+      , start_time(0)
+      , state(IDLE) { }
+
+    LoadGenerator* generator;
+    uint64_t start_time;
+    cass::Atomic<int> state;
+  };
+
+  struct Scheduled {
+    Scheduled(LoadGenerator* generator, uint64_t start_time)
+      : generator(generator)
+      , start_time(start_time) { }
+
+    LoadGenerator* generator;
+    uint64_t start_time;
+  };
+
+  void execute(Slot* slot);
+  static void on_closed_loop_result(CassFuture* future, void* data);
+
+  static void run_fixed_rate(void* arg);
+
+  static void run_bursts(void* arg);
+  static void on_fixed_rate_result(CassFuture* future, void* data);
+
+  void record(CassFuture* future, uint64_t start_time);
+  hdr_histogram* thread_histogram();
+  void maybe_pin_thread();
+
+private:
+  CassSession* const session_;
+  const CassStatement* const statement_;
+  const LoadSettings settings_;
+
+  CpuTimeFunc excluded_cpu_time_func_;
+  void* excluded_cpu_time_data_;
+
+  uint64_t measure_start_time_;
+  uint64_t end_time_;
+
+  cass::Atomic<uint64_t> outstanding_;
+  cass::Atomic<uint64_t> requests_;
+  cass::Atomic<uint64_t> errors_;
+  cass::Atomic<uint64_t> total_requests_;
+  cass::Atomic<size_t> thread_count_;
+
+  cass::DynamicArray<Slot> slots_;
+
+  uv_key_t histogram_key_;
+  cass::Atomic<size_t> histogram_count_;
+  cass::Vector<hdr_histogram*> histograms_;
+};
+
+} // namespace benchmarks
+
+#endif
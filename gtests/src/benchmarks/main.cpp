@@ -0,0 +1,566 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "control_connection.hpp" // For the keyspaces query
+#include "load_generator.hpp"
+#include "mockssandra.hpp"
+#include "result_decoding.hpp"
+#include "routing.hpp"
+#include "timer_churn.hpp"
+#include "token_map.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using benchmarks::LoadGenerator;
+using benchmarks::LoadResults;
+using benchmarks::LoadSettings;
+using benchmarks::ResultDecodingResults;
+using benchmarks::RoutingResults;
+using benchmarks::TimerChurnResults;
+using benchmarks::TokenMapResults;
+
+#define TIMER_CHURN_OPERATIONS 1000000
+#define ROUTING_OPERATIONS 1000000
+#define TOKEN_MAP_OPERATIONS 10
+#define RESULT_DECODING_ROWS 10000000
+
+struct Options {
+  Options()
+    : num_nodes(1)
+    , num_server_threads(1)
+    , response_latency_ms(0)
+    , response_rows(1)
+    , response_value_size(64)
+    , num_connections(1)
+    , timer_churn(0)
+    , routing(0)
+    , token_map(0)
+    , result_decoding(0) { }
+
+  LoadSettings load;
+  unsigned num_nodes;
+  unsigned num_server_threads;
+  unsigned response_latency_ms;
+  unsigned response_rows;
+  unsigned response_value_size;
+  unsigned num_connections;
+  unsigned timer_churn;
+  unsigned routing;
+  unsigned token_map;
+  unsigned result_decoding;
+};
+
+static void print_usage(const char* program) {
+  Options defaults;
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "\n"
+          "Load:\n"
+          "  --concurrency <n>     Outstanding requests for closed loop (default: %u)\n"
+          "  --rate <n>            Requests per second for fixed rate; overrides\n"
+          "                        --concurrency (default: closed loop)\n"
+          "  --threads <n>         Application threads for fixed rate and bursts\n"
+          "                        (default: %u)\n"
+          "  --burst <n>           Submit <n> requests at a time from each thread and\n"
+          "                        wait for them; overrides --rate and --concurrency\n"
+          "  --execute-many <0|1>  Submit bursts using cass_session_execute_many()\n"
+          "                        instead of cass_session_execute() (default: %u)\n"
+          "  --duration <secs>     Measurement duration (default: %u)\n"
+          "  --warmup <secs>       Warmup before measuring (default: %u)\n"
+          "\n"
+          "Driver:\n"
+          "  --io-threads <n>      I/O threads (default: %u)\n"
+          "  --connections <n>     Connections per host (default: %u)\n"
+          "  --io-cpus <list>      Pin the I/O threads to a comma-separated list of\n"
+          "                        CPUs and dispatch requests to the I/O thread on\n"
+          "                        the caller's CPU; application threads are pinned\n"
+          "                        to the same CPUs (default: not pinned)\n"
+          "\n"
+          "Server:\n"
+          "  --nodes <n>           Nodes (default: %u)\n"
+          "  --server-threads <n>  Server threads (default: %u)\n"
+          "  --latency <ms>        Response latency (default: %u)\n"
+          "  --rows <n>            Rows per response (default: %u)\n"
+          "  --value-size <bytes>  Size of each row's value (default: %u)\n"
+          "\n"
+          "Other:\n"
+          "  --timer-churn <n>     Measure the cost of restarting timers with <n> timers\n"
+          "                        in flight instead of running the load\n"
+          "  --routing <n>         Measure the cost of token-aware routing with <n>\n"
+          "                        hosts instead of running the load\n"
+          "  --token-map <n>       Measure the cost of building and updating the token\n"
+          "                        map with <n> hosts instead of running the load\n"
+          "  --result-decoding <n> Measure the cost of reading results with <n> rows\n"
+          "                        instead of running the load\n",
+          program,
+          defaults.load.concurrency, defaults.load.num_threads,
+          defaults.load.execute_many ? 1 : 0,
+          defaults.load.duration_secs, defaults.load.warmup_secs,
+          defaults.load.num_io_threads, defaults.num_connections,
+          defaults.num_nodes, defaults.num_server_threads,
+          defaults.response_latency_ms, defaults.response_rows,
+          defaults.response_value_size);
+}
+
+static bool parse_unsigned(const char* value, unsigned min, unsigned* output) {
+  char* end;
+  unsigned long result = strtoul(value, &end, 10);
+  if (*value == '\0' || *end != '\0' || result < min) return false;
+  *output = static_cast<unsigned>(result);
+  return true;
+}
+
+static bool parse_cpus(const char* value, cass::Vector<unsigned>* output) {
+  output->clear();
+  const char* pos = value;
+  while (true) {
+    char* end;
+    unsigned long cpu = strtoul(pos, &end, 10);
+    if (end == pos || (*end != ',' && *end != '\0')) return false;
+    output->push_back(static_cast<unsigned>(cpu));
+    if (*end == '\0') break;
+    pos = end + 1;
+  }
+  return true;
+}
+
+static bool parse_options(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const char* name = argv[i];
+    if (strcmp(name, "--help") == 0) return false;
+    if (i + 1 >= argc) {
+      fprintf(stderr, "Missing value for %s\n", name);
+      return false;
+    }
+    const char* value = argv[++i];
+
+    bool valid;
+    if (strcmp(name, "--concurrency") == 0) {
+      valid = parse_unsigned(value, 1, &options->load.concurrency);
+    } else if (strcmp(name, "--rate") == 0) {
+      char* end;
+      options->load.rate = strtod(value, &end);
+      valid = *end == '\0' && options->load.rate > 0.0;
+    } else if (strcmp(name, "--threads") == 0) {
+      valid = parse_unsigned(value, 1, &options->load.num_threads);
+    } else if (strcmp(name, "--burst") == 0) {
+      valid = parse_unsigned(value, 1, &options->load.burst_size);
+    } else if (strcmp(name, "--execute-many") == 0) {
+      unsigned execute_many = 0;
+      valid = parse_unsigned(value, 0, &execute_many) && execute_many <= 1;
+      options->load.execute_many = execute_many != 0;
+    } else if (strcmp(name, "--duration") == 0) {
+      valid = parse_unsigned(value, 1, &options->load.duration_secs);
+    } else if (strcmp(name, "--warmup") == 0) {
+      valid = parse_unsigned(value, 0, &options->load.warmup_secs);
+    } else if (strcmp(name, "--io-threads") == 0) {
+      valid = parse_unsigned(value, 1, &options->load.num_io_threads);
+    } else if (strcmp(name, "--connections") == 0) {
+      valid = parse_unsigned(value, 1, &options->num_connections);
+    } else if (strcmp(name, "--io-cpus") == 0) {
+      valid = parse_cpus(value, &options->load.cpus);
+    } else if (strcmp(name, "--nodes") == 0) {
+      valid = parse_unsigned(value, 1, &options->num_nodes);
+    } else if (strcmp(name, "--server-threads") == 0) {
+      valid = parse_unsigned(value, 1, &options->num_server_threads);
+    } else if (strcmp(name, "--latency") == 0) {
+      valid = parse_unsigned(value, 0, &options->response_latency_ms);
+    } else if (strcmp(name, "--rows") == 0) {
+      valid = parse_unsigned(value, 0, &options->response_rows);
+    } else if (strcmp(name, "--value-size") == 0) {
+      valid = parse_unsigned(value, 0, &options->response_value_size);
+    } else if (strcmp(name, "--timer-churn") == 0) {
+      valid = parse_unsigned(value, 1, &options->timer_churn);
+    } else if (strcmp(name, "--routing") == 0) {
+      valid = parse_unsigned(value, 2, &options->routing);
+    } else if (strcmp(name, "--token-map") == 0) {
+      valid = parse_unsigned(value, 3, &options->token_map);
+    } else if (strcmp(name, "--result-decoding") == 0) {
+      valid = parse_unsigned(value, 1, &options->result_decoding);
+    } else {
+      fprintf(stderr, "Unknown option %s\n", name);
+      return false;
+    }
+
+    if (!valid) {
+      fprintf(stderr, "Invalid value for %s: %s\n", name, value);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * An in-process cluster whose threads are excluded from the driver's
+ * allocation and CPU measurements.
+ */
+class BenchmarkCluster : public mockssandra::Cluster {
+public:
+  BenchmarkCluster(const mockssandra::RequestHandler* request_handler,
+                   size_t num_nodes, size_t num_threads)
+    : factory_(request_handler, this)
+    , event_loop_group_(num_threads) {
+    init(generator_, factory_, num_nodes, 0);
+    run_on_all_threads(exclude_thread);
+  }
+
+  ~BenchmarkCluster() {
+    stop_all();
+  }
+
+  int start_all() {
+    return Cluster::start_all(&event_loop_group_);
+  }
+
+  /**
+   * The total CPU time of the server threads. This is only available on
+   * platforms that support per-thread resource usage.
+   *
+   * @return The CPU time in nanoseconds or 0 if it's not available.
+   */
+  static uint64_t cpu_time_ns(void* data) {
+#if defined(RUSAGE_THREAD)
+    BenchmarkCluster* cluster = static_cast<BenchmarkCluster*>(data);
+    cluster->cpu_time_ns_.store(0);
+    cluster->run_on_all_threads(add_thread_cpu_time);
+    return cluster->cpu_time_ns_.load();
+#else
+    return 0;
+#endif
+  }
+
+private:
+  typedef void (*ThreadFunc)(BenchmarkCluster* cluster);
+
+  class RunOnThread : public cass::Task {
+  public:
+    RunOnThread(ThreadFunc func, BenchmarkCluster* cluster, uv_sem_t* sem)
+      : func_(func)
+      , cluster_(cluster)
+      , sem_(sem) { }
+
+    virtual void run(cass::EventLoop* event_loop) {
+      func_(cluster_);
+      uv_sem_post(sem_);
+    }
+
+  private:
+    ThreadFunc func_;
+    BenchmarkCluster* cluster_;
+    uv_sem_t* sem_;
+  };
+
+  void run_on_all_threads(ThreadFunc func) {
+    uv_sem_t sem;
+    uv_sem_init(&sem, 0);
+    for (size_t i = 0; i < event_loop_group_.size(); ++i) {
+      event_loop_group_.get(i)->add(cass::Memory::allocate<RunOnThread>(func, this, &sem));
+    }
+    for (size_t i = 0; i < event_loop_group_.size(); ++i) {
+      uv_sem_wait(&sem);
+    }
+    uv_sem_destroy(&sem);
+  }
+
+  static void exclude_thread(BenchmarkCluster* cluster) {
+    LoadGenerator::exclude_current_thread();
+  }
+
+  static void add_thread_cpu_time(BenchmarkCluster* cluster) {
+#if defined(RUSAGE_THREAD)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+      cluster->cpu_time_ns_.fetch_add((usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+                                      (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL);
+    }
+#endif
+  }
+
+private:
+  mockssandra::Ipv4AddressGenerator generator_;
+  mockssandra::ClientConnectionFactory factory_;
+  mockssandra::SimpleEventLoopGroup event_loop_group_;
+  cass::Atomic<uint64_t> cpu_time_ns_;
+};
+
+/**
+ * Counts the last level cache misses of the current thread and the threads
+ * it creates after the counter is opened. The server's threads are created
+ * before it's opened so they're not counted.
+ */
+class CacheMissCounter {
+public:
+  CacheMissCounter()
+    : fd_(-1) {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~CacheMissCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0) close(fd_);
+#endif
+  }
+
+  bool is_available() const { return fd_ >= 0; }
+
+  /**
+   * @return The number of cache misses so far (including the threads that are
+   * still running) or 0 if the counter isn't available.
+   */
+  uint64_t read() const {
+    uint64_t count = 0;
+#if defined(__linux__)
+    if (fd_ >= 0 && ::read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      count = 0;
+    }
+#endif
+    return count;
+  }
+
+private:
+  int fd_;
+};
+
+static const mockssandra::RequestHandler* create_request_handler(const Options& options) {
+  mockssandra::SimpleRequestHandlerBuilder builder;
+  mockssandra::Action::Builder& query = builder.on(mockssandra::OPCODE_QUERY)
+                                          .system_local()
+                                          .system_peers()
+                                          .is_query(SELECT_KEYSPACES_30)
+                                            .then(mockssandra::Action::Builder().empty_rows_result(0));
+  if (options.response_latency_ms > 0) {
+    query.wait(options.response_latency_ms);
+  }
+  query.text_rows_result(options.response_rows, options.response_value_size);
+  return builder.build();
+}
+
+static void print_results(const Options& options, const LoadResults& results,
+                          const CacheMissCounter& cache_misses, uint64_t cache_miss_count) {
+  const LoadSettings& load = options.load;
+  if (load.burst_size > 0) {
+    printf("Bursts: %u requests using %u threads (%s)\n", load.burst_size, load.num_threads,
+           load.execute_many ? "cass_session_execute_many()" : "cass_session_execute()");
+  } else if (load.rate > 0.0) {
+    printf("Fixed rate: %.0f requests/s using %u threads\n", load.rate, load.num_threads);
+  } else {
+    printf("Closed loop: %u outstanding requests\n", load.concurrency);
+  }
+  printf("Driver: %u I/O threads, %u connections per host",
+         load.num_io_threads, options.num_connections);
+  if (!load.cpus.empty()) {
+    printf(", pinned to CPUs");
+    for (size_t i = 0; i < load.cpus.size(); ++i) {
+      printf("%c%u", i == 0 ? ' ' : ',', load.cpus[i]);
+    }
+  }
+  printf("\n");
+  printf("Server: %u nodes, %u ms latency, %u rows of %u bytes\n\n",
+         options.num_nodes, options.response_latency_ms,
+         options.response_rows, options.response_value_size);
+
+  double requests = results.requests > 0 ? static_cast<double>(results.requests) : 1.0;
+
+  printf("Requests:     %llu (%llu errors)\n",
+         static_cast<unsigned long long>(results.requests),
+         static_cast<unsigned long long>(results.errors));
+  printf("Throughput:   %.2f requests/s\n", results.requests / results.elapsed_secs);
+  printf("Latency (us): min %.1f, mean %.1f, 50%% %.1f, 90%% %.1f, 99%% %.1f, "
+         "99.9%% %.1f, 99.99%% %.1f, max %.1f\n",
+         results.min / 1000.0, results.mean / 1000.0,
+         results.percentile_50th / 1000.0, results.percentile_90th / 1000.0,
+         results.percentile_99th / 1000.0, results.percentile_999th / 1000.0,
+         results.percentile_9999th / 1000.0, results.max / 1000.0);
+  printf("Allocations:  %.2f per request\n", results.allocations / requests);
+  if (results.excluded_cpu_time_ns > 0) {
+    printf("CPU:          %.2f us per request\n",
+           (results.cpu_time_ns - results.excluded_cpu_time_ns) / requests / 1000.0);
+  } else {
+    printf("CPU:          %.2f us per request (includes the server)\n",
+           results.cpu_time_ns / requests / 1000.0);
+  }
+  // The counter runs during the warmup so it's divided by all the requests
+  if (cache_misses.is_available() && results.total_requests > 0) {
+    printf("Cache misses: %.2f per request\n",
+           static_cast<double>(cache_miss_count) / results.total_requests);
+  } else {
+    printf("Cache misses: n/a\n");
+  }
+}
+
+static void print_timer_churn_results(const Options& options,
+                                      const TimerChurnResults& results) {
+  printf("Timer churn: %u in-flight timers, %u restarts\n\n",
+         options.timer_churn, TIMER_CHURN_OPERATIONS);
+  printf("Timer (libuv): %.1f ns per restart\n", results.timer_ns);
+  printf("WheelTimer:    %.1f ns per restart\n", results.wheel_timer_ns);
+}
+
+static void print_routing_results(const Options& options,
+                                  const RoutingResults& results) {
+  printf("Routing: %u hosts, %u query plans\n\n", options.routing, ROUTING_OPERATIONS);
+  printf("Single key:    %.1f ns, %.2f allocations per request\n",
+         results.single_key.ns, results.single_key.allocations);
+  printf("Composite key: %.1f ns, %.2f allocations per request\n",
+         results.composite_key.ns, results.composite_key.allocations);
+}
+
+static void print_token_map_results(const Options& options,
+                                    const TokenMapResults& results) {
+  printf("Token map: %u hosts, %u host additions and removals\n\n",
+         options.token_map, TOKEN_MAP_OPERATIONS);
+  printf("Build:       %.2f ms (%u threads)\n", results.build_ms, results.build_threads);
+  printf("Copy:        %.2f ms\n", results.copy_ms);
+  printf("Add host:    %.2f ms\n", results.add_host_ms);
+  printf("Remove host: %.2f ms\n", results.remove_host_ms);
+}
+
+static unsigned result_decoding_operations(const Options& options) {
+  unsigned operations = RESULT_DECODING_ROWS / options.result_decoding;
+  return operations > 0 ? operations : 1;
+}
+
+static void print_result_decoding_results(const Options& options,
+                                          const ResultDecodingResults& results) {
+  printf("Result decoding: %u rows, read %u times\n\n",
+         options.result_decoding, result_decoding_operations(options));
+  printf("Rows:    %.1f ns, %.2f allocations per row\n",
+         results.rows.ns, results.rows.allocations);
+  printf("Columns: %.1f ns, %.2f allocations per row\n",
+         results.columns.ns, results.columns.allocations);
+  printf("Arrays (fixed-width columns only): %.1f ns, %.2f allocations per row\n",
+         results.arrays.ns, results.arrays.allocations);
+  printf("Wide rows (%d columns): %.1f ns, %.2f allocations per row\n",
+         RESULT_DECODING_WIDE_COLUMNS, results.wide_rows.ns, results.wide_rows.allocations);
+  printf("Wide rows, seek to the last row: %.1f ns, %.2f allocations per row\n",
+         results.wide_seek.ns, results.wide_seek.allocations);
+}
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, &options)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  if (options.timer_churn > 0) {
+    TimerChurnResults results;
+    benchmarks::run_timer_churn(options.timer_churn, TIMER_CHURN_OPERATIONS, &results);
+    print_timer_churn_results(options, results);
+    return 0;
+  }
+
+  if (options.token_map > 0) {
+    TokenMapResults results;
+    benchmarks::run_token_map(options.token_map, TOKEN_MAP_OPERATIONS, &results);
+    print_token_map_results(options, results);
+    return 0;
+  }
+
+  // This needs to happen before anything is allocated by the driver
+  LoadGenerator::install_allocation_hooks();
+
+  if (options.routing > 0) {
+    RoutingResults results;
+    benchmarks::run_routing(options.routing, ROUTING_OPERATIONS, &results);
+    print_routing_results(options, results);
+    return 0;
+  }
+
+  if (options.result_decoding > 0) {
+    ResultDecodingResults results;
+    benchmarks::run_result_decoding(options.result_decoding,
+                                    result_decoding_operations(options), &results);
+    print_result_decoding_results(options, results);
+    return 0;
+  }
+
+  BenchmarkCluster server(create_request_handler(options),
+                          options.num_nodes, options.num_server_threads);
+  if (server.start_all() != 0) {
+    fprintf(stderr, "Unable to start the server\n");
+    return 1;
+  }
+
+  cass_log_set_level(CASS_LOG_ERROR);
+
+  CassCluster* cluster = cass_cluster_new();
+  cass_cluster_set_contact_points(cluster, "127.0.0.1");
+  cass_cluster_set_num_threads_io(cluster, options.load.num_io_threads);
+  cass_cluster_set_core_connections_per_host(cluster, options.num_connections);
+  cass_cluster_set_queue_size_io(cluster, 128 * 1024);
+  cass_cluster_set_use_schema(cluster, cass_false);
+  if (!options.load.cpus.empty()) {
+    cass_cluster_set_io_thread_cpus(cluster, &options.load.cpus[0], options.load.cpus.size());
+    cass_cluster_set_request_dispatch(cluster, CASS_REQUEST_DISPATCH_CPU_AFFINITY);
+  }
+
+  // The driver's threads are created when connecting
+  CacheMissCounter cache_misses;
+
+  CassSession* session = cass_session_new();
+  CassFuture* connect_future = cass_session_connect(session, cluster);
+  CassError rc = cass_future_error_code(connect_future);
+  cass_future_free(connect_future);
+
+  if (rc != CASS_OK) {
+    fprintf(stderr, "Unable to connect: %s\n", cass_error_desc(rc));
+  } else {
+    CassStatement* statement = cass_statement_new("SELECT value FROM keyspace.table", 0);
+    cass_statement_set_is_idempotent(statement, cass_true);
+
+    LoadResults results;
+    LoadGenerator generator(session, statement, options.load);
+    generator.set_excluded_cpu_time(BenchmarkCluster::cpu_time_ns, &server);
+    uint64_t cache_miss_start = cache_misses.read();
+    generator.run(&results);
+    uint64_t cache_miss_count = cache_misses.read() - cache_miss_start;
+    print_results(options, results, cache_misses, cache_miss_count);
+
+    cass_statement_free(statement);
+  }
+
+  CassFuture* close_future = cass_session_close(session);
+  cass_future_wait(close_future);
+  cass_future_free(close_future);
+
+  cass_session_free(session);
+  cass_cluster_free(cluster);
+
+  return rc == CASS_OK ? 0 : 1;
+}
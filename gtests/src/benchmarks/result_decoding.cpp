@@ -0,0 +1,305 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "result_decoding.hpp"
+
+#include "load_generator.hpp"
+
+#include "constants.hpp"
+#include "result_response.hpp"
+#include "serialization.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_COLUMNS 4
+
+namespace benchmarks {
+
+class ResultBodyBuilder {
+public:
+  void int32(int32_t value) {
+    char buf[sizeof(int32_t)];
+    cass::encode_int32(buf, value);
+    body_.append(buf, sizeof(buf));
+  }
+
+  void int64(int64_t value) {
+    char buf[sizeof(int64_t)];
+    cass::encode_int64(buf, value);
+    body_.append(buf, sizeof(buf));
+  }
+
+  void float64(double value) {
+    char buf[sizeof(double)];
+    cass::encode_double(buf, value);
+    body_.append(buf, sizeof(buf));
+  }
+
+  void string(const cass::String& value) {
+    char buf[sizeof(uint16_t)];
+    cass::encode_uint16(buf, static_cast<uint16_t>(value.size()));
+    body_.append(buf, sizeof(buf));
+    body_.append(value);
+  }
+
+  void column(const cass::String& name, CassValueType type) {
+    string(name);
+    char buf[sizeof(uint16_t)];
+    cass::encode_uint16(buf, static_cast<uint16_t>(type));
+    body_.append(buf, sizeof(buf));
+  }
+
+  void append(const cass::String& value) { body_.append(value); }
+
+  void value(const cass::String& value) {
+    int32(static_cast<int32_t>(value.size()));
+    append(value);
+  }
+
+  void header(int32_t column_count) {
+    int32(CASS_RESULT_KIND_ROWS);
+    int32(CASS_RESULT_FLAG_GLOBAL_TABLESPEC);
+    int32(column_count);
+    string("keyspace");
+    string("table");
+  }
+
+  const cass::String& body() const { return body_; }
+
+private:
+  cass::String body_;
+};
+
+static cass::ResultResponse::Ptr decode_result(const cass::String& body) {
+  cass::ResultResponse::Ptr result(cass::Memory::allocate<cass::ResultResponse>());
+  result->set_buffer(body.size());
+  memcpy(result->data(), body.data(), body.size());
+  cass::Decoder decoder(result->data(), body.size(),
+                        cass::ProtocolVersion(CASS_PROTOCOL_VERSION_V4));
+  if (!result->decode(decoder)) {
+    fprintf(stderr, "Unable to decode the result\n");
+    abort();
+  }
+  return result;
+}
+
+static cass::ResultResponse::Ptr create_result(unsigned num_rows) {
+  ResultBodyBuilder builder;
+  builder.header(NUM_COLUMNS);
+  builder.column("id", CASS_VALUE_TYPE_INT);
+  builder.column("time", CASS_VALUE_TYPE_BIGINT);
+  builder.column("value", CASS_VALUE_TYPE_DOUBLE);
+  builder.column("tag", CASS_VALUE_TYPE_VARCHAR);
+  builder.int32(num_rows);
+  for (unsigned i = 0; i < num_rows; ++i) {
+    builder.int32(sizeof(int32_t));
+    builder.int32(i);
+    builder.int32(sizeof(int64_t));
+    builder.int64(1000000 + i);
+    builder.int32(sizeof(double));
+    builder.float64(i * 0.5);
+    builder.value("tag-0000");
+  }
+  return decode_result(builder.body());
+}
+
+static cass::ResultResponse::Ptr create_wide_result(unsigned num_rows) {
+  static const CassValueType types[] = {
+    CASS_VALUE_TYPE_INT, CASS_VALUE_TYPE_BIGINT, CASS_VALUE_TYPE_DOUBLE,
+    CASS_VALUE_TYPE_VARCHAR, CASS_VALUE_TYPE_BOOLEAN, CASS_VALUE_TYPE_UUID,
+    CASS_VALUE_TYPE_TIMESTAMP, CASS_VALUE_TYPE_FLOAT
+  };
+  static const size_t num_types = sizeof(types) / sizeof(types[0]);
+
+  ResultBodyBuilder builder;
+  builder.header(RESULT_DECODING_WIDE_COLUMNS);
+  for (unsigned i = 0; i < RESULT_DECODING_WIDE_COLUMNS; ++i) {
+    cass::OStringStream ss;
+    ss << "column" << i;
+    builder.column(ss.str(), types[i % num_types]);
+  }
+  builder.int32(num_rows);
+  for (unsigned i = 0; i < num_rows; ++i) {
+    for (unsigned j = 0; j < RESULT_DECODING_WIDE_COLUMNS; ++j) {
+      switch (types[j % num_types]) {
+        case CASS_VALUE_TYPE_INT:
+        case CASS_VALUE_TYPE_FLOAT:
+          builder.value(cass::String(sizeof(int32_t), '\x01'));
+          break;
+        case CASS_VALUE_TYPE_BOOLEAN:
+          builder.value(cass::String(1, '\x01'));
+          break;
+        case CASS_VALUE_TYPE_UUID:
+          builder.value(cass::String(16, '\x01'));
+          break;
+        case CASS_VALUE_TYPE_VARCHAR:
+          builder.value("value-0000");
+          break;
+        default:
+          builder.value(cass::String(sizeof(int64_t), '\x01'));
+          break;
+      }
+    }
+  }
+  return decode_result(builder.body());
+}
+
+static double read_rows(const CassResult* result) {
+  double sum = 0.0;
+  CassIterator* iterator = cass_iterator_from_result(result);
+  while (cass_iterator_next(iterator)) {
+    const CassRow* row = cass_iterator_get_row(iterator);
+    cass_int32_t id = 0;
+    cass_int64_t time = 0;
+    cass_double_t value = 0.0;
+    const char* tag;
+    size_t tag_length = 0;
+    cass_value_get_int32(cass_row_get_column(row, 0), &id);
+    cass_value_get_int64(cass_row_get_column(row, 1), &time);
+    cass_value_get_double(cass_row_get_column(row, 2), &value);
+    cass_value_get_string(cass_row_get_column(row, 3), &tag, &tag_length);
+    sum += id + time + value + tag_length;
+  }
+  cass_iterator_free(iterator);
+  return sum;
+}
+
+static double read_columns(const CassResult* result) {
+  double sum = 0.0;
+  CassResultColumns* columns = cass_result_columns_new(result);
+  size_t row_count = cass_result_columns_row_count(columns);
+  const cass_int32_t* ids = cass_result_columns_int32(columns, 0);
+  const cass_int64_t* times = cass_result_columns_int64(columns, 1);
+  const cass_double_t* values = cass_result_columns_double(columns, 2);
+  const cass_byte_t* data;
+  const cass_uint32_t* offsets;
+  const cass_int32_t* lengths;
+  cass_result_columns_bytes(columns, 3, &data, &offsets, &lengths);
+  for (size_t i = 0; i < row_count; ++i) {
+    sum += ids[i] + times[i] + values[i] + lengths[i];
+  }
+  cass_result_columns_free(columns);
+  return sum;
+}
+
+// The arrays are reused between reads (like an application reading pages)
+static cass::Vector<cass_int32_t> ids_array;
+static cass::Vector<cass_int64_t> times_array;
+static cass::Vector<cass_double_t> values_array;
+
+static double read_arrays(const CassResult* result) {
+  double sum = 0.0;
+  size_t row_count = ids_array.size();
+  cass_result_column_get_int32_array(result, 0, &ids_array[0], row_count, NULL);
+  cass_result_column_get_int64_array(result, 1, &times_array[0], row_count, NULL);
+  cass_result_column_get_double_array(result, 2, &values_array[0], row_count, NULL);
+  for (size_t i = 0; i < row_count; ++i) {
+    sum += ids_array[i] + times_array[i] + values_array[i];
+  }
+  return sum;
+}
+
+static double read_wide_rows(const CassResult* result) {
+  double sum = 0.0;
+  CassIterator* iterator = cass_iterator_from_result(result);
+  while (cass_iterator_next(iterator)) {
+    const CassRow* row = cass_iterator_get_row(iterator);
+    for (size_t i = 0; i < RESULT_DECODING_WIDE_COLUMNS; ++i) {
+      sum += cass_value_is_null(cass_row_get_column(row, i)) ? 0 : 1;
+    }
+  }
+  cass_iterator_free(iterator);
+  return sum;
+}
+
+static double seek_last_wide_row(const CassResult* result) {
+  double sum = 0.0;
+  CassIterator* iterator = cass_iterator_from_result(result);
+  if (cass_iterator_seek_row(iterator, cass_result_row_count(result) - 1) == CASS_OK) {
+    const CassRow* row = cass_iterator_get_row(iterator);
+    for (size_t i = 0; i < RESULT_DECODING_WIDE_COLUMNS; ++i) {
+      sum += cass_value_is_null(cass_row_get_column(row, i)) ? 0 : 1;
+    }
+  }
+  cass_iterator_free(iterator);
+  return sum;
+}
+
+static void measure(double (*read)(const CassResult*),
+                    const CassResult* result, unsigned num_rows,
+                    unsigned num_operations, ResultDecodingResult* output,
+                    double* sum) {
+  LoadGenerator::start_counting_allocations();
+  uint64_t start = uv_hrtime();
+  for (unsigned i = 0; i < num_operations; ++i) {
+    *sum += read(result);
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+  uint64_t allocations = LoadGenerator::stop_counting_allocations();
+
+  double total_rows = static_cast<double>(num_rows) * num_operations;
+  output->ns = elapsed / total_rows;
+  output->allocations = allocations / total_rows;
+}
+
+void run_result_decoding(unsigned num_rows, unsigned num_operations,
+                         ResultDecodingResults* results) {
+  cass::ResultResponse::Ptr result(create_result(num_rows));
+  const CassResult* external = CassResult::to(result.get());
+
+  double rows_sum = 0.0, columns_sum = 0.0;
+  measure(read_rows, external, num_rows, num_operations, &results->rows, &rows_sum);
+  measure(read_columns, external, num_rows, num_operations, &results->columns, &columns_sum);
+
+  // This also keeps the reads from being optimized away
+  if (rows_sum != columns_sum) {
+    fprintf(stderr, "The rows and columns don't match (%f != %f)\n", rows_sum, columns_sum);
+  }
+
+  ids_array.resize(num_rows);
+  times_array.resize(num_rows);
+  values_array.resize(num_rows);
+  double arrays_sum = 0.0;
+  measure(read_arrays, external, num_rows, num_operations, &results->arrays, &arrays_sum);
+  // The arrays don't include the length of the text values
+  double tag_lengths = static_cast<double>(num_rows) * num_operations * 8;
+  if (rows_sum != arrays_sum + tag_lengths) {
+    fprintf(stderr, "The rows and arrays don't match (%f != %f)\n",
+            rows_sum, arrays_sum + tag_lengths);
+  }
+  ids_array.clear();
+  times_array.clear();
+  values_array.clear();
+
+  cass::ResultResponse::Ptr wide_result(create_wide_result(num_rows));
+  double wide_sum = 0.0;
+  measure(read_wide_rows, CassResult::to(wide_result.get()), num_rows, num_operations,
+          &results->wide_rows, &wide_sum);
+  if (wide_sum != static_cast<double>(num_rows) * num_operations * RESULT_DECODING_WIDE_COLUMNS) {
+    fprintf(stderr, "Unexpected null values in the wide rows\n");
+  }
+
+  double seek_sum = 0.0;
+  measure(seek_last_wide_row, CassResult::to(wide_result.get()), num_rows, num_operations,
+          &results->wide_seek, &seek_sum);
+  if (seek_sum != static_cast<double>(num_operations) * RESULT_DECODING_WIDE_COLUMNS) {
+    fprintf(stderr, "Unable to move to the last of the wide rows\n");
+  }
+}
+
+} // namespace benchmarks
@@ -0,0 +1,61 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __BENCHMARKS_RESULT_DECODING_HPP_INCLUDED__
+#define __BENCHMARKS_RESULT_DECODING_HPP_INCLUDED__
+
+#include <stdint.h>
+
+#define RESULT_DECODING_WIDE_COLUMNS 32
+
+namespace benchmarks {
+
+struct ResultDecodingResult {
+  double ns;          // Average time per row
+  double allocations; // Average driver allocations per row
+};
+
+struct ResultDecodingResults {
+  ResultDecodingResult rows;      // Iterating over the rows and getting each value
+  ResultDecodingResult columns;   // Decoding the rows into columns and scanning them
+  ResultDecodingResult arrays;    // Copying the fixed-width columns into arrays
+  ResultDecodingResult wide_rows; // Iterating over wide rows (decoding only)
+  ResultDecodingResult wide_seek; // Moving to the last of the wide rows
+};
+
+/**
+ * Measures the per-row cost of reading a result with narrow rows (an int, a
+ * bigint, a double and a short text column) by iterating over its rows
+ * compared to decoding it into columns. Every value is read and summed so
+ * that both sides do the same amount of work. Copying only the fixed-width
+ * columns into arrays is measured separately.
+ *
+ * It also measures the cost of iterating over a result with wide rows
+ * (`RESULT_DECODING_WIDE_COLUMNS` columns of eight different types) and only
+ * checking whether each value is null, which is dominated by decoding the
+ * rows, compared to moving an iterator directly to the last row (which finds
+ * the offsets of all the rows).
+ *
+ * @param num_rows The number of rows in the result.
+ * @param num_operations The number of times the result is read.
+ * @param results The average cost per row.
+ */
+void run_result_decoding(unsigned num_rows, unsigned num_operations,
+                         ResultDecodingResults* results);
+
+} // namespace benchmarks
+
+#endif
@@ -0,0 +1,113 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "routing.hpp"
+
+#include "load_generator.hpp"
+#include "test_token_map_utils.hpp"
+
+#include "dc_aware_policy.hpp"
+#include "query_request.hpp"
+#include "random.hpp"
+#include "request_handler.hpp"
+#include "token_aware_policy.hpp"
+
+#define NUM_TOKENS_PER_HOST 256
+#define LOCAL_DC "dc1"
+#define REMOTE_DC "dc2"
+
+namespace benchmarks {
+
+static void route(cass::LoadBalancingPolicy* policy,
+                  const cass::TokenMap* token_map,
+                  const cass::Vector<cass::RequestHandler::Ptr>& request_handlers,
+                  unsigned num_operations,
+                  RoutingResult* result) {
+  // Query plans are created in storage embedded in the request handler
+  cass::QueryPlanStorage query_plan;
+  LoadGenerator::start_counting_allocations();
+  uint64_t start = uv_hrtime();
+  for (unsigned i = 0; i < num_operations; ++i) {
+    cass::RequestHandler* request_handler = request_handlers[i % request_handlers.size()].get();
+    query_plan.reset(policy->emplace_query_plan(&query_plan, "ks", request_handler, token_map));
+    query_plan->compute_next();
+  }
+  query_plan.reset();
+  uint64_t elapsed = uv_hrtime() - start;
+  uint64_t allocations = LoadGenerator::stop_counting_allocations();
+
+  result->ns = static_cast<double>(elapsed) / num_operations;
+  result->allocations = static_cast<double>(allocations) / num_operations;
+}
+
+static cass::RequestHandler::Ptr create_request_handler(unsigned key, bool is_composite) {
+  cass::OStringStream ss;
+  ss << "key" << key;
+  cass::String value(ss.str());
+
+  cass::QueryRequest::Ptr request(
+        cass::Memory::allocate<cass::QueryRequest>("SELECT * FROM ks.table", is_composite ? 2 : 1));
+  request->set(0, cass::CassString(value.data(), value.size()));
+  request->add_key_index(0);
+  if (is_composite) {
+    request->set(1, static_cast<cass_int32_t>(key));
+    request->add_key_index(1);
+  }
+  return cass::RequestHandler::Ptr(
+        cass::Memory::allocate<cass::RequestHandler>(request, cass::ResponseFuture::Ptr()));
+}
+
+void run_routing(unsigned num_hosts, unsigned num_operations,
+                 RoutingResults* results) {
+  MT19937_64 rng;
+  cass::HostMap hosts;
+  cass::TokenMap::Ptr token_map(cass::TokenMap::from_partitioner(cass::Murmur3Partitioner::name()));
+
+  for (unsigned i = 0; i < num_hosts; ++i) {
+    cass::OStringStream ss;
+    ss << "127.0." << (i / 256) << "." << (i % 256 + 1);
+    // The rack and datacenter are in the same order as the unit tests use them
+    cass::Host::Ptr host(create_host(ss.str(),
+                                     random_murmur3_tokens(rng, NUM_TOKENS_PER_HOST),
+                                     cass::Murmur3Partitioner::name().to_string(),
+                                     "rack1", i % 2 == 0 ? LOCAL_DC : REMOTE_DC));
+    hosts[host->address()] = host;
+    token_map->add_host(host);
+  }
+
+  ReplicationMap replication;
+  replication[LOCAL_DC] = "3";
+  replication[REMOTE_DC] = "3";
+  add_keyspace_network_topology("ks", replication, token_map.get());
+  token_map->build();
+
+  cass::Random random;
+  cass::TokenAwarePolicy policy(cass::Memory::allocate<cass::DCAwarePolicy>(LOCAL_DC, 0, false), true);
+  policy.init(cass::Host::Ptr(), hosts, &random);
+
+  // Cycle through a set of keys so that the replicas vary between requests
+  const unsigned num_keys = 1024;
+  cass::Vector<cass::RequestHandler::Ptr> single_key, composite_key;
+  for (unsigned i = 0; i < num_keys; ++i) {
+    single_key.push_back(create_request_handler(i, false));
+    composite_key.push_back(create_request_handler(i, true));
+  }
+
+  route(&policy, token_map.get(), single_key, num_operations, &results->single_key);
+  route(&policy, token_map.get(), composite_key, num_operations, &results->composite_key);
+}
+
+} // namespace benchmarks
@@ -0,0 +1,50 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __BENCHMARKS_ROUTING_HPP_INCLUDED__
+#define __BENCHMARKS_ROUTING_HPP_INCLUDED__
+
+#include <stdint.h>
+
+namespace benchmarks {
+
+struct RoutingResult {
+  double ns;          // Average time per request
+  double allocations; // Average driver allocations per request
+};
+
+struct RoutingResults {
+  RoutingResult single_key;    // A partition key with one component
+  RoutingResult composite_key; // A partition key with two components
+};
+
+/**
+ * Measures the per-request cost of token-aware routing: building a query
+ * plan with `TokenAwarePolicy` (wrapping `DCAwarePolicy`, with replica
+ * shuffling) and getting its first host. The token map has two datacenters
+ * with 256 tokens per host and a keyspace with three replicas in each
+ * datacenter.
+ *
+ * @param num_hosts The number of hosts (split evenly between datacenters).
+ * @param num_operations The number of query plans to measure.
+ * @param results The average cost per request.
+ */
+void run_routing(unsigned num_hosts, unsigned num_operations,
+                 RoutingResults* results);
+
+} // namespace benchmarks
+
+#endif
@@ -0,0 +1,111 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "timer_churn.hpp"
+
+#include "memory.hpp"
+#include "timer.hpp"
+#include "timer_wheel.hpp"
+#include "vector.hpp"
+
+#include <uv.h>
+
+namespace benchmarks {
+
+// Timeouts are spread across a typical request timeout range (in milliseconds)
+#define MIN_TIMEOUT_MS 1000
+#define TIMEOUT_RANGE_MS 11000
+
+static void on_timer(cass::Timer* timer) { }
+static void on_wheel_timer(cass::WheelTimer* timer) { }
+
+static uint64_t next_timeout(uint64_t* seed) {
+  // A simple LCG so both runs see the same sequence of timeouts
+  *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  return MIN_TIMEOUT_MS + (*seed >> 33) % TIMEOUT_RANGE_MS;
+}
+
+static double churn_timers(uv_loop_t* loop, unsigned num_timers, unsigned num_operations) {
+  cass::Vector<cass::Timer*> timers(num_timers);
+  cass::Timer::Callback callback(on_timer);
+
+  uint64_t seed = 0;
+  for (unsigned i = 0; i < num_timers; ++i) {
+    timers[i] = cass::Memory::allocate<cass::Timer>();
+    timers[i]->start(loop, next_timeout(&seed), callback);
+  }
+
+  // Stopping a `Timer` closes its libuv handle so starting it again allocates
+  // and initializes a new handle. This is what requests have been paying for.
+  uint64_t start = uv_hrtime();
+  for (unsigned i = 0; i < num_operations; ++i) {
+    cass::Timer* timer = timers[i % num_timers];
+    timer->stop();
+    timer->start(loop, next_timeout(&seed), callback);
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+
+  for (unsigned i = 0; i < num_timers; ++i) {
+    cass::Memory::deallocate(timers[i]);
+  }
+  uv_run(loop, UV_RUN_NOWAIT); // Free the closed timer handles
+
+  return static_cast<double>(elapsed) / num_operations;
+}
+
+static double churn_wheel_timers(uv_loop_t* loop, unsigned num_timers, unsigned num_operations) {
+  cass::TimerWheel wheel;
+  wheel.init(loop);
+
+  cass::Vector<cass::WheelTimer*> timers(num_timers);
+  cass::WheelTimer::Callback callback(on_wheel_timer);
+
+  uint64_t seed = 0;
+  for (unsigned i = 0; i < num_timers; ++i) {
+    timers[i] = cass::Memory::allocate<cass::WheelTimer>();
+    timers[i]->start(&wheel, next_timeout(&seed), callback);
+  }
+
+  uint64_t start = uv_hrtime();
+  for (unsigned i = 0; i < num_operations; ++i) {
+    cass::WheelTimer* timer = timers[i % num_timers];
+    timer->stop();
+    timer->start(&wheel, next_timeout(&seed), callback);
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+
+  for (unsigned i = 0; i < num_timers; ++i) {
+    cass::Memory::deallocate(timers[i]);
+  }
+  wheel.close_handles();
+  uv_run(loop, UV_RUN_NOWAIT);
+
+  return static_cast<double>(elapsed) / num_operations;
+}
+
+void run_timer_churn(unsigned num_timers, unsigned num_operations,
+                     TimerChurnResults* results) {
+  uv_loop_t loop;
+  uv_loop_init(&loop);
+
+  results->timer_ns = churn_timers(&loop, num_timers, num_operations);
+  results->wheel_timer_ns = churn_wheel_timers(&loop, num_timers, num_operations);
+
+  uv_run(&loop, UV_RUN_DEFAULT);
+  uv_loop_close(&loop);
+}
+
+} // namespace benchmarks
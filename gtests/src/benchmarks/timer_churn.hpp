@@ -0,0 +1,45 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __BENCHMARKS_TIMER_CHURN_HPP_INCLUDED__
+#define __BENCHMARKS_TIMER_CHURN_HPP_INCLUDED__
+
+#include <stdint.h>
+
+namespace benchmarks {
+
+struct TimerChurnResults {
+  // Average cost of restarting (stop, then start) an in-flight timer
+  double timer_ns;       // libuv timers (binary heap)
+  double wheel_timer_ns; // Timer wheel
+};
+
+/**
+ * Measures the cost of the timer churn caused by requests: a fixed number of
+ * timers are in flight and each operation stops one of them and starts it
+ * again with a new timeout (the pattern of request timeouts and speculative
+ * executions). The timers never fire.
+ *
+ * @param num_timers The number of in-flight timers.
+ * @param num_operations The number of restarts to measure.
+ * @param results The average cost per restart.
+ */
+void run_timer_churn(unsigned num_timers, unsigned num_operations,
+                     TimerChurnResults* results);
+
+} // namespace benchmarks
+
+#endif
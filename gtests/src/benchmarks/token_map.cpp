@@ -0,0 +1,83 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "token_map.hpp"
+
+#include "test_token_map_utils.hpp"
+
+#include "fork_join.hpp"
+
+#include <uv.h>
+
+#define NUM_TOKENS_PER_HOST 256
+#define NUM_DCS 3
+#define NUM_RACKS_PER_DC 3
+#define NUM_KEYSPACES 200
+#define MAX_REPLICATION_FACTOR 4
+
+namespace benchmarks {
+
+static double elapsed_ms(uint64_t start) {
+  return static_cast<double>(uv_hrtime() - start) / (1000.0 * 1000.0);
+}
+
+void run_token_map(unsigned num_hosts, unsigned num_operations,
+                   TokenMapResults* results) {
+  MT19937_64 rng;
+  cass::HostVec hosts(create_murmur3_ring(rng, num_hosts + num_operations,
+                                          NUM_TOKENS_PER_HOST, NUM_DCS, NUM_RACKS_PER_DC));
+
+  uint64_t start = uv_hrtime();
+  cass::TokenMap::Ptr token_map(cass::TokenMap::from_partitioner(cass::Murmur3Partitioner::name()));
+  for (unsigned i = 0; i < num_hosts; ++i) {
+    token_map->add_host(hosts[i]);
+  }
+  // The keyspaces are split evenly between replication factors
+  for (unsigned i = 1; i <= MAX_REPLICATION_FACTOR; ++i) {
+    cass::OStringStream prefix;
+    prefix << "ks_rf" << i << "_";
+    add_keyspaces_network_topology(prefix.str(), NUM_KEYSPACES / MAX_REPLICATION_FACTOR,
+                                   NUM_DCS, i, token_map.get());
+  }
+  token_map->build();
+  results->build_ms = elapsed_ms(start);
+  results->build_threads = cass::ForkJoin::num_threads();
+
+  // Each topology change is applied to a copy of the current token map (the
+  // same as the cluster does).
+  double copy_ms = 0.0, add_host_ms = 0.0, remove_host_ms = 0.0;
+  for (unsigned i = 0; i < num_operations; ++i) {
+    start = uv_hrtime();
+    token_map = token_map->copy();
+    copy_ms += elapsed_ms(start);
+
+    const cass::Host::Ptr& host = hosts[num_hosts + i];
+    start = uv_hrtime();
+    token_map->update_host_and_build(host);
+    add_host_ms += elapsed_ms(start);
+
+    token_map = token_map->copy();
+    start = uv_hrtime();
+    token_map->remove_host_and_build(host);
+    remove_host_ms += elapsed_ms(start);
+  }
+
+  results->copy_ms = copy_ms / num_operations;
+  results->add_host_ms = add_host_ms / num_operations;
+  results->remove_host_ms = remove_host_ms / num_operations;
+}
+
+} // namespace benchmarks
@@ -0,0 +1,47 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __BENCHMARKS_TOKEN_MAP_HPP_INCLUDED__
+#define __BENCHMARKS_TOKEN_MAP_HPP_INCLUDED__
+
+#include <stdint.h>
+
+namespace benchmarks {
+
+struct TokenMapResults {
+  double build_ms;       // Building the token map from scratch (done when connecting)
+  unsigned build_threads; // The number of threads used to build replicas
+  double copy_ms;        // Copying the token map (done for every topology change)
+  double add_host_ms;    // Adding a host to a copy
+  double remove_host_ms; // Removing a host from a copy
+};
+
+/**
+ * Measures the cost of building the token map and updating it for topology
+ * changes. The ring has three datacenters, each with three racks, and 256
+ * tokens per host. There are two hundred network topology keyspaces split
+ * evenly between one, two, three and four replicas in each datacenter.
+ *
+ * @param num_hosts The number of hosts (split evenly between datacenters).
+ * @param num_operations The number of host additions and removals to measure.
+ * @param results The average cost of each operation.
+ */
+void run_token_map(unsigned num_hosts, unsigned num_operations,
+                   TokenMapResults* results);
+
+} // namespace benchmarks
+
+#endif
@@ -186,6 +186,8 @@ void ClientConnection::close() {
 int ClientConnection::accept() {
   int rc = server_->accept(tcp_.as_stream());
   if (rc != 0) return rc;
+  // Don't delay pipelined responses
+  uv_tcp_nodelay(reinterpret_cast<uv_tcp_t*>(tcp_.as_stream()), 1);
   return uv_read_start(tcp_.as_stream(), on_alloc, on_read);
 }
 
@@ -1219,6 +1221,10 @@ Action::Builder& Action::Builder::empty_rows_result(int32_t row_count) {
   return execute(Memory::allocate<EmptyRowsResult>(row_count));
 }
 
+Action::Builder& Action::Builder::text_rows_result(int32_t row_count, size_t value_size) {
+  return execute(Memory::allocate<TextRowsResult>(row_count, value_size));
+}
+
 Action::Builder& Action::Builder::no_result() {
   return execute(Memory::allocate<NoResult>());
 }
@@ -1328,7 +1334,17 @@ void Request::write(int8_t opcode, const String& body) {
 }
 
 void Request::write(int16_t stream, int8_t opcode, const cass::String& body) {
-  client_->write(encode_header(version_, flags_, stream, opcode, body.size()) + body);
+  int8_t flags = flags_ & ~FLAG_COMPRESSION;
+  const cass::Compressor::Ptr& compressor(client_->compressor());
+  cass::Buffer compressed;
+  if (compressor && !body.empty() &&
+      compressor->compress(body.data(), body.size(), &compressed)) {
+    flags |= FLAG_COMPRESSION;
+    client_->write(encode_header(version_, flags, stream, opcode, compressed.size()) +
+                   String(compressed.data(), compressed.size()));
+  } else {
+    client_->write(encode_header(version_, flags, stream, opcode, body.size()) + body);
+  }
 }
 
 void Request::error(int32_t code, const String& message) {
@@ -1390,6 +1406,9 @@ Hosts Request::hosts() const {
 
 void Request::on_timeout(Timer* timer) {
   timer_action_->run_next(this);
+  if (!is_waiting()) { // The remaining actions could have started another wait
+    Memory::deallocate(this);
+  }
 }
 
 void SendError::on_run(Request* request) const {
@@ -1420,7 +1439,14 @@ void SendAuthSuccess::on_run(Request* request) const {
 
 void SendSupported::on_run(Request* request) const {
   String body;
-  encode_uint16(0, &body);
+  Vector<String> compression(cass::Compressor::supported_names());
+  if (compression.empty()) {
+    encode_uint16(0, &body);
+  } else {
+    encode_uint16(1, &body);
+    encode_string("COMPRESSION", &body);
+    encode_string_list(compression, &body);
+  }
   request->write(OPCODE_SUPPORTED, body);
 }
 
@@ -1450,6 +1476,19 @@ void EmptyRowsResult::on_run(Request* request) const {
   }
 }
 
+TextRowsResult::TextRowsResult(int32_t row_count, size_t value_size) {
+  ResultSet::Builder builder("keyspace", "table");
+  builder.column("value", Type::text());
+  for (int32_t i = 0; i < row_count; ++i) {
+    builder.row(Row::Builder().text(String(value_size, 'x')).build());
+  }
+  body = builder.build().encode(CASS_HIGHEST_SUPPORTED_PROTOCOL_VERSION);
+}
+
+void TextRowsResult::on_run(Request* request) const {
+  request->write(OPCODE_RESULT, body);
+}
+
 void NoResult::on_run(Request* request) const { }
 
 void MatchQuery::on_run(Request* request) const {
@@ -1683,6 +1722,17 @@ void ValidateStartup::on_run(Request* request) const {
   if (!request->decode_startup(&options)) {
     request->error(ERROR_PROTOCOL_ERROR, "Invalid startup message");
   } else {
+    for (Options::const_iterator it = options.begin(),
+         end = options.end(); it != end; ++it) {
+      if (it->first == "COMPRESSION") {
+        cass::Compressor::Ptr compressor(cass::Compressor::create(it->second));
+        if (!compressor) {
+          request->error(ERROR_PROTOCOL_ERROR, "Unsupported compression algorithm");
+          return;
+        }
+        request->client()->set_compressor(compressor);
+      }
+    }
     request->client()->set_options(options);
     run_next(request);
   }
@@ -1790,7 +1840,8 @@ int32_t ProtocolHandler::decode_frame(ClientConnection* client, const char* fram
   const char* end = pos + len;
   int32_t remaining = len;
 
-  while (remaining > 0) {
+  // Frames with an empty body (e.g. OPTIONS) are complete after the header
+  while (remaining > 0 || (state_ == BODY && length_ == 0)) {
     switch (state_) {
       case PROTOCOL_VERSION:
         // Version requires a single byte and that's guaranteed by the loop check.
@@ -1845,6 +1896,20 @@ int32_t ProtocolHandler::decode_frame(ClientConnection* client, const char* fram
 }
 
 void ProtocolHandler::decode_body(ClientConnection* client, const char* body, int32_t len) {
+  if (flags_ & FLAG_COMPRESSION) {
+    cass::RefBuffer::Ptr decompressed;
+    size_t decompressed_size;
+    if (!client->compressor() ||
+        !client->compressor()->decompress(body, len, &decompressed, &decompressed_size)) {
+      fprintf(stderr, "Unable to decompress request body\n");
+      client->close();
+      return;
+    }
+    request_handler_->run(Memory::allocate<Request>(version_, flags_, stream_, opcode_,
+                                                    String(decompressed->data(), decompressed_size),
+                                                    client));
+    return;
+  }
   request_handler_->run(Memory::allocate<Request>(version_, flags_, stream_, opcode_, String(body, len), client));
 }
 
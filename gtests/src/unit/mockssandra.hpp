@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include "address.hpp"
+#include "compression.hpp"
 #include "event_loop.hpp"
 #include "memory.hpp"
 #include "string.hpp"
@@ -636,6 +637,7 @@ struct Action {
 
     Builder& void_result();
     Builder& empty_rows_result(int32_t row_count);
+    Builder& text_rows_result(int32_t row_count, size_t value_size);
     Builder& no_result();
     Builder& match_query(const Matches& matches);
 
@@ -736,6 +738,7 @@ public:
   void write(int16_t stream, int8_t opcode, const String& body);
   void error(int32_t code, const String& message);
   void wait(uint64_t timeout, const Action* action);
+  bool is_waiting() const { return timer_.is_running(); }
   void close();
 
   bool decode_startup(Options* options);
@@ -846,6 +849,12 @@ struct EmptyRowsResult : public Action {
   int32_t row_count;
 };
 
+struct TextRowsResult : public Action {
+  TextRowsResult(int32_t row_count, size_t value_size);
+  virtual void on_run(Request* request) const;
+  String body; // Text values are encoded the same for all protocol versions
+};
+
 struct NoResult : public Action {
   virtual void on_run(Request* request) const;
 };
@@ -993,7 +1002,9 @@ public:
     } else {
       invalid_opcode_->run(request);
     }
-    Memory::deallocate(request);
+    if (!request->is_waiting()) { // Waiting requests free themselves when done
+      Memory::deallocate(request);
+    }
   }
 
 private:
@@ -1065,6 +1076,9 @@ public:
   const Options& options() const { return options_; }
   void set_options(const Options& options) { options_ = options; }
 
+  const cass::Compressor::Ptr& compressor() const { return compressor_; }
+  void set_compressor(const cass::Compressor::Ptr& compressor) { compressor_ = compressor; }
+
 private:
   ProtocolHandler handler_;
   const Cluster* cluster_;
@@ -1072,6 +1086,7 @@ private:
   int protocol_version_;
   bool is_registered_for_events_;
   Options options_;
+  cass::Compressor::Ptr compressor_;
 };
 
 class CloseConnection : public ClientConnection {
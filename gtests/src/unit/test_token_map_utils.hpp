@@ -348,6 +348,53 @@ inline cass::Host::Ptr create_host(const cass::String& address,
   return create_host(cass::Address(address, 9042), tokens, partitioner, dc, rack, release_version);
 }
 
+/**
+ * Create the hosts of a large synthetic ring. The hosts are distributed
+ * evenly across datacenters ("dc1", "dc2", ...) and each datacenter's racks
+ * ("rack1", "rack2", ...) and are given random Murmur3 tokens.
+ */
+inline cass::HostVec create_murmur3_ring(MT19937_64& rng,
+                                         size_t num_hosts,
+                                         size_t num_tokens_per_host,
+                                         size_t num_dcs,
+                                         size_t num_racks_per_dc) {
+  cass::HostVec hosts;
+  for (size_t i = 0; i < num_hosts; ++i) {
+    cass::OStringStream ip, dc, rack;
+    ip << "127." << (i / (256 * 256)) % 256 << "." << (i / 256) % 256 << "." << i % 256 + 1;
+    dc << "dc" << (i % num_dcs) + 1;
+    rack << "rack" << (i / num_dcs) % num_racks_per_dc + 1;
+    // The rack and datacenter are in the same order as the unit tests use them
+    hosts.push_back(create_host(ip.str(),
+                                random_murmur3_tokens(rng, num_tokens_per_host),
+                                cass::Murmur3Partitioner::name().to_string(),
+                                rack.str(), dc.str()));
+  }
+  return hosts;
+}
+
+/**
+ * Add network topology keyspaces (e.g. "ks1", "ks2", ...) that replicate to
+ * every datacenter of a ring created by `create_murmur3_ring()`.
+ */
+inline void add_keyspaces_network_topology(const cass::String& prefix,
+                                           size_t num_keyspaces,
+                                           size_t num_dcs,
+                                           size_t replication_factor,
+                                           cass::TokenMap* token_map) {
+  ReplicationMap replication;
+  for (size_t i = 1; i <= num_dcs; ++i) {
+    cass::OStringStream dc, rf;
+    dc << "dc" << i;
+    rf << replication_factor;
+    replication[dc.str()] = rf.str();
+  }
+  for (size_t i = 1; i <= num_keyspaces; ++i) {
+    cass::OStringStream keyspace_name;
+    keyspace_name << prefix << i;
+    add_keyspace_network_topology(keyspace_name.str(), replication, token_map);
+  }
+}
 
 inline cass::RandomPartitioner::Token create_random_token(const cass::String& s) {
   cass::RandomPartitioner::Token token;
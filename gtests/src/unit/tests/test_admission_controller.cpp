@@ -0,0 +1,231 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "admission_controller.hpp"
+#include "map.hpp"
+#include "query_request.hpp"
+#include "request_handler.hpp"
+
+using cass::AdmissionController;
+using cass::RequestHandler;
+
+class AdmissionControllerUnitTest
+    : public testing::Test
+    , public cass::AdmissionListener {
+public:
+  virtual void on_admitted(const RequestHandler::Ptr& request_handler) {
+    admitted.push_back(request_handler);
+  }
+
+  RequestHandler::Ptr create() {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    cass::ResponseFuture::Ptr future(cass::Memory::allocate<cass::ResponseFuture>());
+    RequestHandler::Ptr request_handler(cass::Memory::allocate<RequestHandler>(request, future));
+    futures[request_handler.get()] = future;
+    return request_handler;
+  }
+
+  static void finish(const RequestHandler::Ptr& request_handler) {
+    request_handler->set_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Finished");
+  }
+
+  static void finish_on_thread(void* arg) {
+    finish(*static_cast<RequestHandler::Ptr*>(arg));
+  }
+
+  CassError error_code(const RequestHandler::Ptr& request_handler) {
+    cass::ResponseFuture::Ptr future(futures[request_handler.get()]);
+    if (!future->ready()) return CASS_OK;
+    return future->error() != NULL ? future->error()->code : CASS_OK;
+  }
+
+  cass::Map<RequestHandler*, cass::ResponseFuture::Ptr> futures;
+  RequestHandler::Vec admitted;
+};
+
+TEST_F(AdmissionControllerUnitTest, Fail) {
+  AdmissionController::Ptr controller(
+        cass::Memory::allocate<AdmissionController>(2, CASS_ADMISSION_MODE_FAIL, 16, this));
+
+  RequestHandler::Ptr first(create());
+  RequestHandler::Ptr second(create());
+  RequestHandler::Ptr third(create());
+
+  EXPECT_TRUE(controller->admit(first));
+  EXPECT_TRUE(controller->admit(second));
+  EXPECT_EQ(2u, controller->in_flight_count());
+
+  // Over the limit
+  EXPECT_FALSE(controller->admit(third));
+  EXPECT_EQ(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, error_code(third));
+  EXPECT_EQ(1u, controller->rejected_count());
+  EXPECT_EQ(0u, controller->waiting_count());
+
+  // Finishing a request releases its slot
+  finish(first);
+  EXPECT_EQ(1u, controller->in_flight_count());
+
+  RequestHandler::Ptr fourth(create());
+  EXPECT_TRUE(controller->admit(fourth));
+  EXPECT_TRUE(admitted.empty());
+
+  finish(second);
+  finish(fourth);
+  EXPECT_EQ(0u, controller->in_flight_count());
+}
+
+TEST_F(AdmissionControllerUnitTest, Wait) {
+  AdmissionController::Ptr controller(
+        cass::Memory::allocate<AdmissionController>(1, CASS_ADMISSION_MODE_WAIT, 16, this));
+
+  RequestHandler::Ptr first(create());
+  RequestHandler::Ptr second(create());
+  RequestHandler::Ptr third(create());
+
+  EXPECT_TRUE(controller->admit(first));
+  EXPECT_FALSE(controller->admit(second));
+  EXPECT_FALSE(controller->admit(third));
+  EXPECT_EQ(2u, controller->waiting_count());
+  EXPECT_EQ(CASS_OK, error_code(second));
+  EXPECT_TRUE(admitted.empty());
+
+  // The waiting requests are admitted in order as slots are released
+  finish(first);
+  ASSERT_EQ(1u, admitted.size());
+  EXPECT_EQ(second, admitted[0]);
+  EXPECT_EQ(1u, controller->waiting_count());
+  EXPECT_EQ(1u, controller->in_flight_count());
+
+  finish(second);
+  ASSERT_EQ(2u, admitted.size());
+  EXPECT_EQ(third, admitted[1]);
+  EXPECT_EQ(0u, controller->waiting_count());
+
+  finish(third);
+  EXPECT_EQ(0u, controller->in_flight_count());
+  EXPECT_EQ(0u, controller->rejected_count());
+}
+
+TEST_F(AdmissionControllerUnitTest, WaitQueueFull) {
+  AdmissionController::Ptr controller(
+        cass::Memory::allocate<AdmissionController>(1, CASS_ADMISSION_MODE_WAIT, 1, this));
+
+  RequestHandler::Ptr first(create());
+  RequestHandler::Ptr second(create());
+  RequestHandler::Ptr third(create());
+
+  EXPECT_TRUE(controller->admit(first));
+  EXPECT_FALSE(controller->admit(second));
+
+  // The number of waiting requests is bounded
+  EXPECT_FALSE(controller->admit(third));
+  EXPECT_EQ(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, error_code(third));
+  EXPECT_EQ(1u, controller->waiting_count());
+  EXPECT_EQ(1u, controller->rejected_count());
+
+  finish(first);
+  ASSERT_EQ(1u, admitted.size());
+  finish(second);
+}
+
+TEST_F(AdmissionControllerUnitTest, Close) {
+  AdmissionController::Ptr controller(
+        cass::Memory::allocate<AdmissionController>(1, CASS_ADMISSION_MODE_WAIT, 16, this));
+
+  RequestHandler::Ptr first(create());
+  RequestHandler::Ptr second(create());
+
+  EXPECT_TRUE(controller->admit(first));
+  EXPECT_FALSE(controller->admit(second));
+
+  // Waiting requests fail when the controller is closed
+  controller->close();
+  EXPECT_EQ(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, error_code(second));
+  EXPECT_EQ(0u, controller->waiting_count());
+
+  RequestHandler::Ptr third(create());
+  EXPECT_FALSE(controller->admit(third));
+  EXPECT_EQ(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, error_code(third));
+
+  finish(first);
+  EXPECT_TRUE(admitted.empty());
+}
+
+struct BlockingListener : public cass::AdmissionListener {
+  BlockingListener()
+    : is_dispatched(false) {
+    uv_sem_init(&entered, 0);
+    uv_sem_init(&release, 0);
+  }
+
+  ~BlockingListener() {
+    uv_sem_destroy(&entered);
+    uv_sem_destroy(&release);
+  }
+
+  virtual void on_admitted(const RequestHandler::Ptr& request_handler) {
+    uv_sem_post(&entered);
+    uv_sem_wait(&release);
+    is_dispatched.store(true);
+  }
+
+  uv_sem_t entered;
+  uv_sem_t release;
+  cass::Atomic<bool> is_dispatched;
+};
+
+struct CloseOnThread {
+  AdmissionController* controller;
+  BlockingListener* listener;
+  bool is_dispatched_after_close;
+
+  static void run(void* arg) {
+    CloseOnThread* data = static_cast<CloseOnThread*>(arg);
+    data->controller->close();
+    data->is_dispatched_after_close = data->listener->is_dispatched.load();
+  }
+};
+
+TEST_F(AdmissionControllerUnitTest, CloseWaitsForAdmitted) {
+  BlockingListener listener;
+  AdmissionController::Ptr controller(
+        cass::Memory::allocate<AdmissionController>(1, CASS_ADMISSION_MODE_WAIT, 16, &listener));
+
+  RequestHandler::Ptr first(create());
+  RequestHandler::Ptr second(create());
+
+  EXPECT_TRUE(controller->admit(first));
+  EXPECT_FALSE(controller->admit(second));
+
+  // Admit the waiting request on another thread and block its listener
+  uv_thread_t finish_thread;
+  ASSERT_EQ(0, uv_thread_create(&finish_thread, finish_on_thread, &first));
+  uv_sem_wait(&listener.entered);
+
+  // The listener can't be removed while it's still being used
+  CloseOnThread data = { controller.get(), &listener, false };
+  uv_thread_t close_thread;
+  ASSERT_EQ(0, uv_thread_create(&close_thread, CloseOnThread::run, &data));
+  uv_sem_post(&listener.release);
+
+  uv_thread_join(&close_thread);
+  uv_thread_join(&finish_thread);
+  EXPECT_TRUE(data.is_dispatched_after_close);
+
+  finish(second);
+}
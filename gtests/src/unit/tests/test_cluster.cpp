@@ -43,9 +43,10 @@ public:
     const Cluster::Ptr& cluster() const { return cluster_; }
 
     void set_cluster(const Cluster::Ptr& cluster) {
-      ScopedMutex lock(&mutex_);
-      cluster_ = cluster;
-      internal_set(lock);
+      if (claim()) {
+        cluster_ = cluster;
+        internal_set();
+      }
     }
 
   private:
@@ -0,0 +1,100 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "coalesce_controller.hpp"
+
+#define MAX_DELAY_US 200u
+
+using cass::CoalesceController;
+
+static const uint64_t MIN_DELAY_US = CASS_COALESCE_MIN_DELAY_US;
+
+// Simulates windows with a constant arrival rate (in requests per
+// microsecond) until the controller settles.
+static void simulate(CoalesceController* controller, double rate,
+                     uint64_t io_time_us = 0) {
+  for (int i = 0; i < 100; ++i) {
+    uint64_t elapsed_us = controller->delay_us() + io_time_us;
+    int processed = static_cast<int>(rate * elapsed_us + 0.5);
+    controller->record(processed, elapsed_us * 1000, io_time_us * 1000);
+  }
+}
+
+TEST(CoalesceControllerUnitTest, Fixed) {
+  CoalesceController controller(CASS_COALESCE_MODE_FIXED, MAX_DELAY_US);
+  EXPECT_EQ(MAX_DELAY_US, controller.delay_us());
+
+  simulate(&controller, 10.0);
+  EXPECT_EQ(MAX_DELAY_US, controller.delay_us());
+
+  simulate(&controller, 0.0);
+  EXPECT_EQ(MAX_DELAY_US, controller.delay_us());
+}
+
+TEST(CoalesceControllerUnitTest, AdaptiveLatency) {
+  CoalesceController controller(CASS_COALESCE_MODE_ADAPTIVE_LATENCY, MAX_DELAY_US);
+  EXPECT_EQ(MIN_DELAY_US, controller.delay_us());
+
+  // Sparse requests are written as soon as possible
+  simulate(&controller, 0.001);
+  EXPECT_EQ(MIN_DELAY_US, controller.delay_us());
+
+  // A small batch is collected when requests arrive quickly enough
+  simulate(&controller, 0.1);
+  EXPECT_NEAR(40.0, static_cast<double>(controller.delay_us()), 5.0);
+  EXPECT_NEAR(100000.0, controller.arrival_rate(), 10000.0);
+
+  // Very high request rates fill the batch within the minimum delay
+  simulate(&controller, 10.0);
+  EXPECT_EQ(MIN_DELAY_US, controller.delay_us());
+
+  // Back to sparse
+  simulate(&controller, 0.0);
+  EXPECT_EQ(MIN_DELAY_US, controller.delay_us());
+}
+
+TEST(CoalesceControllerUnitTest, AdaptiveThroughput) {
+  CoalesceController controller(CASS_COALESCE_MODE_ADAPTIVE_THROUGHPUT, MAX_DELAY_US);
+  EXPECT_EQ(MAX_DELAY_US, controller.delay_us());
+
+  // Wait as long as possible when the batch can't be filled
+  simulate(&controller, 0.01);
+  EXPECT_EQ(MAX_DELAY_US, controller.delay_us());
+
+  simulate(&controller, 0.5);
+  EXPECT_NEAR(128.0, static_cast<double>(controller.delay_us()), 10.0);
+
+  simulate(&controller, 10.0);
+  EXPECT_EQ(MIN_DELAY_US, controller.delay_us());
+}
+
+TEST(CoalesceControllerUnitTest, IoTime) {
+  CoalesceController controller(CASS_COALESCE_MODE_ADAPTIVE_THROUGHPUT, MAX_DELAY_US);
+
+  // Time spent handling I/O counts towards the window
+  simulate(&controller, 0.5, 50);
+  EXPECT_NEAR(78.0, static_cast<double>(controller.delay_us()), 10.0);
+}
+
+TEST(CoalesceControllerUnitTest, MaxDelayLessThanMin) {
+  CoalesceController controller(CASS_COALESCE_MODE_ADAPTIVE_LATENCY, 5);
+  EXPECT_EQ(5u, controller.delay_us());
+
+  simulate(&controller, 10.0);
+  EXPECT_EQ(5u, controller.delay_us());
+}
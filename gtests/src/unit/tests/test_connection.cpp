@@ -20,13 +20,21 @@
 #include "connector.hpp"
 #include "delayed_connector.hpp"
 #include "constants.hpp"
+#include "query_request.hpp"
 #include "request_callback.hpp"
+#include "response.hpp"
+#include "result_response.hpp"
+#include "serialization.hpp"
 #include "ssl.hpp"
 
 #ifdef WIN32
 #undef STATUS_TIMEOUT
 #endif
 
+#define BENCHMARK_NUM_REQUESTS 200000
+#define BENCHMARK_NUM_VALUES 10
+#define BENCHMARK_BATCH_SIZE 128
+
 using namespace cass;
 
 class ConnectionUnitTest : public LoopTest {
@@ -114,6 +122,44 @@ public:
   }
 };
 
+class StreamingRowsHandler : public ResponseMessage::RowsHandler {
+public:
+  StreamingRowsHandler()
+    : calls(0)
+    , row_count(0) { }
+
+  virtual bool on_rows_start(int16_t stream) { return true; }
+
+  virtual void on_rows(int16_t stream, ResultResponse* rows) {
+    ++calls;
+    row_count += rows->row_count();
+    CassIterator* iterator = cass_iterator_from_result(CassResult::to(rows));
+    while (cass_iterator_next(iterator)) {
+      const char* value;
+      size_t value_length;
+      const CassRow* row = cass_iterator_get_row(iterator);
+      if (cass_value_get_string(cass_row_get_column(row, 0),
+                                &value, &value_length) == CASS_OK) {
+        values.append(value, value_length);
+      }
+    }
+    cass_iterator_free(iterator);
+  }
+
+  int calls;
+  int row_count;
+  String values;
+};
+
+static String encode_frame(int16_t stream, const String& body) {
+  // Header (v4): version, flags, stream, opcode and length
+  char header[9] = { '\x84', 0x00 };
+  encode_int16(header + 2, stream);
+  header[4] = CQL_OPCODE_RESULT;
+  encode_int32(header + 5, static_cast<int32_t>(body.size()));
+  return String(header, sizeof(header)) + body;
+}
+
 
 TEST_F(ConnectionUnitTest, Simple) {
   mockssandra::SimpleCluster cluster(simple());
@@ -177,6 +223,137 @@ TEST_F(ConnectionUnitTest, Auth) {
   EXPECT_EQ(state.status, STATUS_SUCCESS);
 }
 
+TEST_F(ConnectionUnitTest, ZeroCopyResponses) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  State state;
+  Connector::Ptr connector(Memory::allocate<Connector>(Address("127.0.0.1", PORT),
+                                                       PROTOCOL_VERSION,
+                                                       bind_callback(on_connection_connected, &state)));
+
+  ConnectionSettings settings;
+  settings.zero_copy_responses = true;
+
+  connector
+      ->with_settings(settings)
+      ->connect(loop());
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(state.status, STATUS_SUCCESS);
+}
+
+TEST_F(ConnectionUnitTest, ZeroCopyResponseDecode) {
+  // Header (v4): version, flags, stream, opcode and length followed by a
+  // READY response (empty body) and a partial RESULT response.
+  const char frames[] = {
+    '\x84', 0x00, 0x00, 0x01, CQL_OPCODE_READY, 0x00, 0x00, 0x00, 0x00,
+    '\x84', 0x00, 0x00, 0x02, CQL_OPCODE_RESULT, 0x00, 0x00, 0x00, 0x04,
+    0x00, 0x00
+  };
+  const char remaining[] = { 0x00, 0x01 }; // CASS_RESULT_KIND_VOID
+
+  RefBuffer::Ptr buffer(RefBuffer::create(sizeof(frames)));
+  memcpy(buffer->data(), frames, sizeof(frames));
+
+  { // The entire frame is contiguous in the buffer so it's sliced
+    ResponseMessage response;
+    ssize_t consumed = response.decode(buffer->data(), sizeof(frames), buffer);
+    ASSERT_EQ(consumed, 9);
+    ASSERT_TRUE(response.is_body_ready());
+    EXPECT_EQ(response.response_body()->buffer(), buffer);
+    EXPECT_EQ(response.response_body()->data(), buffer->data() + 9);
+  }
+
+  { // The frame straddles two reads so it's copied
+    ResponseMessage response;
+    ssize_t consumed = response.decode(buffer->data() + 9, sizeof(frames) - 9, buffer);
+    ASSERT_EQ(consumed, static_cast<ssize_t>(sizeof(frames) - 9));
+    ASSERT_FALSE(response.is_body_ready());
+    consumed = response.decode(remaining, sizeof(remaining));
+    ASSERT_EQ(consumed, static_cast<ssize_t>(sizeof(remaining)));
+    ASSERT_TRUE(response.is_body_ready());
+    EXPECT_FALSE(response.response_body()->buffer() == buffer);
+    EXPECT_EQ(response.response_body()->opcode(), CQL_OPCODE_RESULT);
+  }
+}
+
+TEST_F(ConnectionUnitTest, StreamRowsDecode) {
+  mockssandra::TextRowsResult result(3, 4);
+  String frame(encode_frame(1, result.body));
+
+  { // Each row is delivered as soon as it's received
+    StreamingRowsHandler handler;
+    ResponseMessage response(NULL, &handler);
+    for (size_t i = 0; i < frame.size(); ++i) {
+      ASSERT_EQ(response.decode(&frame[i], 1), 1);
+    }
+    ASSERT_TRUE(response.is_body_ready());
+    EXPECT_EQ(handler.calls, 3);
+    EXPECT_EQ(handler.row_count, 3);
+    EXPECT_EQ(handler.values, "xxxxxxxxxxxx");
+
+    // The result only has the metadata
+    const ResultResponse* body = static_cast<const ResultResponse*>(response.response_body().get());
+    EXPECT_EQ(body->kind(), CASS_RESULT_KIND_ROWS);
+    EXPECT_EQ(body->row_count(), 0);
+    EXPECT_EQ(body->column_count(), 1);
+    EXPECT_EQ(body->keyspace().to_string(), "keyspace");
+  }
+
+  { // A whole frame followed by the start of another
+    StreamingRowsHandler handler;
+    ResponseMessage response(NULL, &handler);
+    String input(frame + frame.substr(0, 16));
+    ASSERT_EQ(response.decode(input.data(), 20), 20);
+    ASSERT_EQ(response.decode(input.data() + 20, input.size() - 20),
+              static_cast<ssize_t>(frame.size() - 20));
+    ASSERT_TRUE(response.is_body_ready());
+    EXPECT_EQ(handler.calls, 1);
+    EXPECT_EQ(handler.row_count, 3);
+  }
+
+  { // Results that aren't rows are decoded as a whole
+    StreamingRowsHandler handler;
+    ResponseMessage response(NULL, &handler);
+    String frame(encode_frame(1, String("\x00\x00\x00\x01", 4))); // CASS_RESULT_KIND_VOID
+    for (size_t i = 0; i < frame.size(); ++i) {
+      ASSERT_EQ(response.decode(&frame[i], 1), 1);
+    }
+    ASSERT_TRUE(response.is_body_ready());
+    EXPECT_EQ(handler.calls, 0);
+    const ResultResponse* body = static_cast<const ResultResponse*>(response.response_body().get());
+    EXPECT_EQ(body->kind(), CASS_RESULT_KIND_VOID);
+  }
+}
+
+TEST_F(ConnectionUnitTest, Compression) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  State state;
+  Connector::Ptr connector(Memory::allocate<Connector>(Address("127.0.0.1", PORT),
+                                                       PROTOCOL_VERSION,
+                                                       bind_callback(on_connection_connected, &state)));
+
+  ConnectionSettings settings;
+  settings.compression = CASS_COMPRESSION_AUTO;
+  settings.compression_threshold = 0; // Compress every request
+
+  connector
+      ->with_settings(settings)
+      ->connect(loop());
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  // Falls back to uncompressed frames when no algorithm is compiled in
+  EXPECT_EQ(state.status, STATUS_SUCCESS);
+  ASSERT_TRUE(static_cast<bool>(state.connection));
+  EXPECT_EQ(static_cast<bool>(state.connection->compressor()),
+            !Compressor::supported_names().empty());
+}
+
 TEST_F(ConnectionUnitTest, Ssl) {
   mockssandra::SimpleCluster cluster(simple());
   ConnectionSettings settings(use_ssl(&cluster));
@@ -515,3 +692,114 @@ TEST_F(ConnectionUnitTest, DelayedCancel) {
 
   EXPECT_EQ(Connector::CONNECTION_CANCELED, error_code);
 }
+
+class WriteBenchmark {
+public:
+  class Callback : public SimpleRequestCallback {
+  public:
+    Callback(const Request::ConstPtr& request, WriteBenchmark* benchmark)
+      : SimpleRequestCallback(request)
+      , benchmark_(benchmark) { }
+
+    virtual void on_internal_set(ResponseMessage* response) {
+      benchmark_->on_complete();
+    }
+
+    virtual void on_internal_error(CassError code, const String& message) {
+      benchmark_->on_error(message);
+    }
+
+    virtual void on_internal_timeout() {
+      benchmark_->on_error("Timed out");
+    }
+
+  private:
+    WriteBenchmark* benchmark_;
+  };
+
+  WriteBenchmark()
+    : sent_(0)
+    , completed_(0)
+    , start_(0)
+    , elapsed_(0) {
+    QueryRequest::Ptr request(Memory::allocate<QueryRequest>("INSERT INTO blah (k, v1, v2, v3, v4, v5, v6, v7, v8, v9) "
+                                                             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                                                             BENCHMARK_NUM_VALUES));
+    for (size_t i = 0; i < BENCHMARK_NUM_VALUES; ++i) {
+      request->set(i, static_cast<cass_int32_t>(i));
+    }
+    request_ = Request::ConstPtr(request);
+  }
+
+  static void on_connected(Connector* connector, WriteBenchmark* benchmark) {
+    ASSERT_TRUE(connector->is_ok());
+    benchmark->connection_ = connector->release_connection();
+    benchmark->start_ = uv_hrtime();
+    benchmark->send_batch();
+  }
+
+  void send_batch() {
+    for (int i = 0; i < BENCHMARK_BATCH_SIZE && sent_ < BENCHMARK_NUM_REQUESTS; ++i, ++sent_) {
+      connection_->write(RequestCallback::Ptr(Memory::allocate<Callback>(request_, this)));
+    }
+    connection_->flush();
+  }
+
+  void on_complete() {
+    if (++completed_ == BENCHMARK_NUM_REQUESTS) {
+      elapsed_ = uv_hrtime() - start_;
+      flush_stats_ = connection_->flush_stats();
+      connection_->close();
+    } else if (completed_ == sent_) {
+      send_batch();
+    }
+  }
+
+  void on_error(const String& message) {
+    error_ = message;
+    connection_->close();
+  }
+
+  void print() const {
+    printf("%d requests with %d values, %d requests per flush\n",
+           BENCHMARK_NUM_REQUESTS, BENCHMARK_NUM_VALUES, BENCHMARK_BATCH_SIZE);
+    printf("%10.0f requests/s\n",
+           BENCHMARK_NUM_REQUESTS / (static_cast<double>(elapsed_) / 1e9));
+    printf("%10.1f bytes/flush\n",
+           static_cast<double>(flush_stats_.bytes) / flush_stats_.count);
+    printf("%10.1f iovecs/flush\n",
+           static_cast<double>(flush_stats_.bufs) / flush_stats_.count);
+  }
+
+  const String& error() const { return error_; }
+
+private:
+  Request::ConstPtr request_;
+  Connection::Ptr connection_;
+  int sent_;
+  int completed_;
+  uint64_t start_;
+  uint64_t elapsed_;
+  Socket::FlushStats flush_stats_;
+  String error_;
+};
+
+// Measures the write path against mockssandra using pipelined requests with
+// many bound values. Run using:
+// --gtest_also_run_disabled_tests --gtest_filter=*Connection*Benchmark*
+TEST_F(ConnectionUnitTest, DISABLED_BenchmarkWrite) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  WriteBenchmark benchmark;
+  Connector::Ptr connector(Memory::allocate<Connector>(Address("127.0.0.1", PORT),
+                                                       PROTOCOL_VERSION,
+                                                       bind_callback(WriteBenchmark::on_connected, &benchmark)));
+
+  connector->connect(loop());
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  ASSERT_TRUE(benchmark.error().empty()) << benchmark.error();
+  benchmark.print();
+}
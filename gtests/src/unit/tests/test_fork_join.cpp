@@ -0,0 +1,90 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "fork_join.hpp"
+#include "vector.hpp"
+
+#include <uv.h>
+
+using namespace cass;
+
+namespace {
+
+void count_task(void* data, size_t index) {
+  (*static_cast<Vector<int>*>(data))[index]++;
+}
+
+void verify_run(size_t num_tasks, size_t num_threads) {
+  Vector<int> counts(num_tasks);
+  ForkJoin::run(num_tasks, num_threads, count_task, &counts);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    EXPECT_EQ(counts[i], 1) << "Task " << i << " with " << num_threads << " threads";
+  }
+}
+
+} // namespace
+
+TEST(ForkJoinUnitTest, NumThreads) {
+  EXPECT_GE(ForkJoin::num_threads(), 1u);
+}
+
+TEST(ForkJoinUnitTest, RunEachTaskOnce) {
+  verify_run(0, 4);
+  verify_run(1, 4);
+  verify_run(100, 1);
+  verify_run(100, 4);
+  verify_run(3, 8); // More threads than tasks
+}
+
+TEST(ForkJoinUnitTest, ReuseWorkers) {
+  // The workers are kept between batches while the pool has a user
+  ForkJoin::acquire();
+  for (int i = 0; i < 100; ++i) {
+    verify_run(64, 4);
+  }
+  ForkJoin::release();
+
+  // The workers are joined, they're created again for the next batch
+  verify_run(64, 4);
+}
+
+namespace {
+
+void run_batches(void* arg) {
+  for (int i = 0; i < 100; ++i) {
+    verify_run(64, 4);
+  }
+}
+
+} // namespace
+
+TEST(ForkJoinUnitTest, ConcurrentBatches) {
+  // Batches that can't use the workers are run on the calling thread
+  uv_thread_t threads[4];
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(0, uv_thread_create(&threads[i], run_batches, NULL));
+  }
+  // Releasing the workers waits for the batch that's using them
+  for (int i = 0; i < 100; ++i) {
+    ForkJoin::acquire();
+    ForkJoin::release();
+  }
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(0, uv_thread_join(&threads[i]));
+  }
+}
@@ -34,6 +34,38 @@ void on_future_callback(CassFuture* future, void* data) {
   *is_future_callback_called = true;
 }
 
+void on_future_callback_wait(CassFuture* future, void* data) {
+  cass_future_wait(future);
+}
+
+struct BlockedCallback {
+  BlockedCallback()
+    : is_finished(false) {
+    uv_sem_init(&entered, 0);
+    uv_sem_init(&release, 0);
+  }
+
+  ~BlockedCallback() {
+    uv_sem_destroy(&entered);
+    uv_sem_destroy(&release);
+  }
+
+  uv_sem_t entered;
+  uv_sem_t release;
+  cass::Atomic<bool> is_finished;
+};
+
+void on_future_callback_blocked(CassFuture* future, void* data) {
+  BlockedCallback* callback = static_cast<BlockedCallback*>(data);
+  uv_sem_post(&callback->entered);
+  uv_sem_wait(&callback->release);
+  callback->is_finished.store(true, cass::MEMORY_ORDER_RELAXED);
+}
+
+void set_future(void* arg) {
+  static_cast<cass::Future*>(arg)->set();
+}
+
 void start_timer(void* arg) {
   cass::Future* future = static_cast<cass::Future*>(arg);
   test::Utils::msleep(DELAY_MS);
@@ -122,3 +154,79 @@ TEST(FutureUnitTest, CallbackAfterFutureIsSet) {
   ASSERT_TRUE(future.set_callback(&on_future_callback, &is_future_callback_called));
   ASSERT_TRUE(is_future_callback_called);
 }
+
+void start_short_timer(void* arg) {
+  cass::Future* future = static_cast<cass::Future*>(arg);
+  test::Utils::msleep(10);
+  future->set();
+}
+
+TEST(FutureUnitTest, WaitForTimeout) {
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  ASSERT_FALSE(future.wait_for(1000)); // 1 millisecond
+  ASSERT_FALSE(future.ready());
+
+  future.set();
+  ASSERT_TRUE(future.wait_for(1000));
+}
+
+TEST(FutureUnitTest, SetOnlyOnce) {
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  ASSERT_TRUE(future.set_error(CASS_ERROR_LIB_BAD_PARAMS, "First"));
+  ASSERT_FALSE(future.set_error(CASS_ERROR_LIB_REQUEST_TIMED_OUT, "Second"));
+  future.set(); // Ignored
+  ASSERT_TRUE(future.error());
+  ASSERT_EQ(CASS_ERROR_LIB_BAD_PARAMS, future.error()->code);
+}
+
+TEST(FutureUnitTest, SpinWait) {
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  future.set_wait_spin_time_us(1000 * 1000); // Spin for long enough to not block
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, start_short_timer, &future));
+
+  future.wait();
+  ASSERT_TRUE(future.ready());
+
+  ASSERT_EQ(0, uv_thread_join(&thread));
+}
+
+TEST(FutureUnitTest, SpinWaitThenBlock) {
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  future.set_wait_spin_time_us(100); // Spins for less time than the set takes
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, start_short_timer, &future));
+
+  ASSERT_TRUE(future.wait_for(1000 * 1000)); // 1 second
+  ASSERT_TRUE(future.ready());
+
+  ASSERT_EQ(0, uv_thread_join(&thread));
+}
+
+TEST(FutureUnitTest, WaitInCallback) {
+  // Waiting on a future in its own callback (e.g. getting the result) must
+  // not block
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  ASSERT_TRUE(future.set_callback(&on_future_callback_wait, NULL));
+  future.set();
+  ASSERT_TRUE(future.ready());
+}
+
+TEST(FutureUnitTest, WaitSeesCallbackSideEffects) {
+  // Other threads don't see the future as set until the callback has finished
+  BlockedCallback callback;
+  cass::Future future(cass::Future::FUTURE_TYPE_GENERIC);
+  ASSERT_TRUE(future.set_callback(&on_future_callback_blocked, &callback));
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, set_future, &future));
+
+  uv_sem_wait(&callback.entered);
+  EXPECT_FALSE(future.ready());
+  EXPECT_FALSE(future.wait_for(1000)); // 1 millisecond
+  uv_sem_post(&callback.release);
+
+  future.wait();
+  EXPECT_TRUE(callback.is_finished.load(cass::MEMORY_ORDER_RELAXED));
+
+  ASSERT_EQ(0, uv_thread_join(&thread));
+}
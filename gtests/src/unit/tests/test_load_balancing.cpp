@@ -438,6 +438,39 @@ TEST(DatacenterAwareLoadBalancingUnitTest, RemoteRemovedReturned) {
   }
 }
 
+TEST(DatacenterAwareLoadBalancingUnitTest, QueryPlanUsesSnapshot) {
+  cass::HostMap hosts;
+  populate_hosts(2, "rack", LOCAL_DC, &hosts);
+
+  cass::DCAwarePolicy policy(LOCAL_DC, 1, false);
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts, NULL);
+
+  cass::ScopedPtr<cass::QueryPlan> qp_before(policy.new_query_plan("ks", NULL, NULL));
+
+  // Hosts added after a plan is created are only used by newer plans
+  cass::Host::Ptr local_host(host_for_addr(addr_for_sequence(3), "rack", LOCAL_DC));
+  cass::Host::Ptr remote_host(host_for_addr(addr_for_sequence(4), "rack", REMOTE_DC));
+  policy.on_host_up(local_host);
+  policy.on_host_up(remote_host);
+
+  cass::ScopedPtr<cass::QueryPlan> qp_after(policy.new_query_plan("ks", NULL, NULL));
+
+  {
+    const size_t seq[] = {1, 2};
+    verify_sequence(qp_before.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  {
+    const size_t seq[] = {2, 3, 1, 4};
+    verify_sequence(qp_after.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  EXPECT_EQ(CASS_HOST_DISTANCE_REMOTE, policy.distance(remote_host));
+  policy.on_host_removed(remote_host);
+  EXPECT_EQ(CASS_HOST_DISTANCE_IGNORE, policy.distance(remote_host));
+  EXPECT_FALSE(policy.is_host_up(remote_host->address()));
+}
+
 TEST(DatacenterAwareLoadBalancingUnitTest, UsedHostsPerDatacenter) {
   cass::HostMap hosts;
   populate_hosts(3, "rack", LOCAL_DC, &hosts);
@@ -709,6 +742,63 @@ TEST(TokenAwareLoadBalancingUnitTest, Simple) {
   }
 }
 
+TEST(TokenAwareLoadBalancingUnitTest, EmplaceQueryPlan) {
+  const int64_t num_hosts = 4;
+  cass::HostMap hosts;
+  cass::TokenMap::Ptr token_map(cass::TokenMap::from_partitioner(cass::Murmur3Partitioner::name()));
+
+  const uint64_t partition_size = CASS_UINT64_MAX / num_hosts;
+  cass::Murmur3Partitioner::Token token = CASS_INT64_MIN + partition_size;
+
+  for (size_t i = 1; i <= num_hosts; ++i) {
+    cass::Host::Ptr host(create_host(addr_for_sequence(i),
+                                     single_token(token),
+                                     cass::Murmur3Partitioner::name().to_string(),
+                                     "rack1",
+                                     LOCAL_DC));
+
+    hosts[host->address()] = host;
+    token_map->add_host(host);
+    token += partition_size;
+  }
+
+  add_keyspace_simple("test", 3, token_map.get());
+  token_map->build();
+
+  // A DC-aware child policy uses a single plan with the child plan embedded
+  cass::TokenAwarePolicy policy(cass::Memory::allocate<cass::DCAwarePolicy>(LOCAL_DC, 0, false), false);
+  policy.init(cass::SharedRefPtr<cass::Host>(), hosts, NULL);
+
+  cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("", 1));
+  const char* value = "kjdfjkldsdjkl"; // hash: 9024137376112061887
+  request->set(0, cass::CassString(value, strlen(value)));
+  request->add_key_index(0);
+  cass::SharedRefPtr<cass::RequestHandler> request_handler(
+      cass::Memory::allocate<cass::RequestHandler>(request, cass::ResponseFuture::Ptr()));
+
+  cass::QueryPlanStorage storage;
+
+  storage.reset(policy.emplace_query_plan(&storage, "test", request_handler.get(), token_map.get()));
+  {
+    const size_t seq[] = { 4, 1, 2, 3 };
+    verify_sequence(storage.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  // Replacing the plan reuses the storage
+  storage.reset(policy.emplace_query_plan(&storage, "test", request_handler.get(), token_map.get()));
+  {
+    const size_t seq[] = { 4, 1, 2, 3 };
+    verify_sequence(storage.get(), VECTOR_FROM(size_t, seq));
+  }
+
+  // Plans without replicas come from the child policy
+  storage.reset(policy.emplace_query_plan(&storage, "", request_handler.get(), token_map.get()));
+  {
+    const size_t seq[] = { 3, 4, 1, 2 };
+    verify_sequence(storage.get(), VECTOR_FROM(size_t, seq));
+  }
+}
+
 TEST(TokenAwareLoadBalancingUnitTest, NetworkTopology) {
   const size_t num_hosts = 7;
   cass::HostMap hosts;
@@ -537,6 +537,44 @@ TEST_F(PoolUnitTest, AddRemove) {
   EXPECT_EQ(add_remove_listener_status.count(ListenerStatus::UP), 3u) << add_remove_listener_status.results();
 }
 
+TEST_F(PoolUnitTest, AddWhileRemoving) {
+  mockssandra::SimpleCluster cluster(simple(), NUM_NODES);
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  ListenerStatus listener_status(loop());
+  ListenerStatus add_remove_listener_status(loop(), 2);
+  ScopedPtr<Listener> listener(Memory::allocate<Listener>(&listener_status));
+
+  RequestStatusWithManager request_status(loop(), 0);
+
+  ConnectionPoolManagerInitializer::Ptr initializer(
+        Memory::allocate<ConnectionPoolManagerInitializer>(
+          PROTOCOL_VERSION,
+          bind_callback(on_pool_nop, &request_status)));
+
+  AddressVec addresses = this->addresses();
+
+  initializer
+      ->with_listener(listener.get())
+      ->initialize(loop(), addresses);
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(listener_status.count(ListenerStatus::UP), NUM_NODES) << listener_status.results();
+
+  ConnectionPoolManager::Ptr manager = request_status.manager();
+  ASSERT_TRUE(manager);
+
+  // Add the node back before its pool has finished closing
+  listener->reset(&add_remove_listener_status);
+  manager->remove(addresses[0]);
+  manager->add(addresses[0]);
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(add_remove_listener_status.count(ListenerStatus::DOWN), 1u) << add_remove_listener_status.results();
+  EXPECT_EQ(add_remove_listener_status.count(ListenerStatus::UP), 1u) << add_remove_listener_status.results();
+  run_request(manager, addresses[0]);
+}
+
 TEST_F(PoolUnitTest, Reconnect) {
   mockssandra::SimpleCluster cluster(simple(), NUM_NODES);
   ASSERT_EQ(cluster.start_all(), 0);
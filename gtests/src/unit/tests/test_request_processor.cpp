@@ -73,9 +73,10 @@ public:
     const RequestProcessor::Ptr& processor() const { return processor_; }
 
     void set_processor(const RequestProcessor::Ptr& processor) {
-      ScopedMutex lock(&mutex_);
-      processor_ = processor;
-      internal_set(lock);
+      if (claim()) {
+        processor_ = processor;
+        internal_set();
+      }
     }
 
   private:
@@ -0,0 +1,287 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "query_request.hpp"
+#include "ref_counted.hpp"
+#include "request_processor_selector.hpp"
+
+#include <stdio.h>
+
+#define BENCHMARK_NUM_PROCESSORS 16
+#define BENCHMARK_NUM_THREADS 32
+#define BENCHMARK_NUM_SELECTIONS 1000000
+
+using cass::Atomic;
+using cass::QueryRequest;
+using cass::RefCounted;
+using cass::RequestProcessorSelector;
+using cass::SharedRefPtr;
+using cass::Vector;
+
+// Stands in for a request processor. Only the request count is used by the
+// selector and each count is on its own cache line like the real thing.
+class MockProcessor : public RefCounted<MockProcessor> {
+public:
+  typedef SharedRefPtr<MockProcessor> Ptr;
+  typedef Vector<Ptr> Vec;
+
+  MockProcessor(int request_count = 0)
+    : request_count_(request_count) { }
+
+  int request_count() const { return request_count_.load(cass::MEMORY_ORDER_RELAXED); }
+
+  void inc() { request_count_.fetch_add(1); }
+  void dec() { request_count_.fetch_sub(1); }
+
+private:
+  char pad_before__[64];
+  Atomic<int> request_count_;
+  char pad_after__[64];
+  void no_unused_private_warning__() { pad_before__[0] = pad_after__[0] = 0; }
+};
+
+static MockProcessor::Vec create_processors(const int* request_counts, size_t count) {
+  MockProcessor::Vec processors;
+  for (size_t i = 0; i < count; ++i) {
+    processors.push_back(MockProcessor::Ptr(cass::Memory::allocate<MockProcessor>(request_counts[i])));
+  }
+  return processors;
+}
+
+static size_t index_of(const MockProcessor::Vec& processors,
+                       const MockProcessor::Ptr& processor) {
+  for (size_t i = 0; i < processors.size(); ++i) {
+    if (processors[i] == processor) return i;
+  }
+  return processors.size();
+}
+
+struct SelectOnThread {
+  SelectOnThread(const RequestProcessorSelector* selector,
+                 const MockProcessor::Vec* processors)
+    : selector(selector)
+    , processors(processors)
+    , index(0) { }
+
+  static void run(void* arg) {
+    SelectOnThread* data = static_cast<SelectOnThread*>(arg);
+    data->index = index_of(*data->processors,
+                           data->selector->select(*data->processors, NULL));
+  }
+
+  const RequestProcessorSelector* selector;
+  const MockProcessor::Vec* processors;
+  size_t index;
+};
+
+TEST(RequestProcessorSelectorUnitTest, LeastBusy) {
+  const int counts[] = { 3, 1, 4, 1, 5 };
+  MockProcessor::Vec processors(create_processors(counts, 5));
+
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_LEAST_BUSY);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(1u, index_of(processors, selector.select(processors, NULL)));
+  }
+}
+
+TEST(RequestProcessorSelectorUnitTest, PowerOfTwoChoices) {
+  const int counts[] = { 0, 5, 10 };
+  MockProcessor::Vec processors(create_processors(counts, 3));
+
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES);
+  size_t selected[3] = { 0, 0, 0 };
+  for (int i = 0; i < 1000; ++i) {
+    selected[index_of(processors, selector.select(processors, NULL))]++;
+  }
+
+  // The two choices are always distinct so the busiest is never selected
+  EXPECT_GT(selected[0], 0u);
+  EXPECT_GT(selected[1], 0u);
+  EXPECT_EQ(0u, selected[2]);
+}
+
+TEST(RequestProcessorSelectorUnitTest, ThreadAffinity) {
+  const int counts[] = { 0, 0, 0, 0 };
+  MockProcessor::Vec processors(create_processors(counts, 4));
+
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_THREAD_AFFINITY);
+  size_t index = index_of(processors, selector.select(processors, NULL));
+  for (int i = 0; i < 10; ++i) {
+    processors[index]->inc(); // Load doesn't change the selection
+    EXPECT_EQ(index, index_of(processors, selector.select(processors, NULL)));
+  }
+
+  SelectOnThread data(&selector, &processors);
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, SelectOnThread::run, &data));
+  uv_thread_join(&thread);
+  EXPECT_NE(index, data.index);
+}
+
+TEST(RequestProcessorSelectorUnitTest, TokenAffinity) {
+  const int counts[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  MockProcessor::Vec processors(create_processors(counts, 8));
+
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_TOKEN_AFFINITY);
+
+  size_t selected[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  for (cass_int32_t key = 0; key < 100; ++key) {
+    QueryRequest::Ptr request(cass::Memory::allocate<QueryRequest>("", 1));
+    request->set(0, key);
+    request->add_key_index(0);
+
+    size_t index = index_of(processors, selector.select(processors, request.get()));
+    selected[index]++;
+
+    // The same partition is always sent to the same processor
+    for (int i = 0; i < 3; ++i) {
+      processors[i]->inc();
+      EXPECT_EQ(index, index_of(processors, selector.select(processors, request.get())));
+    }
+  }
+
+  // Partitions are spread across the processors
+  size_t used = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    if (selected[i] > 0) used++;
+  }
+  EXPECT_GT(used, 4u);
+}
+
+TEST(RequestProcessorSelectorUnitTest, TokenAffinityNoRoutingKey) {
+  const int counts[] = { 0, 10 };
+  MockProcessor::Vec processors(create_processors(counts, 2));
+
+  // Falls back to power of two choices
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_TOKEN_AFFINITY);
+  QueryRequest::Ptr request(cass::Memory::allocate<QueryRequest>("SELECT * FROM blah", 0));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(0u, index_of(processors, selector.select(processors, request.get())));
+  }
+}
+
+struct SelectOnCpu {
+  SelectOnCpu(const RequestProcessorSelector* selector,
+              const MockProcessor::Vec* processors)
+    : selector(selector)
+    , processors(processors)
+    , is_pinned(false)
+    , index(0) { }
+
+  static void run(void* arg) {
+    SelectOnCpu* data = static_cast<SelectOnCpu*>(arg);
+    data->is_pinned = cass::set_thread_affinity(0);
+    data->index = index_of(*data->processors,
+                           data->selector->select(*data->processors, NULL));
+  }
+
+  const RequestProcessorSelector* selector;
+  const MockProcessor::Vec* processors;
+  bool is_pinned;
+  size_t index;
+};
+
+TEST(RequestProcessorSelectorUnitTest, CpuAffinity) {
+  const int counts[] = { 0, 0, 10 };
+  MockProcessor::Vec processors(create_processors(counts, 3));
+
+  RequestProcessorSelector selector(CASS_REQUEST_DISPATCH_CPU_AFFINITY);
+
+  { // The processor on the thread's CPU is used even though it's the busiest
+    Vector<int> cpus;
+    cpus.push_back(-1);
+    cpus.push_back(-1);
+    cpus.push_back(0);
+    selector.set_processor_cpus(cpus);
+
+    SelectOnCpu data(&selector, &processors);
+    uv_thread_t thread;
+    ASSERT_EQ(0, uv_thread_create(&thread, SelectOnCpu::run, &data));
+    uv_thread_join(&thread);
+    if (!data.is_pinned) return; // Not supported on this platform
+    EXPECT_EQ(2u, data.index);
+  }
+
+  { // Falls back to power of two choices if there's no processor on the CPU
+    Vector<int> cpus;
+    cpus.push_back(-1);
+    cpus.push_back(-1);
+    cpus.push_back(1);
+    selector.set_processor_cpus(cpus);
+
+    SelectOnCpu data(&selector, &processors);
+    uv_thread_t thread;
+    ASSERT_EQ(0, uv_thread_create(&thread, SelectOnCpu::run, &data));
+    uv_thread_join(&thread);
+    EXPECT_NE(2u, data.index);
+  }
+}
+
+struct BenchmarkThread {
+  BenchmarkThread(const RequestProcessorSelector* selector,
+                  const MockProcessor::Vec* processors)
+    : selector(selector)
+    , processors(processors) { }
+
+  static void run(void* arg) {
+    BenchmarkThread* data = static_cast<BenchmarkThread*>(arg);
+    for (int i = 0; i < BENCHMARK_NUM_SELECTIONS; ++i) {
+      // Simulate the processor accounting for the request
+      const MockProcessor::Ptr& processor = data->selector->select(*data->processors, NULL);
+      processor->inc();
+      processor->dec();
+    }
+  }
+
+  const RequestProcessorSelector* selector;
+  const MockProcessor::Vec* processors;
+};
+
+static void benchmark(CassRequestDispatch dispatch, const char* name) {
+  int counts[BENCHMARK_NUM_PROCESSORS] = { 0 };
+  MockProcessor::Vec processors(create_processors(counts, BENCHMARK_NUM_PROCESSORS));
+  RequestProcessorSelector selector(dispatch);
+
+  Vector<BenchmarkThread> data(BENCHMARK_NUM_THREADS, BenchmarkThread(&selector, &processors));
+  uv_thread_t threads[BENCHMARK_NUM_THREADS];
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < BENCHMARK_NUM_THREADS; ++i) {
+    ASSERT_EQ(0, uv_thread_create(&threads[i], BenchmarkThread::run, &data[i]));
+  }
+  for (int i = 0; i < BENCHMARK_NUM_THREADS; ++i) {
+    uv_thread_join(&threads[i]);
+  }
+  uint64_t elapsed = uv_hrtime() - start;
+
+  const double total = static_cast<double>(BENCHMARK_NUM_THREADS) * BENCHMARK_NUM_SELECTIONS;
+  printf("%-24s %8.2f ns/request %8.2f Mrequests/s\n", name,
+         static_cast<double>(elapsed) * BENCHMARK_NUM_THREADS / total,
+         total / (static_cast<double>(elapsed) / 1000.0));
+}
+
+// Compares the dispatch strategies with many application threads selecting
+// from many processors concurrently. Run using:
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(RequestProcessorSelectorUnitTest, DISABLED_Benchmark) {
+  printf("%d threads, %d processors, %d requests per thread\n",
+         BENCHMARK_NUM_THREADS, BENCHMARK_NUM_PROCESSORS, BENCHMARK_NUM_SELECTIONS);
+  benchmark(CASS_REQUEST_DISPATCH_LEAST_BUSY, "least busy");
+  benchmark(CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES, "power of two choices");
+  benchmark(CASS_REQUEST_DISPATCH_THREAD_AFFINITY, "thread affinity");
+}
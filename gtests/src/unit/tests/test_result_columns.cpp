@@ -0,0 +1,358 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "constants.hpp"
+#include "result_columns.hpp"
+#include "result_response.hpp"
+#include "serialization.hpp"
+
+#include <string.h>
+
+using cass::ResultResponse;
+
+class ResultColumnsUnitTest : public testing::Test {
+public:
+  ResultColumnsUnitTest() {
+    encode_int32(CASS_RESULT_KIND_ROWS);
+    encode_int32(CASS_RESULT_FLAG_GLOBAL_TABLESPEC);
+    encode_int32(4); // Column count
+    encode_string("keyspace");
+    encode_string("table");
+    encode_column("i", CASS_VALUE_TYPE_INT);
+    encode_column("b", CASS_VALUE_TYPE_BIGINT);
+    encode_column("d", CASS_VALUE_TYPE_DOUBLE);
+    encode_column("t", CASS_VALUE_TYPE_VARCHAR);
+  }
+
+  void encode_int32(int32_t value) {
+    char buf[sizeof(int32_t)];
+    cass::encode_int32(buf, value);
+    body.append(buf, sizeof(buf));
+  }
+
+  void encode_string(const cass::String& value) {
+    char buf[sizeof(uint16_t)];
+    cass::encode_uint16(buf, static_cast<uint16_t>(value.size()));
+    body.append(buf, sizeof(buf));
+    body.append(value);
+  }
+
+  void encode_column(const cass::String& name, CassValueType type) {
+    encode_string(name);
+    char buf[sizeof(uint16_t)];
+    cass::encode_uint16(buf, static_cast<uint16_t>(type));
+    body.append(buf, sizeof(buf));
+  }
+
+  void encode_null() {
+    encode_int32(-1);
+  }
+
+  void encode_int32_value(int32_t value) {
+    encode_int32(sizeof(int32_t));
+    encode_int32(value);
+  }
+
+  void encode_int64_value(int64_t value) {
+    char buf[sizeof(int64_t)];
+    cass::encode_int64(buf, value);
+    encode_int32(sizeof(int64_t));
+    body.append(buf, sizeof(buf));
+  }
+
+  void encode_double_value(double value) {
+    char buf[sizeof(double)];
+    cass::encode_double(buf, value);
+    encode_int32(sizeof(double));
+    body.append(buf, sizeof(buf));
+  }
+
+  void encode_text_value(const cass::String& value) {
+    encode_int32(static_cast<int32_t>(value.size()));
+    body.append(value);
+  }
+
+  ResultResponse::Ptr decode() {
+    ResultResponse::Ptr result(cass::Memory::allocate<ResultResponse>());
+    result->set_buffer(body.size());
+    memcpy(result->data(), body.data(), body.size());
+    cass::Decoder decoder(result->data(), body.size(),
+                          cass::ProtocolVersion(CASS_PROTOCOL_VERSION_V4));
+    if (!result->decode(decoder)) return ResultResponse::Ptr();
+    return result;
+  }
+
+  cass::String body;
+};
+
+TEST_F(ResultColumnsUnitTest, Decode) {
+  encode_int32(3); // Row count
+
+  encode_int32_value(1);
+  encode_int64_value(10);
+  encode_double_value(1.5);
+  encode_text_value("a");
+
+  encode_null();
+  encode_int64_value(-20);
+  encode_null();
+  encode_text_value("bc");
+
+  encode_int32_value(3);
+  encode_null();
+  encode_double_value(3.5);
+  encode_null();
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+
+  CassResultColumns* columns = cass_result_columns_new(CassResult::to(result.get()));
+  ASSERT_TRUE(columns != NULL);
+  result.reset(); // The columns keep the result alive
+
+  EXPECT_EQ(3u, cass_result_columns_row_count(columns));
+  ASSERT_EQ(4u, cass_result_columns_column_count(columns));
+  EXPECT_EQ(CASS_VALUE_TYPE_INT, cass_result_columns_type(columns, 0));
+  EXPECT_EQ(CASS_VALUE_TYPE_VARCHAR, cass_result_columns_type(columns, 3));
+  EXPECT_EQ(CASS_VALUE_TYPE_UNKNOWN, cass_result_columns_type(columns, 4));
+
+  const cass_int32_t* ints = cass_result_columns_int32(columns, 0);
+  ASSERT_TRUE(ints != NULL);
+  EXPECT_EQ(1, ints[0]);
+  EXPECT_EQ(0, ints[1]);
+  EXPECT_EQ(3, ints[2]);
+  EXPECT_EQ(0x02, cass_result_columns_null_bitmap(columns, 0)[0]);
+
+  const cass_int64_t* bigints = cass_result_columns_int64(columns, 1);
+  ASSERT_TRUE(bigints != NULL);
+  EXPECT_EQ(10, bigints[0]);
+  EXPECT_EQ(-20, bigints[1]);
+  EXPECT_EQ(0x04, cass_result_columns_null_bitmap(columns, 1)[0]);
+
+  const cass_double_t* doubles = cass_result_columns_double(columns, 2);
+  ASSERT_TRUE(doubles != NULL);
+  EXPECT_EQ(1.5, doubles[0]);
+  EXPECT_EQ(3.5, doubles[2]);
+  EXPECT_EQ(0x02, cass_result_columns_null_bitmap(columns, 2)[0]);
+
+  // Packed values are only available for the matching types
+  EXPECT_TRUE(cass_result_columns_int64(columns, 0) == NULL);
+  EXPECT_TRUE(cass_result_columns_int32(columns, 3) == NULL);
+
+  const cass_byte_t* data;
+  const cass_uint32_t* offsets;
+  const cass_int32_t* lengths;
+  ASSERT_EQ(CASS_OK, cass_result_columns_bytes(columns, 3, &data, &offsets, &lengths));
+  EXPECT_EQ(cass::String("a"),
+            cass::String(reinterpret_cast<const char*>(data + offsets[0]), lengths[0]));
+  EXPECT_EQ(cass::String("bc"),
+            cass::String(reinterpret_cast<const char*>(data + offsets[1]), lengths[1]));
+  EXPECT_LT(lengths[2], 0);
+  EXPECT_EQ(0x04, cass_result_columns_null_bitmap(columns, 3)[0]);
+
+  EXPECT_EQ(CASS_ERROR_LIB_INVALID_VALUE_TYPE,
+            cass_result_columns_bytes(columns, 0, &data, &offsets, &lengths));
+  EXPECT_EQ(CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS,
+            cass_result_columns_bytes(columns, 4, &data, &offsets, &lengths));
+
+  cass_result_columns_free(columns);
+}
+
+TEST_F(ResultColumnsUnitTest, InvalidFixedWidthValue) {
+  encode_int32(1); // Row count
+
+  encode_int32_value(1);
+  encode_int32_value(2); // Not the size of a bigint
+  encode_double_value(1.5);
+  encode_text_value("a");
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(cass_result_columns_new(CassResult::to(result.get())) == NULL);
+}
+
+TEST_F(ResultColumnsUnitTest, Truncated) {
+  encode_int32(2); // Row count
+
+  encode_int32_value(1);
+  encode_int64_value(10);
+  encode_double_value(1.5);
+  encode_text_value("a");
+
+  // The first row is decoded with the result so the truncated second row is
+  // only found when the columns are decoded
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(cass_result_columns_new(CassResult::to(result.get())) == NULL);
+}
+
+TEST_F(ResultColumnsUnitTest, RowsMatchColumns) {
+  encode_int32(3); // Row count
+
+  encode_int32_value(1);
+  encode_null();
+  encode_double_value(1.5);
+  encode_text_value("a");
+
+  encode_null();
+  encode_int64_value(-20);
+  encode_null();
+  encode_text_value("");
+
+  encode_int32_value(3);
+  encode_int64_value(30);
+  encode_double_value(3.5);
+  encode_null();
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+
+  // The rows are decoded in place so values change from null to not null (and
+  // back) between rows
+  CassIterator* iterator = cass_iterator_from_result(CassResult::to(result.get()));
+  cass_int32_t ints[3] = { 0 };
+  cass_int64_t bigints[3] = { 0 };
+  cass_double_t doubles[3] = { 0.0 };
+  size_t lengths[3] = { 0 };
+  cass_bool_t nulls[3][4];
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(cass_iterator_next(iterator));
+    const CassRow* row = cass_iterator_get_row(iterator);
+    for (size_t j = 0; j < 4; ++j) {
+      nulls[i][j] = cass_value_is_null(cass_row_get_column(row, j));
+    }
+    cass_value_get_int32(cass_row_get_column(row, 0), &ints[i]);
+    cass_value_get_int64(cass_row_get_column(row, 1), &bigints[i]);
+    cass_value_get_double(cass_row_get_column(row, 2), &doubles[i]);
+    const char* text;
+    cass_value_get_string(cass_row_get_column(row, 3), &text, &lengths[i]);
+    EXPECT_EQ(CASS_VALUE_TYPE_DOUBLE,
+              cass_value_type(cass_row_get_column(row, 2)));
+  }
+  EXPECT_FALSE(cass_iterator_next(iterator));
+  cass_iterator_free(iterator);
+
+  CassResultColumns* columns = cass_result_columns_new(CassResult::to(result.get()));
+  ASSERT_TRUE(columns != NULL);
+  for (size_t i = 0; i < 3; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      bool is_null = (cass_result_columns_null_bitmap(columns, j)[i / 8] & (1 << (i % 8))) != 0;
+      EXPECT_EQ(is_null, nulls[i][j] == cass_true) << "row " << i << ", column " << j;
+    }
+    EXPECT_EQ(cass_result_columns_int32(columns, 0)[i], ints[i]);
+    EXPECT_EQ(cass_result_columns_int64(columns, 1)[i], bigints[i]);
+    EXPECT_EQ(cass_result_columns_double(columns, 2)[i], doubles[i]);
+  }
+  EXPECT_EQ(1u, lengths[0]);
+  EXPECT_EQ(0u, lengths[1]);
+  EXPECT_FALSE(nulls[1][3]); // An empty value isn't null
+  cass_result_columns_free(columns);
+}
+
+TEST_F(ResultColumnsUnitTest, SeekRow) {
+  encode_int32(3); // Row count
+  for (int32_t i = 0; i < 3; ++i) {
+    encode_int32_value(i);
+    if (i == 1) encode_null(); else encode_int64_value(i * 10);
+    encode_double_value(i * 0.5);
+    encode_text_value(cass::String(i, 'a'));
+  }
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+
+  CassIterator* iterator = cass_iterator_from_result(CassResult::to(result.get()));
+  cass_int32_t value = -1;
+
+  ASSERT_EQ(CASS_OK, cass_iterator_seek_row(iterator, 2));
+  const CassRow* row = cass_iterator_get_row(iterator);
+  EXPECT_EQ(CASS_OK, cass_value_get_int32(cass_row_get_column(row, 0), &value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(cass_iterator_next(iterator));
+
+  ASSERT_EQ(CASS_OK, cass_iterator_seek_row(iterator, 0));
+  row = cass_iterator_get_row(iterator);
+  EXPECT_EQ(CASS_OK, cass_value_get_int32(cass_row_get_column(row, 0), &value));
+  EXPECT_EQ(0, value);
+
+  // Iterating continues after the row that was moved to
+  ASSERT_TRUE(cass_iterator_next(iterator));
+  row = cass_iterator_get_row(iterator);
+  EXPECT_EQ(CASS_OK, cass_value_get_int32(cass_row_get_column(row, 0), &value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(cass_value_is_null(cass_row_get_column(row, 1)));
+
+  EXPECT_EQ(CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS, cass_iterator_seek_row(iterator, 3));
+  cass_iterator_free(iterator);
+}
+
+TEST_F(ResultColumnsUnitTest, SeekRowTruncated) {
+  encode_int32(3); // Row count
+  encode_int32_value(1);
+  encode_int64_value(10);
+  encode_double_value(1.5);
+  encode_text_value("a");
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+
+  CassIterator* iterator = cass_iterator_from_result(CassResult::to(result.get()));
+  EXPECT_EQ(CASS_ERROR_LIB_NOT_ENOUGH_DATA, cass_iterator_seek_row(iterator, 1));
+  cass_iterator_free(iterator);
+}
+
+TEST_F(ResultColumnsUnitTest, CopyColumn) {
+  encode_int32(3); // Row count
+  for (int32_t i = 0; i < 3; ++i) {
+    if (i == 1) encode_null(); else encode_int32_value(i);
+    encode_int64_value(i * 10);
+    encode_double_value(i * 0.5);
+    encode_text_value("a");
+  }
+
+  ResultResponse::Ptr result(decode());
+  ASSERT_TRUE(result);
+  const CassResult* external = CassResult::to(result.get());
+
+  cass_int32_t ints[4] = { -1, -1, -1, -1 };
+  cass_uint8_t nulls = 0xFF;
+  ASSERT_EQ(CASS_OK, cass_result_column_get_int32_array(external, 0, ints, 4, &nulls));
+  EXPECT_EQ(0, ints[0]);
+  EXPECT_EQ(0, ints[1]);
+  EXPECT_EQ(2, ints[2]);
+  EXPECT_EQ(-1, ints[3]); // Past the last row
+  EXPECT_EQ(0x02, nulls);
+
+  // Only the first rows that fit are copied
+  cass_int64_t bigints[2];
+  ASSERT_EQ(CASS_OK, cass_result_column_get_int64_array(external, 1, bigints, 2, NULL));
+  EXPECT_EQ(0, bigints[0]);
+  EXPECT_EQ(10, bigints[1]);
+
+  cass_double_t doubles[3];
+  ASSERT_EQ(CASS_OK, cass_result_column_get_double_array(external, 2, doubles, 3, NULL));
+  EXPECT_EQ(1.0, doubles[2]);
+
+  cass_float_t floats[3];
+  EXPECT_EQ(CASS_ERROR_LIB_INVALID_VALUE_TYPE,
+            cass_result_column_get_float_array(external, 2, floats, 3, NULL));
+  EXPECT_EQ(CASS_ERROR_LIB_INVALID_VALUE_TYPE,
+            cass_result_column_get_int64_array(external, 0, bigints, 2, NULL));
+  EXPECT_EQ(CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS,
+            cass_result_column_get_int32_array(external, 4, ints, 3, NULL));
+}
@@ -158,3 +158,27 @@ TEST_F(RoutingKeyUnitTest, Composite)
     EXPECT_EQ(hash, 4466051201071860026);
   }
 }
+
+TEST_F(RoutingKeyUnitTest, InPlace)
+{
+  cass::QueryRequest query("", 2);
+
+  const char* value = "abcdefghijklmnop";
+  query.set(0, cass::CassString(value, strlen(value)));
+  query.add_key_index(0);
+
+  // A single component refers to the bound value
+  cass::RoutingKey routing_key;
+  EXPECT_TRUE(query.get_routing_key(&routing_key));
+  EXPECT_EQ(routing_key.value(), cass::StringRef(value));
+
+  // The same routing key can be reused for a composite key
+  query.set(1, static_cast<cass_int32_t>(123456789));
+  query.add_key_index(1);
+  EXPECT_TRUE(query.get_routing_key(&routing_key));
+
+  cass::String expected;
+  EXPECT_TRUE(query.get_routing_key(&expected));
+  EXPECT_EQ(routing_key.value(), cass::StringRef(expected));
+  EXPECT_EQ(routing_key.value().size(), 2 + strlen(value) + 1 + 2 + sizeof(cass_int32_t) + 1);
+}
@@ -17,11 +17,97 @@
 #include "event_loop_test.hpp"
 #include "query_request.hpp"
 #include "session.hpp"
+#include "set.hpp"
 
 #define KEYSPACE "datastax"
 #define NUM_THREADS 2 // Number of threads to execute queries using a session
 #define OUTAGE_PLAN_DELAY 250 // Reduced delay to incorporate larger outage plan
 
+#define METRICS_EXPORTER_PORT 19042
+
+/**
+ * A blocking HTTP GET of the local metrics exporter.
+ */
+class HttpGet {
+public:
+  HttpGet(int port)
+    : port_(port)
+    , is_done_(false) { }
+
+  bool run() {
+    uv_loop_t loop;
+    if (uv_loop_init(&loop) != 0) return false;
+
+    struct sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", port_, &addr);
+
+    uv_tcp_init(&loop, &tcp_);
+    tcp_.data = this;
+    connect_req_.data = this;
+    // The exporter is started asynchronously after the session connects
+    for (int i = 0; i < 100 && !is_done_; ++i) {
+      if (uv_tcp_connect(&connect_req_, &tcp_,
+                         reinterpret_cast<const struct sockaddr*>(&addr),
+                         on_connect) != 0) {
+        break;
+      }
+      uv_run(&loop, UV_RUN_DEFAULT);
+      if (!is_done_) {
+        uv_close(reinterpret_cast<uv_handle_t*>(&tcp_), NULL);
+        uv_run(&loop, UV_RUN_DEFAULT);
+        uv_tcp_init(&loop, &tcp_);
+        tcp_.data = this;
+        test::Utils::msleep(10);
+      }
+    }
+
+    if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(&tcp_))) {
+      uv_close(reinterpret_cast<uv_handle_t*>(&tcp_), NULL);
+    }
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+    return is_done_;
+  }
+
+  const cass::String& response() const { return response_; }
+
+private:
+  static void on_connect(uv_connect_t* req, int status) {
+    HttpGet* get = static_cast<HttpGet*>(req->data);
+    if (status != 0) return; // Retried
+
+    static char request[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    uv_buf_t buf = uv_buf_init(request, sizeof(request) - 1);
+    get->write_req_.data = get;
+    uv_write(&get->write_req_, req->handle, &buf, 1, NULL);
+    uv_read_start(req->handle, on_alloc, on_read);
+  }
+
+  static void on_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    HttpGet* get = static_cast<HttpGet*>(handle->data);
+    *buf = uv_buf_init(get->buffer_, sizeof(get->buffer_));
+  }
+
+  static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    HttpGet* get = static_cast<HttpGet*>(stream->data);
+    if (nread > 0) {
+      get->response_.append(buf->base, nread);
+    } else if (nread < 0) {
+      get->is_done_ = nread == UV_EOF;
+      uv_close(reinterpret_cast<uv_handle_t*>(stream), NULL);
+    }
+  }
+
+private:
+  int port_;
+  bool is_done_;
+  uv_tcp_t tcp_;
+  uv_connect_t connect_req_;
+  uv_write_t write_req_;
+  char buffer_[4096];
+  cass::String response_;
+};
+
 class SessionUnitTest : public EventLoopTest {
 public:
   SessionUnitTest()
@@ -127,17 +213,15 @@ public:
     Type type() { return event_.first; }
 
     void set_event(Type type, const Address& host) {
-      cass::ScopedMutex lock(&mutex_);
-      if (!is_set()) {
+      if (claim()) {
         event_ = Event(type, host);
-        internal_set(lock);
+        internal_set();
       }
     }
 
     Event wait_for_event(uint64_t timeout_us) {
-      cass::ScopedMutex lock(&mutex_);
-      return internal_wait_for(lock, timeout_us) ? event_ : Event(INVALID,
-                                                                  Address());
+      return internal_wait_for(timeout_us) ? event_ : Event(INVALID,
+                                                            Address());
     }
 
   private:
@@ -404,6 +488,556 @@ TEST_F(SessionUnitTest, ExecuteQueryWithThreads) {
   close(&session);
 }
 
+TEST_F(SessionUnitTest, ExecuteManyNotConnected) {
+  cass::Request::ConstVec requests;
+  for (int i = 0; i < 3; ++i) {
+    requests.push_back(cass::Request::ConstPtr(
+                         cass::Memory::allocate<cass::QueryRequest>("blah", 0)));
+  }
+
+  cass::Session session;
+  cass::Future::Vec futures;
+  session.execute_many(requests, &futures);
+  ASSERT_EQ(requests.size(), futures.size());
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_EQ(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE, futures[i]->error()->code);
+  }
+}
+
+TEST_F(SessionUnitTest, ExecuteMany) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_thread_count_io(2);
+
+  cass::Session session;
+  connect(config, &session);
+
+  cass::Request::ConstVec requests;
+  for (int i = 0; i < 100; ++i) {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    request->set_is_idempotent(true);
+    requests.push_back(request);
+  }
+
+  cass::Future::Vec futures;
+  session.execute_many(requests, &futures);
+  ASSERT_EQ(requests.size(), futures.size());
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_TRUE(futures[i]->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+    ASSERT_FALSE(futures[i]->error())
+      << cass_error_desc(futures[i]->error()->code) << ": "
+      << futures[i]->error()->message;
+  }
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, ExecuteManyQueueFull) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_queue_size_io(16);
+
+  cass::Session session;
+  connect(config, &session);
+
+  cass::Request::ConstVec requests;
+  for (int i = 0; i < 64; ++i) {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    request->set_is_idempotent(true);
+    requests.push_back(request);
+  }
+
+  // The requests that don't fit in the queue fail, the rest are executed
+  cass::Future::Vec futures;
+  session.execute_many(requests, &futures);
+  ASSERT_EQ(requests.size(), futures.size());
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_TRUE(futures[i]->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+    if (i < 16) {
+      EXPECT_FALSE(futures[i]->error());
+    } else {
+      ASSERT_TRUE(futures[i]->error());
+      EXPECT_EQ(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, futures[i]->error()->code);
+    }
+  }
+
+  close(&session);
+}
+
+struct StreamedRows {
+  StreamedRows()
+    : calls(0)
+    , row_count(0)
+    , invalid_count(0) { }
+
+  static void on_rows(const CassResult* rows, void* data) {
+    StreamedRows* streamed = static_cast<StreamedRows*>(data);
+    streamed->calls++;
+    CassIterator* iterator = cass_iterator_from_result(rows);
+    while (cass_iterator_next(iterator)) {
+      const char* value;
+      size_t value_length;
+      const CassRow* row = cass_iterator_get_row(iterator);
+      if (cass_value_get_string(cass_row_get_column(row, 0),
+                                &value, &value_length) != CASS_OK ||
+          value_length != 100) {
+        streamed->invalid_count++;
+      }
+      streamed->row_count++;
+    }
+    cass_iterator_free(iterator);
+  }
+
+  int calls;
+  int row_count;
+  int invalid_count;
+};
+
+TEST_F(SessionUnitTest, StreamRows) {
+  mockssandra::SimpleRequestHandlerBuilder builder;
+  builder.on(mockssandra::OPCODE_QUERY)
+      .system_local()
+      .system_peers()
+      .text_rows_result(10000, 100); // A ~1 MB page that straddles many reads
+  mockssandra::SimpleCluster cluster(builder.build());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_use_schema(false);
+
+  cass::Session session;
+  connect(config, &session);
+
+  StreamedRows streamed;
+  cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+  request->set_rows_callback(StreamedRows::on_rows, &streamed);
+
+  cass::Future::Ptr future = session.execute(request, NULL);
+  ASSERT_TRUE(future->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+  ASSERT_FALSE(future->error())
+    << cass_error_desc(future->error()->code) << ": "
+    << future->error()->message;
+
+  // The rows are delivered in chunks before the future is set
+  EXPECT_GT(streamed.calls, 1);
+  EXPECT_EQ(streamed.row_count, 10000);
+  EXPECT_EQ(streamed.invalid_count, 0);
+
+  // The result only has the metadata
+  const CassResult* result = cass_future_get_result(CassFuture::to(future.get()));
+  ASSERT_TRUE(result != NULL);
+  EXPECT_EQ(cass_result_row_count(result), 0u);
+  EXPECT_EQ(cass_result_column_count(result), 1u);
+  cass_result_free(result);
+
+  close(&session);
+}
+
+// Sends the first half of a rows result, the connection is closed by the
+// following actions
+class HalfRowsResult : public mockssandra::Action {
+public:
+  HalfRowsResult(int32_t row_count, size_t value_size)
+    : rows_(row_count, value_size) { }
+
+  virtual void on_run(mockssandra::Request* request) const {
+    const cass::String& body = rows_.body;
+    cass::String frame;
+    frame.push_back(static_cast<char>(0x80 | request->version()));
+    frame.push_back(0); // Flags
+    frame.push_back(static_cast<char>(request->stream() >> 8));
+    frame.push_back(static_cast<char>(request->stream() & 0xFF));
+    frame.push_back(mockssandra::OPCODE_RESULT);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      frame.push_back(static_cast<char>((body.size() >> shift) & 0xFF));
+    }
+    frame.append(body);
+    request->client()->write(frame.data(), frame.size() / 2);
+    run_next(request);
+  }
+
+private:
+  mockssandra::TextRowsResult rows_;
+};
+
+TEST_F(SessionUnitTest, StreamRowsNotRetried) {
+  mockssandra::SimpleRequestHandlerBuilder builder;
+  builder.on(mockssandra::OPCODE_QUERY)
+      .system_local()
+      .system_peers()
+      .is_query("blah")
+        .then(mockssandra::Action::Builder()
+              .execute(cass::Memory::allocate<HalfRowsResult>(10000, 100))
+              .wait(100) // Give the driver time to deliver some of the rows
+              .close())
+      .empty_rows_result(1);
+  mockssandra::SimpleCluster cluster(builder.build());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_use_schema(false);
+
+  cass::Session session;
+  connect(config, &session);
+
+  StreamedRows streamed;
+  cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+  request->set_is_idempotent(true); // Would be retried if no rows were delivered
+  request->set_rows_callback(StreamedRows::on_rows, &streamed);
+
+  cass::Future::Ptr future = session.execute(request, NULL);
+  ASSERT_TRUE(future->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+  ASSERT_TRUE(future->error());
+  EXPECT_EQ(CASS_ERROR_LIB_UNABLE_TO_EXECUTE, future->error()->code);
+  EXPECT_GT(streamed.row_count, 0);
+  EXPECT_LT(streamed.row_count, 10000);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, AdmissionControlFail) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_max_in_flight_requests(4);
+  config.set_admission_mode(CASS_ADMISSION_MODE_FAIL);
+
+  cass::Session session;
+  connect(config, &session);
+
+  cass::Request::ConstVec requests;
+  for (int i = 0; i < 64; ++i) {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    request->set_is_idempotent(true);
+    requests.push_back(request);
+  }
+
+  // The requests over the limit fail right away, the rest are executed
+  cass::Future::Vec futures;
+  session.execute_many(requests, &futures);
+  ASSERT_EQ(requests.size(), futures.size());
+  size_t rejected = 0;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_TRUE(futures[i]->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+    if (i < 4) {
+      EXPECT_FALSE(futures[i]->error());
+    } else if (futures[i]->error()) {
+      EXPECT_EQ(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, futures[i]->error()->code);
+      rejected++;
+    }
+  }
+  EXPECT_GT(rejected, 0u);
+
+  CassAdmissionMetrics metrics;
+  cass_session_get_admission_metrics(CassSession::to(&session), &metrics);
+  EXPECT_EQ(rejected, metrics.rejected_requests);
+  EXPECT_EQ(0u, metrics.waiting_requests);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, AdmissionControlWait) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_max_in_flight_requests(4);
+  config.set_admission_mode(CASS_ADMISSION_MODE_WAIT);
+
+  cass::Session session;
+  connect(config, &session);
+
+  cass::Future::Vec futures;
+  for (int i = 0; i < 64; ++i) {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    request->set_is_idempotent(true);
+    futures.push_back(session.execute(cass::Request::ConstPtr(request)));
+  }
+
+  // The requests over the limit wait until there's room for them
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_TRUE(futures[i]->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+    EXPECT_FALSE(futures[i]->error());
+  }
+
+  CassAdmissionMetrics metrics;
+  cass_session_get_admission_metrics(CassSession::to(&session), &metrics);
+  EXPECT_EQ(0u, metrics.rejected_requests);
+  EXPECT_EQ(0u, metrics.waiting_requests);
+  EXPECT_EQ(0u, metrics.in_flight_bytes);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, MaxInFlightRequestsPerHost) {
+  mockssandra::SimpleRequestHandlerBuilder builder;
+  builder.on(mockssandra::OPCODE_QUERY)
+      .system_local()
+      .system_peers()
+      .is_query("slow") // Delayed so that it's still in flight
+        .then(mockssandra::Action::Builder().wait(100).void_result())
+      .empty_rows_result(1);
+  mockssandra::SimpleCluster cluster(builder.build());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_thread_count_io(1);
+  config.set_max_in_flight_requests_per_host(1);
+
+  cass::Session session;
+  connect(config, &session);
+
+  cass::QueryRequest::Ptr slow(cass::Memory::allocate<cass::QueryRequest>("slow", 0));
+  cass::Future::Ptr slow_future(session.execute(cass::Request::ConstPtr(slow)));
+
+  // The only host is at its limit so the request isn't executed. It fails
+  // with a different error than when no hosts are available.
+  cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+  cass::Future::Ptr future(session.execute(cass::Request::ConstPtr(request)));
+  EXPECT_TRUE(future->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+  EXPECT_TRUE(future->error() != NULL);
+  if (future->error()) {
+    EXPECT_EQ(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, future->error()->code);
+  }
+
+  EXPECT_TRUE(slow_future->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+  EXPECT_FALSE(slow_future->error());
+
+  // The host can be used again once its request finishes
+  query(&session);
+
+  close(&session);
+}
+
+struct BlockingCallback {
+  BlockingCallback()
+    : entered(cass::Memory::allocate<cass::Future>(cass::Future::FUTURE_TYPE_GENERIC))
+    , release(cass::Memory::allocate<cass::Future>(cass::Future::FUTURE_TYPE_GENERIC)) { }
+
+  // Blocks the I/O thread that completes the future until it's released
+  static void on_future(CassFuture* future, void* data) {
+    BlockingCallback* callback = static_cast<BlockingCallback*>(data);
+    callback->entered->set();
+    callback->release->wait_for(WAIT_FOR_TIME);
+  }
+
+  cass::Future::Ptr entered;
+  cass::Future::Ptr release;
+};
+
+TEST_F(SessionUnitTest, WorkStealing) {
+  mockssandra::SimpleRequestHandlerBuilder builder;
+  builder.on(mockssandra::OPCODE_QUERY)
+      .system_local()
+      .system_peers()
+      .is_query("block") // Delayed so that its callback is set before it finishes
+        .then(mockssandra::Action::Builder().wait(100).void_result())
+      .empty_rows_result(1);
+  mockssandra::SimpleCluster cluster(builder.build());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_thread_count_io(2);
+  // All the requests from this thread are added to the same I/O thread
+  config.set_request_dispatch(CASS_REQUEST_DISPATCH_THREAD_AFFINITY);
+  config.set_work_stealing(true);
+
+  cass::Session session;
+  connect(config, &session);
+
+  // Block this thread's I/O thread so that its queued requests can only be
+  // executed by its idle peer
+  BlockingCallback blocking;
+  {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("block", 0));
+    cass::Future::Ptr future(session.execute(cass::Request::ConstPtr(request)));
+    ASSERT_TRUE(future->set_callback(BlockingCallback::on_future, &blocking));
+    ASSERT_TRUE(blocking.entered->wait_for(WAIT_FOR_TIME));
+  }
+
+  cass::Request::ConstVec requests;
+  for (int i = 0; i < 1024; ++i) {
+    cass::QueryRequest::Ptr request(cass::Memory::allocate<cass::QueryRequest>("blah", 0));
+    request->set_is_idempotent(true);
+    requests.push_back(request);
+  }
+
+  cass::Future::Vec futures;
+  session.execute_many(requests, &futures);
+  ASSERT_EQ(requests.size(), futures.size());
+
+  // The first requests in the queue are taken by the peer and finish while
+  // their I/O thread is still blocked
+  bool is_stolen = futures.front()->wait_for(WAIT_FOR_TIME);
+  blocking.release->set();
+  EXPECT_TRUE(is_stolen) << "Timed out waiting for a stolen request";
+
+  for (size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_TRUE(futures[i]->wait_for(WAIT_FOR_TIME)) << "Timed out executing query";
+    EXPECT_FALSE(futures[i]->error());
+  }
+
+  CassAdmissionMetrics metrics;
+  cass_session_get_admission_metrics(CassSession::to(&session), &metrics);
+  EXPECT_GT(metrics.stolen_requests, 0u);
+  EXPECT_LE(metrics.stolen_requests, requests.size());
+  EXPECT_EQ(0u, metrics.request_queue_depth);
+
+  // The I/O threads' queue latencies decay once they're idle
+  for (int i = 0; i < 100 && metrics.queue_latency_skew_us > 0; ++i) {
+    test::Utils::msleep(10);
+    cass_session_get_admission_metrics(CassSession::to(&session), &metrics);
+  }
+  EXPECT_EQ(0u, metrics.queue_latency_skew_us);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, CoalesceMetrics) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_coalesce_mode(CASS_COALESCE_MODE_ADAPTIVE_LATENCY);
+
+  cass::Session session;
+  connect(config, &session);
+  for (int i = 0; i < 10; ++i) {
+    query(&session);
+  }
+
+  CassCoalesceMetrics metrics;
+  cass_session_get_coalesce_metrics(CassSession::to(&session), &metrics);
+  EXPECT_GE(metrics.writes_per_flush.max, 1u);
+  EXPECT_GE(metrics.writes_per_flush.min, 1u);
+  EXPECT_GE(metrics.reads_per_flush.max, 1u);
+  EXPECT_LE(metrics.delays.min, metrics.delays.max);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, HostMetrics) {
+  mockssandra::SimpleCluster cluster(simple(), 3);
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Session session;
+  connect(&session);
+  for (int i = 0; i < 30; ++i) {
+    query(&session);
+  }
+
+  CassIterator* iterator = cass_iterator_host_metrics_from_session(CassSession::to(&session));
+  CassHostMetrics metrics;
+  EXPECT_EQ(cass_iterator_get_host_metrics(iterator, &metrics), CASS_ERROR_LIB_BAD_PARAMS);
+
+  cass::Set<cass::Address> addresses;
+  while (cass_iterator_next(iterator)) {
+    ASSERT_EQ(cass_iterator_get_host_metrics(iterator, &metrics), CASS_OK);
+    cass::Address address;
+    ASSERT_TRUE(cass::Address::from_inet(metrics.address.address,
+                                         metrics.address.address_length,
+                                         9042, &address));
+    addresses.insert(address);
+    EXPECT_EQ(metrics.stats.total_connections, 1u);
+    EXPECT_EQ(metrics.stats.in_flight_requests, 0u);
+    EXPECT_GT(metrics.stats.bytes_written, 0u);
+    EXPECT_GT(metrics.stats.bytes_read, 0u);
+    EXPECT_EQ(metrics.stats.stream_exhaustions, 0u);
+    EXPECT_EQ(metrics.errors.errors, 0u);
+    EXPECT_GT(metrics.requests.max, 0u);
+    EXPECT_LE(metrics.requests.min, metrics.requests.max);
+  }
+  cass_iterator_free(iterator);
+
+  EXPECT_EQ(addresses.size(), 3u);
+  EXPECT_EQ(addresses.count(cass::Address("127.0.0.1", 9042)), 1u);
+  EXPECT_EQ(addresses.count(cass::Address("127.0.0.3", 9042)), 1u);
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, MetricsText) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Session session;
+  connect(&session, NULL, WAIT_FOR_TIME, 1);
+  for (int i = 0; i < 10; ++i) {
+    query(&session);
+  }
+
+  size_t length = 0;
+  EXPECT_EQ(cass_session_get_metrics_text(CassSession::to(&session), NULL, 0, &length),
+            CASS_ERROR_LIB_NOT_ENOUGH_DATA);
+  ASSERT_GT(length, 0u);
+
+  char truncated[16];
+  size_t output_length = 0;
+  EXPECT_EQ(cass_session_get_metrics_text(CassSession::to(&session),
+                                          truncated, sizeof(truncated), &output_length),
+            CASS_ERROR_LIB_NOT_ENOUGH_DATA);
+  EXPECT_GT(output_length, sizeof(truncated));
+  EXPECT_EQ(strlen(truncated), sizeof(truncated) - 1);
+
+  // Extra room because the length of the values (e.g. rates) can change
+  // between calls.
+  cass::String text(2 * length, 'x');
+
+  ASSERT_EQ(cass_session_get_metrics_text(CassSession::to(&session),
+                                          &text[0], text.size(), &output_length), CASS_OK);
+  text.resize(output_length);
+
+  EXPECT_NE(text.find("# TYPE cass_request_latency_microseconds histogram\n"), cass::String::npos);
+  EXPECT_NE(text.find("cass_request_latency_microseconds_bucket{le=\"+Inf\"}"), cass::String::npos);
+  // Host metrics are recorded before the request's future is set
+  EXPECT_NE(text.find("cass_host_requests_total{host=\"127.0.0.1:9042\"} 10\n"), cass::String::npos);
+  EXPECT_NE(text.find("cass_host_request_latency_microseconds_bucket{host=\"127.0.0.1:9042\",le=\"+Inf\"} 10\n"),
+            cass::String::npos);
+  EXPECT_NE(text.find("cass_host_request_latency_microseconds_count{host=\"127.0.0.1:9042\"} 10\n"),
+            cass::String::npos);
+  EXPECT_NE(text.find("cass_host_request_latency_microseconds_bucket{host=\"127.0.0.1:9042\",le=\"1.0\"}"),
+            cass::String::npos);
+  EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+
+  close(&session);
+}
+
+TEST_F(SessionUnitTest, MetricsExporter) {
+  mockssandra::SimpleCluster cluster(simple());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.1");
+  config.set_metrics_exporter_port(METRICS_EXPORTER_PORT);
+
+  cass::Session session;
+  connect(config, &session);
+  query(&session);
+
+  HttpGet get(METRICS_EXPORTER_PORT);
+  ASSERT_TRUE(get.run()) << "Unable to scrape the metrics";
+  EXPECT_EQ(get.response().find("HTTP/1.1 200 OK\r\n"), 0u);
+  EXPECT_NE(get.response().find("Content-Type: application/openmetrics-text"), cass::String::npos);
+  EXPECT_NE(get.response().find("cass_host_requests_total{host=\"127.0.0.1:9042\"} 1\n"), cass::String::npos);
+  EXPECT_EQ(get.response().substr(get.response().size() - 6), "# EOF\n");
+
+  close(&session);
+}
+
 TEST_F(SessionUnitTest, ExecuteQueryWithThreadsUsingSsl) {
   mockssandra::SimpleCluster cluster(simple());
   cass::SslContext::Ptr ssl_context = use_ssl(&cluster).socket_settings.ssl_context;
@@ -452,6 +1086,40 @@ TEST_F(SessionUnitTest, ExecuteQueryWithThreadsUsingSslChaotic) {
   close(&session);
 }
 
+TEST_F(SessionUnitTest, HostMetricsRemovedWithHost) {
+  mockssandra::SimpleCluster cluster(simple(), 2);
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  TestHostListener::Ptr listener(cass::Memory::allocate<TestHostListener>());
+
+  cass::Config config;
+  config.contact_points().push_back("127.0.0.2");
+  config.set_host_listener(listener);
+
+  cass::Session session;
+  connect(config, &session);
+  for (int i = 0; i < 10; ++i) {
+    query(&session);
+  }
+
+  cluster.remove(1);
+  EXPECT_EQ(HostEventFuture::Event(HostEventFuture::STOP_NODE,
+                                   Address("127.0.0.1", 9042)),
+            listener->wait_for_event(WAIT_FOR_TIME));
+  EXPECT_EQ(HostEventFuture::Event(HostEventFuture::REMOVE_NODE,
+                                   Address("127.0.0.1", 9042)),
+            listener->wait_for_event(WAIT_FOR_TIME));
+
+  cass::Metrics::HostMetrics::Vec hosts;
+  session.metrics()->all_host_metrics(&hosts);
+  EXPECT_EQ(hosts.size(), 1u);
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    EXPECT_EQ(hosts[i]->address(), Address("127.0.0.2", 9042));
+  }
+
+  close(&session);
+}
+
 TEST_F(SessionUnitTest, HostListener) {
   mockssandra::SimpleCluster cluster(simple(), 2);
   ASSERT_EQ(cluster.start_all(), 0);
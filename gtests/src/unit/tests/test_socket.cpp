@@ -131,6 +131,36 @@ public:
     }
   }
 
+  struct CoalesceState {
+    String result;
+    String expected;
+    Socket::FlushStats flush_stats;
+  };
+
+  static void on_socket_connected_coalesce(SocketConnector* connector, CoalesceState* state) {
+    Socket::Ptr socket = connector->release_socket();
+    ASSERT_EQ(connector->error_code(), SocketConnector::SOCKET_OK)
+      << "Failed to connect: " << connector->error_message();
+    socket->set_handler(Memory::allocate<TestSocketHandler>(&state->result));
+
+    // Many small buffers, a large buffer, then more small buffers
+    for (int i = 0; i < 100; ++i) {
+      OStringStream ss;
+      ss << i << ",";
+      Buffer buf(ss.str().data(), ss.str().size());
+      state->expected.append(buf.data(), buf.size());
+      socket->write(Memory::allocate<BufferSocketRequest>(buf));
+    }
+    String large(4096, 'x');
+    state->expected.append(large);
+    socket->write(Memory::allocate<BufferSocketRequest>(Buffer(large.data(), large.size())));
+    state->expected.append("Closed");
+    socket->write(Memory::allocate<BufferSocketRequest>(Buffer("Closed", sizeof("Closed") - 1)));
+    socket->flush();
+
+    state->flush_stats = socket->flush_stats();
+  }
+
   static void on_socket_refused(SocketConnector* connector, bool* is_refused) {
     if (connector->error_code() == SocketConnector::SOCKET_ERROR_CONNECT) {
       *is_refused = true;
@@ -183,6 +213,25 @@ TEST_F(SocketUnitTest, Simple) {
   EXPECT_EQ(result, "The socket is successfully connected and wrote data - Closed");
 }
 
+TEST_F(SocketUnitTest, CoalesceSmallBuffers) {
+  listen();
+
+  CoalesceState state;
+  SocketConnector::Ptr connector(Memory::allocate<SocketConnector>(Address("127.0.0.1", 8888),
+                                                                   cass::bind_callback(on_socket_connected_coalesce, &state)));
+
+  connector->connect(loop());
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(state.result, state.expected);
+
+  // The small buffers on either side of the large buffer are coalesced
+  EXPECT_EQ(state.flush_stats.count, 1u);
+  EXPECT_EQ(state.flush_stats.bufs, 3u);
+  EXPECT_EQ(state.flush_stats.bytes, state.expected.size());
+}
+
 TEST_F(SocketUnitTest, Ssl) {
   listen();
 
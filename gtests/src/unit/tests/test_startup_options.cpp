@@ -16,6 +16,7 @@
 
 #include "unit.hpp"
 
+#include "compression.hpp"
 #include "driver_info.hpp"
 #include "query_request.hpp"
 #include "session.hpp"
@@ -129,3 +130,23 @@ TEST_F(StartupRequestUnitTest, Application) {
   ASSERT_EQ(cass::driver_name(), options["DRIVER_NAME"]);
   ASSERT_EQ(cass::driver_version(), options["DRIVER_VERSION"]);
 }
+
+TEST_F(StartupRequestUnitTest, Compression) {
+  cass::Vector<cass::String> supported(cass::Compressor::supported_names());
+  if (supported.empty()) return; // No compression algorithms compiled in
+
+  mockssandra::SimpleCluster cluster(simple_with_client_options());
+  ASSERT_EQ(cluster.start_all(), 0);
+
+  config().set_compression(CASS_COMPRESSION_AUTO);
+  config().set_compression_threshold(0);
+  connect();
+  cass::Map<cass::String, cass::String> options = client_options();
+  ASSERT_EQ(5u, options.size());
+
+  ASSERT_EQ(supported.front(), options["COMPRESSION"]);
+  ASSERT_EQ(client_id(), options["CLIENT_ID"]);
+  ASSERT_EQ(CASS_DEFAULT_CQL_VERSION, options["CQL_VERSION"]);
+  ASSERT_EQ(cass::driver_name(), options["DRIVER_NAME"]);
+  ASSERT_EQ(cass::driver_version(), options["DRIVER_VERSION"]);
+}
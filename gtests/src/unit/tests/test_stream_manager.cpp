@@ -18,6 +18,12 @@
 
 #include "stream_manager.hpp"
 
+#include <uv.h>
+
+#include <stdio.h>
+
+#define BENCHMARK_NUM_ITERATIONS 10000000
+
 TEST(StreamManagerUnitTest, MaxStreams)
 {
   ASSERT_EQ(cass::StreamManager<int>().max_streams(), 32768u);
@@ -73,3 +79,88 @@ TEST(StreamManagerUnitTest, Release)
   // Verify there are no more streams left
   ASSERT_LT(streams.acquire(streams.max_streams()), 0);
 }
+
+TEST(StreamManagerUnitTest, LowestAvailable)
+{
+  cass::StreamManager<int> streams;
+
+  for (int i = 0; i < 256; ++i) {
+    ASSERT_EQ(i, streams.acquire(i));
+  }
+  EXPECT_EQ(256u, streams.pending_streams());
+
+  // Released streams are re-acquired lowest first
+  streams.release(200);
+  streams.release(3);
+  EXPECT_EQ(3, streams.acquire(3));
+  EXPECT_EQ(200, streams.acquire(200));
+  EXPECT_EQ(256, streams.acquire(256));
+  EXPECT_EQ(257u, streams.pending_streams());
+  EXPECT_EQ(streams.max_streams() - 257u, streams.available_streams());
+}
+
+TEST(StreamManagerUnitTest, Get)
+{
+  cass::StreamManager<int> streams;
+
+  int item = -1;
+  EXPECT_FALSE(streams.get(0, item));
+  EXPECT_FALSE(streams.get(-1, item));
+  EXPECT_FALSE(streams.get(static_cast<int>(streams.max_streams()), item));
+
+  int stream = streams.acquire(42);
+  ASSERT_GE(stream, 0);
+  EXPECT_TRUE(streams.get(stream, item));
+  EXPECT_EQ(42, item);
+
+  streams.release(stream);
+  EXPECT_FALSE(streams.get(stream, item));
+}
+
+static void print_benchmark(const char* name, uint64_t start) {
+  double elapsed = static_cast<double>(uv_hrtime() - start);
+  printf("%-32s %8.2f ns/op\n", name, elapsed / BENCHMARK_NUM_ITERATIONS);
+}
+
+// Run using: --gtest_also_run_disabled_tests --gtest_filter=*StreamManager*Benchmark*
+TEST(StreamManagerUnitTest, DISABLED_BenchmarkFewPending)
+{
+  cass::StreamManager<int> streams;
+
+  // Acquire, lookup and release with a handful of requests in flight
+  int pending[8];
+  for (int i = 0; i < 8; ++i) {
+    pending[i] = streams.acquire(i);
+  }
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < BENCHMARK_NUM_ITERATIONS; ++i) {
+    int& stream = pending[i % 8];
+    int item;
+    streams.get(stream, item);
+    streams.release(stream);
+    stream = streams.acquire(i);
+  }
+  print_benchmark("acquire/get/release (8 pending)", start);
+}
+
+TEST(StreamManagerUnitTest, DISABLED_BenchmarkNearlyFull)
+{
+  cass::StreamManager<int> streams;
+
+  // Acquire, lookup and release when only one stream is ever available
+  for (size_t i = 0; i < streams.max_streams(); ++i) {
+    streams.acquire(i);
+  }
+
+  uint64_t start = uv_hrtime();
+  for (int i = 0; i < BENCHMARK_NUM_ITERATIONS; ++i) {
+    // Spread the free stream across the whole range
+    int stream = static_cast<int>((static_cast<size_t>(i) * 7919) % streams.max_streams());
+    int item;
+    streams.get(stream, item);
+    streams.release(stream);
+    streams.acquire(i);
+  }
+  print_benchmark("acquire/get/release (full)", start);
+}
@@ -0,0 +1,223 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "timer_wheel.hpp"
+
+#include "loop_test.hpp"
+
+using namespace cass;
+
+class TimerWheelUnitTest : public LoopTest {
+public:
+  TimerWheelUnitTest()
+    : count_(0)
+    , other_(NULL)
+    , start_time_(0) { }
+
+  virtual void SetUp() {
+    LoopTest::SetUp();
+    wheel_.init(loop());
+    start_time_ = uv_now(loop());
+  }
+
+  virtual void TearDown() {
+    wheel_.close_handles();
+    uv_run(loop(), UV_RUN_DEFAULT);
+    LoopTest::TearDown();
+  }
+
+  TimerWheel* wheel() { return &wheel_; }
+
+  WheelTimer::Callback once() {
+    return bind_callback(&TimerWheelUnitTest::on_timer_once, this);
+  }
+
+  WheelTimer::Callback restart() {
+    return bind_callback(&TimerWheelUnitTest::on_timer_restart, this);
+  }
+
+  LoopTimer::Callback loop_once() {
+    return bind_callback(&TimerWheelUnitTest::on_loop_timer, this);
+  }
+
+  WheelTimer::Callback stop_other(WheelTimer* other) {
+    other_ = other;
+    return bind_callback(&TimerWheelUnitTest::on_timer_stop_other, this);
+  }
+
+protected:
+  struct Expected {
+    Expected()
+      : test(NULL)
+      , timeout(0)
+      , elapsed(0)
+      , order(-1) { }
+
+    TimerWheelUnitTest* test;
+    WheelTimer timer;
+    uint64_t timeout;
+    uint64_t elapsed;
+    int order;
+  };
+
+  void start(Expected* expected, uint64_t timeout) {
+    expected->test = this;
+    expected->timeout = timeout;
+    expected->timer.start(wheel(), timeout,
+                          bind_callback(&TimerWheelUnitTest::on_expected, expected));
+  }
+
+  static void on_expected(WheelTimer* timer, Expected* expected) {
+    EXPECT_FALSE(timer->is_running());
+    TimerWheelUnitTest* test = expected->test;
+    expected->elapsed = uv_now(test->loop()) - test->start_time_;
+    expected->order = test->count_++;
+  }
+
+  void on_timer_once(WheelTimer* timer) {
+    EXPECT_FALSE(timer->is_running());
+    count_++;
+  }
+
+  void on_timer_restart(WheelTimer* timer) {
+    count_++;
+    if (count_ == 1) {
+      timer->start(wheel(), 1, restart());
+    }
+  }
+
+  void on_timer_stop_other(WheelTimer* timer) {
+    count_++;
+    other_->stop();
+  }
+
+  void on_loop_timer(LoopTimer* timer) {
+    EXPECT_FALSE(timer->is_running());
+    count_++;
+  }
+
+  int count_;
+  WheelTimer* other_;
+  uint64_t start_time_;
+
+private:
+  TimerWheel wheel_;
+};
+
+TEST_F(TimerWheelUnitTest, Once) {
+  WheelTimer timer;
+  timer.start(wheel(), 5, once());
+  EXPECT_TRUE(timer.is_running());
+  EXPECT_EQ(wheel()->size(), 1u);
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_FALSE(timer.is_running());
+  EXPECT_EQ(wheel()->size(), 0u);
+  EXPECT_EQ(count_, 1);
+}
+
+TEST_F(TimerWheelUnitTest, Zero) {
+  WheelTimer timer;
+  timer.start(wheel(), 0, once());
+  uv_run(loop(), UV_RUN_DEFAULT);
+  EXPECT_EQ(count_, 1);
+}
+
+TEST_F(TimerWheelUnitTest, Stop) {
+  WheelTimer timer;
+  timer.start(wheel(), 1, once());
+  timer.stop();
+  EXPECT_FALSE(timer.is_running());
+  EXPECT_EQ(wheel()->size(), 0u);
+
+  // The driving timer fires once, finds nothing and stops
+  uv_run(loop(), UV_RUN_DEFAULT);
+  EXPECT_EQ(count_, 0);
+}
+
+TEST_F(TimerWheelUnitTest, Restart) {
+  WheelTimer timer;
+  timer.start(wheel(), 1, restart());
+  // Starting a running timer moves it
+  timer.start(wheel(), 2, restart());
+  EXPECT_EQ(wheel()->size(), 1u);
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+  EXPECT_EQ(count_, 2);
+}
+
+TEST_F(TimerWheelUnitTest, Order) {
+  // These cover the root level and the first cascaded level
+  const uint64_t timeouts[] = { 300, 2, 17, 0, 256, 255, 40, 257, 520 };
+  const size_t num_timeouts = sizeof(timeouts) / sizeof(timeouts[0]);
+
+  Expected expected[num_timeouts];
+  for (size_t i = 0; i < num_timeouts; ++i) {
+    start(&expected[i], timeouts[i]);
+  }
+  EXPECT_EQ(wheel()->size(), num_timeouts);
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(count_, static_cast<int>(num_timeouts));
+  for (size_t i = 0; i < num_timeouts; ++i) {
+    EXPECT_GE(expected[i].elapsed, expected[i].timeout);
+    int earlier = 0;
+    for (size_t j = 0; j < num_timeouts; ++j) {
+      if (timeouts[j] < timeouts[i]) earlier++;
+    }
+    EXPECT_EQ(expected[i].order, earlier) << "Timeout " << timeouts[i];
+  }
+}
+
+TEST_F(TimerWheelUnitTest, StopFromCallback) {
+  WheelTimer first, second;
+  first.start(wheel(), 3, stop_other(&second));
+  second.start(wheel(), 3, once());
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(count_, 1);
+  EXPECT_FALSE(second.is_running());
+}
+
+TEST_F(TimerWheelUnitTest, Close) {
+  WheelTimer timer;
+  timer.start(wheel(), 10 * 1000, once());
+
+  wheel()->close_handles();
+  EXPECT_FALSE(timer.is_running());
+  EXPECT_EQ(wheel()->size(), 0u);
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+  EXPECT_EQ(count_, 0);
+}
+
+TEST_F(TimerWheelUnitTest, LoopTimerWithoutEventLoop) {
+  // A loop that isn't run by an event loop doesn't have a wheel
+  loop()->data = NULL;
+
+  LoopTimer timer;
+  timer.start(loop(), 5, loop_once());
+  EXPECT_TRUE(timer.is_running());
+  EXPECT_EQ(wheel()->size(), 0u);
+
+  uv_run(loop(), UV_RUN_DEFAULT);
+
+  EXPECT_EQ(count_, 1);
+  EXPECT_FALSE(timer.is_running());
+}
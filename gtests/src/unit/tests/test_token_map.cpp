@@ -462,3 +462,150 @@ TEST(TokenMapUnitTest, DropKeyspace)
     EXPECT_FALSE(replicas);
   }
 }
+
+TEST(TokenMapUnitTest, KeyspaceIds)
+{
+  TestTokenMap<cass::Murmur3Partitioner> test_keyspace_ids;
+
+  test_keyspace_ids.add_host(create_host("1.0.0.1", single_token(CASS_INT64_MIN / 2)));
+  test_keyspace_ids.add_host(create_host("1.0.0.2", single_token(0)));
+  test_keyspace_ids.add_host(create_host("1.0.0.3", single_token(CASS_INT64_MAX / 2)));
+
+  test_keyspace_ids.build("ks", 2);
+
+  cass::TokenMap* token_map = test_keyspace_ids.token_map.get();
+
+  uint32_t keyspace_id = token_map->get_keyspace_id("ks");
+  EXPECT_NE(keyspace_id, 0u);
+  EXPECT_EQ(token_map->get_keyspace_id("invalid"), 0u);
+  EXPECT_FALSE(token_map->get_replicas(0, "abc"));
+
+  {
+    const cass::CopyOnWriteHostVec& replicas = token_map->get_replicas(keyspace_id, "abc");
+    ASSERT_TRUE(replicas && replicas->size() == 2);
+    EXPECT_EQ((*replicas)[0]->address(), cass::Address("1.0.0.1", 9042));
+  }
+
+  // Copies keep the keyspace identifiers, but are different instances
+  cass::TokenMap::Ptr copy(token_map->copy());
+  EXPECT_NE(copy->instance_id(), token_map->instance_id());
+  EXPECT_EQ(copy->get_keyspace_id("ks"), keyspace_id);
+
+  // The identifier doesn't change if a keyspace is dropped and recreated
+  copy->drop_keyspace("ks");
+  EXPECT_FALSE(copy->get_replicas(keyspace_id, "abc"));
+  add_keyspace_simple("ks", 2, copy.get());
+  copy->build();
+  EXPECT_EQ(copy->get_keyspace_id("ks"), keyspace_id);
+  EXPECT_TRUE(copy->get_replicas(keyspace_id, "abc"));
+}
+
+namespace {
+
+// Verify that the replicas of an incrementally updated token map are the same
+// as the replicas of a token map fully rebuilt from the same hosts.
+void verify_same_as_rebuilt(const cass::TokenMap* token_map,
+                            const cass::Vector<cass::String>& keyspace_names) {
+  cass::TokenMap::Ptr rebuilt(token_map->copy());
+  rebuilt->build();
+
+  for (cass::Vector<cass::String>::const_iterator i = keyspace_names.begin(),
+       end = keyspace_names.end(); i != end; ++i) {
+    for (int k = 0; k < 2000; ++k) {
+      cass::OStringStream ss;
+      ss << "key" << k;
+      const cass::CopyOnWriteHostVec& expected = rebuilt->get_replicas(*i, ss.str());
+      const cass::CopyOnWriteHostVec& replicas = token_map->get_replicas(*i, ss.str());
+      ASSERT_TRUE(expected && replicas);
+      ASSERT_EQ(expected->size(), replicas->size()) << *i << " " << ss.str();
+      for (size_t j = 0; j < expected->size(); ++j) {
+        EXPECT_EQ((*expected)[j].get(), (*replicas)[j].get()) << *i << " " << ss.str();
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(TokenMapUnitTest, IncrementalUpdateMurmur3)
+{
+  MT19937_64 rng;
+  cass::TokenMap::Ptr token_map(cass::TokenMap::from_partitioner(cass::Murmur3Partitioner::name()));
+
+  cass::HostVec hosts(create_murmur3_ring(rng, 24, 16, 3, 2));
+  for (cass::HostVec::const_iterator i = hosts.begin(),
+       end = hosts.end(); i != end; ++i) {
+    token_map->add_host(*i);
+  }
+
+  cass::Vector<cass::String> keyspace_names;
+  add_keyspaces_network_topology("ks", 2, 3, 3, token_map.get());
+  keyspace_names.push_back("ks1");
+  ReplicationMap replication;
+  replication["dc1"] = "2";
+  replication["dc3"] = "1";
+  add_keyspace_network_topology("ks_nts", replication, token_map.get());
+  keyspace_names.push_back("ks_nts");
+  add_keyspace_simple("ks_simple", 3, token_map.get());
+  keyspace_names.push_back("ks_simple");
+  token_map->build();
+
+  // Remove hosts (also removing the last host of a rack in "dc3")
+  token_map->remove_host_and_build(hosts[0]);
+  verify_same_as_rebuilt(token_map.get(), keyspace_names);
+  token_map->remove_host_and_build(hosts[5]);
+  verify_same_as_rebuilt(token_map.get(), keyspace_names);
+
+  // Add new hosts
+  cass::HostVec new_hosts(create_murmur3_ring(rng, 30, 16, 3, 2));
+  for (size_t i = 24; i < new_hosts.size(); ++i) {
+    token_map->update_host_and_build(new_hosts[i]);
+    verify_same_as_rebuilt(token_map.get(), keyspace_names);
+  }
+
+  // Update an existing host with new tokens in a different rack
+  token_map->update_host_and_build(create_host(hosts[1]->address(),
+                                               random_murmur3_tokens(rng, 16),
+                                               cass::Murmur3Partitioner::name().to_string(),
+                                               "rack2", hosts[1]->dc()));
+  verify_same_as_rebuilt(token_map.get(), keyspace_names);
+
+  // Remove many hosts so that replication factors exceed the number of hosts
+  for (size_t i = 6; i < hosts.size(); ++i) {
+    token_map->remove_host_and_build(hosts[i]);
+    verify_same_as_rebuilt(token_map.get(), keyspace_names);
+  }
+}
+
+TEST(TokenMapUnitTest, SharedReplicas)
+{
+  MT19937_64 rng;
+  cass::TokenMap::Ptr token_map(cass::TokenMap::from_partitioner(cass::Murmur3Partitioner::name()));
+
+  cass::HostVec hosts(create_murmur3_ring(rng, 6, 16, 2, 1));
+  for (cass::HostVec::const_iterator i = hosts.begin(),
+       end = hosts.end(); i != end; ++i) {
+    token_map->add_host(*i);
+  }
+
+  add_keyspaces_network_topology("ks", 2, 2, 3, token_map.get());
+  add_keyspace_simple("ks_simple", 3, token_map.get());
+  token_map->build();
+
+  const cass::CopyOnWriteHostVec& ks1 = token_map->get_replicas("ks1", "abc");
+  const cass::CopyOnWriteHostVec& ks2 = token_map->get_replicas("ks2", "abc");
+  const cass::CopyOnWriteHostVec& ks_simple = token_map->get_replicas("ks_simple", "abc");
+  ASSERT_TRUE(ks1 && ks2 && ks_simple);
+
+  // Keyspaces with the same replication strategy share replicas
+  EXPECT_EQ(&*ks1, &*ks2);
+  EXPECT_NE(&*ks1, &*ks_simple);
+
+  // Copies share replicas until they're changed
+  cass::TokenMap::Ptr copy(token_map->copy());
+  EXPECT_EQ(&*copy->get_replicas("ks1", "abc"), &*ks1);
+
+  copy->remove_host_and_build(hosts[0]);
+  EXPECT_EQ(&*copy->get_replicas("ks1", "abc"), &*copy->get_replicas("ks2", "abc"));
+  EXPECT_EQ(&*token_map->get_replicas("ks1", "abc"), &*ks1);
+}
@@ -220,6 +220,13 @@ typedef struct CassPrepared_ CassPrepared;
  */
 typedef struct CassResult_ CassResult;
 
+/**
+ * The rows of a result decoded into columns.
+ *
+ * @struct CassResultColumns
+ */
+typedef struct CassResultColumns_ CassResultColumns;
+
 /**
  * A error result of a request
  *
@@ -443,6 +450,112 @@ typedef struct CassSpeculativeExecutionMetrics_ {
   cass_double_t percentage; /**< Fraction of requests that are aborted speculative retries */
 } CassSpeculativeExecutionMetrics;
 
+/**
+ * A snapshot of the session's request coalescing metrics. A sample is
+ * recorded each time an I/O thread flushes coalesced requests.
+ *
+ * @struct CassCoalesceMetrics
+ */
+typedef struct CassCoalesceMetrics_ {
+  struct {
+    cass_uint64_t min; /**< Minimum in microseconds */
+    cass_uint64_t max; /**< Maximum in microseconds */
+    cass_uint64_t mean; /**< Mean in microseconds */
+    cass_uint64_t stddev; /**< Standard deviation in microseconds */
+    cass_uint64_t median; /**< Median in microseconds */
+    cass_uint64_t percentile_75th; /**< 75th percentile in microseconds */
+    cass_uint64_t percentile_95th; /**< 95th percentile in microseconds */
+    cass_uint64_t percentile_98th; /**< 98th percentile in microseconds */
+    cass_uint64_t percentile_99th; /**< 99th percentile in microseconds */
+    cass_uint64_t percentile_999th; /**< 99.9th percentile in microseconds */
+  } delays; /**< Time spent waiting for requests to coalesce */
+
+  struct {
+    cass_uint64_t min; /**< Minimum */
+    cass_uint64_t max; /**< Maximum */
+    cass_uint64_t mean; /**< Mean */
+    cass_uint64_t stddev; /**< Standard deviation */
+    cass_uint64_t median; /**< Median */
+    cass_uint64_t percentile_75th; /**< 75th percentile */
+    cass_uint64_t percentile_95th; /**< 95th percentile */
+    cass_uint64_t percentile_98th; /**< 98th percentile */
+    cass_uint64_t percentile_99th; /**< 99th percentile */
+    cass_uint64_t percentile_999th; /**< 99.9th percentile */
+  } writes_per_flush; /**< Requests written per flush */
+
+  struct {
+    cass_uint64_t min; /**< Minimum */
+    cass_uint64_t max; /**< Maximum */
+    cass_uint64_t mean; /**< Mean */
+    cass_uint64_t stddev; /**< Standard deviation */
+    cass_uint64_t median; /**< Median */
+    cass_uint64_t percentile_75th; /**< 75th percentile */
+    cass_uint64_t percentile_95th; /**< 95th percentile */
+    cass_uint64_t percentile_98th; /**< 98th percentile */
+    cass_uint64_t percentile_99th; /**< 99th percentile */
+    cass_uint64_t percentile_999th; /**< 99.9th percentile */
+  } reads_per_flush; /**< Responses read per flush */
+} CassCoalesceMetrics;
+
+/**
+ * A snapshot of the session's admission control and request queue metrics.
+ *
+ * @struct CassAdmissionMetrics
+ *
+ * @see cass_cluster_set_max_in_flight_requests()
+ */
+typedef struct CassAdmissionMetrics_ {
+  cass_uint64_t request_queue_depth; /**< Requests handed to the I/O threads that haven't finished */
+  cass_uint64_t waiting_requests; /**< Requests waiting for an in-flight request to finish */
+  cass_uint64_t rejected_requests; /**< Requests that failed because the in-flight limit was reached */
+  cass_uint64_t in_flight_bytes; /**< Request bytes written and waiting on a response */
+  cass_uint64_t stolen_requests; /**< Requests taken from a busier I/O thread's queue (work stealing) */
+  cass_uint64_t queue_latency_skew_us; /**< Difference in the average time requests spend queued between the slowest and fastest I/O threads (microseconds) */
+} CassAdmissionMetrics;
+
+/**
+ * A snapshot of the metrics for a single host. Only hosts that the session
+ * has connected to (a connection pool was created) have metrics.
+ *
+ * @struct CassHostMetrics
+ *
+ * @see cass_iterator_host_metrics_from_session()
+ */
+typedef struct CassHostMetrics_ {
+  CassInet address; /**< The address of the host */
+
+  struct {
+    cass_uint64_t min; /**< Minimum in microseconds */
+    cass_uint64_t max; /**< Maximum in microseconds */
+    cass_uint64_t mean; /**< Mean in microseconds */
+    cass_uint64_t stddev; /**< Standard deviation in microseconds */
+    cass_uint64_t median; /**< Median in microseconds */
+    cass_uint64_t percentile_75th; /**< 75th percentile in microseconds */
+    cass_uint64_t percentile_95th; /**< 95th percentile in microseconds */
+    cass_uint64_t percentile_98th; /**< 98th percentile in microseconds */
+    cass_uint64_t percentile_99th; /**< 99th percentile in microseconds */
+    cass_uint64_t percentile_999th; /**< 99.9th percentile in microseconds */
+    cass_double_t mean_rate; /**<  Mean rate in requests per second */
+    cass_double_t one_minute_rate; /**< 1 minute rate in requests per second */
+    cass_double_t five_minute_rate; /**<  5 minute rate in requests per second */
+    cass_double_t fifteen_minute_rate; /**< 15 minute rate in requests per second */
+  } requests; /**< Performance request metrics (latencies are within 1%) */
+
+  struct {
+    cass_uint64_t in_flight_requests; /**< Requests written and waiting on a response */
+    cass_uint64_t total_connections; /**< The number of connections to the host */
+    cass_uint64_t bytes_written; /**< Request bytes written */
+    cass_uint64_t bytes_read; /**< Response bytes read */
+    cass_uint64_t stream_exhaustions; /**< Writes that failed because a connection had no free stream IDs */
+    cass_uint64_t in_flight_bytes; /**< Request bytes written and waiting on a response */
+  } stats; /**< Diagnostic metrics */
+
+  struct {
+    cass_uint64_t errors; /**< Error responses from the host */
+    cass_uint64_t retries; /**< Error responses that were retried by the retry policy */
+  } errors; /**< Error metrics */
+} CassHostMetrics;
+
 typedef enum CassConsistency_ {
   CASS_CONSISTENCY_UNKNOWN      = 0xFFFF,
   CASS_CONSISTENCY_ANY          = 0x0000,
@@ -589,7 +702,8 @@ typedef enum CassIteratorType_ {
   CASS_ITERATOR_TYPE_AGGREGATE_META,
   CASS_ITERATOR_TYPE_COLUMN_META,
   CASS_ITERATOR_TYPE_INDEX_META,
-  CASS_ITERATOR_TYPE_MATERIALIZED_VIEW_META
+  CASS_ITERATOR_TYPE_MATERIALIZED_VIEW_META,
+  CASS_ITERATOR_TYPE_HOST_METRICS
 } CassIteratorType;
 
 #define CASS_LOG_LEVEL_MAPPING(XX) \
@@ -633,6 +747,46 @@ typedef enum CassProtocolVersion_ {
                                            driver with DataStax Enterprise */
 } CassProtocolVersion;
 
+typedef enum CassCompression_ {
+  CASS_COMPRESSION_NONE   = 0x00,
+  CASS_COMPRESSION_LZ4    = 0x01, /**< Requires the driver to be built with LZ4 */
+  CASS_COMPRESSION_SNAPPY = 0x02, /**< Requires the driver to be built with Snappy */
+  CASS_COMPRESSION_AUTO   = 0x03  /**< Use the first algorithm supported by
+                                       both the driver and the server */
+} CassCompression;
+
+typedef enum CassRequestDispatch_ {
+  CASS_REQUEST_DISPATCH_LEAST_BUSY,           /**< Scan every I/O thread for the
+                                                   fewest in-flight requests */
+  CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES, /**< Pick the less busy of two
+                                                   random I/O threads */
+  CASS_REQUEST_DISPATCH_THREAD_AFFINITY,      /**< Each application thread
+                                                   always uses the same I/O
+                                                   thread */
+  CASS_REQUEST_DISPATCH_TOKEN_AFFINITY,       /**< Requests with the same
+                                                   routing key always use the
+                                                   same I/O thread */
+  CASS_REQUEST_DISPATCH_CPU_AFFINITY          /**< Requests use the I/O thread
+                                                   pinned to the calling
+                                                   thread's CPU */
+} CassRequestDispatch;
+
+typedef enum CassAdmissionMode_ {
+  CASS_ADMISSION_MODE_FAIL, /**< Fail requests when the in-flight limit is
+                                 reached */
+  CASS_ADMISSION_MODE_WAIT  /**< Queue requests until an in-flight request
+                                 finishes */
+} CassAdmissionMode;
+
+typedef enum CassCoalesceMode_ {
+  CASS_COALESCE_MODE_FIXED,              /**< Always wait the coalesce delay */
+  CASS_COALESCE_MODE_ADAPTIVE_LATENCY,   /**< Only wait when requests arrive
+                                              fast enough to fill a small
+                                              batch */
+  CASS_COALESCE_MODE_ADAPTIVE_THROUGHPUT /**< Wait long enough to fill a
+                                              large batch */
+} CassCoalesceMode;
+
 typedef enum  CassErrorSource_ {
   CASS_ERROR_SOURCE_NONE,
   CASS_ERROR_SOURCE_LIB,
@@ -677,6 +831,7 @@ typedef enum  CassErrorSource_ {
   XX(CASS_ERROR_SOURCE_LIB, CASS_ERROR_LIB_NO_CUSTOM_PAYLOAD, 33, "No custom payload") \
   XX(CASS_ERROR_SOURCE_LIB, CASS_ERROR_LIB_EXECUTION_PROFILE_INVALID, 34, "Invalid execution profile specified") \
   XX(CASS_ERROR_SOURCE_LIB, CASS_ERROR_LIB_NO_TRACING_ID, 35, "No tracing ID") \
+  XX(CASS_ERROR_SOURCE_LIB, CASS_ERROR_LIB_UNABLE_TO_EXECUTE, 36, "Unable to execute request") \
   XX(CASS_ERROR_SOURCE_SERVER, CASS_ERROR_SERVER_SERVER_ERROR, 0x0000, "Server error") \
   XX(CASS_ERROR_SOURCE_SERVER, CASS_ERROR_SERVER_PROTOCOL_ERROR, 0x000A, "Protocol error") \
   XX(CASS_ERROR_SOURCE_SERVER, CASS_ERROR_SERVER_BAD_CREDENTIALS, 0x0100, "Bad credentials") \
@@ -730,6 +885,21 @@ typedef enum CassError_ {
 typedef void (*CassFutureCallback)(CassFuture* future,
                                    void* data);
 
+/**
+ * A callback that receives some of the rows of a statement's result as they
+ * arrive.
+ *
+ * @param[in] rows A result that only has the rows that were received since
+ * the last call (and the result's metadata). It's only valid for the duration
+ * of the callback.
+ * @param[in] data user defined data provided when the callback
+ * was registered.
+ *
+ * @see cass_statement_set_rows_callback()
+ */
+typedef void (*CassResultRowsCallback)(const CassResult* rows,
+                                       void* data);
+
 /**
  * Maximum size of a log message
  */
@@ -1774,6 +1944,59 @@ CASS_EXPORT CassError
 cass_cluster_set_new_request_ratio(CassCluster* cluster,
                                    cass_int32_t ratio);
 
+/**
+ * Sets how the amount of time spent waiting for new requests to coalesce is
+ * chosen.
+ *
+ * <ul>
+ *   <li>CASS_COALESCE_MODE_FIXED: Always wait the coalesce delay.</li>
+ *   <li>CASS_COALESCE_MODE_ADAPTIVE_LATENCY: Wait only as long as it takes
+ *   for a few requests to arrive. Sparse requests are written almost
+ *   immediately.</li>
+ *   <li>CASS_COALESCE_MODE_ADAPTIVE_THROUGHPUT: Wait as long as it takes for
+ *   many requests to arrive to reduce the number of system calls.</li>
+ * </ul>
+ *
+ * The adaptive modes measure the request arrival rate and the time spent
+ * handling I/O on each I/O thread. The coalesce delay is used as the maximum
+ * amount of time to wait.
+ *
+ * <b>Default:</b> CASS_COALESCE_MODE_FIXED
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] mode
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_cluster_set_coalesce_delay()
+ * @see cass_session_get_coalesce_metrics()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_coalesce_mode(CassCluster* cluster,
+                               CassCoalesceMode mode);
+
+/**
+ * Sets the port of a local HTTP server that exposes the session's metrics
+ * as OpenMetrics (Prometheus) text. The server listens on the loopback
+ * interface (127.0.0.1) and is run by one of the session's I/O threads.
+ * Every GET request is answered with the same text as
+ * cass_session_get_metrics_text().
+ *
+ * <b>Default:</b> 0 (disabled)
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] port The port to listen on, or 0 to disable the server.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_session_get_metrics_text()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_metrics_exporter_port(CassCluster* cluster,
+                                       int port);
+
 /**
  * Sets the maximum number of connections that will be created concurrently.
  * Connections are created when the current connections are unable to keep up with
@@ -2672,6 +2895,262 @@ CASS_EXPORT CassError
 cass_cluster_set_no_compact(CassCluster* cluster,
                             cass_bool_t enabled);
 
+/**
+ * Sets the compression algorithm used for frame bodies (protocol v3 and v4).
+ * The algorithm is negotiated with each host using its <b>SUPPORTED</b>
+ * response and a connection falls back to uncompressed frames if the host
+ * doesn't support the requested algorithm.
+ *
+ * <b>Default:</b> CASS_COMPRESSION_NONE
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] compression
+ * @return CASS_OK if successful, otherwise CASS_ERROR_LIB_NOT_IMPLEMENTED if
+ * the driver wasn't built with support for the algorithm.
+ *
+ * @see cass_cluster_set_compression_threshold()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_compression(CassCluster* cluster,
+                             CassCompression compression);
+
+/**
+ * Sets the minimum size of a request frame body to compress. Smaller frames
+ * are sent uncompressed because the overhead outweighs the bandwidth saved.
+ *
+ * <b>Default:</b> 512 (bytes)
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] threshold_bytes
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_compression()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_compression_threshold(CassCluster* cluster,
+                                       unsigned threshold_bytes);
+
+/**
+ * Sets the strategy used to choose the I/O thread that processes a request.
+ *
+ * The default strategy scans every I/O thread for the one with the fewest
+ * in-flight requests. With many I/O threads and many application threads
+ * the scan contends on shared cache lines, and the other strategies avoid
+ * this:
+ *
+ * <ul>
+ *   <li>CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES: Compare the load of only
+ *   two randomly chosen I/O threads.</li>
+ *   <li>CASS_REQUEST_DISPATCH_THREAD_AFFINITY: Don't compare load at all;
+ *   each application thread is pinned to one I/O thread.</li>
+ *   <li>CASS_REQUEST_DISPATCH_TOKEN_AFFINITY: Requests for the same partition
+ *   are always processed by the same I/O thread. Requests without a routing
+ *   key fall back to power of two choices.</li>
+ *   <li>CASS_REQUEST_DISPATCH_CPU_AFFINITY: Requests are processed by the I/O
+ *   thread pinned to the CPU the calling thread is running on, so that the
+ *   request doesn't cross cores. Calls from CPUs without a pinned I/O thread
+ *   fall back to power of two choices. This requires pinned I/O
+ *   threads.</li>
+ * </ul>
+ *
+ * <b>Default:</b> CASS_REQUEST_DISPATCH_LEAST_BUSY
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] dispatch
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_num_threads_io()
+ * @see cass_cluster_set_io_thread_cpus()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_request_dispatch(CassCluster* cluster,
+                                  CassRequestDispatch dispatch);
+
+/**
+ * Pins the I/O threads to CPUs. The first I/O thread is pinned to the first
+ * CPU, the second to the second and so on, wrapping around if there are
+ * more I/O threads than CPUs. Memory that an I/O thread allocates for its
+ * connections is first used on its CPU so it's placed on that CPU's NUMA
+ * node by the operating system.
+ *
+ * Use with CASS_REQUEST_DISPATCH_CPU_AFFINITY and application threads that
+ * are pinned to the same CPUs for a shared-nothing setup where requests
+ * don't cross cores.
+ *
+ * <b>Note:</b> This is only supported on Linux and Windows. A warning is
+ * logged if a thread can't be pinned.
+ *
+ * <b>Default:</b> Not pinned
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] cpus The CPU numbers (starting at 0).
+ * @param[in] cpus_count The number of CPUs, or 0 to not pin the threads.
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_num_threads_io()
+ * @see cass_cluster_set_request_dispatch()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_io_thread_cpus(CassCluster* cluster,
+                                const unsigned* cpus,
+                                size_t cpus_count);
+
+/**
+ * Enable zero-copy decoding of response bodies.
+ *
+ * When enabled, responses that are completely contained in a single socket
+ * read reference a slice of the read buffer instead of copying the response
+ * body into a newly allocated buffer. Responses that straddle multiple reads
+ * are still copied. This reduces memory bandwidth on the I/O threads for
+ * large results, but a result that's held by the application keeps its
+ * entire read buffer (64KB) alive.
+ *
+ * <b>Note:</b> This has no effect on SSL connections.
+ *
+ * <b>Default:</b> cass_false
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ * @return CASS_OK if successful, otherwise an error occurred
+ */
+CASS_EXPORT CassError
+cass_cluster_set_zero_copy_responses(CassCluster* cluster,
+                                     cass_bool_t enabled);
+
+/**
+ * Sets the maximum amount of time, in microseconds, that a thread waiting on
+ * a request's future spins checking for the result before blocking. Spinning
+ * avoids the cost of putting the waiting thread to sleep and waking it up,
+ * which can dominate the latency of synchronous requests that complete in
+ * less than a millisecond, at the cost of CPU time while waiting.
+ *
+ * The waiting thread checks the future in a tight loop at first, then yields
+ * to other threads between checks until the spin time has elapsed.
+ *
+ * <b>Default:</b> 0 (disabled; waiting threads block immediately)
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] spin_time_us
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_future_wait()
+ * @see cass_future_wait_timed()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_future_wait_spin_time(CassCluster* cluster,
+                                       unsigned spin_time_us);
+
+/**
+ * Sets the maximum number of requests that a session can have in flight. A
+ * request is in flight from the time it's executed until its future is set.
+ * What happens to requests executed when the limit is reached depends on the
+ * admission mode.
+ *
+ * <b>Default:</b> 0 (unlimited)
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] max_requests
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_admission_mode()
+ * @see cass_session_get_admission_metrics()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_max_in_flight_requests(CassCluster* cluster,
+                                        unsigned max_requests);
+
+/**
+ * Sets how requests are handled when the session's in-flight limit is
+ * reached.
+ *
+ * <ul>
+ *   <li>CASS_ADMISSION_MODE_FAIL: The request's future is immediately set
+ *   with CASS_ERROR_LIB_REQUEST_QUEUE_FULL.</li>
+ *   <li>CASS_ADMISSION_MODE_WAIT: The request waits, in order, until an
+ *   in-flight request finishes. Its future is set once it has been executed.
+ *   The number of waiting requests is bounded by the I/O queue size; requests
+ *   beyond that fail with CASS_ERROR_LIB_REQUEST_QUEUE_FULL. Waiting requests
+ *   fail if the session is closed.</li>
+ * </ul>
+ *
+ * <b>Default:</b> CASS_ADMISSION_MODE_FAIL
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] mode
+ * @return CASS_OK if successful, otherwise an error occurred
+ *
+ * @see cass_cluster_set_max_in_flight_requests()
+ * @see cass_cluster_set_queue_size_io()
+ */
+CASS_EXPORT CassError
+cass_cluster_set_admission_mode(CassCluster* cluster,
+                                CassAdmissionMode mode);
+
+/**
+ * Sets the maximum number of requests that each I/O thread can have in
+ * flight to a single host. A host that has reached the limit is skipped and
+ * the next host in the query plan is tried.
+ *
+ * Requests are not queued at this limit. If no host in the query plan can
+ * take the request and at least one of them was skipped because of the limit
+ * then the request fails with CASS_ERROR_LIB_REQUEST_QUEUE_FULL (instead of
+ * CASS_ERROR_LIB_NO_HOSTS_AVAILABLE) and it can be retried later. Use
+ * cass_cluster_set_max_in_flight_requests() with CASS_ADMISSION_MODE_WAIT to
+ * have requests wait instead.
+ *
+ * <b>Default:</b> 0 (unlimited)
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] max_requests
+ * @return CASS_OK if successful, otherwise an error occurred
+ */
+CASS_EXPORT CassError
+cass_cluster_set_max_in_flight_requests_per_host(CassCluster* cluster,
+                                                 unsigned max_requests);
+
+/**
+ * Enable/Disable work stealing between I/O threads. When enabled, an I/O
+ * thread that has run out of requests takes queued requests from a busier
+ * I/O thread and executes them on its own connections. This evens out the
+ * load when some I/O threads are slowed down, e.g. by large responses.
+ *
+ * <b>Note:</b> This has no effect with a single I/O thread. Requests that
+ * are moved to another I/O thread lose the affinity chosen by the request
+ * dispatch strategy.
+ *
+ * <b>Default:</b> cass_false (disabled).
+ *
+ * @public @memberof CassCluster
+ *
+ * @param[in] cluster
+ * @param[in] enabled
+ *
+ * @see cass_cluster_set_num_threads_io()
+ * @see cass_cluster_set_request_dispatch()
+ * @see cass_session_get_admission_metrics()
+ */
+CASS_EXPORT void
+cass_cluster_set_work_stealing(CassCluster* cluster,
+                               cass_bool_t enabled);
+
 /**
  * Sets a callback for handling host state changes in the cluster.
  *
@@ -2857,6 +3336,32 @@ CASS_EXPORT CassFuture*
 cass_session_execute(CassSession* session,
                      const CassStatement* statement);
 
+/**
+ * Execute several statements. This is equivalent to calling
+ * cass_session_execute() for each statement, but the statements are queued
+ * together, which reduces the cost of submitting a large number of
+ * independent statements at once.
+ *
+ * <b>Note:</b> This is not a batch statement. Each statement is executed
+ * independently and has its own future.
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @param[in] statements An array of statements.
+ * @param[in] statements_count The number of statements.
+ * @param[out] output An array of at least statements_count elements that's
+ * populated with a future for each statement, in the same order as the
+ * statements. The futures must be freed.
+ *
+ * @see cass_session_execute()
+ */
+CASS_EXPORT void
+cass_session_execute_many(CassSession* session,
+                          const CassStatement* const* statements,
+                          size_t statements_count,
+                          CassFuture** output);
+
 /**
  * Execute a batch statement.
  *
@@ -2914,6 +3419,65 @@ CASS_EXPORT void
 cass_session_get_speculative_execution_metrics(const CassSession* session,
                                                CassSpeculativeExecutionMetrics* output);
 
+/**
+ * Gets a copy of this session's request coalescing metrics.
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @param[out] output
+ *
+ * @see cass_cluster_set_coalesce_mode()
+ */
+CASS_EXPORT void
+cass_session_get_coalesce_metrics(const CassSession* session,
+                                  CassCoalesceMetrics* output);
+
+/**
+ * Gets a copy of this session's admission control and request queue
+ * metrics. These can be used to shed load before the session's limits are
+ * reached.
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @param[out] output
+ *
+ * @see cass_cluster_set_max_in_flight_requests()
+ */
+CASS_EXPORT void
+cass_session_get_admission_metrics(const CassSession* session,
+                                   CassAdmissionMetrics* output);
+
+/**
+ * Renders all of this session's metrics as OpenMetrics (Prometheus) text.
+ * Unlike the metrics structs, the latency and coalescing histograms are
+ * rendered with all of their buckets. Per-host metrics are labeled with the
+ * host's address.
+ *
+ * The text is null-terminated. If the output buffer is too small the text is
+ * truncated and the required length is still returned. Rendering doesn't
+ * block requests that are recording metrics.
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @param[out] output The buffer to render into. It can be NULL if output_size
+ * is 0.
+ * @param[in] output_size The size of the output buffer.
+ * @param[out] output_length The length of the text (excluding the null
+ * terminator). This can be NULL.
+ * @return CASS_OK if successful, CASS_ERROR_LIB_NOT_ENOUGH_DATA if the output
+ * buffer is too small, otherwise an error occurred.
+ *
+ * @see cass_cluster_set_metrics_exporter_port()
+ */
+CASS_EXPORT CassError
+cass_session_get_metrics_text(const CassSession* session,
+                              char* output,
+                              size_t output_size,
+                              size_t* output_length);
+
 /***********************************************************************************
  *
  * Schema Metadata
@@ -4971,6 +5535,37 @@ cass_statement_set_paging_state_token(CassStatement* statement,
                                       const char* paging_state,
                                       size_t paging_state_size);
 
+/**
+ * Sets a callback that receives the rows of the statement's result as they
+ * arrive instead of after the whole result (page) is received. This reduces
+ * the time to the first row and the memory held for large pages because the
+ * rows are decoded and released as the response is read.
+ *
+ * The rows are delivered in order, in one or more calls, before the
+ * statement's future is set. The future's result has the metadata and the
+ * paging state but no rows. Rows of responses that can't be decoded as they
+ * arrive (e.g. compressed responses) are delivered in a single call.
+ *
+ * <b>Important:</b> The callback is called on one of the driver's I/O
+ * threads so it should not block. Statements with a rows callback are not
+ * speculatively executed, always receive the result metadata and are not
+ * retried after some of their rows are delivered. A request that would have
+ * been retried after that fails with CASS_ERROR_LIB_UNABLE_TO_EXECUTE.
+ *
+ * <b>Default:</b> NULL (disabled)
+ *
+ * @public @memberof CassStatement
+ *
+ * @param[in] statement
+ * @param[in] callback The callback, or NULL to disable it.
+ * @param[in] data
+ * @return CASS_OK if successful, otherwise an error occurred.
+ */
+CASS_EXPORT CassError
+cass_statement_set_rows_callback(CassStatement* statement,
+                                 CassResultRowsCallback callback,
+                                 void* data);
+
 /**
  * Sets the statement's timestamp.
  *
@@ -9190,6 +9785,291 @@ cass_result_paging_state_token(const CassResult* result,
                                const char** paging_state,
                                size_t* paging_state_size);
 
+/***********************************************************************************
+ *
+ * Result columns
+ *
+ ***********************************************************************************/
+
+/**
+ * Decodes all the rows of a result into columns in a single pass. This avoids
+ * creating a row and a value object for every cell so it's much cheaper than
+ * iterating over the rows when a result has many rows.
+ *
+ * Values of columns with the types int, bigint, counter, timestamp, time,
+ * float and double are copied into packed arrays. The values of all other
+ * columns are described by an offset and a length into the result's data so
+ * they're not copied. Every column has a null bitmap.
+ *
+ * The columns object keeps the result alive so the result can be freed before
+ * the columns object.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] result
+ * @return Returns a columns object that must be freed. NULL if the result
+ * doesn't contain rows or its rows can't be decoded.
+ *
+ * @see cass_result_columns_free()
+ */
+CASS_EXPORT CassResultColumns*
+cass_result_columns_new(const CassResult* result);
+
+/**
+ * Frees a columns object.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ */
+CASS_EXPORT void
+cass_result_columns_free(CassResultColumns* columns);
+
+/**
+ * Gets the number of rows.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @return The number of rows.
+ */
+CASS_EXPORT size_t
+cass_result_columns_row_count(const CassResultColumns* columns);
+
+/**
+ * Gets the number of columns.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @return The number of columns.
+ */
+CASS_EXPORT size_t
+cass_result_columns_column_count(const CassResultColumns* columns);
+
+/**
+ * Gets the value type of a column.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return The column's value type. CASS_VALUE_TYPE_UNKNOWN if the index is
+ * out of bounds.
+ */
+CASS_EXPORT CassValueType
+cass_result_columns_type(const CassResultColumns* columns,
+                         size_t index);
+
+/**
+ * Gets the null bitmap of a column. The value of row <em>i</em> is null if
+ * bit <em>(i % 8)</em> of byte <em>(i / 8)</em> is set.
+ *
+ * <b>Note:</b> Empty values of the fixed-width types are reported as null.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return The column's null bitmap. NULL if the index is out of bounds.
+ */
+CASS_EXPORT const cass_uint8_t*
+cass_result_columns_null_bitmap(const CassResultColumns* columns,
+                                size_t index);
+
+/**
+ * Gets the packed values of an int column. Null values are zero.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return An array with a value for each row. NULL if the index is out of
+ * bounds or the column isn't an int.
+ */
+CASS_EXPORT const cass_int32_t*
+cass_result_columns_int32(const CassResultColumns* columns,
+                          size_t index);
+
+/**
+ * Gets the packed values of a bigint, counter, timestamp or time column. Null
+ * values are zero.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return An array with a value for each row. NULL if the index is out of
+ * bounds or the column isn't one of the supported types.
+ */
+CASS_EXPORT const cass_int64_t*
+cass_result_columns_int64(const CassResultColumns* columns,
+                          size_t index);
+
+/**
+ * Gets the packed values of a float column. Null values are zero.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return An array with a value for each row. NULL if the index is out of
+ * bounds or the column isn't a float.
+ */
+CASS_EXPORT const cass_float_t*
+cass_result_columns_float(const CassResultColumns* columns,
+                          size_t index);
+
+/**
+ * Gets the packed values of a double column. Null values are zero.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @return An array with a value for each row. NULL if the index is out of
+ * bounds or the column isn't a double.
+ */
+CASS_EXPORT const cass_double_t*
+cass_result_columns_double(const CassResultColumns* columns,
+                           size_t index);
+
+/**
+ * Gets the values of a column that doesn't have packed values. The value of
+ * row <em>i</em> starts at <em>data + offsets[i]</em> and is
+ * <em>lengths[i]</em> bytes long. The length is negative if the value is
+ * null. The values use the same encoding as the values returned by
+ * cass_value_get_bytes() so collections, tuples and UDTs can be decoded
+ * using the native protocol's encoding.
+ *
+ * The data is bound to the lifetime of the columns object.
+ *
+ * @public @memberof CassResultColumns
+ *
+ * @param[in] columns
+ * @param[in] index
+ * @param[out] data The start of the result's data.
+ * @param[out] offsets An array with an offset for each row.
+ * @param[out] lengths An array with a length for each row.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_INVALID_VALUE_TYPE is returned if the column has packed
+ * values.
+ */
+CASS_EXPORT CassError
+cass_result_columns_bytes(const CassResultColumns* columns,
+                          size_t index,
+                          const cass_byte_t** data,
+                          const cass_uint32_t** offsets,
+                          const cass_int32_t** lengths);
+
+/**
+ * Copies the values of an int column into an array without decoding the
+ * rows. Null (and empty) values are zero in the output.
+ *
+ * @public @memberof CassResult
+ *
+ * @param[in] result
+ * @param[in] index The index of the column.
+ * @param[out] output The values of the first <em>output_count</em> rows (or
+ * of all the rows if the result has fewer rows).
+ * @param[in] output_count The number of values the output can hold.
+ * @param[out] null_bitmap An optional null bitmap with room for
+ * <em>(output_count + 7) / 8</em> bytes (can be NULL). The value of row
+ * <em>i</em> is null if bit <em>(i % 8)</em> of byte <em>(i / 8)</em> is set.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_INVALID_VALUE_TYPE is returned if the column's type doesn't
+ * match.
+ *
+ * @see cass_result_columns_new()
+ */
+CASS_EXPORT CassError
+cass_result_column_get_int32_array(const CassResult* result,
+                                   size_t index,
+                                   cass_int32_t* output,
+                                   size_t output_count,
+                                   cass_uint8_t* null_bitmap);
+
+/**
+ * Copies the values of a bigint, counter, timestamp or time column into an array without decoding the
+ * rows. Null (and empty) values are zero in the output.
+ *
+ * @public @memberof CassResult
+ *
+ * @param[in] result
+ * @param[in] index The index of the column.
+ * @param[out] output The values of the first <em>output_count</em> rows (or
+ * of all the rows if the result has fewer rows).
+ * @param[in] output_count The number of values the output can hold.
+ * @param[out] null_bitmap An optional null bitmap with room for
+ * <em>(output_count + 7) / 8</em> bytes (can be NULL). The value of row
+ * <em>i</em> is null if bit <em>(i % 8)</em> of byte <em>(i / 8)</em> is set.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_INVALID_VALUE_TYPE is returned if the column's type doesn't
+ * match.
+ *
+ * @see cass_result_columns_new()
+ */
+CASS_EXPORT CassError
+cass_result_column_get_int64_array(const CassResult* result,
+                                   size_t index,
+                                   cass_int64_t* output,
+                                   size_t output_count,
+                                   cass_uint8_t* null_bitmap);
+
+/**
+ * Copies the values of a float column into an array without decoding the
+ * rows. Null (and empty) values are zero in the output.
+ *
+ * @public @memberof CassResult
+ *
+ * @param[in] result
+ * @param[in] index The index of the column.
+ * @param[out] output The values of the first <em>output_count</em> rows (or
+ * of all the rows if the result has fewer rows).
+ * @param[in] output_count The number of values the output can hold.
+ * @param[out] null_bitmap An optional null bitmap with room for
+ * <em>(output_count + 7) / 8</em> bytes (can be NULL). The value of row
+ * <em>i</em> is null if bit <em>(i % 8)</em> of byte <em>(i / 8)</em> is set.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_INVALID_VALUE_TYPE is returned if the column's type doesn't
+ * match.
+ *
+ * @see cass_result_columns_new()
+ */
+CASS_EXPORT CassError
+cass_result_column_get_float_array(const CassResult* result,
+                                   size_t index,
+                                   cass_float_t* output,
+                                   size_t output_count,
+                                   cass_uint8_t* null_bitmap);
+
+/**
+ * Copies the values of a double column into an array without decoding the
+ * rows. Null (and empty) values are zero in the output.
+ *
+ * @public @memberof CassResult
+ *
+ * @param[in] result
+ * @param[in] index The index of the column.
+ * @param[out] output The values of the first <em>output_count</em> rows (or
+ * of all the rows if the result has fewer rows).
+ * @param[in] output_count The number of values the output can hold.
+ * @param[out] null_bitmap An optional null bitmap with room for
+ * <em>(output_count + 7) / 8</em> bytes (can be NULL). The value of row
+ * <em>i</em> is null if bit <em>(i % 8)</em> of byte <em>(i / 8)</em> is set.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_INVALID_VALUE_TYPE is returned if the column's type doesn't
+ * match.
+ *
+ * @see cass_result_columns_new()
+ */
+CASS_EXPORT CassError
+cass_result_column_get_double_array(const CassResult* result,
+                                    size_t index,
+                                    cass_double_t* output,
+                                    size_t output_count,
+                                    cass_uint8_t* null_bitmap);
+
 /***********************************************************************************
  *
  * Error result
@@ -9779,6 +10659,21 @@ cass_iterator_fields_from_materialized_view_meta(const CassMaterializedViewMeta*
 CASS_EXPORT CassIterator*
 cass_iterator_fields_from_column_meta(const CassColumnMeta* column_meta);
 
+/**
+ * Creates a new iterator over a snapshot of the session's per-host metrics.
+ * Hosts that are added after the iterator is created aren't included.
+ *
+ * @public @memberof CassSession
+ *
+ * @param[in] session
+ * @return A new iterator that must be freed.
+ *
+ * @see cass_iterator_get_host_metrics()
+ * @see cass_iterator_free()
+ */
+CASS_EXPORT CassIterator*
+cass_iterator_host_metrics_from_session(const CassSession* session);
+
 /**
  * Creates a new fields iterator for the specified index metadata. Metadata
  * fields allow direct access to the index data found in the underlying
@@ -9860,6 +10755,27 @@ cass_iterator_next(CassIterator* iterator);
 CASS_EXPORT const CassRow*
 cass_iterator_get_row(const CassIterator* iterator);
 
+/**
+ * Moves a result iterator to a row. Afterwards, cass_iterator_get_row()
+ * returns that row and cass_iterator_next() advances to the row after it.
+ *
+ * The first call finds the offsets of all the result's rows (validating
+ * them) in a single pass so moving to a row doesn't decode the rows before
+ * it. Calling this will invalidate the previous row returned by
+ * cass_iterator_get_row().
+ *
+ * @public @memberof CassIterator
+ *
+ * @param[in] iterator
+ * @param[in] index The index of the row.
+ * @return CASS_OK if successful, otherwise an error occurred.
+ * CASS_ERROR_LIB_BAD_PARAMS is returned if the iterator isn't a result
+ * iterator.
+ */
+CASS_EXPORT CassError
+cass_iterator_seek_row(CassIterator* iterator,
+                       size_t index);
+
 /**
  * Gets the column value at the row iterator's current position.
  *
@@ -10105,6 +11021,22 @@ cass_iterator_get_meta_field_name(const CassIterator* iterator,
 CASS_EXPORT const CassValue*
 cass_iterator_get_meta_field_value(const CassIterator* iterator);
 
+/**
+ * Gets a copy of the host metrics at the iterator's current position. The
+ * metrics are current as of this call.
+ *
+ * @public @memberof CassIterator
+ *
+ * @param[in] iterator
+ * @param[out] output
+ * @return CASS_OK if successful, otherwise an error occurred.
+ *
+ * @see cass_iterator_host_metrics_from_session()
+ */
+CASS_EXPORT CassError
+cass_iterator_get_host_metrics(const CassIterator* iterator,
+                               CassHostMetrics* output);
+
 /***********************************************************************************
  *
  * Row
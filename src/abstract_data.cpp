@@ -111,6 +111,13 @@ size_t AbstractData::Element::copy_buffer(size_t pos, Buffer* buf) const {
   }
 }
 
+bool AbstractData::Element::get_value(StringRef* value) const {
+  if (type_ == COLLECTION) return false;
+  assert(type_ == BUFFER || type_ == NUL);
+  *value = StringRef(buf_.data() + sizeof(int32_t), buf_.size() - sizeof(int32_t));
+  return true;
+}
+
 Buffer AbstractData::Element::get_buffer() const {
   if (type_ == COLLECTION) {
     return collection_->encode_with_length();
@@ -75,6 +75,15 @@ public:
     size_t copy_buffer(size_t pos, Buffer* buf) const;
     Buffer get_buffer() const;
 
+    /**
+     * Get the encoded value (without its length) in place. This isn't
+     * possible for collections because they're encoded on demand.
+     *
+     * @param value The element's encoded value.
+     * @return true if the value is available in place.
+     */
+    bool get_value(StringRef* value) const;
+
   private:
     Type type_;
     Buffer buf_;
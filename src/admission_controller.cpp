@@ -0,0 +1,175 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "admission_controller.hpp"
+
+#include "request_handler.hpp"
+#include "scoped_lock.hpp"
+
+#include <assert.h>
+
+namespace cass {
+
+AdmissionController::AdmissionController(unsigned max_requests,
+                                         CassAdmissionMode mode,
+                                         size_t max_waiting,
+                                         AdmissionListener* listener)
+  : max_requests_(max_requests)
+  , mode_(mode)
+  , max_waiting_(max_waiting)
+  , in_flight_count_(0)
+  , waiting_count_(0)
+  , rejected_count_(0)
+  , listener_(listener)
+  , notifying_count_(0)
+  , is_closed_(false) {
+  assert(max_requests_ > 0 && "The maximum number of requests must be greater than zero");
+  uv_mutex_init(&mutex_);
+  uv_cond_init(&cond_);
+}
+
+AdmissionController::~AdmissionController() {
+  uv_cond_destroy(&cond_);
+  uv_mutex_destroy(&mutex_);
+}
+
+bool AdmissionController::admit(const RequestHandler::Ptr& request_handler) {
+  // Don't go ahead of waiting requests
+  if (waiting_count_.load() == 0 && try_acquire()) {
+    request_handler->set_admission_controller(Ptr(this));
+    return true;
+  }
+
+  if (mode_ == CASS_ADMISSION_MODE_FAIL) {
+    reject(request_handler, "The maximum number of in-flight requests has been reached");
+    return false;
+  }
+
+  Vector<RequestHandler::Ptr> admitted;
+  AdmissionListener* listener = NULL;
+  {
+    ScopedMutex l(&mutex_);
+    if (is_closed_) {
+      l.unlock();
+      request_handler->set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                                 "Session is not connected");
+      return false;
+    }
+    if (waiting_.size() >= max_waiting_) {
+      l.unlock();
+      reject(request_handler, "The admission queue has reached capacity");
+      return false;
+    }
+    waiting_.push_back(request_handler);
+    waiting_count_.fetch_add(1);
+    // Requests could have finished after the limit was checked, but before
+    // this request was added to the waiting requests. Without checking again
+    // it would wait for the next request to finish (possibly forever).
+    admit_waiting(&admitted);
+    listener = start_notify(admitted);
+  }
+  notify_admitted(listener, admitted);
+  return false;
+}
+
+void AdmissionController::release() {
+  // Releasing the slot before checking for waiting requests pairs with adding
+  // a waiting request before acquiring a slot in `admit()`. At least one of
+  // the two sides sees the other.
+  in_flight_count_.fetch_sub(1);
+  if (waiting_count_.load() == 0) return;
+
+  Vector<RequestHandler::Ptr> admitted;
+  AdmissionListener* listener = NULL;
+  {
+    ScopedMutex l(&mutex_);
+    admit_waiting(&admitted);
+    listener = start_notify(admitted);
+  }
+  notify_admitted(listener, admitted);
+}
+
+void AdmissionController::close() {
+  Deque<RequestHandler::Ptr> waiting;
+  {
+    ScopedMutex l(&mutex_);
+    is_closed_ = true;
+    listener_ = NULL; // The session is being torn down
+    waiting.swap(waiting_);
+    waiting_count_.store(0);
+    // The listener must not be used after this returns
+    while (notifying_count_ > 0) {
+      uv_cond_wait(&cond_, &mutex_);
+    }
+  }
+  for (Deque<RequestHandler::Ptr>::const_iterator it = waiting.begin(),
+       end = waiting.end(); it != end; ++it) {
+    (*it)->set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                     "Session is not connected");
+  }
+}
+
+bool AdmissionController::try_acquire() {
+  unsigned count = in_flight_count_.load(MEMORY_ORDER_RELAXED);
+  do {
+    if (count >= max_requests_) return false;
+  } while (!in_flight_count_.compare_exchange_weak(count, count + 1));
+  return true;
+}
+
+void AdmissionController::admit_waiting(Vector<RequestHandler::Ptr>* admitted) {
+  while (!waiting_.empty() && try_acquire()) {
+    const RequestHandler::Ptr& request_handler(waiting_.front());
+    request_handler->set_admission_controller(Ptr(this));
+    admitted->push_back(request_handler);
+    waiting_.pop_front();
+    waiting_count_.fetch_sub(1);
+  }
+}
+
+AdmissionListener* AdmissionController::start_notify(const Vector<RequestHandler::Ptr>& admitted) {
+  if (admitted.empty() || listener_ == NULL) return NULL;
+  notifying_count_++;
+  return listener_;
+}
+
+void AdmissionController::notify_admitted(AdmissionListener* listener,
+                                          const Vector<RequestHandler::Ptr>& admitted) {
+  for (Vector<RequestHandler::Ptr>::const_iterator it = admitted.begin(),
+       end = admitted.end(); it != end; ++it) {
+    if (listener) {
+      listener->on_admitted(*it);
+    } else {
+      (*it)->set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                       "Session is not connected");
+    }
+  }
+
+  if (listener) {
+    ScopedMutex l(&mutex_);
+    if (--notifying_count_ == 0) {
+      uv_cond_broadcast(&cond_);
+    }
+  }
+}
+
+void AdmissionController::reject(const RequestHandler::Ptr& request_handler,
+                                 const char* message) {
+  rejected_count_.fetch_add(1);
+  request_handler->set_error(CASS_ERROR_LIB_REQUEST_QUEUE_FULL, message);
+}
+
+} // namespace cass
@@ -0,0 +1,147 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_ADMISSION_CONTROLLER_HPP_INCLUDED__
+#define __CASS_ADMISSION_CONTROLLER_HPP_INCLUDED__
+
+#include "atomic.hpp"
+#include "cassandra.h"
+#include "deque.hpp"
+#include "macros.hpp"
+#include "ref_counted.hpp"
+#include "vector.hpp"
+
+#include <uv.h>
+
+namespace cass {
+
+class RequestHandler;
+
+/**
+ * A listener for requests that are admitted after waiting.
+ */
+class AdmissionListener {
+public:
+  virtual ~AdmissionListener() { }
+
+  /**
+   * A waiting request was admitted and needs to be executed. This is called
+   * on the thread that finished the request that made room for it (usually
+   * an I/O thread).
+   *
+   * @param request_handler The admitted request.
+   */
+  virtual void on_admitted(const SharedRefPtr<RequestHandler>& request_handler) = 0;
+};
+
+/**
+ * Limits the number of requests a session has in flight. Admitting a request
+ * while under the limit is a single atomic operation; the lock is only taken
+ * when the limit has been reached.
+ *
+ * Admitted requests release their slot when they finish (see
+ * `RequestHandler::stop_request()`). In the wait mode, requests that aren't
+ * admitted wait in order and are handed to the listener when a slot is
+ * released. The number of waiting requests is bounded.
+ */
+class AdmissionController : public RefCounted<AdmissionController> {
+public:
+  typedef SharedRefPtr<AdmissionController> Ptr;
+
+  /**
+   * Constructor.
+   *
+   * @param max_requests The maximum number of requests in flight (> 0).
+   * @param mode What to do with requests that can't be admitted.
+   * @param max_waiting The maximum number of waiting requests.
+   * @param listener A listener that handles waiting requests when they're
+   * admitted. It must outlive the controller or be removed by `close()`.
+   */
+  AdmissionController(unsigned max_requests,
+                      CassAdmissionMode mode,
+                      size_t max_waiting,
+                      AdmissionListener* listener);
+  ~AdmissionController();
+
+  /**
+   * Admit a request (thread-safe).
+   *
+   * @param request_handler The request.
+   * @return true if the request was admitted and should be executed by the
+   * caller. Otherwise, the request is either waiting to be admitted or it
+   * failed.
+   */
+  bool admit(const SharedRefPtr<RequestHandler>& request_handler);
+
+  /**
+   * Release the slot of an admitted request that has finished (thread-safe).
+   */
+  void release();
+
+  /**
+   * Fail all waiting requests, stop admitting requests and remove the
+   * listener (thread-safe). This waits for admitted requests that are being
+   * passed to the listener on other threads so the listener can be torn down
+   * once it returns.
+   */
+  void close();
+
+  unsigned in_flight_count() const { return in_flight_count_.load(MEMORY_ORDER_RELAXED); }
+  size_t waiting_count() const { return waiting_count_.load(MEMORY_ORDER_RELAXED); }
+  uint64_t rejected_count() const { return rejected_count_.load(MEMORY_ORDER_RELAXED); }
+
+private:
+  bool try_acquire();
+
+  // Admit waiting requests while there are free slots. This must be called
+  // with the lock held; the admitted requests are added to the output.
+  void admit_waiting(Vector<SharedRefPtr<RequestHandler> >* admitted);
+
+  // Get the listener for admitted requests and track the notification so
+  // that `close()` waits for it. This must be called with the lock held; it
+  // returns NULL if the controller is closed.
+  AdmissionListener* start_notify(const Vector<SharedRefPtr<RequestHandler> >& admitted);
+
+  // A non-NULL listener must come from `start_notify()`. The requests fail if
+  // it's NULL.
+  void notify_admitted(AdmissionListener* listener,
+                       const Vector<SharedRefPtr<RequestHandler> >& admitted);
+
+  void reject(const SharedRefPtr<RequestHandler>& request_handler, const char* message);
+
+private:
+  const unsigned max_requests_;
+  const CassAdmissionMode mode_;
+  const size_t max_waiting_;
+
+  Atomic<unsigned> in_flight_count_;
+  Atomic<size_t> waiting_count_;
+  Atomic<uint64_t> rejected_count_;
+
+  uv_mutex_t mutex_;
+  uv_cond_t cond_;
+  AdmissionListener* listener_;
+  unsigned notifying_count_;
+  Deque<SharedRefPtr<RequestHandler> > waiting_;
+  bool is_closed_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(AdmissionController);
+};
+
+} // namespace cass
+
+#endif
@@ -242,7 +242,7 @@ bool BatchRequest::find_prepared_query(const String& id, String* query) const {
   return false;
 }
 
-bool BatchRequest::get_routing_key(String* routing_key) const {
+bool BatchRequest::get_routing_key(RoutingKey* routing_key) const {
   for (BatchRequest::StatementVec::const_iterator i = statements_.begin();
        i != statements_.end(); ++i) {
     if ((*i)->get_routing_key(routing_key)) {
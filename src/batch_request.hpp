@@ -47,7 +47,9 @@ public:
 
   bool find_prepared_query(const String& id, String* query) const;
 
-  virtual bool get_routing_key(String* routing_key) const;
+  using RoutableRequest::get_routing_key;
+
+  virtual bool get_routing_key(RoutingKey* routing_key) const;
 
 private:
   int encode(ProtocolVersion version, RequestCallback* callback, BufferVec* bufs) const;
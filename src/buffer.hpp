@@ -189,6 +189,23 @@ public:
 
   size_t size() const { return size_; }
 
+  /**
+   * Reduce the size of the buffer. This is useful when data is encoded into a
+   * buffer that was allocated using an upper bound (e.g. compression).
+   *
+   * @param size The new size. It must be less than or equal to the current
+   * size.
+   */
+  void truncate(size_t size) {
+    assert(size <= size_);
+    if (size_ > FIXED_BUFFER_SIZE && size <= FIXED_BUFFER_SIZE) {
+      RefBuffer* buffer = data_.buffer;
+      memcpy(data_.fixed, buffer->data(), size);
+      buffer->dec_ref();
+    }
+    size_ = size;
+  }
+
 private:
   // Enough space to avoid extra allocations for most of the basic types
   static const size_t FIXED_BUFFER_SIZE = 16;
@@ -16,6 +16,8 @@
 
 #include "cluster_config.hpp"
 
+#include "compression.hpp"
+
 extern "C" {
 
 CassCluster* cass_cluster_new() {
@@ -158,6 +160,29 @@ CassError cass_cluster_set_new_request_ratio(CassCluster* cluster,
   return CASS_OK;
 }
 
+CassError cass_cluster_set_coalesce_mode(CassCluster* cluster,
+                                         CassCoalesceMode mode) {
+  switch (mode) {
+    case CASS_COALESCE_MODE_FIXED:
+    case CASS_COALESCE_MODE_ADAPTIVE_LATENCY:
+    case CASS_COALESCE_MODE_ADAPTIVE_THROUGHPUT:
+      break;
+    default:
+      return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_coalesce_mode(mode);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_metrics_exporter_port(CassCluster* cluster,
+                                                 int port) {
+  if (port < 0 || port > 65535) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_metrics_exporter_port(port);
+  return CASS_OK;
+}
+
 CassError cass_cluster_set_max_concurrent_creation(CassCluster* cluster,
                                                    unsigned num_connections) {
   // Deprecated
@@ -527,6 +552,89 @@ CassError cass_cluster_set_no_compact(CassCluster* cluster,
   return CASS_OK;
 }
 
+CassError cass_cluster_set_compression(CassCluster* cluster,
+                                       CassCompression compression) {
+  if (!cass::Compressor::is_supported(compression)) {
+    return CASS_ERROR_LIB_NOT_IMPLEMENTED;
+  }
+  cluster->config().set_compression(compression);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_compression_threshold(CassCluster* cluster,
+                                                 unsigned threshold_bytes) {
+  cluster->config().set_compression_threshold(threshold_bytes);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_request_dispatch(CassCluster* cluster,
+                                            CassRequestDispatch dispatch) {
+  switch (dispatch) {
+    case CASS_REQUEST_DISPATCH_LEAST_BUSY:
+    case CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES:
+    case CASS_REQUEST_DISPATCH_THREAD_AFFINITY:
+    case CASS_REQUEST_DISPATCH_TOKEN_AFFINITY:
+    case CASS_REQUEST_DISPATCH_CPU_AFFINITY:
+      break;
+    default:
+      return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_request_dispatch(dispatch);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_io_thread_cpus(CassCluster* cluster,
+                                          const unsigned* cpus,
+                                          size_t cpus_count) {
+  if (cpus == NULL && cpus_count > 0) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_io_thread_cpus(cass::Vector<unsigned>(cpus, cpus + cpus_count));
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_zero_copy_responses(CassCluster* cluster,
+                                               cass_bool_t enabled) {
+  cluster->config().set_zero_copy_responses(enabled == cass_true);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_future_wait_spin_time(CassCluster* cluster,
+                                                 unsigned spin_time_us) {
+  cluster->config().set_future_wait_spin_time_us(spin_time_us);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_max_in_flight_requests(CassCluster* cluster,
+                                                  unsigned max_requests) {
+  cluster->config().set_max_in_flight_requests(max_requests);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_admission_mode(CassCluster* cluster,
+                                          CassAdmissionMode mode) {
+  switch (mode) {
+    case CASS_ADMISSION_MODE_FAIL:
+    case CASS_ADMISSION_MODE_WAIT:
+      break;
+    default:
+      return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  cluster->config().set_admission_mode(mode);
+  return CASS_OK;
+}
+
+CassError cass_cluster_set_max_in_flight_requests_per_host(CassCluster* cluster,
+                                                           unsigned max_requests) {
+  cluster->config().set_max_in_flight_requests_per_host(max_requests);
+  return CASS_OK;
+}
+
+void cass_cluster_set_work_stealing(CassCluster* cluster,
+                                    cass_bool_t enabled) {
+  cluster->config().set_work_stealing(enabled == cass_true);
+}
+
 CassError cass_cluster_set_host_listener_callback(CassCluster* cluster,
                                                   CassHostListenerCallback callback,
                                                   void* data) {
@@ -0,0 +1,72 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "coalesce_controller.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// Weight given to the most recent window
+#define EWMA_ALPHA 0.25
+
+namespace cass {
+
+CoalesceController::CoalesceController(CassCoalesceMode mode, uint64_t max_delay_us)
+  : mode_(mode)
+  , min_delay_us_(std::min(static_cast<uint64_t>(CASS_COALESCE_MIN_DELAY_US), max_delay_us))
+  , max_delay_us_(max_delay_us)
+  , delay_us_(max_delay_us)
+  , arrival_rate_(0.0)
+  , io_time_us_(0.0) {
+  if (mode_ == CASS_COALESCE_MODE_ADAPTIVE_LATENCY) {
+    // Start out assuming the traffic is sparse
+    delay_us_ = min_delay_us_;
+  }
+}
+
+void CoalesceController::record(int processed, uint64_t elapsed_ns, uint64_t io_time_ns) {
+  if (mode_ == CASS_COALESCE_MODE_FIXED || elapsed_ns == 0) return;
+
+  double elapsed_us = static_cast<double>(elapsed_ns) / 1000.0;
+  double rate = static_cast<double>(processed) / elapsed_us;
+  arrival_rate_ += EWMA_ALPHA * (rate - arrival_rate_);
+  io_time_us_ += EWMA_ALPHA * (static_cast<double>(io_time_ns) / 1000.0 - io_time_us_);
+
+  double target = mode_ == CASS_COALESCE_MODE_ADAPTIVE_LATENCY
+                  ? CASS_COALESCE_LATENCY_TARGET_BATCH
+                  : CASS_COALESCE_THROUGHPUT_TARGET_BATCH;
+
+  // The time needed to collect the target number of requests. Time spent
+  // handling I/O already delays the flush so only the remainder is waited.
+  double delay = std::numeric_limits<double>::max();
+  if (arrival_rate_ > 0.0) {
+    delay = target / arrival_rate_ - io_time_us_;
+  }
+
+  if (delay > static_cast<double>(max_delay_us_)) {
+    // The target can't be reached within the maximum delay. Waiting adds
+    // latency without much benefit in the latency mode, but in the
+    // throughput mode the largest possible batch is still preferred.
+    delay_us_ = mode_ == CASS_COALESCE_MODE_ADAPTIVE_LATENCY
+                ? min_delay_us_ : max_delay_us_;
+  } else if (delay < static_cast<double>(min_delay_us_)) {
+    delay_us_ = min_delay_us_;
+  } else {
+    delay_us_ = static_cast<uint64_t>(delay);
+  }
+}
+
+} // namespace cass
@@ -0,0 +1,85 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_COALESCE_CONTROLLER_HPP_INCLUDED__
+#define __CASS_COALESCE_CONTROLLER_HPP_INCLUDED__
+
+#include "cassandra.h"
+#include "constants.hpp"
+
+#include <stdint.h>
+
+// The smallest window used by the adaptive modes
+#define CASS_COALESCE_MIN_DELAY_US 10
+
+// The number of requests the adaptive modes try to write per flush
+#define CASS_COALESCE_LATENCY_TARGET_BATCH 4
+#define CASS_COALESCE_THROUGHPUT_TARGET_BATCH 64
+
+namespace cass {
+
+/**
+ * Chooses how long a request processor waits for new requests to coalesce
+ * before flushing them to the socket. In the fixed mode this is always the
+ * configured coalesce delay. The adaptive modes estimate the request arrival
+ * rate from previous windows and size the next window to collect a target
+ * number of requests, bounded by the configured coalesce delay.
+ *
+ * This is only used from a single event loop thread.
+ */
+class CoalesceController {
+public:
+  CoalesceController(CassCoalesceMode mode = CASS_DEFAULT_COALESCE_MODE,
+                     uint64_t max_delay_us = CASS_DEFAULT_COALESCE_DELAY);
+
+  CassCoalesceMode mode() const { return mode_; }
+
+  /**
+   * The delay to use for the next coalesce window.
+   *
+   * @return The delay in microseconds.
+   */
+  uint64_t delay_us() const { return delay_us_; }
+
+  /**
+   * Estimated request arrival rate.
+   *
+   * @return The number of requests per second.
+   */
+  double arrival_rate() const { return arrival_rate_ * 1000.0 * 1000.0; }
+
+  /**
+   * Update the delay using the results of a completed coalesce window.
+   *
+   * @param processed The number of requests written during the window.
+   * @param elapsed_ns The length of the window in nanoseconds.
+   * @param io_time_ns The time spent handling I/O during the window in
+   * nanoseconds.
+   */
+  void record(int processed, uint64_t elapsed_ns, uint64_t io_time_ns);
+
+private:
+  CassCoalesceMode mode_;
+  uint64_t min_delay_us_;
+  uint64_t max_delay_us_;
+  uint64_t delay_us_;
+  double arrival_rate_; // Requests per microsecond
+  double io_time_us_;
+};
+
+} // namespace cass
+
+#endif
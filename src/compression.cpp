@@ -0,0 +1,212 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "compression.hpp"
+
+#include "cassconfig.hpp"
+#include "logger.hpp"
+#include "serialization.hpp"
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAVE_SNAPPY
+#include <snappy-c.h>
+#endif
+
+#include <algorithm>
+
+// The largest frame body allowed by the native protocol (256 MB)
+#define MAX_DECOMPRESSED_SIZE (256 * 1024 * 1024)
+
+namespace cass {
+
+#ifdef HAVE_LZ4
+
+/**
+ * LZ4 compressor. The compressed body is prefixed by the uncompressed size as
+ * a 4 byte big-endian integer.
+ */
+class Lz4Compressor : public Compressor {
+public:
+  Lz4Compressor(size_t threshold)
+    : Compressor(threshold) { }
+
+  virtual const char* name() const { return "lz4"; }
+
+  virtual bool compress(const char* input, size_t size, Buffer* output) const {
+    if (size > MAX_DECOMPRESSED_SIZE) return false;
+    int bound = LZ4_compressBound(static_cast<int>(size));
+    Buffer buf(sizeof(int32_t) + bound);
+    buf.encode_int32(0, static_cast<int32_t>(size));
+    int result = LZ4_compress_default(input, buf.data() + sizeof(int32_t),
+                                      static_cast<int>(size), bound);
+    if (result <= 0) return false;
+    buf.truncate(sizeof(int32_t) + result);
+    *output = buf;
+    return true;
+  }
+
+  virtual bool decompress(const char* input, size_t size,
+                          RefBuffer::Ptr* output, size_t* output_size) const {
+    if (size < sizeof(int32_t)) return false;
+    int32_t uncompressed_size;
+    decode_int32(input, uncompressed_size);
+    if (uncompressed_size < 0 || uncompressed_size > MAX_DECOMPRESSED_SIZE) return false;
+    RefBuffer::Ptr buf(RefBuffer::create(uncompressed_size));
+    int result = LZ4_decompress_safe(input + sizeof(int32_t), buf->data(),
+                                     static_cast<int>(size - sizeof(int32_t)),
+                                     uncompressed_size);
+    if (result != uncompressed_size) return false;
+    *output = buf;
+    *output_size = static_cast<size_t>(uncompressed_size);
+    return true;
+  }
+};
+
+#endif
+
+#ifdef HAVE_SNAPPY
+
+/**
+ * Snappy compressor.
+ */
+class SnappyCompressor : public Compressor {
+public:
+  SnappyCompressor(size_t threshold)
+    : Compressor(threshold) { }
+
+  virtual const char* name() const { return "snappy"; }
+
+  virtual bool compress(const char* input, size_t size, Buffer* output) const {
+    size_t length = snappy_max_compressed_length(size);
+    Buffer buf(length);
+    if (snappy_compress(input, size, buf.data(), &length) != SNAPPY_OK) {
+      return false;
+    }
+    buf.truncate(length);
+    *output = buf;
+    return true;
+  }
+
+  virtual bool decompress(const char* input, size_t size,
+                          RefBuffer::Ptr* output, size_t* output_size) const {
+    size_t length;
+    if (snappy_uncompressed_length(input, size, &length) != SNAPPY_OK ||
+        length > MAX_DECOMPRESSED_SIZE) {
+      return false;
+    }
+    RefBuffer::Ptr buf(RefBuffer::create(length));
+    if (snappy_uncompress(input, size, buf->data(), &length) != SNAPPY_OK) {
+      return false;
+    }
+    *output = buf;
+    *output_size = length;
+    return true;
+  }
+};
+
+#endif
+
+bool Compressor::compress(const BufferVec::const_iterator& begin,
+                          const BufferVec::const_iterator& end,
+                          size_t size, Buffer* output) const {
+  if (begin + 1 == end) { // Avoid a copy when the body is a single buffer
+    return compress(begin->data(), begin->size(), output);
+  }
+
+  Buffer body(size);
+  size_t pos = 0;
+  for (BufferVec::const_iterator it = begin; it != end; ++it) {
+    pos = body.copy(pos, it->data(), it->size());
+  }
+  return compress(body.data(), body.size(), output);
+}
+
+bool Compressor::is_supported(CassCompression compression) {
+  switch (compression) {
+    case CASS_COMPRESSION_NONE:
+      return true;
+#ifdef HAVE_LZ4
+    case CASS_COMPRESSION_LZ4:
+      return true;
+#endif
+#ifdef HAVE_SNAPPY
+    case CASS_COMPRESSION_SNAPPY:
+      return true;
+#endif
+    case CASS_COMPRESSION_AUTO:
+      return !supported_names().empty();
+    default:
+      return false;
+  }
+}
+
+Compressor::Ptr Compressor::create(CassCompression compression,
+                                   const Vector<String>& supported,
+                                   size_t threshold) {
+  Vector<String> candidates;
+  switch (compression) {
+    case CASS_COMPRESSION_LZ4:
+      candidates.push_back("lz4");
+      break;
+    case CASS_COMPRESSION_SNAPPY:
+      candidates.push_back("snappy");
+      break;
+    case CASS_COMPRESSION_AUTO:
+      candidates = supported_names();
+      break;
+    default:
+      break;
+  }
+
+  for (Vector<String>::const_iterator it = candidates.begin(),
+       end = candidates.end(); it != end; ++it) {
+    if (std::find(supported.begin(), supported.end(), *it) != supported.end()) {
+      return create(*it, threshold);
+    }
+  }
+
+  return Ptr();
+}
+
+Compressor::Ptr Compressor::create(const String& name, size_t threshold) {
+#ifdef HAVE_LZ4
+  if (name == "lz4") {
+    return Ptr(Memory::allocate<Lz4Compressor>(threshold));
+  }
+#endif
+#ifdef HAVE_SNAPPY
+  if (name == "snappy") {
+    return Ptr(Memory::allocate<SnappyCompressor>(threshold));
+  }
+#endif
+  return Ptr();
+}
+
+Vector<String> Compressor::supported_names() {
+  Vector<String> names; // In order of preference
+#ifdef HAVE_LZ4
+  names.push_back("lz4");
+#endif
+#ifdef HAVE_SNAPPY
+  names.push_back("snappy");
+#endif
+  return names;
+}
+
+} // namespace cass
@@ -0,0 +1,133 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_COMPRESSION_HPP_INCLUDED__
+#define __CASS_COMPRESSION_HPP_INCLUDED__
+
+#include "buffer.hpp"
+#include "cassandra.h"
+#include "ref_counted.hpp"
+#include "string.hpp"
+#include "vector.hpp"
+
+namespace cass {
+
+/**
+ * A frame body compressor. This is negotiated using the "COMPRESSION" startup
+ * option and is applied to the body of every frame that has the compression
+ * flag set (protocol v3 and v4).
+ */
+class Compressor : public RefCounted<Compressor> {
+public:
+  typedef SharedRefPtr<Compressor> Ptr;
+
+  /**
+   * Constructor.
+   *
+   * @param threshold Frame bodies smaller than this size (in bytes) are sent
+   * uncompressed.
+   */
+  Compressor(size_t threshold)
+    : threshold_(threshold) { }
+
+  virtual ~Compressor() { }
+
+  /**
+   * The name of the algorithm used by the "COMPRESSION" startup option.
+   */
+  virtual const char* name() const = 0;
+
+  size_t threshold() const { return threshold_; }
+
+  /**
+   * Compress a frame body.
+   *
+   * @param input The uncompressed data.
+   * @param size The size of the uncompressed data.
+   * @param output The compressed data.
+   * @return true if successful, otherwise false.
+   */
+  virtual bool compress(const char* input, size_t size, Buffer* output) const = 0;
+
+  /**
+   * Decompress a frame body.
+   *
+   * @param input The compressed data.
+   * @param size The size of the compressed data.
+   * @param output The decompressed data.
+   * @param output_size The size of the decompressed data.
+   * @return true if successful, otherwise false.
+   */
+  virtual bool decompress(const char* input, size_t size,
+                          RefBuffer::Ptr* output, size_t* output_size) const = 0;
+
+  /**
+   * Compress a frame body that's spread across several buffers.
+   *
+   * @param bufs The uncompressed buffers.
+   * @param size The total size of the buffers.
+   * @param output The compressed data.
+   * @return true if successful, otherwise false.
+   */
+  bool compress(const BufferVec::const_iterator& begin,
+                const BufferVec::const_iterator& end,
+                size_t size, Buffer* output) const;
+
+public:
+  /**
+   * Determine if a compression algorithm was compiled into the driver.
+   *
+   * @param compression The compression algorithm.
+   * @return true if supported, otherwise false.
+   */
+  static bool is_supported(CassCompression compression);
+
+  /**
+   * Create a compressor using the first algorithm that's supported by both
+   * the driver and the server.
+   *
+   * @param compression The requested compression algorithm. If
+   * CASS_COMPRESSION_AUTO then LZ4 is preferred over Snappy.
+   * @param supported The algorithms supported by the server (from the
+   * SUPPORTED response).
+   * @param threshold The minimum size of frame bodies to compress.
+   * @return A compressor or NULL if no common algorithm exists.
+   */
+  static Ptr create(CassCompression compression,
+                    const Vector<String>& supported,
+                    size_t threshold);
+
+  /**
+   * Create a compressor by algorithm name.
+   *
+   * @param name The algorithm name ("lz4" or "snappy").
+   * @param threshold The minimum size of frame bodies to compress.
+   * @return A compressor or NULL if the algorithm isn't supported.
+   */
+  static Ptr create(const String& name, size_t threshold = 0);
+
+  /**
+   * The names of all algorithms compiled into the driver.
+   */
+  static Vector<String> supported_names();
+
+private:
+  size_t threshold_;
+};
+
+} // namespace cass
+
+#endif
@@ -51,6 +51,8 @@ public:
       , tracing_consistency_(CASS_DEFAULT_TRACING_CONSISTENCY)
       , coalesce_delay_us_(CASS_DEFAULT_COALESCE_DELAY)
       , new_request_ratio_(CASS_DEFAULT_NEW_REQUEST_RATIO)
+      , coalesce_mode_(CASS_DEFAULT_COALESCE_MODE)
+      , metrics_exporter_port_(CASS_DEFAULT_METRICS_EXPORTER_PORT)
       , log_level_(CASS_DEFAULT_LOG_LEVEL)
       , log_callback_(stderr_log_callback)
       , log_data_(NULL)
@@ -68,6 +70,15 @@ public:
       , prepare_on_all_hosts_(CASS_DEFAULT_PREPARE_ON_ALL_HOSTS)
       , prepare_on_up_or_add_host_(CASS_DEFAULT_PREPARE_ON_UP_OR_ADD_HOST)
       , no_compact_(CASS_DEFAULT_NO_COMPACT)
+      , zero_copy_responses_(CASS_DEFAULT_ZERO_COPY_RESPONSES)
+      , compression_(CASS_DEFAULT_COMPRESSION)
+      , compression_threshold_(CASS_DEFAULT_COMPRESSION_THRESHOLD)
+      , request_dispatch_(CASS_DEFAULT_REQUEST_DISPATCH)
+      , future_wait_spin_time_us_(CASS_DEFAULT_FUTURE_WAIT_SPIN_TIME_US)
+      , max_in_flight_requests_(CASS_DEFAULT_MAX_IN_FLIGHT_REQUESTS)
+      , admission_mode_(CASS_DEFAULT_ADMISSION_MODE)
+      , max_in_flight_requests_per_host_(CASS_DEFAULT_MAX_IN_FLIGHT_REQUESTS_PER_HOST)
+      , work_stealing_(CASS_DEFAULT_WORK_STEALING)
       , host_listener_(Memory::allocate<DefaultHostListener>()) {
     profiles_.set_empty_key(String());
 
@@ -165,6 +176,18 @@ public:
     new_request_ratio_ = ratio;
   }
 
+  CassCoalesceMode coalesce_mode() const { return coalesce_mode_; }
+
+  void set_coalesce_mode(CassCoalesceMode mode) {
+    coalesce_mode_ = mode;
+  }
+
+  int metrics_exporter_port() const { return metrics_exporter_port_; }
+
+  void set_metrics_exporter_port(int port) {
+    metrics_exporter_port_ = port;
+  }
+
   void set_request_timeout(unsigned timeout_ms) {
     default_profile_.set_request_timeout(timeout_ms);
   }
@@ -386,6 +409,66 @@ public:
     no_compact_ = enabled;
   }
 
+  bool zero_copy_responses() const { return zero_copy_responses_; }
+
+  void set_zero_copy_responses(bool enabled) {
+    zero_copy_responses_ = enabled;
+  }
+
+  CassCompression compression() const { return compression_; }
+
+  void set_compression(CassCompression compression) {
+    compression_ = compression;
+  }
+
+  unsigned compression_threshold() const { return compression_threshold_; }
+
+  void set_compression_threshold(unsigned threshold_bytes) {
+    compression_threshold_ = threshold_bytes;
+  }
+
+  CassRequestDispatch request_dispatch() const { return request_dispatch_; }
+
+  void set_request_dispatch(CassRequestDispatch dispatch) {
+    request_dispatch_ = dispatch;
+  }
+
+  const Vector<unsigned>& io_thread_cpus() const { return io_thread_cpus_; }
+
+  void set_io_thread_cpus(const Vector<unsigned>& cpus) {
+    io_thread_cpus_ = cpus;
+  }
+
+  unsigned future_wait_spin_time_us() const { return future_wait_spin_time_us_; }
+
+  void set_future_wait_spin_time_us(unsigned spin_time_us) {
+    future_wait_spin_time_us_ = spin_time_us;
+  }
+
+  unsigned max_in_flight_requests() const { return max_in_flight_requests_; }
+
+  void set_max_in_flight_requests(unsigned max_requests) {
+    max_in_flight_requests_ = max_requests;
+  }
+
+  CassAdmissionMode admission_mode() const { return admission_mode_; }
+
+  void set_admission_mode(CassAdmissionMode mode) {
+    admission_mode_ = mode;
+  }
+
+  unsigned max_in_flight_requests_per_host() const { return max_in_flight_requests_per_host_; }
+
+  void set_max_in_flight_requests_per_host(unsigned max_requests) {
+    max_in_flight_requests_per_host_ = max_requests;
+  }
+
+  bool work_stealing() const { return work_stealing_; }
+
+  void set_work_stealing(bool enabled) {
+    work_stealing_ = enabled;
+  }
+
   const String& application_name() const { return application_name_; }
 
   void set_application_name(const String& application_name) {
@@ -428,6 +511,8 @@ private:
   CassConsistency tracing_consistency_;
   uint64_t coalesce_delay_us_;
   int new_request_ratio_;
+  CassCoalesceMode coalesce_mode_;
+  int metrics_exporter_port_;
   CassLogLevel log_level_;
   CassLogCallback log_callback_;
   void* log_data_;
@@ -449,6 +534,16 @@ private:
   bool prepare_on_up_or_add_host_;
   Address local_address_;
   bool no_compact_;
+  bool zero_copy_responses_;
+  CassCompression compression_;
+  unsigned compression_threshold_;
+  CassRequestDispatch request_dispatch_;
+  Vector<unsigned> io_thread_cpus_;
+  unsigned future_wait_spin_time_us_;
+  unsigned max_in_flight_requests_;
+  CassAdmissionMode admission_mode_;
+  unsigned max_in_flight_requests_per_host_;
+  bool work_stealing_;
   String application_name_;
   String application_version_;
   DefaultHostListener::Ptr host_listener_;
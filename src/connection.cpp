@@ -16,6 +16,8 @@
 
 #include "connection.hpp"
 
+#include "response.hpp"
+
 #include "event_response.hpp"
 #include "options_request.hpp"
 #include "request.hpp"
@@ -72,7 +74,7 @@ class NopConnectionListener : public ConnectionListener {
 static NopConnectionListener nop_listener__;
 
 void ConnectionHandler::on_read(Socket* socket, ssize_t nread, const uv_buf_t* buf) {
-  connection_->on_read(buf->base, nread);
+  connection_->on_read(buf->base, nread, read_buffer());
   free_buffer(buf);
 }
 
@@ -107,21 +109,25 @@ void RecordingConnectionListener::process_events(const EventResponse::Vec& event
 Connection::Connection(const Socket::Ptr& socket,
                        ProtocolVersion protocol_version,
                        unsigned int idle_timeout_secs,
-                       unsigned int heartbeat_interval_secs)
+                       unsigned int heartbeat_interval_secs,
+                       bool zero_copy_responses)
   : socket_(socket)
   , inflight_request_count_(0)
-  , response_(Memory::allocate<ResponseMessage>())
+  , inflight_bytes_(0)
+  , response_(Memory::allocate<ResponseMessage>(static_cast<const Compressor*>(NULL), this))
   , listener_(&nop_listener__)
   , protocol_version_(protocol_version)
   , idle_timeout_secs_(idle_timeout_secs)
   , heartbeat_interval_secs_(heartbeat_interval_secs)
-  , heartbeat_outstanding_(false) {
+  , heartbeat_outstanding_(false)
+  , zero_copy_responses_(zero_copy_responses) {
   inc_ref(); // For the event loop
 }
 
 int32_t Connection::write(const RequestCallback::Ptr& callback) {
   int stream = stream_manager_.acquire(callback);
   if (stream < 0) {
+    if (host_metrics_) host_metrics_->stream_exhaustions.inc();
     return Request::REQUEST_ERROR_NO_AVAILABLE_STREAM_IDS;
   }
 
@@ -153,6 +159,11 @@ int32_t Connection::write(const RequestCallback::Ptr& callback) {
                            "Operation unsupported by this protocol version");
         break;
 
+      case Request::REQUEST_ERROR_COMPRESSION:
+        callback->on_error(CASS_ERROR_LIB_MESSAGE_ENCODE,
+                           "Unable to compress request");
+        break;
+
       default:
         callback->on_error(CASS_ERROR_LIB_WRITE_ERROR,
                            "Unspecified write error occurred");
@@ -163,7 +174,9 @@ int32_t Connection::write(const RequestCallback::Ptr& callback) {
   }
 
   // Add to the inflight count after we've cleared all posssible errors.
-  inflight_request_count_.fetch_add(1);
+  callback->set_request_size(request_size);
+  inc_inflight_request_count(callback.get());
+  if (host_metrics_) host_metrics_->bytes_written.inc(request_size);
 
   LOG_TRACE("Sending message type %s with stream %d on host %s",
             opcode_to_string(callback->request()->opcode()).c_str(),
@@ -204,6 +217,25 @@ void Connection::start_heartbeats() {
   restart_terminate_timer();
 }
 
+void Connection::set_compressor(const Compressor::Ptr& compressor) {
+  compressor_ = compressor;
+  response_->set_compressor(compressor_.get());
+}
+
+void Connection::set_host_metrics(const Metrics::HostMetrics::Ptr& host_metrics) {
+  // Move the requests that are already in-flight to the new host metrics
+  int count = inflight_request_count();
+  if (host_metrics_) {
+    host_metrics_->in_flight_requests.dec(count);
+    host_metrics_->in_flight_bytes.dec(inflight_bytes_);
+  }
+  host_metrics_ = host_metrics;
+  if (host_metrics_) {
+    host_metrics_->in_flight_requests.inc(count);
+    host_metrics_->in_flight_bytes.inc(inflight_bytes_);
+  }
+}
+
 void Connection::maybe_set_keyspace(ResponseMessage* response) {
   if (response->opcode() == CQL_OPCODE_RESULT) {
     ResultResponse* result =
@@ -233,7 +265,7 @@ void Connection::on_write(int status, RequestCallback* request) {
         pending_reads_.add_to_back(request);
       } else {
         stream_manager_.release(callback->stream());
-        inflight_request_count_.fetch_sub(1);
+        dec_inflight_request_count(callback.get());
         callback->set_state(RequestCallback::REQUEST_STATE_FINISHED);
         callback->on_error(CASS_ERROR_LIB_WRITE_ERROR,
                            "Unable to write to socket");
@@ -242,7 +274,7 @@ void Connection::on_write(int status, RequestCallback* request) {
 
     case RequestCallback::REQUEST_STATE_READ_BEFORE_WRITE:
       stream_manager_.release(callback->stream());
-      inflight_request_count_.fetch_sub(1);
+      dec_inflight_request_count(callback.get());
       // The read callback happened before the write callback
       // returned. This is now responsible for finishing the request.
       callback->set_state(RequestCallback::REQUEST_STATE_FINISHED);
@@ -257,9 +289,12 @@ void Connection::on_write(int status, RequestCallback* request) {
   }
 }
 
-void Connection::on_read(const char* buf, size_t size) {
+void Connection::on_read(const char* buf, size_t size,
+                         const RefBuffer::Ptr& buffer) {
   listener_->on_read();
 
+  if (host_metrics_) host_metrics_->bytes_read.inc(size);
+
   const char* pos = buf;
   size_t remaining = size;
 
@@ -267,7 +302,9 @@ void Connection::on_read(const char* buf, size_t size) {
   restart_terminate_timer();
 
   while (remaining != 0 && !socket_->is_closing()) {
-    ssize_t consumed = response_->decode(pos, remaining);
+    ssize_t consumed = zero_copy_responses_
+                       ? response_->decode(pos, remaining, buffer)
+                       : response_->decode(pos, remaining);
     if (consumed <= 0) {
       LOG_ERROR("Error decoding/consuming message");
       defunct();
@@ -276,7 +313,7 @@ void Connection::on_read(const char* buf, size_t size) {
 
     if (response_->is_body_ready()) {
       ScopedPtr<ResponseMessage> response(response_.release());
-      response_.reset(Memory::allocate<ResponseMessage>());
+      response_.reset(Memory::allocate<ResponseMessage>(compressor_.get(), this));
 
       LOG_TRACE("Consumed message type %s with stream %d, input %u, remaining %u on host %s",
                 opcode_to_string(response->opcode()).c_str(),
@@ -302,7 +339,7 @@ void Connection::on_read(const char* buf, size_t size) {
             case RequestCallback::REQUEST_STATE_READING:
               pending_reads_.remove(callback.get());
               stream_manager_.release(callback->stream());
-              inflight_request_count_.fetch_sub(1);
+              dec_inflight_request_count(callback.get());
               callback->set_state(RequestCallback::REQUEST_STATE_FINISHED);
               maybe_set_keyspace(response.get());
               callback->on_set(response.get());
@@ -333,12 +370,32 @@ void Connection::on_read(const char* buf, size_t size) {
   }
 }
 
+bool Connection::on_rows_start(int16_t stream) {
+  RequestCallback::Ptr callback;
+  // Rows are only streamed to requests that have finished writing (read
+  // before write responses are handled as a whole).
+  return stream_manager_.get(stream, callback) &&
+      callback->state() == RequestCallback::REQUEST_STATE_READING &&
+      callback->streams_rows();
+}
+
+void Connection::on_rows(int16_t stream, ResultResponse* rows) {
+  RequestCallback::Ptr callback;
+  if (stream_manager_.get(stream, callback)) {
+    callback->on_rows(rows);
+  }
+}
+
 void Connection::on_close() {
   heartbeat_timer_.stop();
   terminate_timer_.stop();
   while (!pending_reads_.is_empty()) {
     pending_reads_.pop_front()->on_close();
   }
+  if (host_metrics_) { // Requests that were waiting on a response are no longer in-flight
+    host_metrics_->in_flight_requests.dec(inflight_request_count());
+    host_metrics_->in_flight_bytes.dec(inflight_bytes_);
+  }
   listener_->on_close(this);
   dec_ref();
 }
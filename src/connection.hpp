@@ -14,7 +14,9 @@
   limitations under the License.
 */
 
+#include "compression.hpp"
 #include "event_response.hpp"
+#include "metrics.hpp"
 #include "request_callback.hpp"
 #include "socket.hpp"
 #include "stream_manager.hpp"
@@ -121,7 +123,8 @@ private:
  *
  * @see Connector
  */
-class Connection : public RefCounted<Connection> {
+class Connection : public RefCounted<Connection>
+                 , public ResponseMessage::RowsHandler {
   friend class ConnectionConnector;
   friend class ConnectionHandler;
   friend class SslConnectionHandler;
@@ -139,11 +142,14 @@ public:
    * @param idle_timeout_secs The amount of time (in seconds) without a write or heartbeat
    * where the connection is considered idle and is terminated.
    * @param heartbeat_interval_secs The interval (in seconds) to send a heartbeat.
+   * @param zero_copy_responses If true, response bodies that are contiguous in
+   * a socket read reference the read buffer instead of being copied.
    */
   Connection(const Socket::Ptr& socket,
              ProtocolVersion protocol_version,
              unsigned int idle_timeout_secs,
-             unsigned int heartbeat_interval_secs);
+             unsigned int heartbeat_interval_secs,
+             bool zero_copy_responses = false);
 
   /**
    * Write a request to the connection and coalesce with outstanding requests. This
@@ -204,24 +210,65 @@ public:
    */
   void start_heartbeats();
 
+  /**
+   * Set the compressor used for frame bodies. This is negotiated during
+   * startup and all frames after the STARTUP request may be compressed.
+   *
+   * @param compressor The compressor or NULL to disable compression.
+   */
+  void set_compressor(const Compressor::Ptr& compressor);
+
+  /**
+   * Set the metrics used to record the host's in-flight requests, bytes
+   * written/read and stream ID exhaustion. This is set by connection pools.
+   *
+   * @param host_metrics The host's metrics or NULL to disable.
+   */
+  void set_host_metrics(const Metrics::HostMetrics::Ptr& host_metrics);
+
 public:
   const Address& address() const { return socket_->address(); }
   const String& address_string() const { return socket_->address_string(); }
+  const Socket::FlushStats& flush_stats() const { return socket_->flush_stats(); }
   ProtocolVersion protocol_version() const { return protocol_version_; }
   const String& keyspace() { return keyspace_; }
   uv_loop_t* loop() { return socket_->loop(); }
+  const Compressor::Ptr& compressor() const { return compressor_; }
+  const Metrics::HostMetrics::Ptr& host_metrics() const { return host_metrics_; }
 
   int inflight_request_count() const {
     return inflight_request_count_.load(MEMORY_ORDER_RELAXED);
   }
 
 private:
+  void inc_inflight_request_count(const RequestCallback* callback) {
+    inflight_request_count_.fetch_add(1);
+    inflight_bytes_ += callback->request_size();
+    if (host_metrics_) {
+      host_metrics_->in_flight_requests.inc();
+      host_metrics_->in_flight_bytes.inc(callback->request_size());
+    }
+  }
+
+  void dec_inflight_request_count(const RequestCallback* callback) {
+    inflight_request_count_.fetch_sub(1);
+    inflight_bytes_ -= callback->request_size();
+    if (host_metrics_) {
+      host_metrics_->in_flight_requests.dec();
+      host_metrics_->in_flight_bytes.dec(callback->request_size());
+    }
+  }
+
   void maybe_set_keyspace(ResponseMessage* response);
 
   void on_write(int status, RequestCallback* request);
-  void on_read(const char* buf, size_t size);
+  void on_read(const char* buf, size_t size,
+               const RefBuffer::Ptr& buffer = RefBuffer::Ptr());
   void on_close();
 
+  virtual bool on_rows_start(int16_t stream);
+  virtual void on_rows(int16_t stream, ResultResponse* rows);
+
 private:
   void restart_heartbeat_timer();
   void on_heartbeat(Timer* timer);
@@ -233,9 +280,12 @@ private:
   Socket::Ptr socket_;
   StreamManager<RequestCallback::Ptr> stream_manager_;
   Atomic<int> inflight_request_count_;
+  int64_t inflight_bytes_;
 
   List<SocketRequest> pending_reads_;
   ScopedPtr<ResponseMessage> response_;
+  Compressor::Ptr compressor_;
+  Metrics::HostMetrics::Ptr host_metrics_;
 
   ConnectionListener* listener_;
 
@@ -245,6 +295,7 @@ private:
   unsigned int idle_timeout_secs_;
   unsigned int heartbeat_interval_secs_;
   bool heartbeat_outstanding_;
+  bool zero_copy_responses_;
   Timer heartbeat_timer_;
   Timer terminate_timer_;
 };
@@ -34,12 +34,14 @@ static inline bool least_busy_comp(const PooledConnection::Ptr& a,
 
 ConnectionPoolSettings::ConnectionPoolSettings()
   : num_connections_per_host(CASS_DEFAULT_NUM_CONNECTIONS_PER_HOST)
-  , reconnect_wait_time_ms(CASS_DEFAULT_RECONNECT_WAIT_TIME_MS) { }
+  , reconnect_wait_time_ms(CASS_DEFAULT_RECONNECT_WAIT_TIME_MS)
+  , max_in_flight_requests_per_host(CASS_DEFAULT_MAX_IN_FLIGHT_REQUESTS_PER_HOST) { }
 
 ConnectionPoolSettings::ConnectionPoolSettings(const Config& config)
   : connection_settings(config)
   , num_connections_per_host(config.core_connections_per_host())
-  , reconnect_wait_time_ms(config.reconnect_wait_time_ms()) { }
+  , reconnect_wait_time_ms(config.reconnect_wait_time_ms())
+  , max_in_flight_requests_per_host(config.max_in_flight_requests_per_host()) { }
 
 class NopConnectionPoolListener : public ConnectionPoolListener {
 public:
@@ -71,6 +73,7 @@ ConnectionPool::ConnectionPool(const Connection::Vec& connections,
   , protocol_version_(protocol_version)
   , settings_(settings)
   , metrics_(metrics)
+  , host_metrics_(metrics ? metrics->host_metrics(address) : Metrics::HostMetrics::Ptr())
   , close_state_(CLOSE_STATE_OPEN)
   , notify_state_(NOTIFY_STATE_NEW) {
   inc_ref(); // Reference for the lifetime of the pooled connections
@@ -99,6 +102,18 @@ PooledConnection::Ptr ConnectionPool::find_least_busy() const {
   if (connections_.empty()) {
     return PooledConnection::Ptr();
   }
+  if (settings_.max_in_flight_requests_per_host > 0) {
+    // The host is treated as busy (and skipped by the caller) when the
+    // pool's connections have reached the limit.
+    unsigned count = 0;
+    for (PooledConnection::Vec::const_iterator it = connections_.begin(),
+         end = connections_.end(); it != end; ++it) {
+      count += (*it)->inflight_request_count();
+    }
+    if (count >= settings_.max_in_flight_requests_per_host) {
+      return PooledConnection::Ptr();
+    }
+  }
   return *std::min_element(connections_.begin(),
                            connections_.end(), least_busy_comp);
 }
@@ -144,6 +159,7 @@ void ConnectionPool::requires_flush(PooledConnection* connection, ConnectionPool
 void ConnectionPool::close_connection(PooledConnection* connection, Protected) {
   if (metrics_) {
     metrics_->total_connections.dec();
+    host_metrics_->total_connections.dec();
   }
   connections_.erase(std::remove(connections_.begin(), connections_.end(), connection),
                      connections_.end());
@@ -163,6 +179,7 @@ void ConnectionPool::close_connection(PooledConnection* connection, Protected) {
 void ConnectionPool::add_connection(const PooledConnection::Ptr& connection) {
   if (metrics_) {
     metrics_->total_connections.inc();
+    host_metrics_->total_connections.inc();
   }
   connections_.push_back(connection);
 }
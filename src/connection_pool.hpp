@@ -94,6 +94,7 @@ struct ConnectionPoolSettings {
   ConnectionSettings connection_settings;
   size_t num_connections_per_host;
   uint64_t reconnect_wait_time_ms;
+  unsigned max_in_flight_requests_per_host; // Zero means unlimited
 };
 
 /**
@@ -174,6 +175,8 @@ public:
   const Address& address() const { return address_; }
   ProtocolVersion protocol_version() const { return protocol_version_; }
   const String& keyspace() const { return keyspace_; }
+  bool is_closing() const { return close_state_ != CLOSE_STATE_OPEN; }
+  const Metrics::HostMetrics::Ptr& host_metrics() const { return host_metrics_; }
 
   void set_keyspace(const String& keyspace);
 
@@ -237,6 +240,7 @@ private:
   const ProtocolVersion protocol_version_;
   const ConnectionPoolSettings settings_;
   Metrics* const metrics_;
+  const Metrics::HostMetrics::Ptr host_metrics_;
 
   CloseState close_state_;
   NotifyState notify_state_;
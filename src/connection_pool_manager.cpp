@@ -53,6 +53,7 @@ ConnectionPoolManager::ConnectionPoolManager(const ConnectionPool::Map& pools,
   , metrics_(metrics)
 #ifdef CASS_INTERNAL_DIAGNOSTICS
   , flush_bytes_("flushed")
+  , flush_bufs_("flushed iovecs")
 #endif
 {
   inc_ref(); // Reference for the lifetime of the connection pools
@@ -99,7 +100,15 @@ AddressVec ConnectionPoolManager::available() const {
 
 void ConnectionPoolManager::add(const Address& address) {
   ConnectionPool::Map::iterator it = pools_.find(address);
-  if (it != pools_.end()) return;
+  if (it != pools_.end()) {
+    // The host was removed and quickly added back. Wait for the previous pool
+    // to finish closing before connecting a new one.
+    if (it->second->is_closing() &&
+        std::find(pending_adds_.begin(), pending_adds_.end(), address) == pending_adds_.end()) {
+      pending_adds_.push_back(address);
+    }
+    return;
+  }
 
   for (ConnectionPoolConnector::Vec::iterator it = pending_pools_.begin(),
        end = pending_pools_.end(); it != end; ++it) {
@@ -120,6 +129,8 @@ void ConnectionPoolManager::add(const Address& address) {
 }
 
 void ConnectionPoolManager::remove(const Address& address) {
+  pending_adds_.erase(std::remove(pending_adds_.begin(), pending_adds_.end(), address),
+                      pending_adds_.end());
   ConnectionPool::Map::iterator it = pools_.find(address);
   if (it == pools_.end()) return;
   // The connection pool will remove itself from the manager when all of its
@@ -191,8 +202,18 @@ void ConnectionPoolManager::on_requires_flush(ConnectionPool* pool) {
 }
 
 void ConnectionPoolManager::on_close(ConnectionPool* pool) {
-  pools_.erase(pool->address());
+  Address address(pool->address());
+  pools_.erase(address);
   to_flush_.erase(pool);
+
+  AddressVec::iterator it = std::find(pending_adds_.begin(), pending_adds_.end(), address);
+  if (it != pending_adds_.end()) {
+    pending_adds_.erase(it);
+    if (close_state_ == CLOSE_STATE_OPEN) {
+      add(address);
+    }
+  }
+
   maybe_closed();
 }
 
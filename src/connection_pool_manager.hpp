@@ -156,6 +156,7 @@ public:
 
 #ifdef CASS_INTERNAL_DIAGNOSTICS
   HistogramWrapper& flush_bytes() { return flush_bytes_; }
+  HistogramWrapper& flush_bufs() { return flush_bufs_; }
 #endif
 
 private:
@@ -198,6 +199,7 @@ private:
   CloseState close_state_;
   ConnectionPool::Map pools_;
   ConnectionPoolConnector::Vec pending_pools_;
+  AddressVec pending_adds_; // Hosts re-added while their previous pool was closing
   DenseHashSet<ConnectionPool*> to_flush_;
 
   String keyspace_;
@@ -206,6 +208,7 @@ private:
 
 #ifdef CASS_INTERNAL_DIAGNOSTICS
   HistogramWrapper flush_bytes_;
+  HistogramWrapper flush_bufs_;
 #endif
 };
 
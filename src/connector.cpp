@@ -63,11 +63,9 @@ StartupCallback::StartupCallback(Connector* connector, const Request::ConstPtr&
 
 void StartupCallback::on_internal_set(ResponseMessage* response) {
   switch (response->opcode()) {
-#ifdef CASS_USE_OPTIONS
     case CQL_OPCODE_SUPPORTED:
       connector_->on_supported(response);
       break;
-#endif
 
     case CQL_OPCODE_ERROR: {
       ErrorResponse* error
@@ -155,7 +153,10 @@ ConnectionSettings::ConnectionSettings()
   , auth_provider(Memory::allocate<AuthProvider>())
   , idle_timeout_secs(CASS_DEFAULT_IDLE_TIMEOUT_SECS)
   , heartbeat_interval_secs(CASS_DEFAULT_HEARTBEAT_INTERVAL_SECS)
-  , no_compact(CASS_DEFAULT_NO_COMPACT) { }
+  , no_compact(CASS_DEFAULT_NO_COMPACT)
+  , zero_copy_responses(CASS_DEFAULT_ZERO_COPY_RESPONSES)
+  , compression(CASS_DEFAULT_COMPRESSION)
+  , compression_threshold(CASS_DEFAULT_COMPRESSION_THRESHOLD) { }
 
 ConnectionSettings::ConnectionSettings(const Config& config)
   : socket_settings(config)
@@ -164,6 +165,9 @@ ConnectionSettings::ConnectionSettings(const Config& config)
   , idle_timeout_secs(config.connection_idle_timeout_secs())
   , heartbeat_interval_secs(config.connection_heartbeat_interval_secs())
   , no_compact(config.no_compact())
+  , zero_copy_responses(config.zero_copy_responses())
+  , compression(config.compression())
+  , compression_threshold(config.compression_threshold())
   , application_name(config.application_name())
   , application_version(config.application_version()) { }
 
@@ -290,17 +294,23 @@ void Connector::on_ready_or_register_for_events() {
   }
 }
 
-// TODO: We don't currently do anything with the options returned from the
-// SUPPORTED response. In the not too distant future we will be using these
-// options for at least compression, but likely other things too.
-#ifdef CASS_USE_OPTIONS
-void ConnectionConnector::on_supported(ResponseMessage* response) {
+void Connector::on_supported(ResponseMessage* response) {
   SupportedResponse* supported =
       static_cast<SupportedResponse*>(response->response_body().get());
 
-  // TODO: Do something with the supported info
-  (void)supported;
+  Compressor::Ptr compressor(Compressor::create(settings_.compression,
+                                                supported->compression(),
+                                                settings_.compression_threshold));
+  if (!compressor) {
+    LOG_WARN("Host %s doesn't support the requested compression algorithm. "
+             "Using uncompressed frames...",
+             socket_connector_->address().to_string().c_str());
+  }
+
+  on_startup(compressor);
+}
 
+void Connector::on_startup(const Compressor::Ptr& compressor) {
   connection_->write_and_flush(
         RequestCallback::Ptr(
           Memory::allocate<StartupCallback>(this,
@@ -308,9 +318,12 @@ void ConnectionConnector::on_supported(ResponseMessage* response) {
                                               Memory::allocate<StartupRequest>(settings_.application_name,
                                                                                settings_.application_version,
                                                                                settings_.client_id,
-                                                                               settings_.no_compact)))));
+                                                                               settings_.no_compact,
+                                                                               compressor ? compressor->name() : "")))));
+  // The STARTUP request is never compressed, but all frames after it are
+  // allowed to be.
+  connection_->set_compressor(compressor);
 }
-#endif
 
 void Connector::on_authenticate(const String& class_name) {
   Authenticator::Ptr auth(settings_.auth_provider->new_authenticator(socket_connector_->address(),
@@ -368,7 +381,8 @@ void Connector::on_connect(SocketConnector* socket_connector) {
     connection_.reset(Memory::allocate<Connection>(socket,
                                                    protocol_version_,
                                                    settings_.idle_timeout_secs,
-                                                   settings_.heartbeat_interval_secs));
+                                                   settings_.heartbeat_interval_secs,
+                                                   settings_.zero_copy_responses));
     connection_->set_listener(this);
 
     if (socket_connector->ssl_session()) {
@@ -381,22 +395,19 @@ void Connector::on_connect(SocketConnector* socket_connector) {
             Memory::allocate<ConnectionHandler>(connection_.get()));
     }
 
-#ifdef CASS_USE_OPTIONS
-    connection_->write_and_flush(
-          RequestCallback::Ptr(
-            Memory::allocate<StartupCallback>(this,
-                                              Request::ConstPtr(
-                                                Memory::allocate<OptionsRequest>()))));
-#else
-    connection_->write_and_flush(
-          RequestCallback::Ptr(
-            Memory::allocate<StartupCallback>(this,
-                                              Request::ConstPtr(
-                                                Memory::allocate<StartupRequest>(settings_.application_name,
-                                                                                 settings_.application_version,
-                                                                                 settings_.client_id,
-                                                                                 settings_.no_compact)))));
-#endif
+    // The SUPPORTED response is only required to negotiate compression.
+    // Compression isn't supported by the beta protocol version (v5) because it
+    // compresses segments instead of frames.
+    if (settings_.compression != CASS_COMPRESSION_NONE &&
+        !protocol_version_.is_beta()) {
+      connection_->write_and_flush(
+            RequestCallback::Ptr(
+              Memory::allocate<StartupCallback>(this,
+                                                Request::ConstPtr(
+                                                  Memory::allocate<OptionsRequest>()))));
+    } else {
+      on_startup(Compressor::Ptr());
+    }
   } else if (socket_connector->is_canceled() || is_timeout_error()) {
     finish();
   } else if (socket_connector->error_code() == SocketConnector::SOCKET_ERROR_CONNECT) {
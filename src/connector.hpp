@@ -51,6 +51,9 @@ struct ConnectionSettings {
   unsigned int idle_timeout_secs;
   unsigned int heartbeat_interval_secs;
   bool no_compact;
+  bool zero_copy_responses;
+  CassCompression compression;
+  unsigned compression_threshold;
   String application_name;
   String application_version;
   String client_id;
@@ -211,6 +214,7 @@ private:
   void on_ready_or_set_keyspace();
   void on_ready_or_register_for_events();
   void on_supported(ResponseMessage* response);
+  void on_startup(const Compressor::Ptr& compressor);
 
   void on_authenticate(const String& class_name);
   void on_auth_challenge(const AuthResponseRequest* request, const String& token);
@@ -133,7 +133,18 @@
 #define CASS_DEFAULT_USE_SCHEMA true
 #define CASS_DEFAULT_COALESCE_DELAY 200
 #define CASS_DEFAULT_NEW_REQUEST_RATIO 50
+#define CASS_DEFAULT_COALESCE_MODE CASS_COALESCE_MODE_FIXED
+#define CASS_DEFAULT_METRICS_EXPORTER_PORT 0
 #define CASS_DEFAULT_NO_COMPACT false
+#define CASS_DEFAULT_ZERO_COPY_RESPONSES false
+#define CASS_DEFAULT_COMPRESSION CASS_COMPRESSION_NONE
+#define CASS_DEFAULT_COMPRESSION_THRESHOLD 512
+#define CASS_DEFAULT_REQUEST_DISPATCH CASS_REQUEST_DISPATCH_LEAST_BUSY
+#define CASS_DEFAULT_FUTURE_WAIT_SPIN_TIME_US 0
+#define CASS_DEFAULT_MAX_IN_FLIGHT_REQUESTS 0
+#define CASS_DEFAULT_ADMISSION_MODE CASS_ADMISSION_MODE_FAIL
+#define CASS_DEFAULT_MAX_IN_FLIGHT_REQUESTS_PER_HOST 0
+#define CASS_DEFAULT_WORK_STEALING false
 #define CASS_DEFAULT_CQL_VERSION "3.0.0"
 #define CASS_DEFAULT_MAX_TRACING_DATA_WAIT_TIME_MS 15
 #define CASS_DEFAULT_RETRY_TRACING_DATA_WAIT_TIME_MS 3
@@ -19,7 +19,6 @@
 #include "logger.hpp"
 #include "memory.hpp"
 #include "request_handler.hpp"
-#include "scoped_lock.hpp"
 
 #include <algorithm>
 
@@ -31,14 +30,8 @@ DCAwarePolicy::DCAwarePolicy(const String& local_dc,
   : local_dc_(local_dc)
   , used_hosts_per_remote_dc_(used_hosts_per_remote_dc)
   , skip_remote_dcs_for_local_cl_(skip_remote_dcs_for_local_cl)
-  , local_dc_live_hosts_(Memory::allocate<HostVec>())
-  , index_(0) {
-  uv_rwlock_init(&available_rwlock_);
-}
-
-DCAwarePolicy::~DCAwarePolicy() {
-  uv_rwlock_destroy(&available_rwlock_);
-}
+  , live_hosts_(Memory::allocate<LiveHosts>())
+  , index_(0) { }
 
 void DCAwarePolicy::init(const Host::Ptr& connected_host,
                          const HostMap& hosts,
@@ -50,14 +43,18 @@ void DCAwarePolicy::init(const Host::Ptr& connected_host,
     local_dc_ = connected_host->dc();
   }
 
-  available_.resize(hosts.size());
+  LiveHosts* live_hosts = Memory::allocate<LiveHosts>();
+  live_hosts->available.resize(hosts.size());
   std::transform(hosts.begin(), hosts.end(),
-                 std::inserter(available_, available_.begin()), GetAddress());
+                 std::inserter(live_hosts->available, live_hosts->available.begin()),
+                 GetAddress());
 
   for (HostMap::const_iterator i = hosts.begin(),
        end = hosts.end(); i != end; ++i) {
-    on_host_added(i->second);
+    add_live_host(live_hosts, i->second);
   }
+  live_hosts_.set(live_hosts);
+
   if (random != NULL) {
     index_ = random->next(std::max(static_cast<size_t>(1), hosts.size()));
   }
@@ -68,10 +65,16 @@ CassHostDistance DCAwarePolicy::distance(const Host::Ptr& host) const {
     return CASS_HOST_DISTANCE_LOCAL;
   }
 
-  const CopyOnWriteHostVec& hosts = per_remote_dc_live_hosts_.get_hosts(host->dc());
-  size_t num_hosts = std::min(hosts->size(), used_hosts_per_remote_dc_);
+  const PerDCHostMap& remote_dcs = live_hosts_->remote_dcs;
+  PerDCHostMap::const_iterator it = remote_dcs.find(host->dc());
+  if (it == remote_dcs.end()) {
+    return CASS_HOST_DISTANCE_IGNORE;
+  }
+
+  const HostVec& hosts = *it->second;
+  size_t num_hosts = std::min(hosts.size(), used_hosts_per_remote_dc_);
   for (size_t i = 0; i < num_hosts; ++i) {
-    if ((*hosts)[i]->address() == host->address()) {
+    if (hosts[i]->address() == host->address()) {
       return CASS_HOST_DISTANCE_REMOTE;
     }
   }
@@ -82,137 +85,105 @@ CassHostDistance DCAwarePolicy::distance(const Host::Ptr& host) const {
 QueryPlan* DCAwarePolicy::new_query_plan(const String& keyspace,
                                          RequestHandler* request_handler,
                                          const TokenMap* token_map) {
-  CassConsistency cl = request_handler != NULL ? request_handler->consistency() : CASS_DEFAULT_CONSISTENCY;
-  return Memory::allocate<DCAwareQueryPlan>(this, cl, index_++);
+  return emplace_query_plan(NULL, keyspace, request_handler, token_map);
+}
+
+QueryPlan* DCAwarePolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                             const String& keyspace,
+                                             RequestHandler* request_handler,
+                                             const TokenMap* token_map) {
+  return new (QueryPlanStorage::allocate(storage, sizeof(DCAwareQueryPlan)))
+      DCAwareQueryPlan(this, request_handler);
 }
 
 bool DCAwarePolicy::is_host_up(const Address& address) const {
-  ScopedReadLock rl(&available_rwlock_);
-  return available_.count(address);
+  return live_hosts_->available.count(address) > 0;
 }
 
 void DCAwarePolicy::on_host_added(const Host::Ptr& host) {
-  const String& dc = host->dc();
-  if (local_dc_.empty() && !dc.empty()) {
-    LOG_INFO("Using '%s' for local data center "
-             "(if this is incorrect, please provide the correct data center)",
-             host->dc().c_str());
-    local_dc_ = dc;
-  }
-
-  if (dc == local_dc_) {
-    add_host(local_dc_live_hosts_, host);
-  } else {
-    per_remote_dc_live_hosts_.add_host_to_dc(dc, host);
-  }
+  LiveHosts* live_hosts = live_hosts_.copy();
+  add_live_host(live_hosts, host);
+  live_hosts_.set(live_hosts);
 }
 
 void DCAwarePolicy::on_host_removed(const Host::Ptr& host) {
+  LiveHosts* live_hosts = live_hosts_.copy();
   const String& dc = host->dc();
   if (dc == local_dc_) {
-    remove_host(local_dc_live_hosts_, host);
+    remove_host(live_hosts->local_dc, host);
   } else {
-    per_remote_dc_live_hosts_.remove_host_from_dc(host->dc(), host);
+    PerDCHostMap::iterator i = live_hosts->remote_dcs.find(dc);
+    if (i != live_hosts->remote_dcs.end()) {
+      remove_host(i->second, host);
+    }
   }
-
-  ScopedWriteLock wl(&available_rwlock_);
-  available_.erase(host->address());
+  live_hosts->available.erase(host->address());
+  live_hosts_.set(live_hosts);
 }
 
 void DCAwarePolicy::on_host_up(const Host::Ptr& host) {
-  on_host_added(host);
-
-  ScopedWriteLock wl(&available_rwlock_);
-  available_.insert(host->address());
+  LiveHosts* live_hosts = live_hosts_.copy();
+  add_live_host(live_hosts, host);
+  live_hosts->available.insert(host->address());
+  live_hosts_.set(live_hosts);
 }
 
 void DCAwarePolicy::on_host_down(const Address& address) {
-  if (!remove_host(local_dc_live_hosts_, address) &&
-      !per_remote_dc_live_hosts_.remove_host(address)) {
+  LiveHosts* live_hosts = live_hosts_.copy();
+  bool is_removed = remove_host(live_hosts->local_dc, address);
+  for (PerDCHostMap::iterator i = live_hosts->remote_dcs.begin(),
+       end = live_hosts->remote_dcs.end(); !is_removed && i != end; ++i) {
+    is_removed = remove_host(i->second, address);
+  }
+  if (!is_removed) {
     LOG_DEBUG("Attempted to mark host %s as DOWN, but it doesn't exist",
               address.to_string().c_str());
   }
-
-  ScopedWriteLock wl(&available_rwlock_);
-  available_.erase(address);
-}
-
-void DCAwarePolicy::PerDCHostMap::add_host_to_dc(const String& dc, const Host::Ptr& host) {
-  ScopedWriteLock wl(&rwlock_);
-  Map::iterator i = map_.find(dc);
-  if (i == map_.end()) {
-    CopyOnWriteHostVec hosts(Memory::allocate<HostVec>());
-    hosts->push_back(host);
-    map_.insert(Map::value_type(dc, hosts));
-  } else {
-    add_host(i->second, host);
-  }
+  live_hosts->available.erase(address);
+  live_hosts_.set(live_hosts);
 }
 
-void DCAwarePolicy::PerDCHostMap::remove_host_from_dc(const String& dc, const Host::Ptr& host) {
-  ScopedWriteLock wl(&rwlock_);
-  Map::iterator i = map_.find(dc);
-  if (i != map_.end()) {
-    cass::remove_host(i->second, host);
+void DCAwarePolicy::add_live_host(LiveHosts* live_hosts, const Host::Ptr& host) {
+  const String& dc = host->dc();
+  if (local_dc_.empty() && !dc.empty()) {
+    LOG_INFO("Using '%s' for local data center "
+             "(if this is incorrect, please provide the correct data center)",
+             host->dc().c_str());
+    local_dc_ = dc;
   }
-}
 
-bool DCAwarePolicy::PerDCHostMap::remove_host(const Address& address) {
-  ScopedWriteLock wl(&rwlock_);
-  for (Map::iterator i = map_.begin(),
-       end = map_.end(); i != end; ++i) {
-    if (cass::remove_host(i->second, address)) {
-      return true;
+  if (dc == local_dc_) {
+    add_host(live_hosts->local_dc, host);
+  } else {
+    PerDCHostMap::iterator i = live_hosts->remote_dcs.find(dc);
+    if (i == live_hosts->remote_dcs.end()) {
+      CopyOnWriteHostVec hosts(Memory::allocate<HostVec>());
+      hosts->push_back(host);
+      live_hosts->remote_dcs.insert(PerDCHostMap::value_type(dc, hosts));
+    } else {
+      add_host(i->second, host);
     }
   }
-  return false;
-}
-
-const CopyOnWriteHostVec& DCAwarePolicy::PerDCHostMap::get_hosts(const String& dc) const {
-  ScopedReadLock rl(&rwlock_);
-  Map::const_iterator i = map_.find(dc);
-  if (i == map_.end()) return no_hosts_;
-
-  return i->second;
-}
-
-void DCAwarePolicy::PerDCHostMap::copy_dcs(KeySet* dcs) const {
-  ScopedReadLock rl(&rwlock_);
-  for (Map::const_iterator i = map_.begin(),
-       end = map_.end(); i != end; ++i) {
-    dcs->insert(i->first);
-  }
-}
-
-// Helper functions to prevent copy (Notice: "const CopyOnWriteHostVec&")
-
-static const Host::Ptr& get_next_host(const CopyOnWriteHostVec& hosts, size_t index) {
-  return (*hosts)[index % hosts->size()];
 }
 
-static const Host::Ptr& get_next_host_bounded(const CopyOnWriteHostVec& hosts,
-                                              size_t index, size_t bound) {
-  return (*hosts)[index % std::min(hosts->size(), bound)];
-}
-
-static size_t get_hosts_size(const CopyOnWriteHostVec& hosts) {
-  return hosts->size();
-}
-
-DCAwarePolicy::DCAwareQueryPlan::DCAwareQueryPlan(const DCAwarePolicy* policy,
-                                                  CassConsistency cl,
-                                                  size_t start_index)
+DCAwarePolicy::DCAwareQueryPlan::DCAwareQueryPlan(DCAwarePolicy* policy,
+                                                  RequestHandler* request_handler)
   : policy_(policy)
-  , cl_(cl)
-  , hosts_(policy_->local_dc_live_hosts_)
-  , local_remaining_(get_hosts_size(hosts_))
+  , cl_(request_handler != NULL ? request_handler->consistency() : CASS_DEFAULT_CONSISTENCY)
+  , live_hosts_(policy->live_hosts_.ref())
+  , hosts_(&*live_hosts_->local_dc)
+  , remote_dc_(live_hosts_->remote_dcs.begin())
+  , local_remaining_(hosts_->size())
   , remote_remaining_(0)
-  , index_(start_index) { }
+  , index_(policy->index_++) { }
 
 Host::Ptr DCAwarePolicy::DCAwareQueryPlan::compute_next() {
+  // The hosts come from the snapshot taken when the plan was created, but
+  // they're checked against the policy's current snapshot so that hosts
+  // that went down since then are skipped.
   while (local_remaining_ > 0) {
     --local_remaining_;
-    const Host::Ptr& host(get_next_host(hosts_, index_++));
+    const Host::Ptr& host((*hosts_)[index_++ % hosts_->size()]);
     if (policy_->is_host_up(host->address())) {
       return host;
     }
@@ -222,30 +193,23 @@ Host::Ptr DCAwarePolicy::DCAwareQueryPlan::compute_next() {
     return Host::Ptr();
   }
 
-  if (!remote_dcs_) {
-    remote_dcs_.reset(Memory::allocate<PerDCHostMap::KeySet>());
-    policy_->per_remote_dc_live_hosts_.copy_dcs(remote_dcs_.get());
-  }
-
   while (true) {
     while (remote_remaining_ > 0) {
       --remote_remaining_;
-      const Host::Ptr& host(get_next_host_bounded(hosts_,
-                                                  index_++,
-                                                  policy_->used_hosts_per_remote_dc_));
+      const Host::Ptr& host((*hosts_)[index_++ % std::min(hosts_->size(),
+                                                          policy_->used_hosts_per_remote_dc_)]);
       if (policy_->is_host_up(host->address())) {
         return host;
       }
     }
 
-    if (remote_dcs_->empty()) {
+    if (remote_dc_ == live_hosts_->remote_dcs.end()) {
       break;
     }
 
-    PerDCHostMap::KeySet::iterator i = remote_dcs_->begin();
-    hosts_ = policy_->per_remote_dc_live_hosts_.get_hosts(*i);
-    remote_remaining_ = std::min(get_hosts_size(hosts_), policy_->used_hosts_per_remote_dc_);
-    remote_dcs_->erase(i);
+    hosts_ = &*remote_dc_->second;
+    remote_remaining_ = std::min(hosts_->size(), policy_->used_hosts_per_remote_dc_);
+    ++remote_dc_;
   }
 
   return Host::Ptr();
@@ -21,11 +21,8 @@
 #include "host.hpp"
 #include "map.hpp"
 #include "round_robin_policy.hpp"
-#include "scoped_ptr.hpp"
-#include "scoped_lock.hpp"
-#include "set.hpp"
-
-#include <uv.h>
+#include "ref_counted.hpp"
+#include "snapshot_ptr.hpp"
 
 namespace cass {
 
@@ -35,8 +32,6 @@ public:
                 size_t used_hosts_per_remote_dc = 0,
                 bool skip_remote_dcs_for_local_cl = true);
 
-  ~DCAwarePolicy();
-
   virtual void init(const Host::Ptr& connected_host, const HostMap& hosts, Random* random);
 
   virtual CassHostDistance distance(const Host::Ptr& host) const;
@@ -45,6 +40,11 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   virtual bool is_host_up(const Address& address) const;
 
   virtual void on_host_added(const Host::Ptr& host);
@@ -59,63 +59,57 @@ public:
   }
 
 private:
-  class PerDCHostMap {
-  public:
-    typedef cass::Map<String, CopyOnWriteHostVec> Map;
-    typedef Set<String> KeySet;
+  typedef cass::Map<String, CopyOnWriteHostVec> PerDCHostMap;
 
-    PerDCHostMap() : no_hosts_(Memory::allocate<HostVec>()) {
-      uv_rwlock_init(&rwlock_);
-    }
-    ~PerDCHostMap() { uv_rwlock_destroy(&rwlock_); }
+  /**
+   * An immutable snapshot of the live hosts. Host events publish a modified
+   * copy so that query plans and `is_host_up()` never take a lock.
+   */
+  class LiveHosts : public RefCounted<LiveHosts> {
+  public:
+    typedef SharedRefPtr<const LiveHosts> ConstPtr;
 
-    void add_host_to_dc(const String& dc, const Host::Ptr& host);
-    void remove_host_from_dc(const String& dc, const Host::Ptr& host);
-    bool remove_host(const Address& address);
-    const CopyOnWriteHostVec& get_hosts(const String& dc) const;
-    void copy_dcs(KeySet* dcs) const;
+    LiveHosts()
+      : local_dc(Memory::allocate<HostVec>()) { }
 
-  private:
-    Map map_;
-    mutable uv_rwlock_t rwlock_;
-    const CopyOnWriteHostVec no_hosts_;
+    LiveHosts(const LiveHosts& other)
+      : RefCounted<LiveHosts>()
+      , available(other.available)
+      , local_dc(other.local_dc)
+      , remote_dcs(other.remote_dcs) { }
 
-  private:
-    DISALLOW_COPY_AND_ASSIGN(PerDCHostMap);
+    AddressSet available;
+    CopyOnWriteHostVec local_dc;
+    PerDCHostMap remote_dcs; // Ordered by data center name
   };
 
-  const CopyOnWriteHostVec& get_local_dc_hosts() const;
-  void get_remote_dcs(PerDCHostMap::KeySet* remote_dcs) const;
+  void add_live_host(LiveHosts* live_hosts, const Host::Ptr& host);
 
 public:
   class DCAwareQueryPlan : public QueryPlan {
   public:
-    DCAwareQueryPlan(const DCAwarePolicy* policy,
-                     CassConsistency cl,
-                     size_t start_index);
+    DCAwareQueryPlan(DCAwarePolicy* policy,
+                     RequestHandler* request_handler);
 
     virtual Host::Ptr compute_next();
 
   private:
     const DCAwarePolicy* policy_;
     CassConsistency cl_;
-    CopyOnWriteHostVec hosts_;
-    ScopedPtr<PerDCHostMap::KeySet> remote_dcs_;
+    LiveHosts::ConstPtr live_hosts_;
+    const HostVec* hosts_;
+    PerDCHostMap::const_iterator remote_dc_;
     size_t local_remaining_;
     size_t remote_remaining_;
     size_t index_;
   };
 
 private:
-  mutable uv_rwlock_t available_rwlock_;
-  AddressSet available_;
-
   String local_dc_;
   size_t used_hosts_per_remote_dc_;
   bool skip_remote_dcs_for_local_cl_;
 
-  CopyOnWriteHostVec local_dc_live_hosts_;
-  PerDCHostMap per_remote_dc_live_hosts_;
+  SnapshotPtr<LiveHosts> live_hosts_;
   size_t index_;
 
 private:
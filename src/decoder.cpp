@@ -34,6 +34,36 @@ void Decoder::maybe_log_remaining() const {
   }
 }
 
+bool Decoder::index_rows(size_t row_count, size_t column_count,
+                         Vector<uint32_t>* row_offsets) const {
+  // Each value's position depends on the length of the previous value so this
+  // is a single sequential pass. It only keeps a pointer and checks the bounds
+  // once for each length and value.
+  const char* pos = input_;
+  const char* end = input_ + remaining_;
+  row_offsets->clear();
+  row_offsets->reserve(row_count);
+  for (size_t row = 0; row < row_count; ++row) {
+    row_offsets->push_back(static_cast<uint32_t>(pos - input_));
+    for (size_t column = 0; column < column_count; ++column) {
+      if (end - pos < static_cast<ptrdiff_t>(sizeof(int32_t))) {
+        notify_error("length of bytes", sizeof(int32_t));
+        return false;
+      }
+      int32_t size;
+      pos = cass::decode_int32(pos, size);
+      if (size > 0) { // Null values have a negative size
+        if (end - pos < size) {
+          notify_error("bytes", size);
+          return false;
+        }
+        pos += size;
+      }
+    }
+  }
+  return true;
+}
+
 bool Decoder::decode_inet(Address* output) {
   CHECK_REMAINING(sizeof(uint8_t), "length of inet");
 
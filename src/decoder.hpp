@@ -22,6 +22,9 @@
 #include "protocol.hpp"
 #include "serialization.hpp"
 #include "small_vector.hpp"
+#include "vector.hpp"
+
+#include <assert.h>
 
 #ifdef _WIN32
 # ifndef snprintf
@@ -573,6 +576,30 @@ public:
   bool decode_value(const DataType::ConstPtr& data_type, Value& output,
                     bool is_inside_collection = false);
 
+  /**
+   * Validate the values of rows (each value is `[bytes]`) in a single pass
+   * and record where each row starts. The decoder isn't advanced.
+   *
+   * @param row_count The number of rows.
+   * @param column_count The number of values in each row.
+   * @param row_offsets The offset of each row from the current position.
+   * @return false if the rows are truncated.
+   */
+  bool index_rows(size_t row_count, size_t column_count,
+                  Vector<uint32_t>* row_offsets) const;
+
+  /**
+   * A decoder for the input starting at an offset from the current position
+   * (e.g. an offset from `index_rows()`).
+   */
+  inline Decoder slice(size_t offset) const {
+    assert(offset <= remaining_);
+    Decoder decoder(*this);
+    decoder.input_ += offset;
+    decoder.remaining_ -= offset;
+    return decoder;
+  }
+
 protected:
   // Testing only
   inline const char* buffer() const { return input_; }
@@ -48,7 +48,8 @@ EventLoop::EventLoop()
   , is_joinable_(false)
   , is_closing_(false)
   , io_time_start_(0)
-  , io_time_elapsed_(0) {
+  , io_time_elapsed_(0)
+  , cpu_(-1) {
   // Set user data for PooledConnection to start the I/O elapsed time.
   loop_.data = this;
 }
@@ -75,6 +76,7 @@ int EventLoop::init(const String& thread_name /*= ""*/) {
   rc = async_.start(loop(), bind_callback(&EventLoop::on_task, this));
   if (rc != 0) return rc;
   rc = check_.start(loop(), bind_callback(&EventLoop::on_check, this));
+  timer_wheel_.init(loop());
   is_loop_initialized_ = true;
 
 #if defined(HAVE_SIGTIMEDWAIT) && !defined(HAVE_NOSIGPIPE)
@@ -168,6 +170,13 @@ void EventLoop::internal_on_run(void* arg) {
 }
 
 void EventLoop::handle_run() {
+  if (cpu_ >= 0) {
+    // Pinning happens first so that memory the loop allocates and touches
+    // (e.g. connection buffers) is placed on the CPU's NUMA node.
+    if (!set_thread_affinity(static_cast<unsigned>(cpu_))) {
+      LOG_WARN("Unable to pin event loop thread to CPU %d", cpu_);
+    }
+  }
   on_run();
   uv_run(loop(), UV_RUN_DEFAULT);
   on_after_run();
@@ -196,6 +205,7 @@ void EventLoop::on_task(Async* async) {
   if (is_closing_.load() && tasks_.is_empty()) {
     async_.close_handle();
     check_.close_handle();
+    timer_wheel_.close_handles();
 #if defined(HAVE_SIGTIMEDWAIT) && !defined(HAVE_NOSIGPIPE)
     uv_prepare_stop(&prepare_);
     uv_close(reinterpret_cast<uv_handle_t*>(&prepare_), NULL);
@@ -210,8 +220,12 @@ void EventLoop::on_prepare(uv_prepare_t* prepare) {
 }
 #endif
 
-int RoundRobinEventLoopGroup::init(const String& thread_name /*= ""*/) {
+int RoundRobinEventLoopGroup::init(const String& thread_name /*= ""*/,
+                                   const Vector<unsigned>& cpus /*= Vector<unsigned>()*/) {
   for (size_t i = 0; i < threads_.size(); ++i) {
+    if (!cpus.empty()) {
+      threads_[i].set_cpu(static_cast<int>(cpus[i % cpus.size()]));
+    }
     int rc = threads_[i].init(thread_name);
     if (rc != 0) return rc;
   }
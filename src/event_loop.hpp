@@ -25,6 +25,7 @@
 #include "macros.hpp"
 #include "loop_watcher.hpp"
 #include "scoped_lock.hpp"
+#include "timer_wheel.hpp"
 #include "utils.hpp"
 
 #include <assert.h>
@@ -100,6 +101,14 @@ public:
   uint64_t io_time_elapsed() const { return io_time_elapsed_; }
 
 
+  /**
+   * Get the timing wheel used for request timers. This must only be used on
+   * the event loop thread.
+   *
+   * @return The event loop's timing wheel.
+   */
+  TimerWheel* timer_wheel() { return &timer_wheel_; }
+
   /**
    * Determines if we're running on this event loop.
    *
@@ -114,6 +123,21 @@ public:
    */
   const String& name() const { return name_; }
 
+  /**
+   * Pin the event loop thread to a CPU. This must be called before the
+   * thread is started (*NOT* thread-safe).
+   *
+   * @param cpu The CPU or -1 to not pin the thread.
+   */
+  void set_cpu(int cpu) { cpu_ = cpu; }
+
+  /**
+   * Get the CPU the event loop thread is pinned to.
+   *
+   * @return The CPU or -1 if the thread isn't pinned.
+   */
+  int cpu() const { return cpu_; }
+
 protected:
   /**
    * A callback that's run before the event loop is run.
@@ -164,10 +188,12 @@ private:
   Atomic<bool> is_closing_;
 
   Check check_;
+  TimerWheel timer_wheel_;
   uint64_t io_time_start_;
   uint64_t io_time_elapsed_;
 
   String name_;
+  int cpu_;
 };
 
 /**
@@ -211,7 +237,17 @@ public:
     : current_(0)
     , threads_(num_threads) { }
 
-  int init(const String& thread_name = "");
+  /**
+   * Initialize the event loops.
+   *
+   * @param thread_name The name of the threads (optional).
+   * @param cpus The CPUs to pin the threads to. They're assigned to the
+   * threads in order, wrapping around if there are more threads than CPUs.
+   * The threads aren't pinned if this is empty.
+   * @return Returns 0 if successful, otherwise an error occurred.
+   */
+  int init(const String& thread_name = "",
+           const Vector<unsigned>& cpus = Vector<unsigned>());
   int run();
   void close_handles();
   void join();
@@ -34,7 +34,9 @@ public:
 
   virtual int encode(ProtocolVersion version, RequestCallback* callback, BufferVec* bufs) const;
 
-  bool get_routing_key(String* routing_key)  const {
+  using RoutableRequest::get_routing_key;
+
+  virtual bool get_routing_key(RoutingKey* routing_key) const {
     return calculate_routing_key(prepared_->key_indices(), routing_key);
   }
 
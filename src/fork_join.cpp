@@ -0,0 +1,210 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "fork_join.hpp"
+
+#include "atomic.hpp"
+#include "scoped_lock.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <uv.h>
+
+namespace cass {
+
+namespace {
+
+struct Batch {
+  Batch(size_t num_tasks, ForkJoin::Func func, void* data)
+    : num_tasks(num_tasks)
+    , func(func)
+    , data(data)
+    , next(0) { }
+
+  const size_t num_tasks;
+  const ForkJoin::Func func;
+  void* const data;
+  Atomic<size_t> next;
+};
+
+void run_tasks(Batch* batch) {
+  for (size_t index = batch->next.fetch_add(1);
+       index < batch->num_tasks;
+       index = batch->next.fetch_add(1)) {
+    batch->func(batch->data, index);
+  }
+}
+
+/**
+ * The worker threads are created the first time they're needed and are kept
+ * (parked) while the driver is in use so that token map builds don't create
+ * and join threads each time. They're joined once the last user releases the
+ * pool. Only one batch is run by the workers at a time.
+ */
+struct WorkerPool {
+  uv_mutex_t run_mutex; // Held by the thread running a batch on the workers
+  uv_mutex_t mutex;
+  uv_cond_t work_cond;
+  uv_cond_t done_cond;
+  Batch* batch;
+  size_t slots; // The number of workers that can still join the batch
+  size_t active; // The number of workers running the batch
+  size_t users; // Sessions and batches that keep the workers alive
+  bool is_stopping;
+  Vector<uv_thread_t> workers;
+  size_t num_cpus;
+};
+
+WorkerPool pool__;
+uv_once_t pool_init_guard__ = UV_ONCE_INIT;
+
+void init_pool() {
+  uv_mutex_init(&pool__.run_mutex);
+  uv_mutex_init(&pool__.mutex);
+  uv_cond_init(&pool__.work_cond);
+  uv_cond_init(&pool__.done_cond);
+  pool__.batch = NULL;
+  pool__.slots = 0;
+  pool__.active = 0;
+  pool__.users = 0;
+  pool__.is_stopping = false;
+
+  pool__.num_cpus = 1;
+  uv_cpu_info_t* cpu_infos;
+  int cpu_count;
+  if (uv_cpu_info(&cpu_infos, &cpu_count) == 0) {
+    uv_free_cpu_info(cpu_infos, cpu_count);
+    if (cpu_count > 0) pool__.num_cpus = static_cast<size_t>(cpu_count);
+  }
+}
+
+void on_worker(void* arg) {
+  uv_mutex_lock(&pool__.mutex);
+  while (true) {
+    while (!pool__.is_stopping &&
+           (pool__.batch == NULL || pool__.slots == 0)) {
+      uv_cond_wait(&pool__.work_cond, &pool__.mutex);
+    }
+    if (pool__.is_stopping) break;
+    Batch* batch = pool__.batch;
+    pool__.slots--;
+    pool__.active++;
+    uv_mutex_unlock(&pool__.mutex);
+
+    run_tasks(batch);
+
+    uv_mutex_lock(&pool__.mutex);
+    if (--pool__.active == 0) {
+      uv_cond_signal(&pool__.done_cond);
+    }
+  }
+  uv_mutex_unlock(&pool__.mutex);
+}
+
+void acquire_pool() {
+  ScopedMutex lock(&pool__.mutex);
+  pool__.users++;
+}
+
+// This must be called with the run mutex held so that the workers aren't
+// used by a batch while they're being joined.
+void release_pool() {
+  Vector<uv_thread_t> workers;
+  {
+    ScopedMutex lock(&pool__.mutex);
+    if (--pool__.users > 0) return;
+    pool__.is_stopping = true;
+    pool__.workers.swap(workers);
+    uv_cond_broadcast(&pool__.work_cond);
+  }
+
+  for (Vector<uv_thread_t>::iterator it = workers.begin(),
+       end = workers.end(); it != end; ++it) {
+    uv_thread_join(&(*it));
+  }
+
+  ScopedMutex lock(&pool__.mutex);
+  pool__.is_stopping = false;
+}
+
+} // namespace
+
+size_t ForkJoin::num_threads() {
+  uv_once(&pool_init_guard__, init_pool);
+  return pool__.num_cpus;
+}
+
+void ForkJoin::acquire() {
+  uv_once(&pool_init_guard__, init_pool);
+  acquire_pool();
+}
+
+void ForkJoin::release() {
+  uv_once(&pool_init_guard__, init_pool);
+  ScopedMutex lock(&pool__.run_mutex); // Wait for a running batch
+  release_pool();
+}
+
+void ForkJoin::run(size_t num_tasks, size_t num_threads, Func func, void* data) {
+  Batch batch(num_tasks, func, data);
+
+  // The calling thread is one of the threads
+  size_t num_workers = std::min(num_threads, num_tasks);
+  num_workers = num_workers > 0 ? num_workers - 1 : 0;
+
+  // The batch is run on the calling thread alone if it doesn't need workers
+  // or if another batch is already using them.
+  uv_once(&pool_init_guard__, init_pool);
+  if (num_workers == 0 || uv_mutex_trylock(&pool__.run_mutex) != 0) {
+    run_tasks(&batch);
+    return;
+  }
+
+  // The batch keeps the workers alive if there are no other users
+  acquire_pool();
+
+  {
+    ScopedMutex lock(&pool__.mutex);
+    while (pool__.workers.size() < num_workers) {
+      uv_thread_t thread;
+      // If a thread can't be created the tasks are run by the existing
+      // threads.
+      if (uv_thread_create(&thread, on_worker, NULL) != 0) break;
+      pool__.workers.push_back(thread);
+    }
+    pool__.batch = &batch;
+    pool__.slots = std::min(num_workers, pool__.workers.size());
+    uv_cond_broadcast(&pool__.work_cond);
+  }
+
+  run_tasks(&batch);
+
+  {
+    // Stop workers from joining and wait for the ones that joined to finish
+    // their last task before the batch goes out of scope.
+    ScopedMutex lock(&pool__.mutex);
+    pool__.batch = NULL;
+    pool__.slots = 0;
+    while (pool__.active > 0) {
+      uv_cond_wait(&pool__.done_cond, lock.get());
+    }
+  }
+
+  release_pool();
+  uv_mutex_unlock(&pool__.run_mutex);
+}
+
+} // namespace cass
@@ -0,0 +1,75 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_FORK_JOIN_HPP_INCLUDED__
+#define __CASS_FORK_JOIN_HPP_INCLUDED__
+
+#include <stddef.h>
+
+namespace cass {
+
+/**
+ * Runs a batch of independent, CPU bound tasks on worker threads and waits
+ * for all of them to finish. The calling thread also runs tasks so a batch
+ * that's run with a single thread doesn't use any workers. Tasks are taken
+ * in order from a shared counter so threads that finish early pick up the
+ * remaining work.
+ *
+ * The workers are a pool that's created the first time it's needed and reused
+ * by later batches while it has users (sessions). It's joined when the last
+ * user releases it, otherwise when the batch that created it finishes. A
+ * batch that's started while another batch is using the workers is run on the
+ * calling thread.
+ */
+class ForkJoin {
+public:
+  typedef void (*Func)(void* data, size_t index);
+
+  /**
+   * The number of threads to use for a batch (the number of CPUs). This is
+   * determined once.
+   *
+   * @return The number of threads (at least one).
+   */
+  static size_t num_threads();
+
+  /**
+   * Keep the worker threads between batches (thread-safe).
+   */
+  static void acquire();
+
+  /**
+   * Release the worker threads. The threads are joined when the last user
+   * releases them; this waits for a batch that's running (thread-safe).
+   */
+  static void release();
+
+  /**
+   * Run tasks and wait for them to finish.
+   *
+   * @param num_tasks The number of tasks. `func` is called once with each
+   * index in [0, num_tasks).
+   * @param num_threads The maximum number of threads, including the
+   * calling thread.
+   * @param func The function that runs a task.
+   * @param data User data passed to `func`.
+   */
+  static void run(size_t num_tasks, size_t num_threads, Func func, void* data);
+};
+
+} // namespace cass
+
+#endif
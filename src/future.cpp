@@ -21,6 +21,7 @@
 #include "request_handler.hpp"
 #include "result_response.hpp"
 #include "scoped_ptr.hpp"
+#include "utils.hpp"
 
 extern "C" {
 
@@ -189,26 +190,48 @@ bool Future::set_callback(Future::Callback callback, void* data) {
   }
   callback_ = callback;
   data_ = data;
-  if (is_set_) {
-    // Run the callback if the future is already set
-    lock.unlock();
+  int state = add_state(STATE_CALLBACK);
+  lock.unlock();
+  if (state & STATE_SET) {
+    // Run the callback if the future is already set. The setter didn't see
+    // the callback.
     callback(CassFuture::to(this), data);
   }
   return true;
 }
 
-void Future::internal_set(ScopedMutex& lock) {
-  is_set_ = true;
-  if (callback_) {
-    Callback callback = callback_;
-    void* data = data_;
-    lock.unlock();
-    callback(CassFuture::to(this), data);
-    lock.lock();
+void Future::internal_set() {
+  // The future is ready on this thread while the callback runs so that the
+  // callback can use functions that wait on the future (e.g. getting the
+  // result) without blocking. Other threads wait until the callback has
+  // finished so that they see its side effects.
+  setter_thread_ = uv_thread_self();
+  int state = add_state(STATE_SET);
+  if (state & STATE_CALLBACK) {
+    callback_(CassFuture::to(this), data_);
+  }
+  state = add_state(STATE_DONE);
+  if (state & STATE_BLOCKED) {
+    ScopedMutex lock(&mutex_);
+    add_state(STATE_NOTIFIED);
+    uv_cond_broadcast(&cond_);
+  }
+}
+
+bool Future::spin_wait() const {
+  if (wait_spin_time_us_ == 0) return false;
+
+  // Check often at first, then yield to other threads until the spin time
+  // has elapsed.
+  for (int i = 0; i < 64; ++i) {
+    if (ready()) return true;
   }
-  // Broadcast after we've run the callback so that threads waiting
-  // on this future see the side effects of the callback.
-  uv_cond_broadcast(&cond_);
+  uint64_t deadline = uv_hrtime() + wait_spin_time_us_ * 1000ULL;
+  do {
+    thread_yield();
+    if (ready()) return true;
+  } while (uv_hrtime() < deadline);
+  return false;
 }
 
 } // namespace cass
@@ -26,6 +26,7 @@
 #include "scoped_ptr.hpp"
 #include "string.hpp"
 #include "ref_counted.hpp"
+#include "vector.hpp"
 
 #include <uv.h>
 #include <assert.h>
@@ -34,9 +35,31 @@ namespace cass {
 
 struct Error;
 
+/**
+ * A future's completion is tracked using an atomic state so that setting a
+ * future, and checking or waiting on a future that's already set, doesn't
+ * take a lock. The mutex is only used to register a callback and to block
+ * waiting threads. The condition variable used to block waiting threads is
+ * only created when a thread actually blocks.
+ *
+ * A future moves through the following states:
+ *
+ * 1) Pending: The future can be claimed by exactly one setter.
+ * 2) Claimed: The setter is writing the future's result.
+ * 3) Set: The result is written and the callback, if any, is running. The
+ *    future is only `ready()` on the setter's thread so that the callback can
+ *    use functions that wait on the future (e.g. getting the result).
+ * 4) Done: The future is `ready()` on all threads and blocked threads are
+ *    released. Waiting threads always see the side effects of the callback.
+ *
+ * Waiting threads can optionally spin for a short amount of time before
+ * blocking (see `set_wait_spin_time_us()`). This avoids the cost of sleeping
+ * and waking a thread when results are expected to arrive quickly.
+ */
 class Future : public RefCounted<Future> {
 public:
   typedef SharedRefPtr<Future> Ptr;
+  typedef Vector<Ptr> Vec;
   typedef void (*Callback)(CassFuture*, void*);
 
   enum Type {
@@ -55,50 +78,61 @@ public:
   };
 
   Future(Type type)
-      : is_set_(false)
+      : state_(0)
+      , is_cond_initialized_(false)
       , type_(type)
-      , callback_(NULL) {
+      , wait_spin_time_us_(0)
+      , callback_(NULL)
+      , data_(NULL) {
     uv_mutex_init(&mutex_);
-    uv_cond_init(&cond_);
   }
 
   virtual ~Future() {
     uv_mutex_destroy(&mutex_);
-    uv_cond_destroy(&cond_);
+    if (is_cond_initialized_) {
+      uv_cond_destroy(&cond_);
+    }
   }
 
   Type type() const { return type_; }
 
-  bool ready() {
-    ScopedMutex lock(&mutex_);
-    return is_set_;
+  /**
+   * Set the maximum amount of time a waiting thread spins checking the
+   * future before blocking.
+   *
+   * @param spin_time_us The spin time in microseconds (0 to disable spinning).
+   */
+  void set_wait_spin_time_us(unsigned spin_time_us) { wait_spin_time_us_ = spin_time_us; }
+
+  bool ready() const {
+    int state = state_.load(MEMORY_ORDER_ACQUIRE);
+    return (state & STATE_DONE) != 0 ||
+           // The setter's thread is only recorded once the future is set
+           ((state & STATE_SET) != 0 && uv_thread_self() == setter_thread_);
   }
 
   virtual void wait() {
-    ScopedMutex lock(&mutex_);
-    internal_wait(lock);
+    internal_wait();
   }
 
   virtual bool wait_for(uint64_t timeout_us) {
-    ScopedMutex lock(&mutex_);
-    return internal_wait_for(lock, timeout_us);
+    return internal_wait_for(timeout_us);
   }
 
   Error* error() {
-    ScopedMutex lock(&mutex_);
-    internal_wait(lock);
+    internal_wait();
     return error_.get();
   }
 
   void set() {
-    ScopedMutex lock(&mutex_);
-    internal_set(lock);
+    if (claim()) {
+      internal_set();
+    }
   }
 
   bool set_error(CassError code, const String& message) {
-    ScopedMutex lock(&mutex_);
-    if (!is_set_) {
-      internal_set_error(code, message, lock);
+    if (claim()) {
+      internal_set_error(code, message);
       return true;
     }
     return false;
@@ -107,36 +141,98 @@ public:
   bool set_callback(Callback callback, void* data);
 
 protected:
-  bool is_set() const { return is_set_; }
+  /**
+   * Claim the future so that its result can be written. Only one thread can
+   * claim a future and the claiming thread must then call `internal_set()`
+   * or `internal_set_error()`.
+   *
+   * @return true if the future was claimed, false if it was already claimed.
+   */
+  bool claim() {
+    int state = state_.load(MEMORY_ORDER_RELAXED);
+    do {
+      if (state & STATE_CLAIMED) return false;
+    } while (!state_.compare_exchange_weak(state, state | STATE_CLAIMED));
+    return true;
+  }
 
-  void internal_wait(ScopedMutex& lock) {
-    while (!is_set_) {
-      uv_cond_wait(&cond_, lock.get());
+  void internal_wait() {
+    if (ready() || spin_wait()) return;
+    ScopedMutex lock(&mutex_);
+    if (prepare_to_block()) {
+      while (!is_notified()) {
+        uv_cond_wait(&cond_, lock.get());
+      }
     }
   }
 
-  bool internal_wait_for(ScopedMutex& lock, uint64_t timeout_us) {
-    if (!is_set_) {
-      if (uv_cond_timedwait(&cond_, lock.get(), timeout_us * 1000) != 0) { // Expects nanos
-        return false;
+  bool internal_wait_for(uint64_t timeout_us) {
+    if (ready() || spin_wait()) return true;
+    uint64_t deadline = uv_hrtime() + timeout_us * 1000; // Expects nanos
+    ScopedMutex lock(&mutex_);
+    if (prepare_to_block()) {
+      while (!is_notified()) {
+        uint64_t now = uv_hrtime();
+        if (now >= deadline ||
+            uv_cond_timedwait(&cond_, lock.get(), deadline - now) != 0) {
+          return ready();
+        }
       }
     }
-    return is_set_;
+    return true;
   }
 
-  void internal_set(ScopedMutex& lock);
+  void internal_set();
 
-  void internal_set_error(CassError code, const String& message, ScopedMutex& lock) {
+  void internal_set_error(CassError code, const String& message) {
     error_.reset(Memory::allocate<Error>(code, message));
-    internal_set(lock);
+    internal_set();
   }
 
   uv_mutex_t mutex_;
 
 private:
-  bool is_set_;
+  enum {
+    STATE_CLAIMED  = 1 << 0,
+    STATE_SET      = 1 << 1,
+    STATE_DONE     = 1 << 2, // The callback (if any) has finished
+    STATE_CALLBACK = 1 << 3, // A callback is registered
+    STATE_BLOCKED  = 1 << 4, // A thread is (or is about to be) blocked
+    STATE_NOTIFIED = 1 << 5  // Blocked threads have been released
+  };
+
+  bool spin_wait() const;
+
+  // Add state flags and return the previous state
+  int add_state(int flags) {
+    int state = state_.load(MEMORY_ORDER_RELAXED);
+    while (!state_.compare_exchange_weak(state, state | flags)) { }
+    return state;
+  }
+
+  bool is_notified() const {
+    return (state_.load(MEMORY_ORDER_ACQUIRE) & STATE_NOTIFIED) != 0;
+  }
+
+  // This must be called with the mutex held. Blocked threads wait for the
+  // setter to notify them (instead of only checking if the future is set)
+  // so that the future isn't destroyed while the setter is still using it.
+  bool prepare_to_block() {
+    if (!is_cond_initialized_) {
+      uv_cond_init(&cond_);
+      is_cond_initialized_ = true;
+    }
+    int state = add_state(STATE_BLOCKED);
+    return (state & STATE_DONE) == 0;
+  }
+
+private:
+  Atomic<int> state_;
+  uv_thread_t setter_thread_;
   uv_cond_t cond_;
+  bool is_cond_initialized_;
   Type type_;
+  unsigned wait_spin_time_us_;
   ScopedPtr<Error> error_;
   Callback callback_;
   void* data_;
@@ -31,20 +31,35 @@ void HostTargetingPolicy::init(const SharedRefPtr<Host>& connected_host,
 QueryPlan* HostTargetingPolicy::new_query_plan(const String& keyspace,
                                                RequestHandler* request_handler,
                                                const TokenMap* token_map) {
-  QueryPlan* child_plan = child_policy_->new_query_plan(keyspace,
-                                                        request_handler,
-                                                        token_map);
+  return emplace_query_plan(NULL, keyspace, request_handler, token_map);
+}
+
+QueryPlan* HostTargetingPolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                                   const String& keyspace,
+                                                   RequestHandler* request_handler,
+                                                   const TokenMap* token_map) {
   if (request_handler == NULL ||
       !request_handler->preferred_address().is_valid()) {
-    return child_plan;
+    return child_policy_->emplace_query_plan(storage,
+                                             keyspace,
+                                             request_handler,
+                                             token_map);
   }
 
   HostMap::const_iterator it = hosts_.find(request_handler->preferred_address());
   if (it == hosts_.end() || !is_host_up(it->first)) {
-    return child_plan;
+    return child_policy_->emplace_query_plan(storage,
+                                             keyspace,
+                                             request_handler,
+                                             token_map);
   }
 
-  return Memory::allocate<HostTargetingQueryPlan>(it->second, child_plan);
+  // The child plan is owned by this plan so it can't use the storage
+  return new (QueryPlanStorage::allocate(storage, sizeof(HostTargetingQueryPlan)))
+      HostTargetingQueryPlan(it->second,
+                             child_policy_->new_query_plan(keyspace,
+                                                           request_handler,
+                                                           token_map));
 }
 
 void HostTargetingPolicy::on_host_added(const SharedRefPtr<Host>& host) {
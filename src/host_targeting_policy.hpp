@@ -36,6 +36,11 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   virtual LoadBalancingPolicy* new_instance() {
     return Memory::allocate<HostTargetingPolicy>(child_policy_->new_instance());
   }
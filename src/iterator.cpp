@@ -105,6 +105,13 @@ const CassRow* cass_iterator_get_row(const CassIterator* iterator) {
                        iterator->from())->row());
 }
 
+CassError cass_iterator_seek_row(CassIterator* iterator, size_t index) {
+  if (iterator->type() != CASS_ITERATOR_TYPE_RESULT) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  return static_cast<cass::ResultIterator*>(iterator->from())->seek(index);
+}
+
 const CassValue* cass_iterator_get_column(const CassIterator* iterator) {
   if (iterator->type() != CASS_ITERATOR_TYPE_ROW) {
     return NULL;
@@ -47,10 +47,19 @@ void LatencyAwarePolicy::close_handles() {
 QueryPlan* LatencyAwarePolicy::new_query_plan(const String& keyspace,
                                               RequestHandler* request_handler,
                                               const TokenMap* token_map) {
-  return Memory::allocate<LatencyAwareQueryPlan>(this,
-                                                 child_policy_->new_query_plan(keyspace,
-                                                                               request_handler,
-                                                                               token_map));
+  return emplace_query_plan(NULL, keyspace, request_handler, token_map);
+}
+
+QueryPlan* LatencyAwarePolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                                  const String& keyspace,
+                                                  RequestHandler* request_handler,
+                                                  const TokenMap* token_map) {
+  // The child plan is deleted by this plan so it's always heap allocated
+  return new (QueryPlanStorage::allocate(storage, sizeof(LatencyAwareQueryPlan)))
+      LatencyAwareQueryPlan(this,
+                            child_policy_->new_query_plan(keyspace,
+                                                          request_handler,
+                                                          token_map));
 }
 
 void LatencyAwarePolicy::on_host_added(const Host::Ptr& host) {
@@ -59,6 +59,11 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   virtual LoadBalancingPolicy* new_instance() {
     return Memory::allocate<LatencyAwarePolicy>(child_policy_->new_instance(), settings_);
   }
@@ -54,6 +54,16 @@ QueryPlan* ListPolicy::new_query_plan(const String& keyspace,
                                        token_map);
 }
 
+QueryPlan* ListPolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                          const String& keyspace,
+                                          RequestHandler* request_handler,
+                                          const TokenMap* token_map) {
+  return child_policy_->emplace_query_plan(storage,
+                                           keyspace,
+                                           request_handler,
+                                           token_map);
+}
+
 void ListPolicy::on_host_added(const Host::Ptr& host) {
   if (is_valid_host(host)) {
     child_policy_->on_host_added(host);
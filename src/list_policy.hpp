@@ -38,6 +38,11 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   virtual void on_host_added(const Host::Ptr& host);
   virtual void on_host_removed(const Host::Ptr& host);
 
@@ -17,9 +17,11 @@
 #ifndef __CASS_LOAD_BALANCING_HPP_INCLUDED__
 #define __CASS_LOAD_BALANCING_HPP_INCLUDED__
 
+#include "aligned_storage.hpp"
 #include "cassandra.h"
 #include "constants.hpp"
 #include "host.hpp"
+#include "macros.hpp"
 #include "memory.hpp"
 #include "request.hpp"
 #include "string.hpp"
@@ -73,6 +75,74 @@ public:
   }
 };
 
+/**
+ * Storage for a query plan that's embedded in the plan's owner (e.g. a
+ * request handler) so that the common load balancing policies can create
+ * their query plans without a heap allocation. The storage holds a single
+ * plan; plans that don't fit, and plans nested inside another plan, are heap
+ * allocated. It owns the plan either way.
+ */
+class QueryPlanStorage {
+public:
+  QueryPlanStorage()
+    : plan_(NULL)
+    , is_pending_(false) { }
+
+  ~QueryPlanStorage() { reset(); }
+
+  /**
+   * Allocate memory for a query plan. The plan must be constructed in the
+   * memory using placement new and then passed to `reset()` (or to
+   * `Memory::deallocate()` if the storage is NULL). The storage's current
+   * plan is destroyed if the plan is stored inline.
+   *
+   * @param storage The storage for the plan. If NULL the plan is heap
+   * allocated.
+   * @param size The size of the plan.
+   * @return The memory for the plan.
+   */
+  static void* allocate(QueryPlanStorage* storage, size_t size) {
+    if (storage != NULL && !storage->is_pending_ && size <= STORAGE_SIZE) {
+      storage->reset();
+      storage->is_pending_ = true;
+      return storage->storage_.address();
+    }
+    return Memory::malloc(size);
+  }
+
+  /**
+   * Destroy the current plan and take ownership of a new plan.
+   *
+   * @param plan A plan allocated using this storage, a heap allocated plan
+   * or NULL.
+   */
+  void reset(QueryPlan* plan = NULL) {
+    if (plan_ != NULL) {
+      if (dynamic_cast<void*>(plan_) == storage_.address()) {
+        plan_->~QueryPlan();
+      } else {
+        Memory::deallocate(plan_);
+      }
+    }
+    plan_ = plan;
+    is_pending_ = false;
+  }
+
+  QueryPlan* get() const { return plan_; }
+  QueryPlan* operator->() const { return plan_; }
+
+private:
+  // Large enough for a token-aware plan with an embedded DC-aware plan
+  static const size_t STORAGE_SIZE = 256;
+
+  AlignedStorage<STORAGE_SIZE, 16> storage_;
+  QueryPlan* plan_;
+  bool is_pending_; // The inline memory was allocated, but not yet reset()
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(QueryPlanStorage);
+};
+
 class LoadBalancingPolicy
     : public RefCounted<LoadBalancingPolicy> {
 public:
@@ -101,6 +171,22 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map) = 0;
 
+  /**
+   * Create a query plan in the provided storage to avoid a heap allocation
+   * (see `QueryPlanStorage::allocate()`). Policies that don't override this
+   * heap allocate their plans using `new_query_plan()`.
+   *
+   * @param storage The storage for the plan. If NULL the plan is heap
+   * allocated.
+   * @return The plan. The caller must pass it to `storage->reset()`.
+   */
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map) {
+    return new_query_plan(keyspace, request_handler, token_map);
+  }
+
   virtual LoadBalancingPolicy* new_instance() = 0;
 };
 
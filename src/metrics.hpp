@@ -20,8 +20,12 @@
 #ifndef __CASS_METRICS_HPP_INCLUDED__
 #define __CASS_METRICS_HPP_INCLUDED__
 
+#include "address.hpp"
 #include "atomic.hpp"
 #include "constants.hpp"
+#include "iterator.hpp"
+#include "map.hpp"
+#include "ref_counted.hpp"
 #include "scoped_ptr.hpp"
 #include "scoped_lock.hpp"
 #include "utils.hpp"
@@ -31,6 +35,7 @@
 
 #include <uv.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <math.h>
 
@@ -77,12 +82,12 @@ public:
       : thread_state_(thread_state)
       , counters_(thread_state->max_threads()) {}
 
-    void inc() {
-      counters_[thread_state_->current_thread_id()].add(1LL);
+    void inc(int64_t n = 1LL) {
+      counters_[thread_state_->current_thread_id()].add(n);
     }
 
-    void dec() {
-      counters_[thread_state_->current_thread_id()].sub(1LL);
+    void dec(int64_t n = 1LL) {
+      counters_[thread_state_->current_thread_id()].sub(n);
     }
 
     int64_t sum() const {
@@ -139,6 +144,36 @@ public:
     DISALLOW_COPY_AND_ASSIGN(Counter);
   };
 
+  /**
+   * A value that's computed when it's read. This is used for values that are
+   * already tracked elsewhere so that nothing extra is written when requests
+   * are processed.
+   */
+  class Gauge {
+  public:
+    typedef int64_t (*Func)(void* data);
+
+    Gauge()
+      : func_(NULL)
+      , data_(NULL) {}
+
+    void set(Func func, void* data) {
+      func_ = func;
+      data_ = data;
+    }
+
+    int64_t get() const {
+      return func_ != NULL ? func_(data_) : 0;
+    }
+
+  private:
+    Func func_;
+    void* data_;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(Gauge);
+  };
+
   class ExponentiallyWeightedMovingAverage {
     public:
       static const uint64_t INTERVAL = 5;
@@ -285,10 +320,21 @@ public:
       int64_t percentile_999th;
     };
 
-    Histogram(ThreadState* thread_state)
+    /**
+     * Constructor.
+     *
+     * @param thread_state The thread state used to find the current thread's
+     * histogram.
+     * @param significant_figures The precision of recorded values. Each extra
+     * figure increases the size of the histogram by ~10x.
+     */
+    Histogram(ThreadState* thread_state, int significant_figures = 3)
       : thread_state_(thread_state)
       , histograms_(thread_state->max_threads()) {
-      hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, 3, &histogram_);
+      hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, significant_figures, &histogram_);
+      for (size_t i = 0; i < histograms_.size(); ++i) {
+        histograms_[i].init(significant_figures);
+      }
       uv_mutex_init(&mutex_);
     }
 
@@ -301,12 +347,26 @@ public:
       histograms_[thread_state_->current_thread_id()].record_value(value);
     }
 
+    /**
+     * Cumulative counts of the recorded values using power of two bucket
+     * boundaries. Unlike a snapshot this keeps the shape of the distribution
+     * so that it can be exported and aggregated (e.g. as an OpenMetrics
+     * histogram).
+     */
+    struct Buckets {
+      // The last boundary (2^32) is larger than the highest trackable value
+      static const int COUNT = 33;
+
+      static int64_t upper_bound(int index) { return 1LL << index; }
+
+      int64_t counts[COUNT]; // The number of values <= upper_bound(index)
+      int64_t total_count;
+      double sum;
+    };
+
     void get_snapshot(Snapshot* snapshot) const {
       ScopedMutex l(&mutex_);
-      hdr_histogram* h = histogram_;
-      for (size_t i = 0; i < thread_state_->max_threads(); ++i) {
-        histograms_[i].add(h);
-      }
+      hdr_histogram* h = merge();
 
       if (h->total_count == 0) {
         // There is no data; default to 0 for the stats.
@@ -334,6 +394,32 @@ public:
       }
     }
 
+    void get_buckets(Buckets* buckets) const {
+      ScopedMutex l(&mutex_);
+      hdr_histogram* h = merge();
+
+      memset(buckets->counts, 0, sizeof(buckets->counts));
+      buckets->total_count = h->total_count;
+      buckets->sum = h->total_count > 0 ? hdr_mean(h) * h->total_count : 0.0;
+
+      // Recorded values are visited in increasing order so the bucket index
+      // only moves forward.
+      int index = 0;
+      hdr_iter iter;
+      hdr_iter_recorded_init(&iter, h);
+      while (hdr_iter_next(&iter)) {
+        while (index < Buckets::COUNT - 1 &&
+               iter.value_from_index > Buckets::upper_bound(index)) {
+          ++index;
+        }
+        buckets->counts[index] += iter.count_at_index;
+      }
+
+      for (int i = 1; i < Buckets::COUNT; ++i) {
+        buckets->counts[i] += buckets->counts[i - 1];
+      }
+    }
+
   private:
     class WriterReaderPhaser {
     public:
@@ -393,8 +479,12 @@ public:
     public:
       PerThreadHistogram()
         : active_index_(0) {
-        hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, 3, &histograms_[0]);
-        hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, 3, &histograms_[1]);
+        histograms_[0] = histograms_[1] = NULL;
+      }
+
+      void init(int significant_figures) {
+        hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, significant_figures, &histograms_[0]);
+        hdr_init(1LL, HIGHEST_TRACKABLE_VALUE, significant_figures, &histograms_[1]);
       }
 
       ~PerThreadHistogram() {
@@ -423,6 +513,15 @@ public:
       mutable WriterReaderPhaser phaser_;
     };
 
+    // Adds the per-thread histograms to the aggregate histogram. This
+    // requires the mutex to be held.
+    hdr_histogram* merge() const {
+      for (size_t i = 0; i < thread_state_->max_threads(); ++i) {
+        histograms_[i].add(histogram_);
+      }
+      return histogram_;
+    }
+
     ThreadState* thread_state_;
     DynamicArray<PerThreadHistogram> histograms_;
     hdr_histogram* histogram_;
@@ -432,6 +531,61 @@ public:
     DISALLOW_COPY_AND_ASSIGN(Histogram);
   };
 
+  /**
+   * Metrics for a single host. These are recorded by the connection pools
+   * and the requests that use them.
+   */
+  class HostMetrics : public RefCounted<HostMetrics> {
+  public:
+    typedef SharedRefPtr<HostMetrics> Ptr;
+    typedef Vector<Ptr> Vec;
+
+    // There's a histogram per-host and per-thread so use less precision
+    // (within 1%) to keep their size down.
+    static const int LATENCY_SIGNIFICANT_FIGURES = 2;
+
+    HostMetrics(const Address& address, ThreadState* thread_state)
+      : address_(address)
+      , request_latencies(thread_state, LATENCY_SIGNIFICANT_FIGURES)
+      , request_rates(thread_state)
+      , in_flight_requests(thread_state)
+      , in_flight_bytes(thread_state)
+      , total_connections(thread_state)
+      , bytes_written(thread_state)
+      , bytes_read(thread_state)
+      , stream_exhaustions(thread_state)
+      , errors(thread_state)
+      , retries(thread_state) { }
+
+    const Address& address() const { return address_; }
+
+    void record_request(uint64_t latency_ns) {
+      // Final measurement is in microseconds
+      request_latencies.record_value(latency_ns / 1000);
+      request_rates.mark();
+    }
+
+  private:
+    const Address address_;
+
+  public:
+    Histogram request_latencies;
+    Meter request_rates;
+
+    Counter in_flight_requests;
+    Counter in_flight_bytes; // The size of the requests written, but not yet answered
+    Counter total_connections;
+    Counter bytes_written;
+    Counter bytes_read;
+    Counter stream_exhaustions; // Writes that failed because there were no free stream IDs
+
+    Counter errors;
+    Counter retries;
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(HostMetrics);
+  };
+
   Metrics(size_t max_threads)
     : thread_state_(max_threads)
     , request_latencies(&thread_state_)
@@ -440,7 +594,17 @@ public:
     , total_connections(&thread_state_)
     , connection_timeouts(&thread_state_)
     , pending_request_timeouts(&thread_state_)
-    , request_timeouts(&thread_state_) {}
+    , request_timeouts(&thread_state_)
+    , coalesce_delays(&thread_state_)
+    , writes_per_flush(&thread_state_)
+    , reads_per_flush(&thread_state_)
+    , stolen_requests(&thread_state_) {
+    uv_mutex_init(&host_metrics_mutex_);
+  }
+
+  ~Metrics() {
+    uv_mutex_destroy(&host_metrics_mutex_);
+  }
 
   void record_request(uint64_t latency_ns) {
     // Final measurement is in microseconds
@@ -453,7 +617,52 @@ public:
     speculative_request_latencies.record_value(latency_ns / 1000);
     request_rates.mark_speculative();
   }
+
+  /**
+   * Get (or create) the metrics for a host. This takes a lock so the result
+   * should be kept by the caller and not looked up per request.
+   *
+   * @param address The address of the host.
+   * @return The host's metrics.
+   */
+  HostMetrics::Ptr host_metrics(const Address& address) {
+    ScopedMutex l(&host_metrics_mutex_);
+    HostMetricsMap::iterator it = host_metrics_.find(address);
+    if (it != host_metrics_.end()) return it->second;
+    HostMetrics::Ptr metrics(Memory::allocate<HostMetrics>(address, &thread_state_));
+    host_metrics_[address] = metrics;
+    return metrics;
+  }
+
+  /**
+   * Drop the metrics for a host that has been removed from the cluster.
+   * Connections that still hold the host's metrics keep them alive until
+   * they're closed.
+   *
+   * @param address The address of the removed host.
+   */
+  void remove_host_metrics(const Address& address) {
+    ScopedMutex l(&host_metrics_mutex_);
+    host_metrics_.erase(address);
+  }
+
+  /**
+   * Get the metrics of all the hosts that have been used by the session.
+   *
+   * @param output The metrics for each host.
+   */
+  void all_host_metrics(HostMetrics::Vec* output) const {
+    ScopedMutex l(&host_metrics_mutex_);
+    output->reserve(host_metrics_.size());
+    for (HostMetricsMap::const_iterator it = host_metrics_.begin(),
+         end = host_metrics_.end(); it != end; ++it) {
+      output->push_back(it->second);
+    }
+  }
+
 private:
+  typedef Map<Address, HostMetrics::Ptr> HostMetricsMap;
+
   ThreadState thread_state_;
 
 public:
@@ -467,10 +676,54 @@ public:
   Counter pending_request_timeouts;
   Counter request_timeouts;
 
+  Histogram coalesce_delays;
+  Histogram writes_per_flush;
+  Histogram reads_per_flush;
+
+  Gauge request_queue_depth; // Requests queued for the I/O threads
+  Gauge waiting_requests; // Requests waiting to be admitted
+  Gauge rejected_requests; // Requests rejected by admission control
+
+  Counter stolen_requests; // Requests taken from a busier I/O thread's queue
+  Gauge queue_latency_skew; // Spread of the I/O threads' average queue latencies (microseconds)
+
+private:
+  HostMetricsMap host_metrics_;
+  mutable uv_mutex_t host_metrics_mutex_;
+
 private:
   DISALLOW_COPY_AND_ASSIGN(Metrics);
 };
 
+/**
+ * An iterator over a snapshot of the hosts that have metrics.
+ */
+class HostMetricsIterator : public Iterator {
+public:
+  HostMetricsIterator(const Metrics* metrics)
+    : Iterator(CASS_ITERATOR_TYPE_HOST_METRICS)
+    , index_(0) {
+    if (metrics) {
+      metrics->all_host_metrics(&host_metrics_);
+    }
+  }
+
+  virtual bool next() {
+    if (index_ >= host_metrics_.size()) {
+      return false;
+    }
+    current_ = host_metrics_[index_++];
+    return true;
+  }
+
+  const Metrics::HostMetrics* host_metrics() const { return current_.get(); }
+
+private:
+  Metrics::HostMetrics::Vec host_metrics_;
+  Metrics::HostMetrics::Ptr current_;
+  size_t index_;
+};
+
 } // namespace cass
 
 #endif
@@ -0,0 +1,541 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "metrics_exporter.hpp"
+
+#include "event_loop.hpp"
+#include "logger.hpp"
+#include "memory.hpp"
+#include "scoped_lock.hpp"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+# define vsnprintf _vsnprintf
+#endif
+
+#define HTTP_MAX_REQUEST_SIZE 4096
+#define OPEN_METRICS_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+namespace cass {
+
+/**
+ * Writes OpenMetrics text into a fixed size buffer. Once the buffer is full
+ * the writer keeps counting the length of the text so that the caller knows
+ * how large the buffer needs to be (like snprintf()).
+ */
+class OpenMetricsWriter {
+public:
+  OpenMetricsWriter(char* output, size_t output_size)
+    : output_(output)
+    , output_size_(output_size)
+    , length_(0) {
+    if (output_size_ > 0) output_[0] = '\0';
+  }
+
+  size_t length() const { return length_; }
+
+  void family(const char* name, const char* type,
+              const char* help, const char* unit = NULL) {
+    append("# TYPE %s %s\n", name, type);
+    if (unit != NULL) {
+      append("# UNIT %s %s\n", name, unit);
+    }
+    append("# HELP %s %s\n", name, help);
+  }
+
+  void counter(const char* name, const char* labels, int64_t value) {
+    append("%s_total%s%s%s %lld\n", name,
+           open(labels), labels, close(labels),
+           static_cast<long long>(value));
+  }
+
+  void gauge(const char* name, const char* labels, int64_t value) {
+    append("%s%s%s%s %lld\n", name,
+           open(labels), labels, close(labels),
+           static_cast<long long>(value));
+  }
+
+  void gauge(const char* name, const char* labels, double value) {
+    append("%s%s%s%s %.6f\n", name,
+           open(labels), labels, close(labels),
+           value);
+  }
+
+  void histogram(const char* name, const char* labels,
+                 const Metrics::Histogram& histogram) {
+    Metrics::Histogram::Buckets buckets;
+    histogram.get_buckets(&buckets);
+
+    const char* separator = *labels != '\0' ? "," : "";
+    for (int i = 0; i < Metrics::Histogram::Buckets::COUNT; ++i) {
+      append("%s_bucket{%s%sle=\"%.1f\"} %lld\n", name, labels, separator,
+             static_cast<double>(Metrics::Histogram::Buckets::upper_bound(i)),
+             static_cast<long long>(buckets.counts[i]));
+    }
+    append("%s_bucket{%s%sle=\"+Inf\"} %lld\n", name, labels, separator,
+           static_cast<long long>(buckets.total_count));
+    append("%s_count%s%s%s %lld\n", name,
+           open(labels), labels, close(labels),
+           static_cast<long long>(buckets.total_count));
+    append("%s_sum%s%s%s %.6f\n", name,
+           open(labels), labels, close(labels),
+           buckets.sum);
+  }
+
+  void eof() {
+    append("# EOF\n");
+  }
+
+private:
+  static const char* open(const char* labels) { return *labels != '\0' ? "{" : ""; }
+  static const char* close(const char* labels) { return *labels != '\0' ? "}" : ""; }
+
+  void append(const char* format, ...) {
+    size_t remaining = length_ < output_size_ ? output_size_ - length_ : 0;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(remaining > 0 ? output_ + length_ : NULL,
+                      remaining, format, args);
+    va_end(args);
+#if defined(_MSC_VER) && _MSC_VER < 1900
+    // _vsnprintf() returns -1 when the text is truncated.
+    if (n < 0) {
+      va_start(args, format);
+      n = _vscprintf(format, args);
+      va_end(args);
+      if (remaining > 0) output_[output_size_ - 1] = '\0';
+    }
+#endif
+    if (n > 0) length_ += n;
+  }
+
+private:
+  char* output_;
+  const size_t output_size_;
+  size_t length_;
+};
+
+size_t write_open_metrics(const Metrics* metrics,
+                          char* output, size_t output_size) {
+  OpenMetricsWriter writer(output, output_size);
+
+  writer.family("cass_requests", "counter", "Requests that completed successfully.");
+  writer.counter("cass_requests", "", metrics->request_rates.count());
+
+  writer.family("cass_request_rate", "gauge", "Requests per second over a time window.");
+  writer.gauge("cass_request_rate", "window=\"1m\"", metrics->request_rates.one_minute_rate());
+  writer.gauge("cass_request_rate", "window=\"5m\"", metrics->request_rates.five_minute_rate());
+  writer.gauge("cass_request_rate", "window=\"15m\"", metrics->request_rates.fifteen_minute_rate());
+  writer.gauge("cass_request_rate", "window=\"mean\"", metrics->request_rates.mean_rate());
+
+  writer.family("cass_request_latency_microseconds", "histogram",
+                "Latency of requests.", "microseconds");
+  writer.histogram("cass_request_latency_microseconds", "", metrics->request_latencies);
+
+  writer.family("cass_speculative_requests", "counter",
+                "Speculative executions that were aborted because another execution completed first.");
+  writer.counter("cass_speculative_requests", "",
+                 metrics->request_rates.speculative_request_count());
+
+  writer.family("cass_speculative_request_latency_microseconds", "histogram",
+                "Latency of aborted speculative executions.", "microseconds");
+  writer.histogram("cass_speculative_request_latency_microseconds", "",
+                   metrics->speculative_request_latencies);
+
+  writer.family("cass_connections", "gauge", "Open connections.");
+  writer.gauge("cass_connections", "", metrics->total_connections.sum());
+
+  writer.family("cass_connection_timeouts", "counter", "Connections that timed out.");
+  writer.counter("cass_connection_timeouts", "", metrics->connection_timeouts.sum());
+
+  writer.family("cass_pending_request_timeouts", "counter",
+                "Requests that timed out waiting for a connection.");
+  writer.counter("cass_pending_request_timeouts", "", metrics->pending_request_timeouts.sum());
+
+  writer.family("cass_request_timeouts", "counter", "Requests that timed out.");
+  writer.counter("cass_request_timeouts", "", metrics->request_timeouts.sum());
+
+  writer.family("cass_request_queue_depth", "gauge",
+                "Requests queued for the I/O threads.");
+  writer.gauge("cass_request_queue_depth", "", metrics->request_queue_depth.get());
+
+  writer.family("cass_waiting_requests", "gauge",
+                "Requests waiting to be admitted (admission control).");
+  writer.gauge("cass_waiting_requests", "", metrics->waiting_requests.get());
+
+  writer.family("cass_rejected_requests", "counter",
+                "Requests rejected by admission control.");
+  writer.counter("cass_rejected_requests", "", metrics->rejected_requests.get());
+
+  writer.family("cass_stolen_requests", "counter",
+                "Requests taken from a busier I/O thread's queue (work stealing).");
+  writer.counter("cass_stolen_requests", "", metrics->stolen_requests.sum());
+
+  writer.family("cass_request_queue_latency_skew_microseconds", "gauge",
+                "Difference in the average queue latency of the slowest and fastest I/O threads.",
+                "microseconds");
+  writer.gauge("cass_request_queue_latency_skew_microseconds", "", metrics->queue_latency_skew.get());
+
+  writer.family("cass_coalesce_delay_microseconds", "histogram",
+                "Time spent waiting for requests to coalesce.", "microseconds");
+  writer.histogram("cass_coalesce_delay_microseconds", "", metrics->coalesce_delays);
+
+  writer.family("cass_coalesce_writes_per_flush", "histogram", "Requests written per flush.");
+  writer.histogram("cass_coalesce_writes_per_flush", "", metrics->writes_per_flush);
+
+  writer.family("cass_coalesce_reads_per_flush", "histogram", "Responses read per flush.");
+  writer.histogram("cass_coalesce_reads_per_flush", "", metrics->reads_per_flush);
+
+  Metrics::HostMetrics::Vec hosts;
+  metrics->all_host_metrics(&hosts);
+
+  if (!hosts.empty()) {
+    // The label for each host (e.g. host="127.0.0.1:9042")
+    Vector<String> labels;
+    labels.reserve(hosts.size());
+    for (Metrics::HostMetrics::Vec::const_iterator it = hosts.begin(),
+         end = hosts.end(); it != end; ++it) {
+      labels.push_back("host=\"" + (*it)->address().to_string(true) + "\"");
+    }
+
+#define WRITE_HOST_METRICS(Func, Name, Expr)                 \
+    for (size_t i = 0; i < hosts.size(); ++i) {              \
+      const Metrics::HostMetrics* host = hosts[i].get();     \
+      writer.Func(Name, labels[i].c_str(), Expr);            \
+    }
+
+    writer.family("cass_host_requests", "counter", "Requests that completed successfully on a host.");
+    WRITE_HOST_METRICS(counter, "cass_host_requests", host->request_rates.count())
+
+    writer.family("cass_host_request_latency_microseconds", "histogram",
+                  "Latency of requests on a host.", "microseconds");
+    WRITE_HOST_METRICS(histogram, "cass_host_request_latency_microseconds", host->request_latencies)
+
+    writer.family("cass_host_in_flight_requests", "gauge", "Requests written to a host that are waiting for a response.");
+    WRITE_HOST_METRICS(gauge, "cass_host_in_flight_requests", host->in_flight_requests.sum())
+
+    writer.family("cass_host_in_flight_bytes", "gauge",
+                  "Bytes of requests written to a host that are waiting for a response.", "bytes");
+    WRITE_HOST_METRICS(gauge, "cass_host_in_flight_bytes", host->in_flight_bytes.sum())
+
+    writer.family("cass_host_connections", "gauge", "Open connections to a host.");
+    WRITE_HOST_METRICS(gauge, "cass_host_connections", host->total_connections.sum())
+
+    writer.family("cass_host_written_bytes", "counter", "Bytes written to a host.", "bytes");
+    WRITE_HOST_METRICS(counter, "cass_host_written_bytes", host->bytes_written.sum())
+
+    writer.family("cass_host_read_bytes", "counter", "Bytes read from a host.", "bytes");
+    WRITE_HOST_METRICS(counter, "cass_host_read_bytes", host->bytes_read.sum())
+
+    writer.family("cass_host_stream_exhaustions", "counter",
+                  "Writes to a host that failed because there were no free stream IDs.");
+    WRITE_HOST_METRICS(counter, "cass_host_stream_exhaustions", host->stream_exhaustions.sum())
+
+    writer.family("cass_host_errors", "counter", "Requests to a host that returned an error.");
+    WRITE_HOST_METRICS(counter, "cass_host_errors", host->errors.sum())
+
+    writer.family("cass_host_retries", "counter", "Requests to a host that were retried.");
+    WRITE_HOST_METRICS(counter, "cass_host_retries", host->retries.sum())
+
+#undef WRITE_HOST_METRICS
+  }
+
+  writer.eof();
+
+  return writer.length();
+}
+
+/**
+ * A connection from a scraper. The request is read until the end of the
+ * headers, the response is written, then the connection is closed.
+ */
+class MetricsExporter::Client : public List<Client>::Node {
+public:
+  Client(MetricsExporter* exporter)
+    : exporter_(exporter)
+    , request_length_(0)
+    , is_closing_(false) {
+    exporter_->inc_ref();
+    tcp_.data = this;
+    write_req_.data = this;
+  }
+
+  ~Client() {
+    exporter_->dec_ref();
+  }
+
+  // The handle must only be closed if it was initialized
+  int accept(uv_stream_t* server, bool* is_initialized) {
+    int rc = uv_tcp_init(server->loop, &tcp_);
+    *is_initialized = rc == 0;
+    if (rc != 0) return rc;
+    rc = uv_accept(server, reinterpret_cast<uv_stream_t*>(&tcp_));
+    if (rc != 0) return rc;
+    return uv_read_start(reinterpret_cast<uv_stream_t*>(&tcp_), on_alloc, on_read);
+  }
+
+  void close() {
+    if (!is_closing_) {
+      is_closing_ = true;
+      uv_close(reinterpret_cast<uv_handle_t*>(&tcp_), on_close);
+    }
+  }
+
+private:
+  static void on_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    Client* client = static_cast<Client*>(handle->data);
+    buf->base = client->request_ + client->request_length_;
+    buf->len = sizeof(client->request_) - client->request_length_;
+  }
+
+  static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    Client* client = static_cast<Client*>(stream->data);
+    if (nread < 0) {
+      client->close();
+      return;
+    }
+    client->request_length_ += nread;
+    client->handle_read();
+  }
+
+  void handle_read() {
+    // Wait for the end of the headers. A request body is not expected.
+    bool is_complete = false;
+    for (size_t i = 3; i < request_length_; ++i) {
+      if (memcmp(request_ + i - 3, "\r\n\r\n", 4) == 0) {
+        is_complete = true;
+        break;
+      }
+    }
+
+    if (!is_complete) {
+      if (request_length_ == sizeof(request_)) {
+        respond("431 Request Header Fields Too Large");
+      }
+      return;
+    }
+
+    if (request_length_ < 4 || memcmp(request_, "GET ", 4) != 0) {
+      respond("405 Method Not Allowed");
+      return;
+    }
+
+    if (!exporter_->render(&body_)) {
+      // The session closed while the request was being read
+      respond("503 Service Unavailable");
+      return;
+    }
+    respond("200 OK");
+  }
+
+  void respond(const char* status) {
+    uv_read_stop(reinterpret_cast<uv_stream_t*>(&tcp_));
+
+    char content_length[32];
+    sprintf(content_length, "%u", static_cast<unsigned int>(body_.size()));
+
+    headers_.reserve(256);
+    headers_.append("HTTP/1.1 ").append(status).append("\r\n");
+    if (!body_.empty()) {
+      headers_.append("Content-Type: " OPEN_METRICS_CONTENT_TYPE "\r\n");
+    }
+    headers_.append("Content-Length: ").append(content_length).append("\r\n");
+    headers_.append("Connection: close\r\n\r\n");
+
+    uv_buf_t bufs[2];
+    bufs[0] = uv_buf_init(const_cast<char*>(headers_.data()), headers_.size());
+    bufs[1] = uv_buf_init(const_cast<char*>(body_.data()), body_.size());
+    int rc = uv_write(&write_req_, reinterpret_cast<uv_stream_t*>(&tcp_),
+                      bufs, body_.empty() ? 1 : 2, on_write);
+    if (rc != 0) {
+      close();
+    }
+  }
+
+  static void on_write(uv_write_t* req, int status) {
+    Client* client = static_cast<Client*>(req->data);
+    client->close();
+  }
+
+  static void on_close(uv_handle_t* handle) {
+    Client* client = static_cast<Client*>(handle->data);
+    client->exporter_->clients_.remove(client);
+    Memory::deallocate(client);
+  }
+
+private:
+  MetricsExporter* exporter_;
+  uv_tcp_t tcp_;
+  uv_write_t write_req_;
+  char request_[HTTP_MAX_REQUEST_SIZE];
+  size_t request_length_;
+  String headers_;
+  String body_;
+  bool is_closing_;
+};
+
+/**
+ * A task for starting the server on the event loop thread.
+ */
+class ExporterRunListen : public Task {
+public:
+  ExporterRunListen(const MetricsExporter::Ptr& exporter, const Address& address)
+    : exporter_(exporter)
+    , address_(address) { }
+
+  void run(EventLoop* event_loop) {
+    exporter_->internal_listen(event_loop, address_);
+  }
+
+private:
+  MetricsExporter::Ptr exporter_;
+  Address address_;
+};
+
+/**
+ * A task for closing the server on the event loop thread.
+ */
+class ExporterRunClose : public Task {
+public:
+  ExporterRunClose(const MetricsExporter::Ptr& exporter)
+    : exporter_(exporter) { }
+
+  void run(EventLoop* event_loop) {
+    exporter_->internal_close();
+  }
+
+private:
+  MetricsExporter::Ptr exporter_;
+};
+
+MetricsExporter::MetricsExporter(const Metrics* metrics)
+  : metrics_(metrics)
+  , event_loop_(NULL)
+  , server_(NULL)
+  , last_length_(0) {
+  uv_mutex_init(&mutex_);
+}
+
+MetricsExporter::~MetricsExporter() {
+  uv_mutex_destroy(&mutex_);
+}
+
+void MetricsExporter::listen(EventLoop* event_loop, const Address& address) {
+  event_loop_ = event_loop;
+  event_loop_->add(Memory::allocate<ExporterRunListen>(Ptr(this), address));
+}
+
+void MetricsExporter::close() {
+  { // Connections that are still open will no longer render the metrics.
+    ScopedMutex l(&mutex_);
+    if (metrics_ == NULL) return;
+    metrics_ = NULL;
+  }
+  if (event_loop_ != NULL) {
+    event_loop_->add(Memory::allocate<ExporterRunClose>(Ptr(this)));
+  }
+}
+
+void MetricsExporter::internal_listen(EventLoop* event_loop, const Address& address) {
+  server_ = Memory::allocate<uv_tcp_t>();
+  server_->data = this;
+
+  int rc = uv_tcp_init(event_loop->loop(), server_);
+  if (rc != 0) {
+    LOG_ERROR("Unable to initialize the metrics exporter: %s", uv_strerror(rc));
+    Memory::deallocate(server_);
+    server_ = NULL;
+    return;
+  }
+
+  inc_ref(); // Released when the server is closed
+
+  rc = uv_tcp_bind(server_, address.addr(), 0);
+  if (rc == 0) {
+    rc = uv_listen(reinterpret_cast<uv_stream_t*>(server_), 16, on_connection);
+  }
+  if (rc != 0) {
+    LOG_ERROR("Unable to listen for metrics exporter connections on %s: %s",
+              address.to_string(true).c_str(), uv_strerror(rc));
+    internal_close();
+    return;
+  }
+
+  LOG_INFO("Exporting metrics on http://%s/metrics", address.to_string(true).c_str());
+}
+
+void MetricsExporter::internal_close() {
+  if (server_ != NULL) {
+    uv_close(reinterpret_cast<uv_handle_t*>(server_), on_close);
+    server_ = NULL;
+  }
+  List<Client>::Iterator<Client> it(clients_.iterator());
+  while (it.has_next()) {
+    it.next()->close();
+  }
+}
+
+bool MetricsExporter::render(String* output) {
+  ScopedMutex l(&mutex_);
+  if (metrics_ == NULL) return false;
+
+  // The length of the last render is used as a guess so that the text is
+  // usually rendered once. It only grows when hosts are added.
+  size_t length = last_length_;
+  do {
+    output->resize(length + 1);
+    length = write_open_metrics(metrics_, &(*output)[0], output->size());
+  } while (length >= output->size());
+  output->resize(length);
+  last_length_ = length;
+  return true;
+}
+
+void MetricsExporter::on_connection(uv_stream_t* server, int status) {
+  MetricsExporter* exporter = static_cast<MetricsExporter*>(server->data);
+  if (status != 0) {
+    LOG_WARN("Metrics exporter connection error: %s", uv_strerror(status));
+    return;
+  }
+  exporter->handle_connection(server);
+}
+
+void MetricsExporter::handle_connection(uv_stream_t* server) {
+  Client* client = Memory::allocate<Client>(this);
+  clients_.add_to_back(client);
+  bool is_initialized = false;
+  int rc = client->accept(server, &is_initialized);
+  if (rc != 0) {
+    LOG_WARN("Unable to accept metrics exporter connection: %s", uv_strerror(rc));
+    if (is_initialized) {
+      client->close();
+    } else {
+      clients_.remove(client);
+      Memory::deallocate(client);
+    }
+  }
+}
+
+void MetricsExporter::on_close(uv_handle_t* handle) {
+  MetricsExporter* exporter = static_cast<MetricsExporter*>(handle->data);
+  Memory::deallocate(reinterpret_cast<uv_tcp_t*>(handle));
+  exporter->dec_ref();
+}
+
+} // namespace cass
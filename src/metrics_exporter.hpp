@@ -0,0 +1,104 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_METRICS_EXPORTER_HPP_INCLUDED__
+#define __CASS_METRICS_EXPORTER_HPP_INCLUDED__
+
+#include "address.hpp"
+#include "list.hpp"
+#include "macros.hpp"
+#include "metrics.hpp"
+#include "ref_counted.hpp"
+#include "string.hpp"
+
+#include <uv.h>
+
+namespace cass {
+
+class EventLoop;
+
+/**
+ * Render metrics as OpenMetrics text. The text is written directly into the
+ * output buffer without any intermediate allocations (other than a snapshot
+ * of the hosts).
+ *
+ * @param metrics The metrics to render.
+ * @param output The buffer to render into. It can be NULL if the size is 0.
+ * @param output_size The size of the output buffer.
+ * @return The length of the text excluding the null terminator. If this is
+ * greater than or equal to the output size then the text was truncated.
+ */
+size_t write_open_metrics(const Metrics* metrics,
+                          char* output, size_t output_size);
+
+/**
+ * A minimal HTTP server that responds to GET requests with the session's
+ * metrics as OpenMetrics text so that they can be scraped (e.g. by
+ * Prometheus). It runs on one of the session's event loops.
+ */
+class MetricsExporter : public RefCounted<MetricsExporter> {
+public:
+  typedef SharedRefPtr<MetricsExporter> Ptr;
+
+  MetricsExporter(const Metrics* metrics);
+  ~MetricsExporter();
+
+  /**
+   * Start listening for HTTP connections (asynchronously).
+   *
+   * @param event_loop The event loop used to run the server.
+   * @param address The address to listen on.
+   */
+  void listen(EventLoop* event_loop, const Address& address);
+
+  /**
+   * Stop listening and close all connections (asynchronously). The metrics
+   * are no longer accessed once this returns.
+   */
+  void close();
+
+private:
+  class Client;
+  friend class Client;
+  friend class ExporterRunListen;
+  friend class ExporterRunClose;
+
+  void internal_listen(EventLoop* event_loop, const Address& address);
+  void internal_close();
+
+  // Returns false if the exporter has been closed
+  bool render(String* output);
+
+  static void on_connection(uv_stream_t* server, int status);
+  void handle_connection(uv_stream_t* server);
+
+  static void on_close(uv_handle_t* handle);
+
+private:
+  uv_mutex_t mutex_;
+  const Metrics* metrics_;
+  EventLoop* event_loop_;
+  uv_tcp_t* server_;
+  List<Client> clients_;
+  size_t last_length_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MetricsExporter);
+};
+
+} // namespace cass
+
+#endif
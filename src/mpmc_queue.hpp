@@ -88,6 +88,57 @@ public:
     return false;
   }
 
+  /**
+   * Enqueue several entries, in order, claiming as many contiguous slots as
+   * are available with a single update of the tail. This stops early if the
+   * queue becomes full.
+   *
+   * @param data The entries to enqueue.
+   * @param count The number of entries.
+   * @return The number of entries that were enqueued. These are always the
+   * first entries of `data`.
+   */
+  size_t enqueue_many(const T* data, size_t count) {
+    size_t enqueued = 0;
+    size_t pos = tail_.load(MEMORY_ORDER_RELAXED);
+
+    while (enqueued < count) {
+      // count the empty slots following the tail. A slot is empty if its
+      // sequence matches the position that would be claimed for it.
+      size_t available = 0;
+      intptr_t dif = 0;
+      while (enqueued + available < count) {
+        Node* node = &buffer_[(pos + available) & mask_];
+        size_t node_seq = node->seq.load(MEMORY_ORDER_ACQUIRE);
+        dif = (intptr_t)node_seq - (intptr_t)(pos + available);
+        if (dif != 0) break;
+        available++;
+      }
+
+      if (available > 0) {
+        // claim all the empty slots at once. The slots can't be claimed by
+        // another producer without also moving the tail.
+        if (tail_.compare_exchange_weak(pos, pos + available, MEMORY_ORDER_RELAXED)) {
+          for (size_t i = 0; i < available; ++i) {
+            Node* node = &buffer_[(pos + i) & mask_];
+            node->data = data[enqueued + i];
+            node->seq.store(pos + i + 1, MEMORY_ORDER_RELEASE);
+          }
+          enqueued += available;
+          pos += available;
+        }
+      } else if (dif < 0) {
+        // the slot at the tail is full and therefore the buffer is full
+        break;
+      } else {
+        // another producer moved the tail
+        pos = tail_.load(MEMORY_ORDER_RELAXED);
+      }
+    }
+
+    return enqueued;
+  }
+
   bool dequeue(T& data) {
     size_t pos = head_.load(MEMORY_ORDER_RELAXED);
 
@@ -131,6 +182,18 @@ public:
     return (intptr_t)node_seq - (intptr_t)(pos + 1) < 0;
   }
 
+  /**
+   * Get the approximate number of entries in the queue. This can be stale
+   * when other threads are adding or removing entries.
+   *
+   * @return The number of entries.
+   */
+  size_t size() const {
+    size_t head = head_.load(MEMORY_ORDER_RELAXED);
+    size_t tail = tail_.load(MEMORY_ORDER_RELAXED);
+    return tail > head ? tail - head : 0;
+  }
+
   static void memory_fence() {
 #if defined(HAVE_BOOST_ATOMIC) || defined(HAVE_STD_ATOMIC)
     atomic_thread_fence(MEMORY_ORDER_SEQ_CST);
@@ -116,6 +116,7 @@ PooledConnection::PooledConnection(ConnectionPool* pool,
   , event_loop_(static_cast<EventLoop*>(pool->loop()->data)) {
   inc_ref(); // Reference for the connection's lifetime
   connection_->set_listener(this);
+  connection_->set_host_metrics(pool->host_metrics());
 }
 
 bool PooledConnection::write(RequestCallback* callback) {
@@ -142,10 +143,14 @@ bool PooledConnection::write(RequestCallback* callback) {
 }
 
 void PooledConnection::flush() {
+#ifdef CASS_INTERNAL_DIAGNOSTICS
+  uint64_t bufs_flushed = connection_->flush_stats().bufs;
+#endif
   size_t bytes_flushed = connection_->flush();
 #ifdef CASS_INTERNAL_DIAGNOSTICS
   if (bytes_flushed > 0) {
     pool_->manager()->flush_bytes().record_value(bytes_flushed);
+    pool_->manager()->flush_bufs().record_value(connection_->flush_stats().bufs - bufs_flushed);
   }
 #else
   UNUSED_(bytes_flushed);
@@ -25,8 +25,10 @@
 #include "map.hpp"
 #include "ref_counted.hpp"
 #include "retry_policy.hpp"
+#include "small_vector.hpp"
 #include "socket.hpp"
 #include "string_ref.hpp"
+#include "vector.hpp"
 
 #include <stdint.h>
 #include <utility>
@@ -82,19 +84,23 @@ struct RequestSettings {
 class Request : public RefCounted<Request> {
 public:
   typedef SharedRefPtr<const Request> ConstPtr;
+  typedef Vector<ConstPtr> ConstVec;
 
   enum {
     REQUEST_ERROR_UNSUPPORTED_PROTOCOL = SocketRequest::SOCKET_REQUEST_ERROR_LAST_ENTRY,
     REQUEST_ERROR_BATCH_WITH_NAMED_VALUES,
     REQUEST_ERROR_PARAMETER_UNSET,
-    REQUEST_ERROR_NO_AVAILABLE_STREAM_IDS
+    REQUEST_ERROR_NO_AVAILABLE_STREAM_IDS,
+    REQUEST_ERROR_COMPRESSION
   };
 
   Request(uint8_t opcode)
       : opcode_(opcode)
       , flags_(0)
       , timestamp_(CASS_INT64_MIN)
-      , record_attempted_addresses_(false) { }
+      , record_attempted_addresses_(false)
+      , rows_callback_(NULL)
+      , rows_data_(NULL) { }
 
   virtual ~Request() { }
 
@@ -160,6 +166,14 @@ public:
     record_attempted_addresses_ = record_attempted_addresses;
   }
 
+  CassResultRowsCallback rows_callback() const { return rows_callback_; }
+  void* rows_data() const { return rows_data_; }
+
+  void set_rows_callback(CassResultRowsCallback callback, void* data) {
+    rows_callback_ = callback;
+    rows_data_ = data;
+  }
+
   const CustomPayload::ConstPtr& custom_payload() const {
     return custom_payload_;
   }
@@ -216,6 +230,8 @@ private:
   RequestSettings settings_;
   int64_t timestamp_;
   bool record_attempted_addresses_;
+  CassResultRowsCallback rows_callback_;
+  void* rows_data_;
   CustomPayload::ConstPtr custom_payload_;
   CustomPayload custom_payload_extra_;
   String profile_name_;
@@ -225,12 +241,59 @@ private:
   DISALLOW_COPY_AND_ASSIGN(Request);
 };
 
+/**
+ * The routing key of a request. A key with a single component refers to the
+ * bound value in place and a composite key is encoded into a fixed buffer
+ * that only allocates for large keys. This avoids building an intermediate
+ * string for every routed request.
+ */
+class RoutingKey {
+public:
+  RoutingKey() { }
+
+  const StringRef& value() const { return value_; }
+
+  /**
+   * Use a value that outlives the routing key (e.g. a bound value).
+   *
+   * @param value The routing key's value.
+   */
+  void set(const StringRef& value) { value_ = value; }
+
+  /**
+   * Get a buffer for encoding the routing key's value.
+   *
+   * @param length The length of the value.
+   * @return A buffer of the given length.
+   */
+  char* allocate(size_t length) {
+    buffer_.resize(length);
+    char* data = length > 0 ? &buffer_[0] : NULL;
+    value_ = StringRef(data, length);
+    return data;
+  }
+
+private:
+  StringRef value_;
+  SmallVector<char, 64> buffer_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(RoutingKey);
+};
+
 class RoutableRequest : public Request {
 public:
   RoutableRequest(uint8_t opcode)
     : Request(opcode) { }
 
-  virtual bool get_routing_key(String* routing_key) const = 0;
+  virtual bool get_routing_key(RoutingKey* routing_key) const = 0;
+
+  bool get_routing_key(String* routing_key) const {
+    RoutingKey key;
+    if (!get_routing_key(&key)) return false;
+    routing_key->assign(key.value().data(), key.value().size());
+    return true;
+  }
 };
 
 } // namespace cass
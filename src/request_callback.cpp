@@ -44,15 +44,18 @@ void RequestWrapper::init(const ExecutionProfile& profile,
 
 void RequestCallback::notify_write(Connection* connection, int stream) {
   protocol_version_ = connection->protocol_version();
+  compressor_ = connection->compressor().get();
   stream_ = stream;
   on_write(connection);
 }
 
 bool RequestCallback::skip_metadata() const {
     // Skip the metadata if this an execute request and we have an entry cached
+    // (streamed rows are decoded before the cached metadata can be applied)
   return request()->opcode() == CQL_OPCODE_EXECUTE &&
       prepared_metadata_entry() &&
-      prepared_metadata_entry()->result()->result_metadata();
+      prepared_metadata_entry()->result()->result_metadata() &&
+      !streams_rows();
 }
 
 int32_t RequestCallback::encode(BufferVec* bufs) {
@@ -81,6 +84,21 @@ int32_t RequestCallback::encode(BufferVec* bufs) {
   if (result < 0) return result;
   length += result;
 
+  // Compress the body (everything after the header placeholder) into a single
+  // buffer. Small bodies are sent uncompressed.
+  if (compressor_ != NULL &&
+      static_cast<size_t>(length) >= compressor_->threshold() && length > 0) {
+    Buffer compressed;
+    if (!compressor_->compress(bufs->begin() + index + 1, bufs->end(),
+                               length, &compressed)) {
+      return Request::REQUEST_ERROR_COMPRESSION;
+    }
+    bufs->resize(index + 1);
+    bufs->push_back(compressed);
+    flags |= CASS_FLAG_COMPRESSION;
+    length = static_cast<int32_t>(compressed.size());
+  }
+
   const size_t header_size = CASS_HEADER_SIZE_V3;
 
   Buffer buf(header_size);
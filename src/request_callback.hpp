@@ -136,7 +136,9 @@ public:
 
   RequestCallback(const RequestWrapper& wrapper)
     : wrapper_(wrapper)
+    , compressor_(NULL)
     , stream_(-1)
+    , request_size_(0)
     , state_(REQUEST_STATE_NEW)
     , retry_consistency_(CASS_CONSISTENCY_UNKNOWN) { }
 
@@ -159,9 +161,15 @@ public:
   virtual void on_set(ResponseMessage* response) = 0;
   virtual void on_error(CassError code, const String& message) = 0;
 
+  // Called with the rows of a result as they arrive (before `on_set()`) if
+  // the request streams its rows
+  virtual void on_rows(ResultResponse* rows) { }
+
 public:
   const Request* request() const { return wrapper_.request().get(); }
 
+  virtual bool streams_rows() const { return false; }
+
   bool skip_metadata() const;
 
   CassConsistency consistency() {
@@ -196,6 +204,10 @@ public:
 
   int stream() const { return stream_; }
 
+  // The size of the encoded request (set when it's written to a connection)
+  int32_t request_size() const { return request_size_; }
+  void set_request_size(int32_t request_size) { request_size_ = request_size; }
+
   State state() const { return state_; }
   void set_state(State next_state);
 
@@ -214,7 +226,9 @@ private:
 private:
   const RequestWrapper wrapper_;
   ProtocolVersion protocol_version_;
+  const Compressor* compressor_;
   int stream_;
+  int32_t request_size_;
   State state_;
   CassConsistency retry_consistency_;
   ScopedPtr<ResponseMessage> read_before_write_response_;
@@ -34,6 +34,13 @@
 
 namespace cass {
 
+// An execution that has run out of hosts only fails the request if no other
+// (speculative) executions are still running.
+static inline bool is_out_of_hosts(CassError code) {
+  return code == CASS_ERROR_LIB_NO_HOSTS_AVAILABLE ||
+         code == CASS_ERROR_LIB_REQUEST_QUEUE_FULL;
+}
+
 class SingleHostQueryPlan : public QueryPlan {
 public:
   SingleHostQueryPlan(const Address& address)
@@ -174,9 +181,11 @@ void RequestHandler::init(const ExecutionProfile& profile,
   // If a specific host is set then bypass the load balancing policy and use a
   // specialized single host query plan.
   if (request()->host()) {
-    query_plan_.reset(Memory::allocate<SingleHostQueryPlan>(*request()->host()));
+    query_plan_.reset(new (QueryPlanStorage::allocate(&query_plan_, sizeof(SingleHostQueryPlan)))
+                      SingleHostQueryPlan(*request()->host()));
   } else {
-    query_plan_.reset(profile.load_balancing_policy()->new_query_plan(keyspace, this, token_map));
+    query_plan_.reset(profile.load_balancing_policy()->emplace_query_plan(&query_plan_, keyspace,
+                                                                          this, token_map));
   }
 
   execution_plan_.reset(profile.speculative_execution_policy()->new_plan(keyspace, wrapper_.request().get()));
@@ -214,6 +223,14 @@ void RequestHandler::add_attempted_address(const Address& address, Protected) {
   future_->add_attempted_address(address);
 }
 
+void RequestHandler::notify_rows(ResultResponse* rows, Protected) {
+  // Rows that arrive after the request is finished (e.g. it timed out) are
+  // dropped
+  if (!is_done_) {
+    request()->rows_callback()(CassResult::to(rows), request()->rows_data());
+  }
+}
+
 void RequestHandler::notify_result_metadata_changed(const String& prepared_id,
                                                     const String& query,
                                                     const String& keyspace,
@@ -271,7 +288,7 @@ void RequestHandler::set_response(const Host::Ptr& host,
 void RequestHandler::set_error(CassError code,
                                const String& message) {
   stop_request();
-  bool skip = (code == CASS_ERROR_LIB_NO_HOSTS_AVAILABLE && --running_executions_ > 0);
+  bool skip = (is_out_of_hosts(code) && --running_executions_ > 0);
   if (!skip) {
     future_->set_error(code, message);
   }
@@ -280,7 +297,7 @@ void RequestHandler::set_error(CassError code,
 void RequestHandler::set_error(const Host::Ptr& host,
                                CassError code, const String& message) {
   stop_request();
-  bool skip = (code == CASS_ERROR_LIB_NO_HOSTS_AVAILABLE && --running_executions_ > 0);
+  bool skip = (is_out_of_hosts(code) && --running_executions_ > 0);
   if (!skip) {
     if (host) {
       future_->set_error_with_address(host->address(), code, message);
@@ -302,7 +319,7 @@ void RequestHandler::stop_timer() {
   timer_.stop();
 }
 
-void RequestHandler::on_timeout(Timer* timer) {
+void RequestHandler::on_timeout(LoopTimer* timer) {
   if (metrics_) {
     metrics_->request_timeouts.inc();
   }
@@ -314,6 +331,10 @@ void RequestHandler::stop_request() {
   if (!is_done_) {
     listener_->on_done();
     is_done_ = true;
+    if (admission_controller_) {
+      admission_controller_->release();
+      admission_controller_.reset();
+    }
   }
   timer_.stop();
 }
@@ -329,19 +350,31 @@ void RequestHandler::internal_retry(RequestExecution* request_execution) {
   }
 
   bool is_successful = false;
+  bool is_host_saturated = false;
   while (request_execution->current_host()) {
-    PooledConnection::Ptr connection = manager_->find_least_busy(request_execution->current_host()->address());
+    const Address& address = request_execution->current_host()->address();
+    PooledConnection::Ptr connection = manager_->find_least_busy(address);
     if (connection && connection->write(request_execution)) {
       is_successful = true;
       break;
     }
+    if (!connection && manager_->has_connections(address)) {
+      // The host's pool has reached the in-flight request limit
+      is_host_saturated = true;
+    }
     request_execution->next_host();
   }
 
   if (!is_successful) {
-    set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
-              "All hosts in current policy attempted "
-              "and were either unavailable or failed");
+    if (is_host_saturated) {
+      set_error(CASS_ERROR_LIB_REQUEST_QUEUE_FULL,
+                "All available hosts in current policy have reached "
+                "their in-flight request limit");
+    } else {
+      set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                "All hosts in current policy attempted "
+                "and were either unavailable or failed");
+    }
   }
 }
 
@@ -350,20 +383,35 @@ RequestExecution::RequestExecution(RequestHandler* request_handler)
   , request_handler_(request_handler)
   , current_host_(request_handler->next_host(RequestHandler::Protected()))
   , num_retries_(0)
+  , has_rows_(false)
   , start_time_ns_(uv_hrtime()) { }
 
-void RequestExecution::on_execute_next(Timer* timer) {
+void RequestExecution::on_execute_next(LoopTimer* timer) {
   request_handler_->execute();
 }
 
 void RequestExecution::on_retry_current_host() {
+  if (has_rows_) {
+    set_error(CASS_ERROR_LIB_UNABLE_TO_EXECUTE,
+              "Unable to retry a request after some of its rows were delivered");
+    return;
+  }
   retry_current_host();
 }
 
 void RequestExecution::on_retry_next_host() {
+  if (has_rows_) {
+    set_error(CASS_ERROR_LIB_UNABLE_TO_EXECUTE,
+              "Unable to retry a request after some of its rows were delivered");
+    return;
+  }
   retry_next_host();
 }
 
+bool RequestExecution::streams_rows() const {
+  return request()->rows_callback() != NULL;
+}
+
 void RequestExecution::retry_current_host() {
   // Reset the request so it can be executed again
   set_state(REQUEST_STATE_NEW);
@@ -383,7 +431,9 @@ void RequestExecution::on_write(Connection* connection) {
     request_handler_->add_attempted_address(current_host_->address(), RequestHandler::Protected());
   }
   request_handler_->start_request(connection->loop(), RequestHandler::Protected());
-  if (request()->is_idempotent()) {
+  // Rows can only be delivered from a single execution so requests that
+  // stream their rows aren't speculatively executed
+  if (request()->is_idempotent() && !streams_rows()) {
     int64_t timeout = request_handler_->next_execution(current_host_, RequestHandler::Protected());
     if (timeout == 0) {
       request_handler_->execute();
@@ -400,6 +450,14 @@ void RequestExecution::on_set(ResponseMessage* response) {
 
   Connection* connection = connection_;
 
+  const Metrics::HostMetrics::Ptr& host_metrics = connection->host_metrics();
+  if (host_metrics) {
+    host_metrics->record_request(uv_hrtime() - start_time_ns_);
+    if (response->opcode() != CQL_OPCODE_RESULT) {
+      host_metrics->errors.inc();
+    }
+  }
+
   switch (response->opcode()) {
     case CQL_OPCODE_RESULT:
       on_result_response(connection, response);
@@ -414,6 +472,11 @@ void RequestExecution::on_set(ResponseMessage* response) {
   }
 }
 
+void RequestExecution::on_rows(ResultResponse* rows) {
+  has_rows_ = true;
+  request_handler_->notify_rows(rows, RequestHandler::Protected());
+}
+
 void RequestExecution::on_error(CassError code, const String& message) {
   // Handle recoverable errors by retrying with the next host
   if (code == CASS_ERROR_LIB_WRITE_ERROR ||
@@ -481,6 +544,13 @@ void RequestExecution::on_result_response(Connection* connection, ResponseMessag
         }
       }
 
+      if (streams_rows() && result->row_count() > 0) {
+        // The rows weren't streamed as they arrived (e.g. the response was
+        // compressed or it arrived in a single read)
+        on_rows(result);
+        result->clear_rows();
+      }
+
       if (!response->response_body()->has_tracing_id() ||
           !request_handler_->wait_for_tracing_data(current_host(),
                                                    response->response_body())) {
@@ -605,6 +675,9 @@ void RequestExecution::on_error_response(Connection* connection, ResponseMessage
       break;
 
     case RetryPolicy::RetryDecision::RETRY:
+      if (connection->host_metrics()) {
+        connection->host_metrics()->retries.inc();
+      }
       set_retry_consistency(decision.retry_consistency());
       if (decision.retry_current_host()) {
         retry_current_host();
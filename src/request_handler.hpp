@@ -17,6 +17,7 @@
 #ifndef __CASS_REQUEST_HANDLER_HPP_INCLUDED__
 #define __CASS_REQUEST_HANDLER_HPP_INCLUDED__
 
+#include "admission_controller.hpp"
 #include "constants.hpp"
 #include "error_response.hpp"
 #include "future.hpp"
@@ -33,6 +34,7 @@
 #include "small_vector.hpp"
 #include "speculative_execution.hpp"
 #include "string.hpp"
+#include "timer_wheel.hpp"
 #include "timestamp_generator.hpp"
 
 #include <uv.h>
@@ -44,7 +46,6 @@ class Connection;
 class ConnectionPoolManager;
 class Pool;
 class ExecutionProfile;
-class Timer;
 class TokenMap;
 
 class ResponseFuture : public Future {
@@ -59,27 +60,24 @@ public:
     , schema_metadata(Memory::allocate<Metadata::SchemaSnapshot>(schema_metadata)) { }
 
   bool set_response(Address address, const Response::Ptr& response) {
-    ScopedMutex lock(&mutex_);
-    if (!is_set()) {
+    if (claim()) {
       address_ = address;
       response_ = response;
-      internal_set(lock);
+      internal_set();
       return true;
     }
     return false;
   }
 
   const Response::Ptr& response() {
-    ScopedMutex lock(&mutex_);
-    internal_wait(lock);
+    internal_wait();
     return response_;
   }
 
   bool set_error_with_address(Address address, CassError code, const String& message) {
-    ScopedMutex lock(&mutex_);
-    if (!is_set()) {
+    if (claim()) {
       address_ = address;
-      internal_set_error(code, message, lock);
+      internal_set_error(code, message);
       return true;
     }
     return false;
@@ -87,26 +85,24 @@ public:
 
   bool set_error_with_response(Address address, const Response::Ptr& response,
                                CassError code, const String& message) {
-    ScopedMutex lock(&mutex_);
-    if (!is_set()) {
+    if (claim()) {
       address_ = address;
       response_ = response;
-      internal_set_error(code, message, lock);
+      internal_set_error(code, message);
       return true;
     }
     return false;
   }
 
   Address address() {
-    ScopedMutex lock(&mutex_);
-    internal_wait(lock);
+    internal_wait();
     return address_;
   }
 
   // Currently, used for testing only, but it could be exposed in the future.
   AddressVec attempted_addresses() {
+    internal_wait();
     ScopedMutex lock(&mutex_);
-    internal_wait(lock);
     return attempted_addresses_;
   }
 
@@ -135,6 +131,7 @@ class RequestHandler : public RefCounted<RequestHandler> {
 
 public:
   typedef SharedRefPtr<RequestHandler> Ptr;
+  typedef Vector<Ptr> Vec;
 
   RequestHandler(const Request::ConstPtr& request,
                  const ResponseFuture::Ptr& future,
@@ -143,6 +140,16 @@ public:
 
   void set_prepared_metadata(const PreparedMetadata::Entry::Ptr& entry);
 
+  /**
+   * Set the admission controller that admitted the request. The request
+   * releases its slot when it's finished.
+   *
+   * @param admission_controller
+   */
+  void set_admission_controller(const AdmissionController::Ptr& admission_controller) {
+    admission_controller_ = admission_controller;
+  }
+
   void init(const ExecutionProfile& profile,
             ConnectionPoolManager* manager,
             const TokenMap* token_map,
@@ -155,6 +162,7 @@ public:
   const Request* request() const { return wrapper_.request().get(); }
   CassConsistency consistency() const { return wrapper_.consistency(); }
   const Address& preferred_address() const { return preferred_address_; }
+  uint64_t start_time_ns() const { return start_time_ns_; }
 
 public:
   class Protected {
@@ -172,6 +180,8 @@ public:
 
   void add_attempted_address(const Address& address, Protected);
 
+  void notify_rows(ResultResponse* rows, Protected);
+
   void notify_result_metadata_changed(const String& prepared_id,
                                       const String& query,
                                       const String& keyspace,
@@ -202,7 +212,7 @@ public:
   void stop_timer();
 
 private:
-  void on_timeout(Timer* timer);
+  void on_timeout(LoopTimer* timer);
 
 private:
   void stop_request();
@@ -215,9 +225,9 @@ private:
   bool is_done_;
   int running_executions_;
 
-  ScopedPtr<QueryPlan> query_plan_;
+  QueryPlanStorage query_plan_; // Embedded to avoid an allocation per request
   ScopedPtr<SpeculativeExecutionPlan> execution_plan_;
-  Timer timer_;
+  LoopTimer timer_;
 
   const uint64_t start_time_ns_;
   RequestListener* listener_;
@@ -225,6 +235,7 @@ private:
 
   Metrics* const metrics_;
   const Address preferred_address_;
+  AdmissionController::Ptr admission_controller_;
 };
 
 class KeyspaceChangedResponse {
@@ -300,8 +311,10 @@ public:
   virtual void on_retry_current_host();
   virtual void on_retry_next_host();
 
+  virtual bool streams_rows() const;
+
 private:
-  void on_execute_next(Timer* timer);
+  void on_execute_next(LoopTimer* timer);
 
   void retry_current_host();
   void retry_next_host();
@@ -310,6 +323,7 @@ private:
 
   virtual void on_set(ResponseMessage* response);
   virtual void on_error(CassError code, const String& message);
+  virtual void on_rows(ResultResponse* rows);
 
   void on_result_response(Connection* connection, ResponseMessage* response);
   void on_error_response(Connection* connection, ResponseMessage* response);
@@ -325,8 +339,9 @@ private:
   RequestHandler::Ptr request_handler_;
   Host::Ptr current_host_;
   Connection* connection_;
-  Timer schedule_timer_;
+  LoopTimer schedule_timer_;
   int num_retries_;
+  bool has_rows_; // Some of the rows were delivered
   const uint64_t start_time_ns_;
 };
 
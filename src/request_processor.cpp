@@ -25,6 +25,13 @@
 
 namespace cass {
 
+// The number of queued requests a processor must have before idle peers
+// take some of them
+static const size_t MIN_STEAL_BACKLOG = 128;
+
+// The maximum number of requests taken from a peer at once
+static const size_t MAX_STEAL_COUNT = 256;
+
 class ProcessorRunClose : public Task {
 public:
   ProcessorRunClose(const RequestProcessor::Ptr& processor)
@@ -38,6 +45,19 @@ private:
   const RequestProcessor::Ptr processor_;
 };
 
+class ProcessorMaybeClose : public Task {
+public:
+  ProcessorMaybeClose(const RequestProcessor::Ptr& processor)
+    : processor_(processor) { }
+
+  virtual void run(EventLoop* event_loop) {
+    processor_->maybe_close(processor_->request_count_.load());
+  }
+
+private:
+  const RequestProcessor::Ptr processor_;
+};
+
 class ProcessorNotifyHostAdd : public Task {
 public:
   ProcessorNotifyHostAdd(const Host::Ptr host,
@@ -151,9 +171,11 @@ RequestProcessorSettings::RequestProcessorSettings()
   , request_queue_size(8192)
   , coalesce_delay_us(CASS_DEFAULT_COALESCE_DELAY)
   , new_request_ratio(CASS_DEFAULT_NEW_REQUEST_RATIO)
+  , coalesce_mode(CASS_DEFAULT_COALESCE_MODE)
   , max_tracing_wait_time_ms(CASS_DEFAULT_MAX_TRACING_DATA_WAIT_TIME_MS)
   , retry_tracing_wait_time_ms(CASS_DEFAULT_RETRY_TRACING_DATA_WAIT_TIME_MS)
-  , tracing_consistency(CASS_DEFAULT_TRACING_CONSISTENCY) {
+  , tracing_consistency(CASS_DEFAULT_TRACING_CONSISTENCY)
+  , work_stealing(CASS_DEFAULT_WORK_STEALING) {
     profiles.set_empty_key("");
   }
 
@@ -167,9 +189,11 @@ RequestProcessorSettings::RequestProcessorSettings(const Config& config)
   , request_queue_size(config.queue_size_io())
   , coalesce_delay_us(config.coalesce_delay_us())
   , new_request_ratio(config.new_request_ratio())
+  , coalesce_mode(config.coalesce_mode())
   , max_tracing_wait_time_ms(config.max_tracing_wait_time_ms())
   , retry_tracing_wait_time_ms(config.retry_tracing_wait_time_ms())
-  , tracing_consistency(config.tracing_consistency()) { }
+  , tracing_consistency(config.tracing_consistency())
+  , work_stealing(config.work_stealing()) { }
 
 RequestProcessor::RequestProcessor(RequestProcessorListener* listener,
                                    EventLoop* event_loop,
@@ -187,17 +211,15 @@ RequestProcessor::RequestProcessor(RequestProcessorListener* listener,
   , profiles_(settings.profiles)
   , request_count_(0)
   , request_queue_(Memory::allocate<MPMCQueue<RequestHandler*> >(settings.request_queue_size))
+  , queue_latency_ns_(0)
   , is_closing_(false)
   , is_processing_(false)
   , attempts_without_requests_(0)
   , io_time_during_coalesce_(0)
-#ifdef CASS_INTERNAL_DIAGNOSTICS
+  , coalesce_start_time_ns_(0)
   , reads_during_coalesce_(0)
   , writes_during_coalesce_(0)
-  , writes_per_("writes")
-  , reads_per_("reads")
-#endif
-{
+  , coalesce_controller_(settings.coalesce_mode, settings.coalesce_delay_us) {
   inc_ref(); // For the connection pool manager
   connection_pool_manager_->set_listener(this);
 
@@ -237,6 +259,15 @@ void RequestProcessor::set_listener(RequestProcessorListener* listener) {
   listener_ = listener ? listener : &nop_request_processor_listener__;
 }
 
+void RequestProcessor::set_peers(const Vector<RequestProcessor*>& peers) {
+  peers_.clear();
+  if (!settings_.work_stealing) return;
+  for (Vector<RequestProcessor*>::const_iterator it = peers.begin(),
+       end = peers.end(); it != end; ++it) {
+    if (*it != this) peers_.push_back(*it);
+  }
+}
+
 void RequestProcessor::set_keyspace(const String& keyspace,
                                     const KeyspaceChangedHandler::Ptr& handler) {
   // If running on the the current event loop then just set the keyspace,
@@ -279,7 +310,11 @@ void RequestProcessor::process_request(const RequestHandler::Ptr& request_handle
     if (!is_processing_.load(MEMORY_ORDER_RELAXED) &&
         is_processing_.compare_exchange_strong(expected, true)) {
       async_.send();
-     }
+    } else if (!peers_.empty()) {
+      // This processor is busy (or blocked in a callback), let an idle peer
+      // take some of its requests.
+      notify_idle_peer();
+    }
   } else {
     request_handler->dec_ref();
     request_handler->set_error(CASS_ERROR_LIB_REQUEST_QUEUE_FULL,
@@ -287,6 +322,34 @@ void RequestProcessor::process_request(const RequestHandler::Ptr& request_handle
   }
 }
 
+void RequestProcessor::process_many_requests(const RequestHandler::Vec& request_handlers) {
+  if (request_handlers.empty()) return;
+
+  SmallVector<RequestHandler*, 64> entries(request_handlers.size());
+  for (size_t i = 0; i < request_handlers.size(); ++i) {
+    entries[i] = request_handlers[i].get();
+    entries[i]->inc_ref(); // Queue reference
+  }
+
+  size_t enqueued = request_queue_->enqueue_many(&entries[0], entries.size());
+  if (enqueued > 0) {
+    request_count_.fetch_add(static_cast<int>(enqueued));
+    bool expected = false;
+    if (!is_processing_.load(MEMORY_ORDER_RELAXED) &&
+        is_processing_.compare_exchange_strong(expected, true)) {
+      async_.send();
+    } else if (!peers_.empty()) {
+      notify_idle_peer();
+    }
+  }
+
+  for (size_t i = enqueued; i < entries.size(); ++i) {
+    entries[i]->dec_ref();
+    entries[i]->set_error(CASS_ERROR_LIB_REQUEST_QUEUE_FULL,
+                          "The request queue has reached capacity");
+  }
+}
+
 int RequestProcessor::init(Protected) {
   int rc = async_.start(event_loop_->loop(),
                         bind_callback(&RequestProcessor::on_async, this));
@@ -411,9 +474,7 @@ bool RequestProcessor::on_prepare_all(const RequestHandler::Ptr& request_handler
 }
 
 void RequestProcessor::on_done() {
-#ifdef CASS_INTERNAL_DIAGNOSTICS
   reads_during_coalesce_++;
-#endif
   maybe_close(request_count_.fetch_sub(1) - 1);
 }
 
@@ -503,7 +564,8 @@ void RequestProcessor::internal_host_maybe_up(const Address& address) {
 
 void RequestProcessor::start_coalescing() {
   io_time_during_coalesce_ = 0;
-  timer_.start(event_loop_->loop(), settings_.coalesce_delay_us,
+  coalesce_start_time_ns_ = uv_hrtime();
+  timer_.start(event_loop_->loop(), coalesce_controller_.delay_us(),
                bind_callback(&RequestProcessor::on_timeout, this));
 }
 
@@ -515,21 +577,33 @@ void RequestProcessor::on_timeout(MicroTimer* timer) {
 
   connection_pool_manager_->flush();
 
+  uint64_t elapsed_ns = uv_hrtime() - coalesce_start_time_ns_;
+  coalesce_controller_.record(writes_during_coalesce_, elapsed_ns,
+                              io_time_during_coalesce_);
+
   if (processed > 0) {
     attempts_without_requests_ = 0;
 
-#ifdef CASS_INTERNAL_DIAGNOSTICS
-    reads_per_.record_value(reads_during_coalesce_);
-    writes_per_.record_value(writes_during_coalesce_);
-    reads_during_coalesce_ = 0;
-    writes_during_coalesce_ = 0;
-#endif
-  } else {
+    Metrics* metrics = connection_pool_manager_->metrics();
+    if (metrics) {
+      metrics->coalesce_delays.record_value(elapsed_ns / 1000);
+      metrics->writes_per_flush.record_value(writes_during_coalesce_);
+      metrics->reads_per_flush.record_value(reads_during_coalesce_);
+    }
+  }
+
+  // Reset the counts before the loop possibly goes back to sleep so that the
+  // next flush doesn't include them.
+  reads_during_coalesce_ = 0;
+  writes_during_coalesce_ = 0;
+
+  if (processed == 0) {
     // Keep trying to process more requests before for a few iterations before
     // putting the loop back to sleep.
     attempts_without_requests_++;
     if (attempts_without_requests_ > 5) {
       attempts_without_requests_ = 0;
+      queue_latency_ns_.store(0, MEMORY_ORDER_RELAXED); // The queue is empty
       is_processing_.store(false);
       bool expected = false;
       if (request_queue_->is_empty() ||
@@ -572,43 +646,158 @@ int RequestProcessor::process_requests(uint64_t processing_time) {
   uint64_t finish_time = uv_hrtime() + processing_time;
 
   int processed = 0;
+  bool is_drained = true;
+  bool is_idle = true;
   RequestHandler* request_handler = NULL;
   while (request_queue_->dequeue(request_handler)) {
     if (request_handler) {
-      const String& profile_name = request_handler->request()->execution_profile_name();
-      const ExecutionProfile* profile(execution_profile(profile_name));
-      if (profile) {
-        if (!profile_name.empty()) {
-          LOG_TRACE("Using execution profile '%s'", profile_name.c_str());
-        }
-        request_handler->init(*profile,
-                              connection_pool_manager_.get(),
-                              token_map_.get(),
-                              settings_.timestamp_generator.get(),
-                              this);
-        request_handler->execute();
+      is_idle = false;
+      if ((processed & 0x3F) == 0) { // Sample the queue latency every 64 requests
+        record_queue_latency(request_handler, uv_hrtime());
+      }
+      if (process_request_handler(request_handler)) {
         processed++;
-      } else {
-        maybe_close(request_count_.fetch_sub(1) - 1);
-        request_handler->set_error(CASS_ERROR_LIB_EXECUTION_PROFILE_INVALID,
-                                   profile_name + " does not exist");
       }
-      request_handler->dec_ref();
     }
 
     if ((processed & 0x3F) == 0 && // Check the finish time every 64 requests
         uv_hrtime() >= finish_time) {
+      is_drained = false;
       break;
     }
   }
 
-#ifdef CASS_INTERNAL_DIAGNOSTICS
+  if (is_idle) {
+    // Nothing waited in the queue so decay the average towards zero. Otherwise
+    // peers and the skew metric keep seeing the latency of the last burst.
+    uint64_t average_ns = queue_latency_ns_.load(MEMORY_ORDER_RELAXED);
+    queue_latency_ns_.store(average_ns - average_ns / 8, MEMORY_ORDER_RELAXED);
+  }
+
+  if (!peers_.empty() && !is_closing_) {
+    if (is_drained) {
+      processed += steal_requests(finish_time);
+    } else {
+      notify_idle_peer();
+    }
+  }
+
   writes_during_coalesce_ += processed;
-#endif
 
   return processed;
 }
 
+bool RequestProcessor::process_request_handler(RequestHandler* request_handler) {
+  bool is_processed = false;
+  const String& profile_name = request_handler->request()->execution_profile_name();
+  const ExecutionProfile* profile(execution_profile(profile_name));
+  if (profile) {
+    if (!profile_name.empty()) {
+      LOG_TRACE("Using execution profile '%s'", profile_name.c_str());
+    }
+    request_handler->init(*profile,
+                          connection_pool_manager_.get(),
+                          token_map_.get(),
+                          settings_.timestamp_generator.get(),
+                          this);
+    request_handler->execute();
+    is_processed = true;
+  } else {
+    maybe_close(request_count_.fetch_sub(1) - 1);
+    request_handler->set_error(CASS_ERROR_LIB_EXECUTION_PROFILE_INVALID,
+                               profile_name + " does not exist");
+  }
+  request_handler->dec_ref();
+  return is_processed;
+}
+
+int RequestProcessor::steal_requests(uint64_t finish_time) {
+  // Find the peer with the most queued requests
+  RequestProcessor* peer = NULL;
+  size_t backlog = MIN_STEAL_BACKLOG - 1;
+  for (Vector<RequestProcessor*>::const_iterator it = peers_.begin(),
+       end = peers_.end(); it != end; ++it) {
+    size_t size = (*it)->request_queue_->size();
+    if (size > backlog) {
+      peer = *it;
+      backlog = size;
+    }
+  }
+  if (peer == NULL) return 0;
+
+  // Leave half of the requests so that the peer doesn't become the idle one
+  const size_t count = std::min(backlog / 2, static_cast<size_t>(MAX_STEAL_COUNT));
+
+  int processed = 0;
+  size_t stolen = 0;
+  RequestHandler* request_handler = NULL;
+  while (stolen < count && peer->request_queue_->dequeue(request_handler)) {
+    stolen++;
+    if (request_handler) {
+      // The request is executed using this processor's connections so it
+      // needs to be counted here before it's able to finish.
+      request_count_.fetch_add(1);
+      if (process_request_handler(request_handler)) {
+        processed++;
+      }
+    }
+
+    if ((stolen & 0x3F) == 0 && // Check the finish time every 64 requests
+        uv_hrtime() >= finish_time) {
+      break;
+    }
+  }
+
+  if (stolen > 0) {
+    LOG_TRACE("Stole %u requests from a busier request processor",
+              static_cast<unsigned int>(stolen));
+    int remaining = peer->request_count_.fetch_sub(static_cast<int>(stolen)) -
+                    static_cast<int>(stolen);
+    if (remaining <= 0) {
+      // The peer might be waiting on its requests to finish before closing.
+      // That can only be checked on the peer's event loop.
+      peer->event_loop_->add(Memory::allocate<ProcessorMaybeClose>(Ptr(peer)));
+    }
+    Metrics* metrics = connection_pool_manager_->metrics();
+    if (metrics) {
+      metrics->stolen_requests.inc(static_cast<int64_t>(stolen));
+    }
+  }
+
+  return processed;
+}
+
+void RequestProcessor::notify_idle_peer() {
+  if (request_queue_->size() < MIN_STEAL_BACKLOG) return;
+
+  // Wake up a peer that's not processing requests so that it can steal some
+  // of this processor's requests. Peers that are already processing requests
+  // check for requests to steal when they run out of their own.
+  for (Vector<RequestProcessor*>::const_iterator it = peers_.begin(),
+       end = peers_.end(); it != end; ++it) {
+    RequestProcessor* peer = *it;
+    bool expected = false;
+    if (!peer->is_processing_.load(MEMORY_ORDER_RELAXED) &&
+        peer->is_processing_.compare_exchange_strong(expected, true)) {
+      peer->async_.send();
+      return;
+    }
+  }
+}
+
+void RequestProcessor::record_queue_latency(const RequestHandler* request_handler,
+                                            uint64_t now) {
+  uint64_t start_time_ns = request_handler->start_time_ns();
+  uint64_t latency_ns = now > start_time_ns ? now - start_time_ns : 0;
+  // This is only updated on the processor's thread, other threads only read it
+  uint64_t average_ns = queue_latency_ns_.load(MEMORY_ORDER_RELAXED);
+  if (average_ns != 0) {
+    // An exponentially weighted moving average with a weight of 1/8
+    latency_ns = average_ns - average_ns / 8 + latency_ns / 8;
+  }
+  queue_latency_ns_.store(latency_ns, MEMORY_ORDER_RELAXED);
+}
+
 bool RequestProcessor::write_wait_callback(const RequestHandler::Ptr& request_handler,
                                            const Host::Ptr& current_host,
                                            const RequestCallback::Ptr& callback) {
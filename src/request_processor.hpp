@@ -18,10 +18,10 @@
 #define __CASS_REQUEST_PROCESSOR_HPP_INCLUDED__
 
 #include "atomic.hpp"
+#include "coalesce_controller.hpp"
 #include "config.hpp"
 #include "connection_pool_manager.hpp"
 #include "event_loop.hpp"
-#include "histogram_wrapper.hpp"
 #include "host.hpp"
 #include "micro_timer.hpp"
 #include "mpmc_queue.hpp"
@@ -133,11 +133,15 @@ struct RequestProcessorSettings {
 
   int new_request_ratio;
 
+  CassCoalesceMode coalesce_mode;
+
   uint64_t max_tracing_wait_time_ms;
 
   uint64_t retry_tracing_wait_time_ms;
 
   CassConsistency tracing_consistency;
+
+  bool work_stealing;
 };
 
 /**
@@ -251,6 +255,25 @@ public:
    */
   void process_request(const RequestHandler::Ptr& request_handler);
 
+  /**
+   * Enqueue several requests to be processed. The requests are added to the
+   * queue together and the processor is signaled at most once
+   * (thread-safe, asynchronous).
+   *
+   * @param request_handlers
+   */
+  void process_many_requests(const RequestHandler::Vec& request_handlers);
+
+  /**
+   * Set the other processors of the session. Idle processors take queued
+   * requests from busier peers when work stealing is enabled
+   * (*NOT* thread-safe). This must be done before requests are processed and
+   * the peers must outlive the processor's event loop.
+   *
+   * @param peers The session's processors (this processor is ignored).
+   */
+  void set_peers(const Vector<RequestProcessor*>& peers);
+
   /**
    * Get the number of requests the processor is handling
    *
@@ -260,6 +283,23 @@ public:
     return request_count_.load(MEMORY_ORDER_RELAXED);
   }
 
+  /**
+   * Get the moving average of the time requests wait in the processor's
+   * queue before they're executed (thread-safe).
+   *
+   * @return The average queue latency in nanoseconds.
+   */
+  uint64_t queue_latency_ns() const {
+    return queue_latency_ns_.load(MEMORY_ORDER_RELAXED);
+  }
+
+  /**
+   * Get the CPU the processor's event loop thread is pinned to.
+   *
+   * @return The CPU or -1 if the thread isn't pinned.
+   */
+  int cpu() const { return event_loop_->cpu(); }
+
 public:
   class Protected {
     friend class RequestProcessorInitializer;
@@ -320,6 +360,7 @@ private:
 
 private:
   friend class ProcessorRunClose;
+  friend class ProcessorMaybeClose;
   friend class ProcessorNotifyHostAdd;
   friend class ProcessorNotifyHostRemove;
   friend class ProcessorNotifyHostReady;
@@ -338,6 +379,12 @@ private:
 
   void maybe_close(int request_count);
   int process_requests(uint64_t processing_time);
+  bool process_request_handler(RequestHandler* request_handler);
+
+  // Work stealing
+  int steal_requests(uint64_t finish_time);
+  void notify_idle_peer();
+  void record_queue_latency(const RequestHandler* request_handler, uint64_t now);
 
   bool write_wait_callback(const RequestHandler::Ptr& request_handler,
                            const Host::Ptr& current_host,
@@ -355,22 +402,20 @@ private:
   Atomic<int> request_count_;
   ScopedPtr<MPMCQueue<RequestHandler*> > const request_queue_;
   TokenMap::Ptr token_map_;
+  Vector<RequestProcessor*> peers_;
+  Atomic<uint64_t> queue_latency_ns_;
 
   bool is_closing_;
   Atomic<bool> is_processing_;
   int attempts_without_requests_;
   uint64_t io_time_during_coalesce_;
+  uint64_t coalesce_start_time_ns_;
+  int reads_during_coalesce_;
+  int writes_during_coalesce_;
+  CoalesceController coalesce_controller_;
   Async async_;
   Prepare prepare_;
   MicroTimer timer_;
-
-#ifdef CASS_INTERNAL_DIAGNOSTICS
-  int reads_during_coalesce_;
-  int writes_during_coalesce_;
-
-  HistogramWrapper writes_per_;
-  HistogramWrapper reads_per_;
-#endif
 };
 
 } // namespace cass
@@ -0,0 +1,100 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "request_processor_selector.hpp"
+
+#include "murmur3.hpp"
+
+#include <limits>
+
+namespace cass {
+
+RequestProcessorSelector::RequestProcessorSelector(CassRequestDispatch dispatch)
+  : dispatch_(dispatch)
+  , thread_count_(0) {
+  uv_key_create(&thread_index_key_);
+  uv_key_create(&random_key_);
+}
+
+RequestProcessorSelector::~RequestProcessorSelector() {
+  uv_key_delete(&thread_index_key_);
+  uv_key_delete(&random_key_);
+}
+
+void RequestProcessorSelector::set_processor_cpus(const Vector<int>& cpus) {
+  processor_by_cpu_.clear();
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    if (cpus[i] < 0) continue;
+    size_t cpu = static_cast<size_t>(cpus[i]);
+    if (cpu >= processor_by_cpu_.size()) {
+      processor_by_cpu_.resize(cpu + 1, std::numeric_limits<size_t>::max());
+    }
+    // The first processor on a CPU is used if several share it
+    if (processor_by_cpu_[cpu] == std::numeric_limits<size_t>::max()) {
+      processor_by_cpu_[cpu] = i;
+    }
+  }
+}
+
+size_t RequestProcessorSelector::thread_index() const {
+  // Thread indexes are stored off by one so that NULL means unassigned
+  void* index = uv_key_get(&thread_index_key_);
+  if (index == NULL) {
+    index = reinterpret_cast<void*>(thread_count_.fetch_add(1) + 1);
+    uv_key_set(&thread_index_key_, index);
+  }
+  return reinterpret_cast<size_t>(index) - 1;
+}
+
+uint32_t RequestProcessorSelector::next_random() const {
+  // A per-thread xorshift generator. The state is stored directly in the
+  // thread-local slot so there's no allocation and nothing is shared between
+  // threads.
+  uint32_t state = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(uv_key_get(&random_key_)));
+  if (state == 0) {
+    state = static_cast<uint32_t>((thread_index() + 1) * 0x9E3779B9U);
+    if (state == 0) state = 1;
+  }
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  uv_key_set(&random_key_, reinterpret_cast<void*>(static_cast<uintptr_t>(state)));
+  return state;
+}
+
+bool RequestProcessorSelector::routing_key_hash(const Request* request, uint64_t* hash) {
+  if (request == NULL) return false;
+
+  switch (request->opcode()) {
+    case CQL_OPCODE_QUERY:
+    case CQL_OPCODE_EXECUTE:
+    case CQL_OPCODE_BATCH: {
+      RoutingKey routing_key;
+      if (static_cast<const RoutableRequest*>(request)->get_routing_key(&routing_key) &&
+          !routing_key.value().empty()) {
+        *hash = static_cast<uint64_t>(MurmurHash3_x64_128(routing_key.value().data(),
+                                                          routing_key.value().size(), 0));
+        return true;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return false;
+}
+
+} // namespace cass
@@ -0,0 +1,149 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_REQUEST_PROCESSOR_SELECTOR_HPP_INCLUDED__
+#define __CASS_REQUEST_PROCESSOR_SELECTOR_HPP_INCLUDED__
+
+#include "atomic.hpp"
+#include "cassandra.h"
+#include "constants.hpp"
+#include "macros.hpp"
+#include "request.hpp"
+#include "utils.hpp"
+#include "vector.hpp"
+
+#include <assert.h>
+#include <uv.h>
+
+namespace cass {
+
+/**
+ * Chooses the request processor (I/O thread) that handles a request. This is
+ * called on the application's threads for every request so it avoids
+ * writing to shared memory and, except for the least busy strategy, reads at
+ * most two of the processors' request counts.
+ */
+class RequestProcessorSelector {
+public:
+  RequestProcessorSelector(CassRequestDispatch dispatch = CASS_DEFAULT_REQUEST_DISPATCH);
+  ~RequestProcessorSelector();
+
+  CassRequestDispatch dispatch() const { return dispatch_; }
+
+  /**
+   * Set the dispatch strategy (*NOT* thread-safe). This must be done before
+   * requests are executed.
+   *
+   * @param dispatch The dispatch strategy.
+   */
+  void set_dispatch(CassRequestDispatch dispatch) { dispatch_ = dispatch; }
+
+  /**
+   * Set the CPUs that the processors are pinned to (*NOT* thread-safe). This
+   * is used for CPU affinity and must be done before requests are executed.
+   *
+   * @param cpus The CPU of each processor (in the same order as the
+   * processors passed to `select()`) or -1 if it isn't pinned.
+   */
+  void set_processor_cpus(const Vector<int>& cpus);
+
+  /**
+   * Select a processor for a request (thread-safe).
+   *
+   * @param processors A non-empty list of processors. The elements must
+   * provide a `request_count()` method.
+   * @param request The request being dispatched. This is used to determine
+   * the routing key for token affinity.
+   * @return The selected processor.
+   */
+  template <class T>
+  const T& select(const Vector<T>& processors, const Request* request) const {
+    assert(!processors.empty());
+    const size_t count = processors.size();
+    if (count == 1) return processors.front();
+
+    switch (dispatch_) {
+      case CASS_REQUEST_DISPATCH_POWER_OF_TWO_CHOICES:
+        return power_of_two_choices(processors);
+      case CASS_REQUEST_DISPATCH_THREAD_AFFINITY:
+        return processors[thread_index() % count];
+      case CASS_REQUEST_DISPATCH_TOKEN_AFFINITY: {
+        uint64_t hash;
+        if (routing_key_hash(request, &hash)) {
+          return processors[hash % count];
+        }
+        return power_of_two_choices(processors);
+      }
+      case CASS_REQUEST_DISPATCH_CPU_AFFINITY: {
+        int cpu = current_cpu();
+        if (cpu >= 0 && static_cast<size_t>(cpu) < processor_by_cpu_.size()) {
+          size_t index = processor_by_cpu_[cpu];
+          if (index < count) return processors[index];
+        }
+        return power_of_two_choices(processors);
+      }
+      default:
+        break;
+    }
+
+    return least_busy(processors);
+  }
+
+private:
+  template <class T>
+  static const T& least_busy(const Vector<T>& processors) {
+    typename Vector<T>::const_iterator it = processors.begin(), end = processors.end();
+    typename Vector<T>::const_iterator min = it;
+    int min_count = (*it)->request_count();
+    for (++it; it != end; ++it) {
+      int count = (*it)->request_count();
+      if (count < min_count) {
+        min = it;
+        min_count = count;
+      }
+    }
+    return *min;
+  }
+
+  template <class T>
+  const T& power_of_two_choices(const Vector<T>& processors) const {
+    const size_t count = processors.size();
+    uint32_t random = next_random();
+    size_t first = random % count;
+    // Choose a second processor that's guaranteed to be different
+    size_t second = (first + 1 + (random >> 16) % (count - 1)) % count;
+    return processors[first]->request_count() <= processors[second]->request_count()
+           ? processors[first] : processors[second];
+  }
+
+  size_t thread_index() const;
+  uint32_t next_random() const;
+  static bool routing_key_hash(const Request* request, uint64_t* hash);
+
+private:
+  CassRequestDispatch dispatch_;
+  Vector<size_t> processor_by_cpu_; // Indexed by CPU, out of range if not pinned
+  mutable Atomic<size_t> thread_count_;
+  mutable uv_key_t thread_index_key_;
+  mutable uv_key_t random_key_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(RequestProcessorSelector);
+};
+
+} // namespace cass
+
+#endif
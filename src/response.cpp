@@ -22,6 +22,7 @@
 #include "logger.hpp"
 #include "ready_response.hpp"
 #include "result_response.hpp"
+#include "streaming_result.hpp"
 #include "supported_response.hpp"
 
 #include <cstring>
@@ -44,7 +45,8 @@ public:
 };
 
 Response::Response(uint8_t opcode)
-  : opcode_(opcode) {
+  : opcode_(opcode)
+  , data_(NULL) {
   memset(&tracing_id_, 0, sizeof(CassUuid));
 }
 
@@ -64,6 +66,25 @@ bool Response::decode_warnings(Decoder& decoder) {
   return decoder.decode_warnings(warnings_);
 }
 
+ResponseMessage::ResponseMessage(const Compressor* compressor,
+                                 RowsHandler* rows_handler)
+  : compressor_(compressor)
+  , rows_handler_(rows_handler)
+  , version_(0)
+  , flags_(0)
+  , stream_(0)
+  , opcode_(0)
+  , length_(0)
+  , received_(0)
+  , header_size_(0)
+  , is_header_received_(false)
+  , header_buffer_pos_(header_buffer_)
+  , is_body_ready_(false)
+  , is_body_error_(false)
+  , body_buffer_pos_(NULL) { }
+
+ResponseMessage::~ResponseMessage() { }
+
 bool ResponseMessage::allocate_body(int8_t opcode) {
   response_body_.reset();
   switch (opcode) {
@@ -105,7 +126,8 @@ bool ResponseMessage::allocate_body(int8_t opcode) {
   }
 }
 
-ssize_t ResponseMessage::decode(const char* input, size_t size) {
+ssize_t ResponseMessage::decode(const char* input, size_t size,
+                                const RefBuffer::Ptr& input_buffer) {
   const char* input_pos = input;
 
   received_ += size;
@@ -155,9 +177,6 @@ ssize_t ResponseMessage::decode(const char* input, size_t size) {
       } else if (!allocate_body(opcode_) || !response_body_) {
         return -1;
       }
-
-      response_body_->set_buffer(length_);
-      body_buffer_pos_ = response_body_->data();
     } else {
       // We haven't received all the data for the header. We consume the
       // entire buffer.
@@ -170,6 +189,48 @@ ssize_t ResponseMessage::decode(const char* input, size_t size) {
   const size_t remaining = size - (input_pos - input);
   const size_t frame_size = header_size_ + length_;
 
+  if (body_buffer_pos_ == NULL && !streaming_result_) {
+    // This is the start of the body. If the whole body is already contiguous
+    // in a ref-counted input buffer then reference a slice of that buffer
+    // instead of copying the body. The copy is only required when a frame
+    // straddles multiple reads.
+    if (input_buffer && remaining >= static_cast<size_t>(length_)) {
+      char* body = const_cast<char*>(input_pos);
+      assert(body >= input_buffer->data());
+      response_body_->set_buffer(input_buffer, body);
+      body_buffer_pos_ = body + length_;
+      input_pos += length_;
+      if (!decode_body()) return -1;
+      return input_pos - input;
+    }
+
+    if (remaining == 0 && length_ > 0) {
+      // Wait for the body to start arriving, it might be contiguous in the
+      // next read.
+      return size;
+    }
+
+    if (should_stream_rows()) {
+      ResultResponse::Ptr result(static_cast<ResultResponse*>(response_body_.get()));
+      streaming_result_.reset(Memory::allocate<StreamingResult>(result,
+                                                                ProtocolVersion(version_),
+                                                                flags_, length_));
+    } else {
+      response_body_->set_buffer(length_);
+      body_buffer_pos_ = response_body_->data();
+    }
+  }
+
+  if (streaming_result_) {
+    // We may have received more data then we need, only consume what we need
+    const bool is_frame_complete = received_ >= frame_size;
+    size_t needed = is_frame_complete ? remaining - (received_ - frame_size)
+                                      : remaining;
+    if (!decode_rows(input_pos, needed, is_frame_complete)) return -1;
+    input_pos += needed;
+    return input_pos - input;
+  }
+
   if (received_ >= frame_size) {
     // We may have received more data then we need, only copy what we need
     size_t overage = received_ - frame_size;
@@ -179,26 +240,8 @@ ssize_t ResponseMessage::decode(const char* input, size_t size) {
     body_buffer_pos_ += needed;
     input_pos += needed;
     assert(body_buffer_pos_ == response_body_->data() + length_);
-    Decoder decoder(response_body_->data(), length_, ProtocolVersion(version_));
-
-    if (flags_ & CASS_FLAG_TRACING) {
-      if (!response_body_->decode_trace_id(decoder)) return -1;
-    }
-
-    if (flags_ & CASS_FLAG_WARNING) {
-      if (!response_body_->decode_warnings(decoder)) return -1;
-    }
 
-    if (flags_ & CASS_FLAG_CUSTOM_PAYLOAD) {
-      if (!response_body_->decode_custom_payload(decoder)) return -1;
-    }
-
-    if (!response_body_->decode(decoder)) {
-      is_body_error_ = true;
-      return -1;
-    }
-
-    is_body_ready_ = true;
+    if (!decode_body()) return -1;
   } else {
     // We haven't received all the data for the frame. We consume the entire
     // buffer.
@@ -210,5 +253,87 @@ ssize_t ResponseMessage::decode(const char* input, size_t size) {
   return input_pos - input;
 }
 
-} // namespace cass
+bool ResponseMessage::should_stream_rows() const {
+  return rows_handler_ != NULL &&
+      version_ >= CASS_PROTOCOL_VERSION_V3 &&
+      opcode_ == CQL_OPCODE_RESULT &&
+      !(flags_ & CASS_FLAG_COMPRESSION) && // The whole body is needed to decompress it
+      stream_ >= 0 &&
+      length_ > 0 &&
+      rows_handler_->on_rows_start(stream_);
+}
+
+bool ResponseMessage::decode_rows(const char* input, size_t size,
+                                  bool is_frame_complete) {
+  StreamingResult* result = streaming_result_.get();
+
+  ResultResponse::Ptr rows;
+  if (!result->append(input, size) || !result->next_rows(&rows)) {
+    is_body_error_ = true;
+    return false;
+  }
+
+  if (rows) {
+    rows_handler_->on_rows(stream_, rows.get());
+  }
+
+  if (!is_frame_complete) return true;
+
+  if (!result->is_streaming()) {
+    // The rows weren't streamed (e.g. it's not a rows result) so the whole
+    // body was buffered.
+    response_body_->set_buffer(result->buffer(), result->data());
+    return decode_body();
+  }
+
+  if (!result->finish()) {
+    is_body_error_ = true;
+    return false;
+  }
+
+  is_body_ready_ = true;
+  return true;
+}
+
+bool ResponseMessage::decode_body() {
+  if (flags_ & CASS_FLAG_COMPRESSION) {
+    if (compressor_ == NULL) {
+      LOG_ERROR("Received a compressed response without compression enabled");
+      return false;
+    }
+
+    RefBuffer::Ptr buffer;
+    size_t size;
+    if (!compressor_->decompress(response_body_->data(), length_, &buffer, &size)) {
+      LOG_ERROR("Unable to decompress response using %s", compressor_->name());
+      return false;
+    }
+
+    response_body_->set_buffer(buffer, buffer->data());
+    length_ = static_cast<int32_t>(size);
+  }
+
+  Decoder decoder(response_body_->data(), length_, ProtocolVersion(version_));
+
+  if (flags_ & CASS_FLAG_TRACING) {
+    if (!response_body_->decode_trace_id(decoder)) return false;
+  }
+
+  if (flags_ & CASS_FLAG_WARNING) {
+    if (!response_body_->decode_warnings(decoder)) return false;
+  }
 
+  if (flags_ & CASS_FLAG_CUSTOM_PAYLOAD) {
+    if (!response_body_->decode_custom_payload(decoder)) return false;
+  }
+
+  if (!response_body_->decode(decoder)) {
+    is_body_error_ = true;
+    return false;
+  }
+
+  is_body_ready_ = true;
+  return true;
+}
+
+} // namespace cass
@@ -18,6 +18,7 @@
 #define __CASS_RESPONSE_HPP_INCLUDED__
 
 #include "utils.hpp"
+#include "compression.hpp"
 #include "constants.hpp"
 #include "decoder.hpp"
 #include "hash_table.hpp"
@@ -42,12 +43,26 @@ public:
 
   uint8_t opcode() const { return opcode_; }
 
-  char* data() const { return buffer_->data(); }
+  char* data() const { return data_; }
 
   const RefBuffer::Ptr& buffer() const { return buffer_; }
 
   void set_buffer(size_t size) {
     buffer_ = RefBuffer::Ptr(RefBuffer::create(size));
+    data_ = buffer_->data();
+  }
+
+  /**
+   * Use a slice of an existing buffer as the response body. The buffer is
+   * kept alive for as long as the response (or anything holding a reference
+   * to the response's buffer) is alive.
+   *
+   * @param buffer The buffer that contains the response body.
+   * @param data The start of the response body inside of the buffer.
+   */
+  void set_buffer(const RefBuffer::Ptr& buffer, char* data) {
+    buffer_ = buffer;
+    data_ = data;
   }
 
   bool has_tracing_id() const;
@@ -69,6 +84,7 @@ public:
 private:
   uint8_t opcode_;
   RefBuffer::Ptr buffer_;
+  char* data_;
   CassUuid tracing_id_;
   CustomPayloadVec custom_payload_;
   WarningVec warnings_;
@@ -77,21 +93,42 @@ private:
   DISALLOW_COPY_AND_ASSIGN(Response);
 };
 
+class ResultResponse;
+class StreamingResult;
+
 class ResponseMessage {
 public:
-  ResponseMessage()
-      : version_(0)
-      , flags_(0)
-      , stream_(0)
-      , opcode_(0)
-      , length_(0)
-      , received_(0)
-      , header_size_(0)
-      , is_header_received_(false)
-      , header_buffer_pos_(header_buffer_)
-      , is_body_ready_(false)
-      , is_body_error_(false)
-      , body_buffer_pos_(NULL) {}
+  /**
+   * Receives the rows of result responses as they arrive instead of after
+   * the whole frame is received.
+   */
+  class RowsHandler {
+  public:
+    virtual ~RowsHandler() { }
+
+    /**
+     * Called when the body of an uncompressed result that straddles multiple
+     * reads starts arriving.
+     *
+     * @param stream The stream of the response.
+     * @return true if the result's rows should be streamed.
+     */
+    virtual bool on_rows_start(int16_t stream) = 0;
+
+    /**
+     * Called with the rows that have been received since the last call. It's
+     * always called before the whole frame is decoded.
+     *
+     * @param stream The stream of the response.
+     * @param rows A result that only has the received rows.
+     */
+    virtual void on_rows(int16_t stream, ResultResponse* rows) = 0;
+  };
+
+  ResponseMessage(const Compressor* compressor = NULL,
+                  RowsHandler* rows_handler = NULL);
+
+  ~ResponseMessage();
 
   uint8_t flags() const { return flags_; }
 
@@ -103,12 +140,33 @@ public:
 
   bool is_body_ready() const { return is_body_ready_; }
 
-  ssize_t decode(const char* input, size_t size);
+  void set_compressor(const Compressor* compressor) { compressor_ = compressor; }
+
+  /**
+   * Decode a response frame from the input data. The response body is copied
+   * unless an input buffer is provided and the remaining body is contiguous
+   * in the input, in that case the body references a slice of the input
+   * buffer (zero-copy). Otherwise, the rows of results are decoded as they
+   * arrive if the rows handler streams them.
+   *
+   * @param input The input data.
+   * @param size The size of the input data.
+   * @param input_buffer An optional ref-counted buffer that owns the input data.
+   * @return The number of bytes consumed, or negative if an error occurred.
+   */
+  ssize_t decode(const char* input, size_t size,
+                 const RefBuffer::Ptr& input_buffer = RefBuffer::Ptr());
 
 private:
   bool allocate_body(int8_t opcode);
+  bool decode_body();
+
+  bool should_stream_rows() const;
+  bool decode_rows(const char* input, size_t size, bool is_frame_complete);
 
 private:
+  const Compressor* compressor_;
+  RowsHandler* rows_handler_;
   uint8_t version_;
   uint8_t flags_;
   int16_t stream_;
@@ -125,6 +183,7 @@ private:
   bool is_body_error_;
   Response::Ptr response_body_;
   char* body_buffer_pos_;
+  ScopedPtr<StreamingResult> streaming_result_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ResponseMessage);
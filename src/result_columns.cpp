@@ -0,0 +1,368 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "result_columns.hpp"
+
+#include "logger.hpp"
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+
+CassResultColumns* cass_result_columns_new(const CassResult* result) {
+  cass::ResultColumns* columns
+      = cass::Memory::allocate<cass::ResultColumns>(cass::ResultResponse::ConstPtr(result));
+  if (!columns->decode()) {
+    cass::Memory::deallocate(columns);
+    return NULL;
+  }
+  return CassResultColumns::to(columns);
+}
+
+void cass_result_columns_free(CassResultColumns* columns) {
+  cass::Memory::deallocate(columns->from());
+}
+
+size_t cass_result_columns_row_count(const CassResultColumns* columns) {
+  return columns->row_count();
+}
+
+size_t cass_result_columns_column_count(const CassResultColumns* columns) {
+  return columns->column_count();
+}
+
+CassValueType cass_result_columns_type(const CassResultColumns* columns,
+                                       size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->value_type() : CASS_VALUE_TYPE_UNKNOWN;
+}
+
+const cass_uint8_t* cass_result_columns_null_bitmap(const CassResultColumns* columns,
+                                                    size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->null_bitmap() : NULL;
+}
+
+const cass_int32_t* cass_result_columns_int32(const CassResultColumns* columns,
+                                              size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->int32_values() : NULL;
+}
+
+const cass_int64_t* cass_result_columns_int64(const CassResultColumns* columns,
+                                              size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->int64_values() : NULL;
+}
+
+const cass_float_t* cass_result_columns_float(const CassResultColumns* columns,
+                                              size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->float_values() : NULL;
+}
+
+const cass_double_t* cass_result_columns_double(const CassResultColumns* columns,
+                                                size_t index) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  return column != NULL ? column->double_values() : NULL;
+}
+
+CassError cass_result_columns_bytes(const CassResultColumns* columns,
+                                    size_t index,
+                                    const cass_byte_t** data,
+                                    const cass_uint32_t** offsets,
+                                    const cass_int32_t** lengths) {
+  const cass::ResultColumns::Column* column = columns->column(index);
+  if (column == NULL) {
+    return CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS;
+  }
+  if (column->kind() != cass::ResultColumns::KIND_BYTES) {
+    return CASS_ERROR_LIB_INVALID_VALUE_TYPE;
+  }
+  *data = reinterpret_cast<const cass_byte_t*>(columns->data());
+  *offsets = column->offsets();
+  *lengths = column->lengths();
+  return CASS_OK;
+}
+
+CassError cass_result_column_get_int32_array(const CassResult* result,
+                                             size_t index,
+                                             cass_int32_t* output,
+                                             size_t output_count,
+                                             cass_uint8_t* null_bitmap) {
+  return cass::ResultColumns::copy_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError cass_result_column_get_int64_array(const CassResult* result,
+                                             size_t index,
+                                             cass_int64_t* output,
+                                             size_t output_count,
+                                             cass_uint8_t* null_bitmap) {
+  return cass::ResultColumns::copy_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError cass_result_column_get_float_array(const CassResult* result,
+                                             size_t index,
+                                             cass_float_t* output,
+                                             size_t output_count,
+                                             cass_uint8_t* null_bitmap) {
+  return cass::ResultColumns::copy_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError cass_result_column_get_double_array(const CassResult* result,
+                                              size_t index,
+                                              cass_double_t* output,
+                                              size_t output_count,
+                                              cass_uint8_t* null_bitmap) {
+  return cass::ResultColumns::copy_column(result, index, output, output_count, null_bitmap);
+}
+
+} // extern "C"
+
+namespace cass {
+
+static ResultColumns::Kind column_kind(CassValueType value_type) {
+  switch (value_type) {
+    case CASS_VALUE_TYPE_INT:
+      return ResultColumns::KIND_INT32;
+    case CASS_VALUE_TYPE_BIGINT:
+    case CASS_VALUE_TYPE_COUNTER:
+    case CASS_VALUE_TYPE_TIMESTAMP:
+    case CASS_VALUE_TYPE_TIME:
+      return ResultColumns::KIND_INT64;
+    case CASS_VALUE_TYPE_FLOAT:
+      return ResultColumns::KIND_FLOAT;
+    case CASS_VALUE_TYPE_DOUBLE:
+      return ResultColumns::KIND_DOUBLE;
+    default:
+      return ResultColumns::KIND_BYTES;
+  }
+}
+
+// The kind of column that's copied into each type of array
+template <class T>
+struct ColumnKindOf;
+
+template <>
+struct ColumnKindOf<int32_t> {
+  static const ResultColumns::Kind value = ResultColumns::KIND_INT32;
+};
+
+template <>
+struct ColumnKindOf<int64_t> {
+  static const ResultColumns::Kind value = ResultColumns::KIND_INT64;
+};
+
+template <>
+struct ColumnKindOf<float> {
+  static const ResultColumns::Kind value = ResultColumns::KIND_FLOAT;
+};
+
+template <>
+struct ColumnKindOf<double> {
+  static const ResultColumns::Kind value = ResultColumns::KIND_DOUBLE;
+};
+
+static inline void decode_fixed_width(const char* input, int32_t& output) { decode_int32(input, output); }
+static inline void decode_fixed_width(const char* input, int64_t& output) { decode_int64(input, output); }
+static inline void decode_fixed_width(const char* input, float& output) { decode_float(input, output); }
+static inline void decode_fixed_width(const char* input, double& output) { decode_double(input, output); }
+
+template <class T>
+static CassError copy_fixed_width_column(const ResultResponse* result, size_t index,
+                                         T* output, size_t output_count,
+                                         uint8_t* null_bitmap) {
+  if (result->kind() != CASS_RESULT_KIND_ROWS ||
+      !result->metadata() ||
+      result->row_count() < 0) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+
+  const ResultMetadata::Ptr& metadata(result->metadata());
+  const size_t column_count = metadata->column_count();
+  if (index >= column_count) {
+    return CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS;
+  }
+  if (column_kind(metadata->get_column_definition(index).data_type->value_type()) !=
+      ColumnKindOf<T>::value) {
+    return CASS_ERROR_LIB_INVALID_VALUE_TYPE;
+  }
+
+  const size_t row_count = std::min(output_count, static_cast<size_t>(result->row_count()));
+  if (null_bitmap != NULL) {
+    memset(null_bitmap, 0, (row_count + 7) / 8);
+  }
+
+  Decoder decoder(result->rows_decoder());
+  for (size_t row = 0; row < row_count; ++row) {
+    for (size_t column = 0; column < column_count; ++column) {
+      const char* value;
+      size_t size;
+      if (!decoder.decode_bytes(&value, size)) {
+        return CASS_ERROR_LIB_NOT_ENOUGH_DATA;
+      }
+      if (column != index) continue;
+
+      if (value == NULL || size == 0) { // Empty fixed-width values are null
+        output[row] = 0;
+        if (null_bitmap != NULL) {
+          null_bitmap[row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+        }
+      } else if (size == sizeof(T)) {
+        decode_fixed_width(value, output[row]);
+      } else {
+        return CASS_ERROR_LIB_NOT_ENOUGH_DATA;
+      }
+    }
+  }
+
+  return CASS_OK;
+}
+
+CassError ResultColumns::copy_column(const ResultResponse* result, size_t index,
+                                     int32_t* output, size_t output_count,
+                                     uint8_t* null_bitmap) {
+  return copy_fixed_width_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError ResultColumns::copy_column(const ResultResponse* result, size_t index,
+                                     int64_t* output, size_t output_count,
+                                     uint8_t* null_bitmap) {
+  return copy_fixed_width_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError ResultColumns::copy_column(const ResultResponse* result, size_t index,
+                                     float* output, size_t output_count,
+                                     uint8_t* null_bitmap) {
+  return copy_fixed_width_column(result, index, output, output_count, null_bitmap);
+}
+
+CassError ResultColumns::copy_column(const ResultResponse* result, size_t index,
+                                     double* output, size_t output_count,
+                                     uint8_t* null_bitmap) {
+  return copy_fixed_width_column(result, index, output, output_count, null_bitmap);
+}
+
+ResultColumns::Column::Column(CassValueType value_type)
+  : value_type_(value_type)
+  , kind_(column_kind(value_type)) { }
+
+void ResultColumns::Column::resize(size_t row_count) {
+  null_bitmap_.resize((row_count + 7) / 8, 0);
+  switch (kind_) {
+    case KIND_INT32:
+      int32_values_.resize(row_count, 0);
+      break;
+    case KIND_INT64:
+      int64_values_.resize(row_count, 0);
+      break;
+    case KIND_FLOAT:
+      float_values_.resize(row_count, 0.0f);
+      break;
+    case KIND_DOUBLE:
+      double_values_.resize(row_count, 0.0);
+      break;
+    case KIND_BYTES:
+      offsets_.resize(row_count, 0);
+      lengths_.resize(row_count, -1);
+      break;
+  }
+}
+
+bool ResultColumns::Column::set(size_t row, const char* data,
+                                const char* value, size_t size) {
+  if (kind_ == KIND_BYTES) {
+    if (value == NULL) {
+      set_null(row);
+    } else {
+      offsets_[row] = static_cast<uint32_t>(value - data);
+      lengths_[row] = static_cast<int32_t>(size);
+    }
+    return true;
+  }
+
+  if (value == NULL || size == 0) { // Empty fixed-width values are null
+    set_null(row);
+    return true;
+  }
+
+  switch (kind_) {
+    case KIND_INT32:
+      if (size != sizeof(int32_t)) break;
+      decode_int32(value, int32_values_[row]);
+      return true;
+    case KIND_INT64:
+      if (size != sizeof(int64_t)) break;
+      decode_int64(value, int64_values_[row]);
+      return true;
+    case KIND_FLOAT:
+      if (size != sizeof(float)) break;
+      decode_float(value, float_values_[row]);
+      return true;
+    case KIND_DOUBLE:
+      if (size != sizeof(double)) break;
+      decode_double(value, double_values_[row]);
+      return true;
+    default:
+      break;
+  }
+
+  LOG_ERROR("Invalid size %u for a value of type 0x%04X in row %u",
+            static_cast<unsigned>(size),
+            static_cast<unsigned>(value_type_),
+            static_cast<unsigned>(row));
+  return false;
+}
+
+bool ResultColumns::decode() {
+  if (result_->kind() != CASS_RESULT_KIND_ROWS ||
+      !result_->metadata() ||
+      result_->row_count() < 0) {
+    return false;
+  }
+
+  const ResultMetadata::Ptr& metadata(result_->metadata());
+  const size_t column_count = metadata->column_count();
+
+  row_count_ = result_->row_count();
+  columns_.reserve(column_count);
+  for (size_t i = 0; i < column_count; ++i) {
+    const ColumnDefinition& def = metadata->get_column_definition(i);
+    // Size the columns after they're added to avoid copying their arrays
+    columns_.push_back(Column(def.data_type->value_type()));
+    columns_.back().resize(row_count_);
+  }
+
+  const char* data = result_->data();
+  Decoder decoder(result_->rows_decoder());
+  for (size_t row = 0; row < row_count_; ++row) {
+    for (ColumnVec::iterator it = columns_.begin(),
+         end = columns_.end(); it != end; ++it) {
+      const char* value;
+      size_t size;
+      if (!decoder.decode_bytes(&value, size) ||
+          !it->set(row, data, value, size)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace cass
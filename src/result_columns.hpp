@@ -0,0 +1,162 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_RESULT_COLUMNS_HPP_INCLUDED__
+#define __CASS_RESULT_COLUMNS_HPP_INCLUDED__
+
+#include "cassandra.h"
+#include "external.hpp"
+#include "macros.hpp"
+#include "result_response.hpp"
+#include "vector.hpp"
+
+namespace cass {
+
+/**
+ * The rows of a result decoded into columns (struct-of-arrays). Decoding
+ * doesn't create `Value` objects, so it doesn't touch the reference counts of
+ * the columns' data types for every cell. Fixed-width values are copied into
+ * packed arrays and the other values are recorded as offsets and lengths into
+ * the result's data.
+ */
+class ResultColumns {
+public:
+  enum Kind {
+    KIND_INT32,
+    KIND_INT64,
+    KIND_FLOAT,
+    KIND_DOUBLE,
+    KIND_BYTES
+  };
+
+  class Column {
+  public:
+    Column(CassValueType value_type);
+
+    CassValueType value_type() const { return value_type_; }
+    Kind kind() const { return kind_; }
+
+    bool is_null(size_t row) const {
+      return (null_bitmap_[row / 8] & (1 << (row % 8))) != 0;
+    }
+
+    const uint8_t* null_bitmap() const { return data_of(null_bitmap_); }
+
+    // The packed values are NULL if the column is a different kind
+    const int32_t* int32_values() const { return kind_ == KIND_INT32 ? data_of(int32_values_) : NULL; }
+    const int64_t* int64_values() const { return kind_ == KIND_INT64 ? data_of(int64_values_) : NULL; }
+    const float* float_values() const { return kind_ == KIND_FLOAT ? data_of(float_values_) : NULL; }
+    const double* double_values() const { return kind_ == KIND_DOUBLE ? data_of(double_values_) : NULL; }
+
+    // The offsets (from the start of the result's data) and lengths are NULL
+    // if the column has packed values
+    const uint32_t* offsets() const { return kind_ == KIND_BYTES ? data_of(offsets_) : NULL; }
+    const int32_t* lengths() const { return kind_ == KIND_BYTES ? data_of(lengths_) : NULL; }
+
+  private:
+    friend class ResultColumns;
+
+    template <class T>
+    static const T* data_of(const Vector<T>& values) {
+      return values.empty() ? NULL : &values[0];
+    }
+
+    void resize(size_t row_count);
+
+    bool set(size_t row, const char* data, const char* value, size_t size);
+
+    void set_null(size_t row) {
+      null_bitmap_[row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+    }
+
+  private:
+    CassValueType value_type_;
+    Kind kind_;
+    Vector<uint8_t> null_bitmap_;
+    Vector<int32_t> int32_values_;
+    Vector<int64_t> int64_values_;
+    Vector<float> float_values_;
+    Vector<double> double_values_;
+    Vector<uint32_t> offsets_;
+    Vector<int32_t> lengths_;
+  };
+
+  typedef Vector<Column> ColumnVec;
+
+  /**
+   * Copy the values of a fixed-width column into an array without decoding
+   * the rows into columns (or values).
+   *
+   * @param result The result.
+   * @param index The index of the column. Its type must match the output's.
+   * @param output The values of the first `output_count` rows (or all the
+   * rows if there are fewer). Null values are zero.
+   * @param output_count The size of the output.
+   * @param null_bitmap An optional null bitmap for the copied rows.
+   * @return CASS_OK if successful, otherwise an error occurred.
+   */
+  static CassError copy_column(const ResultResponse* result, size_t index,
+                               int32_t* output, size_t output_count,
+                               uint8_t* null_bitmap);
+  static CassError copy_column(const ResultResponse* result, size_t index,
+                               int64_t* output, size_t output_count,
+                               uint8_t* null_bitmap);
+  static CassError copy_column(const ResultResponse* result, size_t index,
+                               float* output, size_t output_count,
+                               uint8_t* null_bitmap);
+  static CassError copy_column(const ResultResponse* result, size_t index,
+                               double* output, size_t output_count,
+                               uint8_t* null_bitmap);
+
+  ResultColumns(const ResultResponse::ConstPtr& result)
+    : result_(result)
+    , row_count_(0) { }
+
+  /**
+   * Decode all the rows of the result in a single pass.
+   *
+   * @return false if the result doesn't have rows (with metadata) or if the
+   * rows are invalid.
+   */
+  bool decode();
+
+  size_t row_count() const { return row_count_; }
+  size_t column_count() const { return columns_.size(); }
+
+  /**
+   * The start of the result's data. The offsets of the variable-length values
+   * are relative to this.
+   */
+  const char* data() const { return result_->data(); }
+
+  const Column* column(size_t index) const {
+    return index < columns_.size() ? &columns_[index] : NULL;
+  }
+
+private:
+  ResultResponse::ConstPtr result_;
+  size_t row_count_;
+  ColumnVec columns_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ResultColumns);
+};
+
+} // namespace cass
+
+EXTERNAL_TYPE(cass::ResultColumns, CassResultColumns)
+
+#endif
@@ -48,6 +48,39 @@ public:
     return true;
   }
 
+  /**
+   * Move to a row. The offsets of the rows are found (and validated) with a
+   * single pass over the result the first time this is called, so moving to
+   * a row doesn't need to decode the rows before it.
+   *
+   * @param index The index of the row.
+   * @return CASS_OK if successful, otherwise an error occurred.
+   */
+  CassError seek(size_t index) {
+    if (index >= static_cast<size_t>(result_->row_count())) {
+      return CASS_ERROR_LIB_INDEX_OUT_OF_BOUNDS;
+    }
+
+    if (row_offsets_.empty() &&
+        !result_->rows_decoder().index_rows(result_->row_count(),
+                                            result_->column_count(),
+                                            &row_offsets_)) {
+      return CASS_ERROR_LIB_NOT_ENOUGH_DATA;
+    }
+
+    if (index > 0) {
+      Decoder decoder(result_->rows_decoder().slice(row_offsets_[index]));
+      if (!decode_row(decoder, result_, row_.values)) {
+        return CASS_ERROR_LIB_NOT_ENOUGH_DATA;
+      }
+      decoder_ = decoder;
+    } else {
+      decoder_ = result_->row_decoder();
+    }
+    index_ = static_cast<int32_t>(index);
+    return CASS_OK;
+  }
+
   const Row* row() const {
     assert(index_ >= 0 && index_ < result_->row_count());
     if (index_ > 0) {
@@ -62,6 +95,7 @@ private:
   Decoder decoder_;
   int32_t index_;
   Row row_;
+  Vector<uint32_t> row_offsets_;
 };
 
 } // namespace cass
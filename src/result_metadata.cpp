@@ -26,10 +26,23 @@
 
 namespace cass {
 
+ColumnOp::ColumnOp(const DataType::ConstPtr& data_type)
+  : is_collection(data_type && data_type->is_collection())
+  , count(0) {
+  if (!data_type) return;
+  if (data_type->is_tuple()) {
+    count = static_cast<int32_t>(static_cast<const CompositeType*>(data_type.get())->types().size());
+  } else if (data_type->is_user_type()) {
+    count = static_cast<int32_t>(static_cast<const UserType*>(data_type.get())->fields().size());
+  }
+}
+
 ResultMetadata::ResultMetadata(size_t column_count,
                                const RefBuffer::Ptr& buffer)
   : defs_(column_count)
-  , buffer_(buffer) { }
+  , buffer_(buffer) {
+  ops_.reserve(column_count);
+}
 
 size_t ResultMetadata::get_indices(StringRef name, IndexVec* result) const{
   return defs_.get_indices(name, result);
@@ -37,6 +50,7 @@ size_t ResultMetadata::get_indices(StringRef name, IndexVec* result) const{
 
 void ResultMetadata::add(const ColumnDefinition& def) {
   defs_.add(def);
+  ops_.push_back(ColumnOp(def.data_type));
 }
 
 } // namespace cass
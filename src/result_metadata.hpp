@@ -21,6 +21,7 @@
 #include "data_type.hpp"
 #include "hash_table.hpp"
 #include "ref_counted.hpp"
+#include "small_vector.hpp"
 #include "string_ref.hpp"
 
 #include <uv.h>
@@ -36,6 +37,20 @@ struct ColumnDefinition : public HashTableEntry<ColumnDefinition> {
   DataType::ConstPtr data_type;
 };
 
+/**
+ * How to decode a column's values, precomputed from the column's data type
+ * when the metadata is decoded. Rows are decoded using these instead of
+ * dispatching on the data type of every value.
+ */
+struct ColumnOp {
+  ColumnOp(const DataType::ConstPtr& data_type);
+
+  bool is_collection; // The element count is the first part of the value
+  int32_t count;      // The number of tuple elements or UDT fields
+};
+
+typedef SmallVector<ColumnOp, 16> ColumnOpVec;
+
 class ResultMetadata : public RefCounted<ResultMetadata> {
 public:
   typedef SharedRefPtr<ResultMetadata> Ptr;
@@ -49,10 +64,16 @@ public:
 
   size_t column_count() const { return defs_.size(); }
 
+  // Shared by all the results that use this metadata (e.g. the results of a
+  // prepared statement executed without metadata) so they're only computed
+  // once.
+  const ColumnOpVec& column_ops() const { return ops_; }
+
   void add(const ColumnDefinition& meta);
 
 private:
   CaseInsensitiveHashTable<ColumnDefinition> defs_;
+  ColumnOpVec ops_;
   RefBuffer::Ptr buffer_;
 
 private:
@@ -236,6 +236,34 @@ bool ResultResponse::decode(Decoder& decoder) {
   return is_valid;
 }
 
+bool ResultResponse::decode_rows_metadata(Decoder& decoder, int32_t* row_count) {
+  protocol_version_ = decoder.protocol_version();
+  decoder.set_type("result");
+
+  CHECK_RESULT(decoder.decode_int32(kind_));
+  if (kind_ != CASS_RESULT_KIND_ROWS) return false;
+
+  CHECK_RESULT(decode_metadata(decoder, &metadata_));
+  CHECK_RESULT(decoder.decode_int32(*row_count));
+  row_count_ = 0;
+  return true;
+}
+
+bool ResultResponse::set_rows(const ResultResponse& result, const RefBuffer::Ptr& buffer,
+                              char* rows, size_t size, int32_t row_count) {
+  set_buffer(buffer, rows);
+  kind_ = CASS_RESULT_KIND_ROWS;
+  protocol_version_ = result.protocol_version_;
+  metadata_ = result.metadata_;
+  keyspace_ = result.keyspace_;
+  table_ = result.table_;
+  row_count_ = row_count;
+  row_decoder_ = Decoder(rows, size, protocol_version_);
+  row_decoder_.set_type("result");
+  rows_decoder_ = row_decoder_;
+  return decode_first_row();
+}
+
 bool ResultResponse::decode_metadata(Decoder& decoder,
                                      ResultMetadata::Ptr* metadata,
                                      bool has_pk_indices) {
@@ -321,6 +349,7 @@ bool ResultResponse::decode_rows(Decoder& decoder) {
   CHECK_RESULT(decode_metadata(decoder, &metadata_));
   CHECK_RESULT(decoder.decode_int32(row_count_));
   row_decoder_ = decoder;
+  rows_decoder_ = decoder;
   CHECK_RESULT(decode_first_row());
   return true;
 }
@@ -71,6 +71,10 @@ public:
 
   const Decoder& row_decoder() const { return row_decoder_; }
 
+  // A decoder positioned at the first row (`row_decoder()` is positioned
+  // after the first row)
+  const Decoder& rows_decoder() const { return rows_decoder_; }
+
   int32_t row_count() const { return row_count_; }
 
   const Row& first_row() const { return first_row_; }
@@ -79,6 +83,37 @@ public:
 
   virtual bool decode(Decoder& decoder);
 
+  /**
+   * Decode the kind and the metadata of a rows result without its rows. This
+   * is used when the rows are decoded separately as they arrive (see
+   * `StreamingResult`) so the result doesn't have any rows.
+   *
+   * @param decoder A decoder positioned at the result's kind.
+   * @param row_count The number of rows that follow the metadata.
+   * @return false if it's not a rows result or the metadata is invalid.
+   */
+  bool decode_rows_metadata(Decoder& decoder, int32_t* row_count);
+
+  /**
+   * Use some of the rows of a result that was decoded using
+   * `decode_rows_metadata()`.
+   *
+   * @param result The result with the metadata.
+   * @param buffer The buffer that contains the rows.
+   * @param rows The start of the rows inside of the buffer.
+   * @param size The size of the rows.
+   * @param row_count The number of rows.
+   * @return false if the first row is invalid.
+   */
+  bool set_rows(const ResultResponse& result, const RefBuffer::Ptr& buffer,
+                char* rows, size_t size, int32_t row_count);
+
+  // Remove the rows (e.g. after they're delivered to a rows callback)
+  void clear_rows() {
+    row_count_ = 0;
+    first_row_.values.clear();
+  }
+
 private:
   bool decode_metadata(Decoder& decoder, ResultMetadata::Ptr* metadata,
                        bool has_pk_indices = false);
@@ -108,6 +143,7 @@ private:
   StringRef new_metadata_id_; // rows result, protocol v5/DSEv2
   int32_t row_count_;
   Decoder row_decoder_;
+  Decoder rows_decoder_;
   Row first_row_;
   PKIndexVec pk_indices_;
 
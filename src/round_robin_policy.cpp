@@ -15,7 +15,6 @@
 */
 
 #include "round_robin_policy.hpp"
-#include "scoped_lock.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -23,23 +22,20 @@
 namespace cass {
 
 RoundRobinPolicy::RoundRobinPolicy()
-  : hosts_(Memory::allocate<HostVec>())
-  , index_(0) {
-  uv_rwlock_init(&available_rwlock_);
-}
-
-RoundRobinPolicy::~RoundRobinPolicy() {
-  uv_rwlock_destroy(&available_rwlock_);
-}
+  : live_hosts_(Memory::allocate<LiveHosts>())
+  , index_(0) { }
 
 void RoundRobinPolicy::init(const Host::Ptr& connected_host,
                             const HostMap& hosts,
                             Random* random) {
-  available_.resize(hosts.size());
+  LiveHosts* live_hosts = Memory::allocate<LiveHosts>();
+  live_hosts->available.resize(hosts.size());
   std::transform(hosts.begin(), hosts.end(),
-                 std::inserter(available_, available_.begin()), GetAddress());
-  hosts_->reserve(hosts.size());
-  std::transform(hosts.begin(), hosts.end(), std::back_inserter(*hosts_), GetHost());
+                 std::inserter(live_hosts->available, live_hosts->available.begin()),
+                 GetAddress());
+  live_hosts->hosts->reserve(hosts.size());
+  std::transform(hosts.begin(), hosts.end(), std::back_inserter(*live_hosts->hosts), GetHost());
+  live_hosts_.set(live_hosts);
 
   if (random != NULL) {
     index_ = random->next(std::max(static_cast<size_t>(1), hosts.size()));
@@ -53,16 +49,25 @@ CassHostDistance RoundRobinPolicy::distance(const Host::Ptr& host) const {
 QueryPlan* RoundRobinPolicy::new_query_plan(const String& keyspace,
                                             RequestHandler* request_handler,
                                             const TokenMap* token_map) {
-  return Memory::allocate<RoundRobinQueryPlan>(this, hosts_, index_++);
+  return emplace_query_plan(NULL, keyspace, request_handler, token_map);
+}
+
+QueryPlan* RoundRobinPolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                                const String& keyspace,
+                                                RequestHandler* request_handler,
+                                                const TokenMap* token_map) {
+  return new (QueryPlanStorage::allocate(storage, sizeof(RoundRobinQueryPlan)))
+      RoundRobinQueryPlan(this, live_hosts_.ref(), index_++);
 }
 
 bool RoundRobinPolicy::is_host_up(const Address& address) const {
-  ScopedReadLock rl(&available_rwlock_);
-  return available_.count(address) > 0;
+  return live_hosts_->available.count(address) > 0;
 }
 
 void RoundRobinPolicy::on_host_added(const Host::Ptr& host) {
-  add_host(hosts_, host);
+  LiveHosts* live_hosts = live_hosts_.copy();
+  add_host(live_hosts->hosts, host);
+  live_hosts_.set(live_hosts);
 }
 
 void RoundRobinPolicy::on_host_removed(const Host::Ptr& host) {
@@ -70,26 +75,27 @@ void RoundRobinPolicy::on_host_removed(const Host::Ptr& host) {
 }
 
 void RoundRobinPolicy::on_host_up(const Host::Ptr& host) {
-  add_host(hosts_, host);
-
-  ScopedWriteLock wl(&available_rwlock_);
-  available_.insert(host->address());
+  LiveHosts* live_hosts = live_hosts_.copy();
+  add_host(live_hosts->hosts, host);
+  live_hosts->available.insert(host->address());
+  live_hosts_.set(live_hosts);
 }
 
 void RoundRobinPolicy::on_host_down(const Address& address) {
-  if (remove_host(hosts_, address)) {
+  LiveHosts* live_hosts = live_hosts_.copy();
+  if (remove_host(live_hosts->hosts, address)) {
     LOG_DEBUG("Attempted to remove or mark host %s as DOWN, but it doesn't exist",
               address.to_string().c_str());
   }
-
-  ScopedWriteLock wl(&available_rwlock_);
-  available_.erase(address);
+  live_hosts->available.erase(address);
+  live_hosts_.set(live_hosts);
 }
 
 Host::Ptr RoundRobinPolicy::RoundRobinQueryPlan::compute_next() {
+  const HostVec& hosts = *live_hosts_->hosts;
   while (remaining_ > 0) {
     --remaining_;
-    const Host::Ptr& host((*hosts_)[index_++ % hosts_->size()]);
+    const Host::Ptr& host(hosts[index_++ % hosts.size()]);
     if (policy_->is_host_up(host->address())) {
       return host;
     }
@@ -22,13 +22,14 @@
 #include "load_balancing.hpp"
 #include "host.hpp"
 #include "random.hpp"
+#include "ref_counted.hpp"
+#include "snapshot_ptr.hpp"
 
 namespace cass {
 
 class RoundRobinPolicy : public LoadBalancingPolicy {
 public:
   RoundRobinPolicy();
-  ~RoundRobinPolicy();
 
   virtual void init(const Host::Ptr& connected_host, const HostMap& hosts, Random* random);
 
@@ -38,6 +39,11 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   virtual bool is_host_up(const Address& address) const;
 
   virtual void on_host_added(const Host::Ptr& host);
@@ -48,29 +54,46 @@ public:
   virtual LoadBalancingPolicy* new_instance() { return Memory::allocate<RoundRobinPolicy>(); }
 
 private:
+  /**
+   * An immutable snapshot of the hosts. Host events publish a modified copy
+   * so that query plans and `is_host_up()` never take a lock.
+   */
+  class LiveHosts : public RefCounted<LiveHosts> {
+  public:
+    typedef SharedRefPtr<const LiveHosts> ConstPtr;
+
+    LiveHosts()
+      : hosts(Memory::allocate<HostVec>()) { }
+
+    LiveHosts(const LiveHosts& other)
+      : RefCounted<LiveHosts>()
+      , available(other.available)
+      , hosts(other.hosts) { }
+
+    AddressSet available;
+    CopyOnWriteHostVec hosts;
+  };
+
   class RoundRobinQueryPlan : public QueryPlan {
   public:
     RoundRobinQueryPlan(const RoundRobinPolicy* policy,
-                        const CopyOnWriteHostVec& hosts,
+                        const LiveHosts::ConstPtr& live_hosts,
                         size_t start_index)
       : policy_(policy)
-      , hosts_(hosts)
+      , live_hosts_(live_hosts)
       , index_(start_index)
-      , remaining_(hosts->size()) { }
+      , remaining_(live_hosts->hosts->size()) { }
 
     virtual Host::Ptr compute_next();
 
   private:
     const RoundRobinPolicy* policy_;
-    const CopyOnWriteHostVec hosts_;
+    const LiveHosts::ConstPtr live_hosts_;
     size_t index_;
     size_t remaining_;
   };
 
-  mutable uv_rwlock_t available_rwlock_;
-  AddressSet available_;
-
-  CopyOnWriteHostVec hosts_;
+  SnapshotPtr<LiveHosts> live_hosts_;
   size_t index_;
 
 private:
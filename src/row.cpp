@@ -50,13 +50,36 @@ namespace cass {
 
 bool decode_row(Decoder& decoder, const ResultResponse* result,
                 OutputValueVec& output) {
-  output.clear();
-  output.reserve(result->column_count());
-  for (int i = 0; i < result->column_count(); ++i) {
-    Value value;
-    const ColumnDefinition& def = result->metadata()->get_column_definition(i);
-    CHECK_RESULT(decoder.decode_value(def.data_type, value));
-    output.push_back(value);
+  const ResultMetadata* metadata = result->metadata().get();
+  const ColumnOpVec& ops = metadata->column_ops();
+  const size_t column_count = ops.size();
+
+  // The values are created (with their data types) for the first row decoded
+  // into the output. The following rows update the values in place.
+  if (output.size() != column_count) {
+    output.clear();
+    output.reserve(column_count);
+    for (size_t i = 0; i < column_count; ++i) {
+      output.push_back(Value(metadata->get_column_definition(i).data_type));
+    }
+  }
+
+  for (size_t i = 0; i < column_count; ++i) {
+    const char* buffer = NULL;
+    size_t size = 0;
+    CHECK_RESULT(decoder.decode_bytes(&buffer, size));
+    if (buffer == NULL) {
+      output[i].set_null();
+      continue;
+    }
+
+    const ColumnOp& op = ops[i];
+    Decoder value_decoder(buffer, size, decoder.protocol_version());
+    int32_t count = op.count;
+    if (op.is_collection) {
+      CHECK_RESULT(value_decoder.decode_int32(count));
+    }
+    output[i].set(count, value_decoder);
   }
 
   return true;
@@ -29,6 +29,23 @@
 #include "scoped_lock.hpp"
 #include "statement.hpp"
 
+#include <algorithm>
+#include <limits>
+
+template <class T>
+static void copy_snapshot(const cass::Metrics::Histogram::Snapshot& snapshot, T* output) {
+  output->min = snapshot.min;
+  output->max = snapshot.max;
+  output->mean = snapshot.mean;
+  output->stddev = snapshot.stddev;
+  output->median = snapshot.median;
+  output->percentile_75th = snapshot.percentile_75th;
+  output->percentile_95th = snapshot.percentile_95th;
+  output->percentile_98th = snapshot.percentile_98th;
+  output->percentile_99th = snapshot.percentile_99th;
+  output->percentile_999th = snapshot.percentile_999th;
+}
+
 extern "C" {
 
 CassSession* cass_session_new() {
@@ -100,6 +117,24 @@ CassFuture* cass_session_execute(CassSession* session,
   return CassFuture::to(future.get());
 }
 
+void cass_session_execute_many(CassSession* session,
+                               const CassStatement* const* statements,
+                               size_t statements_count,
+                               CassFuture** output) {
+  cass::Request::ConstVec requests;
+  requests.reserve(statements_count);
+  for (size_t i = 0; i < statements_count; ++i) {
+    requests.push_back(cass::Request::ConstPtr(statements[i]->from()));
+  }
+
+  cass::Future::Vec futures;
+  session->execute_many(requests, &futures);
+  for (size_t i = 0; i < futures.size(); ++i) {
+    futures[i]->inc_ref();
+    output[i] = CassFuture::to(futures[i].get());
+  }
+}
+
 CassFuture* cass_session_execute_batch(CassSession* session, const CassBatch* batch) {
   cass::Future::Ptr future(session->execute(cass::Request::ConstPtr(batch->from())));
   future->inc_ref();
@@ -179,14 +214,117 @@ void  cass_session_get_speculative_execution_metrics(const CassSession* session,
       internal_metrics->request_rates.speculative_request_percent();
 }
 
+void cass_session_get_coalesce_metrics(const CassSession* session,
+                                       CassCoalesceMetrics* metrics) {
+  const cass::Metrics* internal_metrics = session->metrics();
+
+  if (internal_metrics == NULL)  {
+    LOG_WARN("Attempted to get coalesce metrics before connecting session object");
+    memset(metrics, 0, sizeof(CassCoalesceMetrics));
+    return;
+  }
+
+  cass::Metrics::Histogram::Snapshot snapshot;
+
+  internal_metrics->coalesce_delays.get_snapshot(&snapshot);
+  copy_snapshot(snapshot, &metrics->delays);
+
+  internal_metrics->writes_per_flush.get_snapshot(&snapshot);
+  copy_snapshot(snapshot, &metrics->writes_per_flush);
+
+  internal_metrics->reads_per_flush.get_snapshot(&snapshot);
+  copy_snapshot(snapshot, &metrics->reads_per_flush);
+}
+
+void cass_session_get_admission_metrics(const CassSession* session,
+                                        CassAdmissionMetrics* metrics) {
+  const cass::Metrics* internal_metrics = session->metrics();
+
+  if (internal_metrics == NULL)  {
+    LOG_WARN("Attempted to get admission metrics before connecting session object");
+    memset(metrics, 0, sizeof(CassAdmissionMetrics));
+    return;
+  }
+
+  metrics->request_queue_depth = internal_metrics->request_queue_depth.get();
+  metrics->waiting_requests = internal_metrics->waiting_requests.get();
+  metrics->rejected_requests = internal_metrics->rejected_requests.get();
+  metrics->stolen_requests = internal_metrics->stolen_requests.sum();
+  metrics->queue_latency_skew_us = internal_metrics->queue_latency_skew.get();
+
+  cass::Metrics::HostMetrics::Vec hosts;
+  internal_metrics->all_host_metrics(&hosts);
+  metrics->in_flight_bytes = 0;
+  for (cass::Metrics::HostMetrics::Vec::const_iterator it = hosts.begin(),
+       end = hosts.end(); it != end; ++it) {
+    metrics->in_flight_bytes += (*it)->in_flight_bytes.sum();
+  }
+}
+
+CassError cass_session_get_metrics_text(const CassSession* session,
+                                        char* output,
+                                        size_t output_size,
+                                        size_t* output_length) {
+  const cass::Metrics* internal_metrics = session->metrics();
+
+  if (internal_metrics == NULL)  {
+    LOG_WARN("Attempted to get metrics text before connecting session object");
+    return CASS_ERROR_LIB_INVALID_STATE;
+  }
+
+  size_t length = cass::write_open_metrics(internal_metrics, output, output_size);
+  if (output_length != NULL) {
+    *output_length = length;
+  }
+  return length < output_size ? CASS_OK : CASS_ERROR_LIB_NOT_ENOUGH_DATA;
+}
+
+CassIterator* cass_iterator_host_metrics_from_session(const CassSession* session) {
+  return CassIterator::to(cass::Memory::allocate<cass::HostMetricsIterator>(session->metrics()));
+}
+
+CassError cass_iterator_get_host_metrics(const CassIterator* iterator,
+                                         CassHostMetrics* output) {
+  if (iterator->type() != CASS_ITERATOR_TYPE_HOST_METRICS) {
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+  const cass::Metrics::HostMetrics* host_metrics =
+      static_cast<const cass::HostMetricsIterator*>(iterator->from())->host_metrics();
+  if (host_metrics == NULL) { // Before the first call to cass_iterator_next()
+    return CASS_ERROR_LIB_BAD_PARAMS;
+  }
+
+  output->address.address_length = host_metrics->address().to_inet(output->address.address);
+
+  cass::Metrics::Histogram::Snapshot snapshot;
+  host_metrics->request_latencies.get_snapshot(&snapshot);
+  copy_snapshot(snapshot, &output->requests);
+
+  output->requests.mean_rate = host_metrics->request_rates.mean_rate();
+  output->requests.one_minute_rate = host_metrics->request_rates.one_minute_rate();
+  output->requests.five_minute_rate = host_metrics->request_rates.five_minute_rate();
+  output->requests.fifteen_minute_rate = host_metrics->request_rates.fifteen_minute_rate();
+
+  output->stats.in_flight_requests = host_metrics->in_flight_requests.sum();
+  output->stats.in_flight_bytes = host_metrics->in_flight_bytes.sum();
+  output->stats.total_connections = host_metrics->total_connections.sum();
+  output->stats.bytes_written = host_metrics->bytes_written.sum();
+  output->stats.bytes_read = host_metrics->bytes_read.sum();
+  output->stats.stream_exhaustions = host_metrics->stream_exhaustions.sum();
+
+  output->errors.errors = host_metrics->errors.sum();
+  output->errors.retries = host_metrics->retries.sum();
+
+  return CASS_OK;
+}
+
 } // extern "C"
 
 namespace cass {
 
-static inline bool least_busy_comp(const RequestProcessor::Ptr& a,
-                                   const RequestProcessor::Ptr& b) {
-  return a->request_count() < b->request_count();
-}
+// The number of requests that `Session::execute_many()` creates before
+// adding them to the request processors' queues
+static const size_t EXECUTE_MANY_CHUNK_SIZE = 128;
 
 /**
  * An initialize helper class for `Session`. This keeps the initialization
@@ -266,6 +404,21 @@ private:
         ScopedMutex l(&session_->mutex_);
         session_->request_processor_count_ = request_processors_.size();
         session_->request_processors_ = request_processors_;
+
+        // The processors haven't received any requests yet so it's safe to
+        // set their peers and the CPUs used for dispatch.
+        Vector<RequestProcessor*> peers;
+        Vector<int> cpus;
+        for (RequestProcessor::Vec::const_iterator it = request_processors_.begin(),
+             end = request_processors_.end(); it != end; ++it) {
+          peers.push_back(it->get());
+          cpus.push_back((*it)->cpu());
+        }
+        for (RequestProcessor::Vec::const_iterator it = request_processors_.begin(),
+             end = request_processors_.end(); it != end; ++it) {
+          (*it)->set_peers(peers);
+        }
+        session_->request_processor_selector_.set_processor_cpus(cpus);
       }
       if (error_code_ != CASS_OK) {
         session_->notify_connect_failed(error_code_, error_message_);
@@ -302,6 +455,7 @@ Future::Ptr Session::prepare(const char* statement, size_t length) {
 
   ResponseFuture::Ptr future(Memory::allocate<ResponseFuture>(cluster()->schema_snapshot()));
   future->prepare_request = PrepareRequest::ConstPtr(prepare);
+  future->set_wait_spin_time_us(config().future_wait_spin_time_us());
 
   execute(RequestHandler::Ptr(
             Memory::allocate<RequestHandler>(prepare, future, metrics())));
@@ -326,6 +480,7 @@ Future::Ptr Session::prepare(const Statement* statement) {
 
   ResponseFuture::Ptr future(Memory::allocate<ResponseFuture>(cluster()->schema_snapshot()));
   future->prepare_request = PrepareRequest::ConstPtr(prepare);
+  future->set_wait_spin_time_us(config().future_wait_spin_time_us());
 
   execute(RequestHandler::Ptr(
             Memory::allocate<RequestHandler>(prepare, future, metrics())));
@@ -334,21 +489,78 @@ Future::Ptr Session::prepare(const Statement* statement) {
 }
 
 Future::Ptr Session::execute(const Request::ConstPtr& request, const Address* preferred_address) {
+  ResponseFuture::Ptr future(create_future());
+  execute(create_request_handler(request, future, preferred_address));
+  return future;
+}
+
+void Session::execute_many(const Request::ConstVec& requests, Future::Vec* futures) {
+  futures->reserve(futures->size() + requests.size());
+
+  if (state() != SESSION_STATE_CONNECTED) {
+    for (Request::ConstVec::const_iterator it = requests.begin(),
+         end = requests.end(); it != end; ++it) {
+      ResponseFuture::Ptr future(create_future());
+      future->set_error(CASS_ERROR_LIB_NO_HOSTS_AVAILABLE,
+                        "Session is not connected");
+      futures->push_back(future);
+    }
+    return;
+  }
+
+  // Group the requests by processor so that each processor's queue is
+  // appended to, and the processor is signaled, once per chunk of requests.
+  // Chunking lets the processors start on the first requests while the rest
+  // are being created and keeps the request handlers warm in the cache. This
+  // doesn't lock the request processors for the same reason as `execute()`.
+  const size_t processor_count = request_processors_.size();
+  Vector<RequestHandler::Vec> batches(processor_count);
+  for (size_t i = 0; i < processor_count; ++i) {
+    batches[i].reserve(std::min(requests.size(), EXECUTE_MANY_CHUNK_SIZE));
+  }
+
+  for (size_t start = 0; start < requests.size(); start += EXECUTE_MANY_CHUNK_SIZE) {
+    size_t end = requests.size() - start > EXECUTE_MANY_CHUNK_SIZE
+                 ? start + EXECUTE_MANY_CHUNK_SIZE : requests.size();
+    for (size_t i = start; i < end; ++i) {
+      ResponseFuture::Ptr future(create_future());
+      RequestHandler::Ptr request_handler(create_request_handler(requests[i], future));
+      futures->push_back(future);
+      if (admission_controller_ && !admission_controller_->admit(request_handler)) {
+        continue; // The request is either waiting to be admitted or it failed
+      }
+      const RequestProcessor::Ptr& request_processor
+          = request_processor_selector_.select(request_processors_,
+                                               request_handler->request());
+      batches[&request_processor - &request_processors_.front()].push_back(request_handler);
+    }
+
+    for (size_t i = 0; i < processor_count; ++i) {
+      request_processors_[i]->process_many_requests(batches[i]);
+      batches[i].clear();
+    }
+  }
+}
+
+ResponseFuture::Ptr Session::create_future() const {
   ResponseFuture::Ptr future(Memory::allocate<ResponseFuture>());
+  future->set_wait_spin_time_us(config().future_wait_spin_time_us());
+  return future;
+}
 
+RequestHandler::Ptr Session::create_request_handler(const Request::ConstPtr& request,
+                                                    const ResponseFuture::Ptr& future,
+                                                    const Address* preferred_address) {
   RequestHandler::Ptr request_handler(
             Memory::allocate<RequestHandler>(request, future,
                                              metrics(), preferred_address));
 
-
   if (request_handler->request()->opcode() == CQL_OPCODE_EXECUTE) {
     const ExecuteRequest* execute = static_cast<const ExecuteRequest*>(request_handler->request());
     request_handler->set_prepared_metadata(cluster()->prepared(execute->prepared()->id()));
   }
 
-  execute(request_handler);
-
-  return future;
+  return request_handler;
 }
 
 void Session::execute(const RequestHandler::Ptr& request_handler) {
@@ -358,18 +570,30 @@ void Session::execute(const RequestHandler::Ptr& request_handler) {
     return;
   }
 
+  if (admission_controller_ && !admission_controller_->admit(request_handler)) {
+    return; // The request is either waiting to be admitted or it failed
+  }
+
+  dispatch(request_handler);
+}
 
+void Session::dispatch(const RequestHandler::Ptr& request_handler) {
   // This intentionally doesn't lock the request processors. The processors will
   // be populated before the connect future returns and calling execute during
   // the connection process is undefined behavior. Locking would cause unnecessary
   // overhead for something that's constant once the session is connected.
   const RequestProcessor::Ptr& request_processor
-      =  *std::min_element(request_processors_.begin(), request_processors_.end(),
-                           least_busy_comp);
+      = request_processor_selector_.select(request_processors_,
+                                           request_handler->request());
   request_processor->process_request(request_handler);
 }
 
 void Session::join() {
+  if (metrics_exporter_) {
+    // The exporter's server needs to be closed for the event loop to exit.
+    metrics_exporter_->close();
+    metrics_exporter_.reset();
+  }
   if (event_loop_group_) {
     event_loop_group_->close_handles();
     event_loop_group_->join();
@@ -391,7 +615,7 @@ void Session::on_connect(const Host::Ptr& connected_host,
 
   join();
   event_loop_group_.reset(Memory::allocate<RoundRobinEventLoopGroup>(config().thread_count_io()));
-  rc = event_loop_group_->init("Request Processor");
+  rc = event_loop_group_->init("Request Processor", config().io_thread_cpus());
   if (rc != 0) {
     notify_connect_failed(CASS_ERROR_LIB_UNABLE_TO_INIT,
                           "Unable to initialize event loop group");
@@ -405,8 +629,33 @@ void Session::on_connect(const Host::Ptr& connected_host,
     return;
   }
 
-  request_processors_.clear();
-  request_processor_count_ = 0;
+  // The gauges need to be set before the metrics can be exported
+  metrics()->request_queue_depth.set(request_queue_depth, this);
+  metrics()->waiting_requests.set(waiting_request_count, this);
+  metrics()->rejected_requests.set(rejected_request_count, this);
+  metrics()->queue_latency_skew.set(queue_latency_skew, this);
+
+  if (config().metrics_exporter_port() > 0) {
+    Address address;
+    Address::from_string("127.0.0.1", config().metrics_exporter_port(), &address);
+    metrics_exporter_.reset(Memory::allocate<MetricsExporter>(metrics()));
+    metrics_exporter_->listen(event_loop_group_->get(0), address);
+  }
+
+  request_processor_selector_.set_dispatch(config().request_dispatch());
+  {
+    ScopedMutex l(&mutex_);
+    request_processors_.clear();
+    request_processor_count_ = 0;
+    admission_controller_.reset();
+    if (config().max_in_flight_requests() > 0) {
+      admission_controller_.reset(
+            Memory::allocate<AdmissionController>(config().max_in_flight_requests(),
+                                                  config().admission_mode(),
+                                                  config().queue_size_io(),
+                                                  this));
+    }
+  }
   is_closing_ = false;
   SessionInitializer::Ptr initializer(Memory::allocate<SessionInitializer>(this));
   initializer->initialize(connected_host,
@@ -416,6 +665,20 @@ void Session::on_connect(const Host::Ptr& connected_host,
 }
 
 void Session::on_close() {
+  if (metrics_exporter_) {
+    // This is done without the session's lock because rendering the metrics
+    // (with the exporter's lock held) can lock the session for gauges.
+    metrics_exporter_->close();
+  }
+
+  if (admission_controller_) {
+    // Waiting requests would never be executed. This waits for admitted
+    // requests that are still being dispatched so that they're queued before
+    // the request processors are closed. It's done without the session's lock
+    // because failed requests run their callbacks.
+    admission_controller_->close();
+  }
+
   // If there are request processors still connected those need to be closed
   // first before sending the close notification.
   ScopedMutex l(&mutex_);
@@ -469,6 +732,7 @@ void Session::on_host_removed(const Host::Ptr& host)  {
       (*it)->notify_host_removed(host);
     }
   }
+  metrics()->remove_host_metrics(host->address());
   config().host_listener()->on_host_removed(host);
 }
 
@@ -524,6 +788,48 @@ void Session::on_prepared_metadata_changed(const String& id,
   cluster()->prepared(id, entry);
 }
 
+void Session::on_admitted(const RequestHandler::Ptr& request_handler) {
+  dispatch(request_handler);
+}
+
+int64_t Session::request_queue_depth(void* data) {
+  Session* session = static_cast<Session*>(data);
+  ScopedMutex l(&session->mutex_);
+  int64_t depth = 0;
+  for (RequestProcessor::Vec::const_iterator it = session->request_processors_.begin(),
+       end = session->request_processors_.end(); it != end; ++it) {
+    depth += (*it)->request_count();
+  }
+  return depth;
+}
+
+int64_t Session::waiting_request_count(void* data) {
+  Session* session = static_cast<Session*>(data);
+  ScopedMutex l(&session->mutex_);
+  return session->admission_controller_ ? session->admission_controller_->waiting_count() : 0;
+}
+
+int64_t Session::queue_latency_skew(void* data) {
+  Session* session = static_cast<Session*>(data);
+  ScopedMutex l(&session->mutex_);
+  if (session->request_processors_.empty()) return 0;
+  uint64_t min_ns = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ns = 0;
+  for (RequestProcessor::Vec::const_iterator it = session->request_processors_.begin(),
+       end = session->request_processors_.end(); it != end; ++it) {
+    uint64_t latency_ns = (*it)->queue_latency_ns();
+    min_ns = std::min(min_ns, latency_ns);
+    max_ns = std::max(max_ns, latency_ns);
+  }
+  return static_cast<int64_t>((max_ns - min_ns) / 1000);
+}
+
+int64_t Session::rejected_request_count(void* data) {
+  Session* session = static_cast<Session*>(data);
+  ScopedMutex l(&session->mutex_);
+  return session->admission_controller_ ? session->admission_controller_->rejected_count() : 0;
+}
+
 void Session::on_close(RequestProcessor* processor) {
   // Requires a lock because the close callback is called from several
   // different request processor threads.
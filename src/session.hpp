@@ -17,9 +17,12 @@
 #ifndef __CASS_SESSION_HPP_INCLUDED__
 #define __CASS_SESSION_HPP_INCLUDED__
 
+#include "admission_controller.hpp"
 #include "metrics.hpp"
+#include "metrics_exporter.hpp"
 #include "mpmc_queue.hpp"
 #include "request_processor.hpp"
+#include "request_processor_selector.hpp"
 #include "session_base.hpp"
 
 #include <uv.h>
@@ -31,7 +34,8 @@ class Statement;
 
 class Session
     : public SessionBase
-    , public RequestProcessorListener {
+    , public RequestProcessorListener
+    , public AdmissionListener {
 public:
   Session();
   ~Session();
@@ -43,11 +47,34 @@ public:
   Future::Ptr execute(const Request::ConstPtr& request,
                       const Address* preferred_address = NULL);
 
+  /**
+   * Execute several requests. The requests are grouped by request processor
+   * and each processor is signaled at most once.
+   *
+   * @param requests The requests to execute.
+   * @param futures The futures for the requests are appended in the same
+   * order as the requests.
+   */
+  void execute_many(const Request::ConstVec& requests, Future::Vec* futures);
+
 private:
+  ResponseFuture::Ptr create_future() const;
+
+  RequestHandler::Ptr create_request_handler(const Request::ConstPtr& request,
+                                             const ResponseFuture::Ptr& future,
+                                             const Address* preferred_address = NULL);
+
   void execute(const RequestHandler::Ptr& request_handler);
 
+  void dispatch(const RequestHandler::Ptr& request_handler);
+
   void join();
 
+  static int64_t request_queue_depth(void* data);
+  static int64_t waiting_request_count(void* data);
+  static int64_t rejected_request_count(void* data);
+  static int64_t queue_latency_skew(void* data);
+
 private:
   // Session base methods
 
@@ -98,13 +125,21 @@ private:
 
   using RequestProcessorListener::on_connect; // Intentional overload
 
+private:
+  // Admission listener methods
+
+  virtual void on_admitted(const RequestHandler::Ptr& request_handler);
+
 private:
   friend class SessionInitializer;
 
 private:
   ScopedPtr<RoundRobinEventLoopGroup> event_loop_group_;
+  MetricsExporter::Ptr metrics_exporter_;
   uv_mutex_t mutex_;
   RequestProcessor::Vec request_processors_;
+  RequestProcessorSelector request_processor_selector_;
+  AdmissionController::Ptr admission_controller_;
   size_t request_processor_count_;
   bool is_closing_;
 };
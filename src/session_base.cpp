@@ -17,6 +17,7 @@
 #include "session_base.hpp"
 
 #include "cluster_config.hpp"
+#include "fork_join.hpp"
 #include "metrics.hpp"
 #include "prepare_all_handler.hpp"
 #include "random.hpp"
@@ -40,6 +41,9 @@ SessionBase::SessionBase()
 
   UuidGen generator;
   generator.generate_random(&client_id_);
+
+  // Token maps are built on the workers, keep them while the session exists
+  ForkJoin::acquire();
 }
 
 SessionBase::~SessionBase() {
@@ -47,6 +51,7 @@ SessionBase::~SessionBase() {
     event_loop_->close_handles();
     event_loop_->join();
   }
+  ForkJoin::release();
   uv_mutex_destroy(&mutex_);
 }
 
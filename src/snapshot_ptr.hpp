@@ -0,0 +1,97 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_SNAPSHOT_PTR_HPP_INCLUDED__
+#define __CASS_SNAPSHOT_PTR_HPP_INCLUDED__
+
+#include "atomic.hpp"
+#include "macros.hpp"
+#include "memory.hpp"
+#include "ref_counted.hpp"
+
+namespace cass {
+
+/**
+ * A pointer to an immutable, reference counted value that's replaced as a
+ * whole (copy, modify, then publish) instead of being modified in place.
+ * Reading the current value is a single atomic load so readers never wait
+ * on writers and don't write to any shared cache lines.
+ *
+ * A replaced value is released as soon as it's no longer referenced. Readers
+ * that keep using a value after a writer could have replaced it must hold a
+ * reference (see `ref()`). Readers that use `get()` must not race with
+ * writers on other threads; the load balancing policies satisfy this because
+ * a policy instance's host events and query plans are run on the same event
+ * loop.
+ */
+template <class T>
+class SnapshotPtr {
+public:
+  typedef SharedRefPtr<const T> Ref;
+
+  SnapshotPtr(T* value)
+    : value_(NULL) {
+    set(value);
+  }
+
+  ~SnapshotPtr() {
+    const T* value = value_.load(MEMORY_ORDER_RELAXED);
+    if (value != NULL) value->dec_ref();
+  }
+
+  /**
+   * Get the current value.
+   *
+   * @return The current value (never NULL).
+   */
+  const T* get() const { return value_.load(MEMORY_ORDER_ACQUIRE); }
+  const T* operator->() const { return get(); }
+  const T& operator*() const { return *get(); }
+
+  /**
+   * Get a reference to the current value. The value remains valid as long as
+   * the reference is held, even if the snapshot is replaced.
+   */
+  Ref ref() const { return Ref(get()); }
+
+  /**
+   * Copy the current value so that it can be modified and published.
+   *
+   * @return A copy of the current value.
+   */
+  T* copy() const { return Memory::allocate<T>(*get()); }
+
+  /**
+   * Publish a new value. The previous value is released.
+   *
+   * @param value The new value.
+   */
+  void set(T* value) {
+    value->inc_ref();
+    const T* previous = value_.exchange(value, MEMORY_ORDER_ACQ_REL);
+    if (previous != NULL) previous->dec_ref();
+  }
+
+private:
+  Atomic<const T*> value_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SnapshotPtr);
+};
+
+} // namespace cass
+
+#endif
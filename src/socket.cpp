@@ -18,6 +18,9 @@
 
 #include "logger.hpp"
 
+#include <algorithm>
+#include <string.h>
+
 #define SSL_READ_SIZE 8192
 #define SSL_WRITE_SIZE 8192
 #define SSL_ENCRYPTED_BUFS_COUNT 16
@@ -25,46 +28,101 @@
 #define MAX_BUFFER_REUSE_NO 8
 #define BUFFER_REUSE_SIZE 64 * 1024
 
+// Buffers up to this size are copied into the write arena; larger buffers
+// are written directly from where they were encoded.
+#define WRITE_ARENA_MAX_COPY_SIZE 1024
+// A larger arena is released once it's no longer required
+#define WRITE_ARENA_MAX_RETAINED_SIZE 64 * 1024
+
 namespace cass {
 
 typedef Vector<uv_buf_t> UvBufVec;
 
 /**
  * A basic socket write handler.
+ *
+ * Requests are encoded as many small buffers (frame headers, bound values,
+ * etc.). To avoid handing the kernel hundreds of tiny iovecs these are
+ * copied into a contiguous arena when the write is flushed so that runs of
+ * small buffers become a single iovec. The arena is kept when the write
+ * object is reused by the socket.
  */
 class SocketWrite : public SocketWriteBase {
 public:
   SocketWrite(Socket* socket)
-    : SocketWriteBase(socket) { }
+    : SocketWriteBase(socket)
+    , arena_(NULL)
+    , arena_capacity_(0) { }
+
+  ~SocketWrite() {
+    Memory::free(arena_);
+  }
 
   size_t flush();
+
+private:
+  void reserve_arena(size_t size);
+
+private:
+  char* arena_;
+  size_t arena_capacity_;
+  UvBufVec bufs_;
 };
 
 size_t SocketWrite::flush() {
   size_t total = 0;
   if (!is_flushed_ && !buffers_.empty()) {
-    UvBufVec bufs;
-
-    bufs.reserve(buffers_.size());
-
+    // The arena is sized up front so that it's not moved while it's being
+    // referenced by the iovecs.
+    size_t arena_size = 0;
     for (BufferVec::const_iterator it = buffers_.begin(),
          end = buffers_.end(); it != end; ++it) {
       total += it->size();
-      bufs.push_back(uv_buf_init(const_cast<char*>(it->data()), it->size()));
+      if (it->size() <= WRITE_ARENA_MAX_COPY_SIZE) {
+        arena_size += it->size();
+      }
+    }
+    reserve_arena(arena_size);
+
+    bufs_.clear();
+    char* pos = arena_;
+    char* run = NULL; // The start of the current run of copied buffers
+    for (BufferVec::const_iterator it = buffers_.begin(),
+         end = buffers_.end(); it != end; ++it) {
+      size_t size = it->size();
+      if (size == 0) continue;
+      if (size <= WRITE_ARENA_MAX_COPY_SIZE) {
+        if (run == NULL) run = pos;
+        memcpy(pos, it->data(), size);
+        pos += size;
+      } else {
+        if (run != NULL) {
+          bufs_.push_back(uv_buf_init(run, pos - run));
+          run = NULL;
+        }
+        bufs_.push_back(uv_buf_init(const_cast<char*>(it->data()), size));
+      }
+    }
+    if (run != NULL) {
+      bufs_.push_back(uv_buf_init(run, pos - run));
     }
 
+    record_flush(total, bufs_.size());
+
     is_flushed_ = true;
     uv_stream_t* sock_stream = reinterpret_cast<uv_stream_t*>(tcp());
-    uv_write(&req_, sock_stream, bufs.data(), bufs.size(), SocketWrite::on_write);
+    uv_write(&req_, sock_stream, bufs_.data(), bufs_.size(), SocketWrite::on_write);
   }
   return total;
 }
 
-SocketHandler::~SocketHandler() {
-  while (!buffer_reuse_list_.empty()) {
-    uv_buf_t buf = buffer_reuse_list_.top();
-    Memory::free(buf.base);
-    buffer_reuse_list_.pop();
+void SocketWrite::reserve_arena(size_t size) {
+  if (size > arena_capacity_ ||
+      (arena_capacity_ > WRITE_ARENA_MAX_RETAINED_SIZE &&
+       size <= WRITE_ARENA_MAX_RETAINED_SIZE)) {
+    Memory::free(arena_);
+    arena_capacity_ = std::max(size, static_cast<size_t>(WRITE_ARENA_MAX_COPY_SIZE));
+    arena_ = static_cast<char*>(Memory::malloc(arena_capacity_));
   }
 }
 
@@ -75,22 +133,29 @@ SocketWriteBase* SocketHandler::new_pending_write(Socket* socket) {
 void SocketHandler::alloc_buffer(size_t suggested_size, uv_buf_t* buf) {
   if (suggested_size <= BUFFER_REUSE_SIZE) {
     if (!buffer_reuse_list_.empty()) {
-      *buf = buffer_reuse_list_.top();
+      read_buffer_ = buffer_reuse_list_.top();
       buffer_reuse_list_.pop();
     } else {
-      *buf = uv_buf_init(reinterpret_cast<char*>(Memory::malloc(BUFFER_REUSE_SIZE)), BUFFER_REUSE_SIZE);
+      read_buffer_.reset(RefBuffer::create(BUFFER_REUSE_SIZE));
     }
+    *buf = uv_buf_init(read_buffer_->data(), BUFFER_REUSE_SIZE);
   } else {
-    *buf = uv_buf_init(reinterpret_cast<char*>(Memory::malloc(suggested_size)), suggested_size);
+    read_buffer_.reset(RefBuffer::create(suggested_size));
+    *buf = uv_buf_init(read_buffer_->data(), suggested_size);
   }
 }
 
 void SocketHandler::free_buffer(const uv_buf_t* buf) {
-  if (buf->len == BUFFER_REUSE_SIZE && buffer_reuse_list_.size() < MAX_BUFFER_REUSE_NO) {
-    buffer_reuse_list_.push(*buf);
-    return;
+  if (!read_buffer_ || buf->base != read_buffer_->data()) return;
+
+  // Only reuse the buffer if it's not referenced by anything else (e.g. a
+  // response that references a slice of the buffer).
+  if (buf->len == BUFFER_REUSE_SIZE &&
+      read_buffer_->ref_count() == 1 &&
+      buffer_reuse_list_.size() < MAX_BUFFER_REUSE_NO) {
+    buffer_reuse_list_.push(read_buffer_);
   }
-  Memory::free(buf->base);
+  read_buffer_.reset();
 }
 
 /**
@@ -124,6 +189,7 @@ size_t SslSocketWrite::flush() {
 
     SmallVector<uv_buf_t, SSL_ENCRYPTED_BUFS_COUNT> bufs;
     total = encrypted_size_ = ssl_session_->outgoing().peek_multiple(prev_pos, &bufs);
+    record_flush(total, bufs.size());
 
     LOG_TRACE("Sending %u encrypted bytes", static_cast<unsigned int>(encrypted_size_));
 
@@ -243,6 +309,13 @@ int32_t SocketWriteBase::write(SocketRequest* request) {
   return request_size;
 }
 
+void SocketWriteBase::record_flush(size_t bytes, size_t bufs) {
+  Socket::FlushStats& stats = socket_->flush_stats_;
+  stats.count++;
+  stats.bytes += bytes;
+  stats.bufs += bufs;
+}
+
 void SocketWriteBase::on_write(uv_write_t* req, int status) {
   SocketWriteBase* pending_write = static_cast<SocketWriteBase*>(req->data);
   pending_write->handle_write(req, status);
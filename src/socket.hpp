@@ -138,11 +138,12 @@ public:
 
 /**
  * A basic socket handler that caches buffers used for reading socket data.
+ * Read buffers are ref-counted so that slices of them can outlive the read
+ * callback (e.g. zero-copy response bodies). A buffer is only reused once
+ * nothing else references it.
  */
 class SocketHandler : public SocketHandlerBase {
 public:
-  ~SocketHandler();
-
   virtual SocketWriteBase* new_pending_write(Socket* socket);
   virtual void alloc_buffer(size_t suggested_size, uv_buf_t* buf);
 
@@ -153,8 +154,17 @@ public:
    */
   void free_buffer(const uv_buf_t* buf);
 
+  /**
+   * The ref-counted buffer that backs the current read. This is only valid
+   * between alloc_buffer() and free_buffer().
+   *
+   * @return The current read buffer.
+   */
+  const RefBuffer::Ptr& read_buffer() const { return read_buffer_; }
+
 private:
-  Stack<uv_buf_t> buffer_reuse_list_;
+  Stack<RefBuffer::Ptr> buffer_reuse_list_;
+  RefBuffer::Ptr read_buffer_;
 };
 
 /**
@@ -250,6 +260,14 @@ protected:
   static void on_write(uv_write_t* req, int status);
   void handle_write(uv_write_t* req, int status);
 
+  /**
+   * Record the size of a flush in the socket's flush stats.
+   *
+   * @param bytes The number of bytes flushed.
+   * @param bufs The number of buffers (iovecs) passed to the write.
+   */
+  void record_flush(size_t bytes, size_t bufs);
+
   typedef Vector<SocketRequest*> RequestVec;
 
   Socket* socket_;
@@ -272,6 +290,21 @@ class Socket : public RefCounted<Socket> {
 public:
   typedef SharedRefPtr<Socket> Ptr;
 
+  /**
+   * Running totals for the flushes on a socket. These are only updated and
+   * read on the socket's event loop thread.
+   */
+  struct FlushStats {
+    FlushStats()
+      : count(0)
+      , bytes(0)
+      , bufs(0) { }
+
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t bufs;
+  };
+
   /**
    * Constructor: Don't use this directly.
    *
@@ -347,6 +380,8 @@ public:
   const Address& address() const { return address_; }
   const String& address_string() const { return address_string_; }
 
+  const FlushStats& flush_stats() const { return flush_stats_; }
+
 private:
   static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
 
@@ -372,6 +407,8 @@ private:
 
   Address address_;
   String address_string_;
+
+  FlushStats flush_stats_;
 };
 
 } // namespace cass
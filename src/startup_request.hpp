@@ -30,17 +30,20 @@ public:
   StartupRequest(const String& application_name,
                  const String& application_version,
                  const String& client_id,
-                 bool no_compact_enabled)
+                 bool no_compact_enabled,
+                 const String& compression = String())
       : Request(CQL_OPCODE_STARTUP)
       , application_name_(application_name)
       , application_version_(application_version)
       , client_id_(client_id)
-      , no_compact_enabled_(no_compact_enabled) { }
+      , no_compact_enabled_(no_compact_enabled)
+      , compression_(compression) { }
 
   const String& application_name() const { return application_name_; }
   const String& application_version() const { return application_version_; }
   const String& client_id() const { return client_id_; }
   bool no_compact_enabled() const { return no_compact_enabled_; }
+  const String& compression() const { return compression_; }
 
 private:
   int encode(ProtocolVersion version,
@@ -54,6 +57,7 @@ private:
   String application_version_;
   String client_id_;
   bool no_compact_enabled_;
+  String compression_;
 };
 
 } // namespace cass
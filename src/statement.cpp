@@ -29,6 +29,7 @@
 #include "tuple.hpp"
 #include "user_type_value.hpp"
 
+#include <string.h>
 #include <uv.h>
 
 extern "C" {
@@ -109,6 +110,13 @@ CassError cass_statement_set_paging_state_token(CassStatement* statement,
   return CASS_OK;
 }
 
+CassError cass_statement_set_rows_callback(CassStatement* statement,
+                                           CassResultRowsCallback callback,
+                                           void* data) {
+  statement->set_rows_callback(callback, data);
+  return CASS_OK;
+}
+
 CassError cass_statement_set_retry_policy(CassStatement* statement,
                                           CassRetryPolicy* retry_policy) {
   statement->set_retry_policy(retry_policy);
@@ -560,7 +568,18 @@ int32_t Statement::encode_end(ProtocolVersion version, RequestCallback* callback
   return length;
 }
 
-bool Statement::calculate_routing_key(const Vector<size_t>& key_indices, String* routing_key) const {
+// Get the element's encoded value without copying it (unless it needs to be
+// encoded first, which only happens for collections).
+static StringRef get_element_value(const AbstractData::Element& element, Buffer* temp) {
+  StringRef value;
+  if (!element.get_value(&value)) {
+    *temp = element.get_buffer();
+    value = StringRef(temp->data() + sizeof(int32_t), temp->size() - sizeof(int32_t));
+  }
+  return value;
+}
+
+bool Statement::calculate_routing_key(const Vector<size_t>& key_indices, RoutingKey* routing_key) const {
   if (key_indices.empty()) return false;
 
   if (key_indices.size() == 1) {
@@ -569,9 +588,14 @@ bool Statement::calculate_routing_key(const Vector<size_t>& key_indices, String*
     if (element.is_unset() || element.is_null()) {
       return false;
     }
-    Buffer buf(element.get_buffer());
-    routing_key->assign(buf.data() + sizeof(int32_t),
-                        buf.size() - sizeof(int32_t));
+    Buffer temp;
+    StringRef value(get_element_value(element, &temp));
+    if (temp.size() == 0) {
+      routing_key->set(value); // The bound value outlives the routing key
+    } else {
+      char* data = routing_key->allocate(value.size());
+      if (data != NULL) memcpy(data, value.data(), value.size());
+    }
   } else {
     size_t length = 0;
 
@@ -586,20 +610,16 @@ bool Statement::calculate_routing_key(const Vector<size_t>& key_indices, String*
       length += sizeof(uint16_t) + size + 1;
     }
 
-    routing_key->clear();
-    routing_key->reserve(length);
+    char* pos = routing_key->allocate(length);
 
     for (Vector<size_t>::const_iterator i = key_indices.begin();
          i != key_indices.end(); ++i) {
-      const AbstractData::Element& element(elements()[*i]);
-      Buffer buf(element.get_buffer());
-      size_t size = buf.size() - sizeof(int32_t);
-
-      char size_buf[sizeof(uint16_t)];
-      encode_uint16(size_buf, size);
-      routing_key->append(size_buf, sizeof(uint16_t));
-      routing_key->append(buf.data() + sizeof(int32_t), size);
-      routing_key->push_back(0);
+      Buffer temp;
+      StringRef value(get_element_value(elements()[*i], &temp));
+      pos = encode_uint16(pos, value.size());
+      memcpy(pos, value.data(), value.size());
+      pos += value.size();
+      *pos++ = 0;
     }
   }
 
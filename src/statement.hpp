@@ -79,7 +79,9 @@ public:
 
   void add_key_index(size_t index) { key_indices_.push_back(index); }
 
-  virtual bool get_routing_key(String* routing_key) const {
+  using RoutableRequest::get_routing_key;
+
+  virtual bool get_routing_key(RoutingKey* routing_key) const {
     return calculate_routing_key(key_indices_, routing_key);
   }
 
@@ -94,7 +96,7 @@ protected:
   int32_t encode_values(ProtocolVersion version, RequestCallback* callback, BufferVec* bufs) const;
   int32_t encode_end(ProtocolVersion version, RequestCallback* callback, BufferVec* bufs) const;
 
-  bool calculate_routing_key(const Vector<size_t>& key_indices, String* routing_key) const;
+  bool calculate_routing_key(const Vector<size_t>& key_indices, RoutingKey* routing_key) const;
 
 private:
   Buffer query_or_id_;
@@ -18,9 +18,9 @@
 #define __CASS_STREAM_MANAGER_HPP_INCLUDED__
 
 #include "constants.hpp"
-#include "dense_hash_map.hpp"
 #include "macros.hpp"
-#include "scoped_ptr.hpp"
+#include "memory.hpp"
+#include "vector.hpp"
 
 #include <assert.h>
 #include <stdint.h>
@@ -32,57 +32,74 @@
 
 namespace cass {
 
-struct StreamHash {
-  std::size_t operator()(int stream) const {
-    return ((stream & 0x3F) << 10) | (stream >> 6);
-  }
-};
-
+/**
+ * Allocates stream IDs and tracks the items (request callbacks) that are
+ * waiting on them.
+ *
+ * Items are stored in a flat array indexed directly by stream ID. The array
+ * is split into pages that are only allocated when a stream in that page is
+ * first used, and streams are always allocated lowest first, so a connection
+ * with only a few requests in flight only ever allocates its first page.
+ *
+ * Available streams are tracked using a two level bitmap: a bit per stream
+ * and a summary bit per word of streams that's set if the word has any
+ * available streams. Finding an available stream scans the summary
+ * (8 words for 32768 streams) instead of every word so it's constant time no
+ * matter how many streams are in use.
+ */
 template <class T>
 class StreamManager {
 public:
   StreamManager()
       : max_streams_(CASS_MAX_STREAMS)
       , num_words_(max_streams_ / NUM_BITS_PER_WORD)
-      , offset_(0)
-      , words_(num_words_, ~static_cast<word_t>(0)) {
-    // Client request stream IDs are always positive values so it's
-    // safe to use negative values for the empty and deleted keys.
-    pending_.set_empty_key(-1);
-    pending_.set_deleted_key(-2);
-    pending_.max_load_factor(0.4f);
+      , num_summary_words_((num_words_ + NUM_BITS_PER_WORD - 1) / NUM_BITS_PER_WORD)
+      , pending_streams_(0)
+      , words_(num_words_, ~static_cast<word_t>(0))
+      , summary_(num_summary_words_, 0)
+      , pages_((max_streams_ + NUM_STREAMS_PER_PAGE - 1) / NUM_STREAMS_PER_PAGE, NULL) {
+    for (size_t i = 0; i < num_words_; ++i) {
+      summary_[i / NUM_BITS_PER_WORD] |= (static_cast<word_t>(1) << (i % NUM_BITS_PER_WORD));
+    }
+  }
+
+  ~StreamManager() {
+    for (typename PageVec::iterator it = pages_.begin(),
+         end = pages_.end(); it != end; ++it) {
+      Memory::deallocate(*it);
+    }
   }
 
   int acquire(const T& item) {
     int stream = acquire_stream();
     if (stream < 0) return -1;
-    pending_.insert(std::pair<int, T>(stream, item));
+    slot(stream) = item;
+    ++pending_streams_;
     return stream;
   }
 
   void release(int stream) {
     assert(stream >= 0 && static_cast<size_t>(stream) < max_streams_);
-    assert(pending_.count(stream) > 0);
-    pending_.erase(stream);
+    assert(is_pending(stream));
+    slot(stream) = T();
+    --pending_streams_;
     release_stream(stream);
   }
 
   bool get(int stream, T& output) {
-    typename PendingMap::iterator i = pending_.find(stream);
-    if (i != pending_.end()) {
-      output = i->second;
-      return true;
+    if (stream < 0 || static_cast<size_t>(stream) >= max_streams_ ||
+        !is_pending(stream)) {
+      return false;
     }
-    return false;
+    output = slot(stream);
+    return true;
   }
 
-  size_t available_streams() const { return max_streams_ - pending_.size(); }
-  size_t pending_streams() const { return pending_.size(); }
+  size_t available_streams() const { return max_streams_ - pending_streams_; }
+  size_t pending_streams() const { return pending_streams_; }
   size_t max_streams() const { return max_streams_; }
 
 private:
-  typedef DenseHashMap<int, T, StreamHash> PendingMap;
-
 #if defined(_MSC_VER) && defined(_M_AMD64)
   typedef __int64 word_t;
 #else
@@ -90,6 +107,13 @@ private:
 #endif
 
   static const size_t NUM_BITS_PER_WORD = sizeof(word_t) * 8;
+  static const size_t NUM_STREAMS_PER_PAGE = 256;
+
+  struct Page {
+    T items[NUM_STREAMS_PER_PAGE];
+  };
+
+  typedef Vector<Page*> PageVec;
 
   static inline int count_trailing_zeros(word_t word) {
 #if defined(__GNUC__)
@@ -108,18 +132,33 @@ private:
   }
 
 private:
-  int acquire_stream() {
-    const size_t offset = offset_;
-    const size_t num_words = num_words_;
+  inline T& slot(int stream) {
+    Page*& page = pages_[stream / NUM_STREAMS_PER_PAGE];
+    if (page == NULL) {
+      page = Memory::allocate<Page>();
+    }
+    return page->items[stream % NUM_STREAMS_PER_PAGE];
+  }
 
-    ++offset_;
+  inline bool is_pending(int stream) const {
+    size_t index = stream / NUM_BITS_PER_WORD;
+    int bit = stream % NUM_BITS_PER_WORD;
+    return (words_[index] & (static_cast<word_t>(1) << bit)) == 0;
+  }
 
-    for (size_t i = 0; i < num_words; ++i) {
-      size_t index = (i + offset) % num_words;
-      int bit = get_and_set_first_available_stream(index);
-      if (bit >= 0) {
-        return bit + (NUM_BITS_PER_WORD * index);
+  int acquire_stream() {
+    for (size_t i = 0; i < num_summary_words_; ++i) {
+      word_t summary = summary_[i];
+      if (summary == 0) continue;
+      size_t index = i * NUM_BITS_PER_WORD + count_trailing_zeros(summary);
+      word_t word = words_[index];
+      int bit = count_trailing_zeros(word);
+      word ^= (static_cast<word_t>(1) << bit);
+      words_[index] = word;
+      if (word == 0) { // The word is full
+        summary_[i] = summary ^ (static_cast<word_t>(1) << (index % NUM_BITS_PER_WORD));
       }
+      return bit + static_cast<int>(NUM_BITS_PER_WORD * index);
     }
 
     return -1;
@@ -130,22 +169,17 @@ private:
     int bit = stream % NUM_BITS_PER_WORD;
     assert((words_[index] & (static_cast<word_t>(1) << (bit))) == 0);
     words_[index] |= (static_cast<word_t>(1) << (bit));
-  }
-
-  inline int get_and_set_first_available_stream(size_t index) {
-    word_t word = words_[index];
-    if (word == 0) return -1;
-    int stream = count_trailing_zeros(word);
-    words_[index] ^= (static_cast<word_t>(1) << stream);
-    return stream;
+    summary_[index / NUM_BITS_PER_WORD] |= (static_cast<word_t>(1) << (index % NUM_BITS_PER_WORD));
   }
 
 private:
   const size_t max_streams_;
   const size_t num_words_;
-  size_t offset_;
+  const size_t num_summary_words_;
+  size_t pending_streams_;
   Vector<word_t> words_;
-  PendingMap pending_;
+  Vector<word_t> summary_;
+  PageVec pages_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(StreamManager);
@@ -0,0 +1,314 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "streaming_result.hpp"
+
+#include "logger.hpp"
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+// The minimum size of the buffers that the pieces of the body are copied into
+#define STREAMING_RESULT_BUFFER_SIZE (64 * 1024)
+
+namespace cass {
+
+/**
+ * Finds the end of the values in a partially received body without decoding
+ * them. Unlike the decoder, running out of data isn't an error (more of the
+ * body is on its way).
+ */
+class BodyScanner {
+public:
+  BodyScanner(const char* pos, const char* end)
+    : pos_(pos)
+    , end_(end) { }
+
+  const char* pos() const { return pos_; }
+
+  bool skip(size_t size) {
+    if (static_cast<size_t>(end_ - pos_) < size) return false;
+    pos_ += size;
+    return true;
+  }
+
+  bool read_int32(int32_t* output) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(int32_t)) return false;
+    pos_ = decode_int32(pos_, *output);
+    return true;
+  }
+
+  bool read_uint16(uint16_t* output) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(uint16_t)) return false;
+    pos_ = decode_uint16(pos_, *output);
+    return true;
+  }
+
+  bool skip_string() {
+    uint16_t size = 0;
+    return read_uint16(&size) && skip(size);
+  }
+
+  bool skip_bytes() {
+    int32_t size = 0;
+    // Null values have a negative size
+    return read_int32(&size) && (size < 0 || skip(size));
+  }
+
+  bool skip_data_type() {
+    uint16_t value_type = 0;
+    if (!read_uint16(&value_type)) return false;
+
+    switch (value_type) {
+      case CASS_VALUE_TYPE_CUSTOM:
+        return skip_string();
+
+      case CASS_VALUE_TYPE_LIST:
+      case CASS_VALUE_TYPE_SET:
+        return skip_data_type();
+
+      case CASS_VALUE_TYPE_MAP:
+        return skip_data_type() && skip_data_type();
+
+      case CASS_VALUE_TYPE_UDT: {
+        uint16_t n = 0;
+        if (!skip_string() || !skip_string() || !read_uint16(&n)) return false;
+        for (uint16_t i = 0; i < n; ++i) {
+          if (!skip_string() || !skip_data_type()) return false;
+        }
+        return true;
+      }
+
+      case CASS_VALUE_TYPE_TUPLE: {
+        uint16_t n = 0;
+        if (!read_uint16(&n)) return false;
+        for (uint16_t i = 0; i < n; ++i) {
+          if (!skip_data_type()) return false;
+        }
+        return true;
+      }
+
+      default:
+        return true;
+    }
+  }
+
+  bool skip_row(size_t column_count) {
+    for (size_t i = 0; i < column_count; ++i) {
+      if (!skip_bytes()) return false;
+    }
+    return true;
+  }
+
+private:
+  const char* pos_;
+  const char* end_;
+};
+
+enum ScanResult {
+  SCAN_INCOMPLETE,
+  SCAN_ROWS,
+  SCAN_OTHER // Not a rows result (or a rows result without metadata)
+};
+
+static ScanResult scan_metadata(BodyScanner& scanner, uint8_t flags) {
+  if (flags & CASS_FLAG_TRACING) {
+    if (!scanner.skip(sizeof(uint8_t) * 16)) return SCAN_INCOMPLETE; // The tracing ID
+  }
+
+  if (flags & CASS_FLAG_WARNING) {
+    uint16_t count = 0;
+    if (!scanner.read_uint16(&count)) return SCAN_INCOMPLETE;
+    for (uint16_t i = 0; i < count; ++i) {
+      if (!scanner.skip_string()) return SCAN_INCOMPLETE;
+    }
+  }
+
+  if (flags & CASS_FLAG_CUSTOM_PAYLOAD) {
+    uint16_t count = 0;
+    if (!scanner.read_uint16(&count)) return SCAN_INCOMPLETE;
+    for (uint16_t i = 0; i < count; ++i) {
+      if (!scanner.skip_string() || !scanner.skip_bytes()) return SCAN_INCOMPLETE;
+    }
+  }
+
+  int32_t kind = 0;
+  if (!scanner.read_int32(&kind)) return SCAN_INCOMPLETE;
+  if (kind != CASS_RESULT_KIND_ROWS) return SCAN_OTHER;
+
+  int32_t result_flags = 0;
+  int32_t column_count = 0;
+  if (!scanner.read_int32(&result_flags) ||
+      !scanner.read_int32(&column_count)) {
+    return SCAN_INCOMPLETE;
+  }
+  if (result_flags & CASS_RESULT_FLAG_NO_METADATA) return SCAN_OTHER;
+
+  if (result_flags & CASS_RESULT_FLAG_METADATA_CHANGED) {
+    if (!scanner.skip_string()) return SCAN_INCOMPLETE;
+  }
+
+  if (result_flags & CASS_RESULT_FLAG_HAS_MORE_PAGES) {
+    if (!scanner.skip_bytes()) return SCAN_INCOMPLETE;
+  }
+
+  bool global_table_spec = (result_flags & CASS_RESULT_FLAG_GLOBAL_TABLESPEC) != 0;
+  if (global_table_spec) {
+    if (!scanner.skip_string() || !scanner.skip_string()) return SCAN_INCOMPLETE;
+  }
+
+  for (int32_t i = 0; i < column_count; ++i) {
+    if (!global_table_spec) {
+      if (!scanner.skip_string() || !scanner.skip_string()) return SCAN_INCOMPLETE;
+    }
+    if (!scanner.skip_string() || !scanner.skip_data_type()) return SCAN_INCOMPLETE;
+  }
+
+  int32_t row_count = 0;
+  if (!scanner.read_int32(&row_count)) return SCAN_INCOMPLETE;
+
+  return SCAN_ROWS;
+}
+
+StreamingResult::StreamingResult(const ResultResponse::Ptr& result,
+                                 ProtocolVersion protocol_version,
+                                 uint8_t flags, int32_t length)
+  : result_(result)
+  , protocol_version_(protocol_version)
+  , flags_(flags)
+  , length_(length)
+  , received_(0)
+  , state_(STATE_METADATA)
+  , capacity_(0)
+  , start_(0)
+  , size_(0)
+  , column_count_(0)
+  , remaining_rows_(0) { }
+
+bool StreamingResult::append(const char* input, size_t size) {
+  if (size == 0) return true;
+
+  reserve(size);
+  memcpy(buffer_->data() + size_, input, size);
+  size_ += size;
+  received_ += size;
+
+  if (state_ == STATE_METADATA) {
+    return decode_metadata();
+  }
+  return true;
+}
+
+bool StreamingResult::next_rows(ResultResponse::Ptr* rows) {
+  rows->reset();
+  if (state_ != STATE_ROWS) return true;
+
+  char* begin = buffer_->data() + start_;
+  BodyScanner scanner(begin, buffer_->data() + size_);
+
+  const char* end = begin;
+  int32_t row_count = 0;
+  while (row_count < remaining_rows_ && scanner.skip_row(column_count_)) {
+    end = scanner.pos();
+    ++row_count;
+  }
+  if (row_count == 0) return true;
+
+  rows->reset(Memory::allocate<ResultResponse>());
+  if (!(*rows)->set_rows(*result_, buffer_, begin, end - begin, row_count)) {
+    return false;
+  }
+
+  start_ += end - begin;
+  remaining_rows_ -= row_count;
+  return true;
+}
+
+bool StreamingResult::finish() const {
+  if (remaining_rows_ > 0) {
+    LOG_ERROR("Streamed result is missing %d row(s)", remaining_rows_);
+    return false;
+  }
+  return true;
+}
+
+void StreamingResult::reserve(size_t size) {
+  if (buffer_ && capacity_ - size_ >= size) return;
+
+  // Only the bytes that haven't been handed out are moved. The previous buffer
+  // is kept alive by the rows (and the metadata) that reference it.
+  const size_t pending = size_ - start_;
+  const size_t remaining = length_ - received_; // Includes the new piece
+  size_t capacity = std::max(pending + size,
+                             std::max(2 * pending,
+                                      static_cast<size_t>(STREAMING_RESULT_BUFFER_SIZE)));
+  capacity = std::min(capacity, pending + remaining);
+
+  RefBuffer::Ptr buffer(RefBuffer::create(capacity));
+  if (pending > 0) {
+    memcpy(buffer->data(), buffer_->data() + start_, pending);
+  }
+  buffer_ = buffer;
+  capacity_ = capacity;
+  start_ = 0;
+  size_ = pending;
+}
+
+bool StreamingResult::decode_metadata() {
+  char* data = buffer_->data();
+  BodyScanner scanner(data, data + size_);
+
+  switch (scan_metadata(scanner, flags_)) {
+    case SCAN_INCOMPLETE:
+      // A body that's complete without complete metadata is invalid, it's
+      // decoded as a whole to report the error.
+      if (received_ == length_) state_ = STATE_BUFFERED;
+      return true;
+
+    case SCAN_OTHER:
+      state_ = STATE_BUFFERED;
+      return true;
+
+    case SCAN_ROWS:
+      break;
+  }
+
+  const size_t metadata_size = scanner.pos() - data;
+  Decoder decoder(data, metadata_size, protocol_version_);
+  result_->set_buffer(buffer_, data);
+
+  if (flags_ & CASS_FLAG_TRACING) {
+    CHECK_RESULT(result_->decode_trace_id(decoder));
+  }
+
+  if (flags_ & CASS_FLAG_WARNING) {
+    CHECK_RESULT(result_->decode_warnings(decoder));
+  }
+
+  if (flags_ & CASS_FLAG_CUSTOM_PAYLOAD) {
+    CHECK_RESULT(result_->decode_custom_payload(decoder));
+  }
+
+  CHECK_RESULT(result_->decode_rows_metadata(decoder, &remaining_rows_));
+
+  column_count_ = result_->column_count();
+  start_ = metadata_size;
+  state_ = STATE_ROWS;
+  return true;
+}
+
+} // namespace cass
@@ -0,0 +1,119 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_STREAMING_RESULT_HPP_INCLUDED__
+#define __CASS_STREAMING_RESULT_HPP_INCLUDED__
+
+#include "macros.hpp"
+#include "ref_counted.hpp"
+#include "result_response.hpp"
+
+namespace cass {
+
+/**
+ * Decodes the rows of a result response while its body is still arriving.
+ * Once the result's metadata has been received the complete rows are handed
+ * out as separate results (chunks) that only reference those rows. Only the
+ * metadata and the bytes of the current partial row are kept between pieces
+ * of the body so the whole body is never buffered.
+ *
+ * Results that aren't rows (or that don't have metadata) are buffered as a
+ * whole and decoded normally.
+ */
+class StreamingResult {
+public:
+  /**
+   * Constructor.
+   *
+   * @param result The result that receives the metadata.
+   * @param protocol_version The protocol version of the response.
+   * @param flags The flags of the response's header.
+   * @param length The length of the response's body.
+   */
+  StreamingResult(const ResultResponse::Ptr& result,
+                  ProtocolVersion protocol_version,
+                  uint8_t flags, int32_t length);
+
+  /**
+   * Determines if the result's rows are being streamed. This is false until
+   * the metadata is received and for results that are buffered as a whole.
+   */
+  bool is_streaming() const { return state_ == STATE_ROWS; }
+
+  /**
+   * The buffered body of a result whose rows aren't streamed.
+   */
+  const RefBuffer::Ptr& buffer() const { return buffer_; }
+  char* data() const { return buffer_ ? buffer_->data() : NULL; }
+
+  /**
+   * Append the next piece of the body.
+   *
+   * @param input The piece of the body.
+   * @param size The size of the piece.
+   * @return false if the result's metadata is invalid.
+   */
+  bool append(const char* input, size_t size);
+
+  /**
+   * Take the rows that have been completely received since the last call.
+   *
+   * @param rows The rows, or an empty pointer if no rows are complete.
+   * @return false if the rows are invalid.
+   */
+  bool next_rows(ResultResponse::Ptr* rows);
+
+  /**
+   * Finish a result whose rows are streamed after the whole body has been
+   * appended and its rows taken.
+   *
+   * @return false if some of the rows are missing.
+   */
+  bool finish() const;
+
+private:
+  enum State {
+    STATE_METADATA,
+    STATE_ROWS,
+    STATE_BUFFERED
+  };
+
+  void reserve(size_t size);
+  bool decode_metadata();
+
+private:
+  ResultResponse::Ptr result_;
+  const ProtocolVersion protocol_version_;
+  const uint8_t flags_;
+  const size_t length_;
+  size_t received_;
+  State state_;
+
+  RefBuffer::Ptr buffer_;
+  size_t capacity_;
+  size_t start_; // The start of the bytes that haven't been handed out
+  size_t size_;
+
+  size_t column_count_;
+  int32_t remaining_rows_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(StreamingResult);
+};
+
+} // namespace cass
+
+#endif
@@ -0,0 +1,247 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include "timer_wheel.hpp"
+
+#include "event_loop.hpp"
+
+#include <assert.h>
+
+// Timeouts larger than this (~49 days) are clamped
+#define MAX_TIMEOUT_TICKS 0xFFFFFFFFULL
+
+namespace cass {
+
+void TimerWheel::init_head(WheelTimer* head) {
+  head->next_ = head->prev_ = head;
+}
+
+WheelTimer::WheelTimer()
+  : next_(NULL)
+  , prev_(NULL)
+  , wheel_(NULL)
+  , expires_(0) { }
+
+WheelTimer::~WheelTimer() {
+  stop();
+}
+
+void WheelTimer::start(TimerWheel* wheel, uint64_t timeout, const Callback& callback) {
+  stop();
+  callback_ = callback;
+  expires_ = uv_now(wheel->loop_) + timeout;
+  wheel->add(this);
+}
+
+void WheelTimer::stop() {
+  if (wheel_ != NULL) {
+    wheel_->remove(this);
+  }
+}
+
+TimerWheel::TimerWheel()
+  : loop_(NULL)
+  , scheduled_tick_(0)
+  , current_tick_(0)
+  , size_(0)
+  , is_ticking_(false) {
+  for (int i = 0; i < ROOT_SIZE; ++i) {
+    init_head(&root_[i]);
+  }
+  for (int i = 0; i < NUM_LEVELS; ++i) {
+    for (int j = 0; j < LEVEL_SIZE; ++j) {
+      init_head(&levels_[i][j]);
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  close_handles();
+}
+
+void TimerWheel::init(uv_loop_t* loop) {
+  loop_ = loop;
+  current_tick_ = uv_now(loop);
+}
+
+void TimerWheel::close_handles() {
+  WheelTimer* heads[2] = { root_, &levels_[0][0] };
+  int counts[2] = { ROOT_SIZE, NUM_LEVELS * LEVEL_SIZE };
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < counts[i]; ++j) {
+      WheelTimer* head = &heads[i][j];
+      while (head->next_ != head) {
+        remove(head->next_);
+      }
+    }
+  }
+  timer_.stop();
+}
+
+void TimerWheel::add(WheelTimer* timer) {
+  if (size_ == 0 && !is_ticking_) {
+    // Don't step through the ticks that passed while the wheel was empty
+    current_tick_ = uv_now(loop_);
+  }
+
+  timer->wheel_ = this;
+  insert(timer);
+  ++size_;
+
+  if (!is_ticking_ &&
+      (!timer_.is_running() || timer->expires_ < scheduled_tick_)) {
+    schedule();
+  }
+}
+
+void TimerWheel::remove(WheelTimer* timer) {
+  assert(timer->wheel_ == this);
+  timer->prev_->next_ = timer->next_;
+  timer->next_->prev_ = timer->prev_;
+  timer->next_ = timer->prev_ = NULL;
+  timer->wheel_ = NULL;
+  --size_;
+  // The driving timer isn't stopped here. It's stopped when it fires and the
+  // wheel is empty, which is cheaper when timers are constantly replaced.
+}
+
+void TimerWheel::insert(WheelTimer* timer) {
+  if (timer->expires_ < current_tick_) {
+    timer->expires_ = current_tick_;
+  }
+
+  uint64_t expires = timer->expires_;
+  uint64_t delta = expires - current_tick_;
+
+  WheelTimer* head;
+  if (delta < (1ULL << ROOT_BITS)) {
+    head = &root_[expires & ROOT_MASK];
+  } else if (delta < (1ULL << (ROOT_BITS + LEVEL_BITS))) {
+    head = &levels_[0][(expires >> ROOT_BITS) & LEVEL_MASK];
+  } else if (delta < (1ULL << (ROOT_BITS + 2 * LEVEL_BITS))) {
+    head = &levels_[1][(expires >> (ROOT_BITS + LEVEL_BITS)) & LEVEL_MASK];
+  } else if (delta < (1ULL << (ROOT_BITS + 3 * LEVEL_BITS))) {
+    head = &levels_[2][(expires >> (ROOT_BITS + 2 * LEVEL_BITS)) & LEVEL_MASK];
+  } else {
+    if (delta > MAX_TIMEOUT_TICKS) {
+      expires = timer->expires_ = current_tick_ + MAX_TIMEOUT_TICKS;
+    }
+    head = &levels_[3][(expires >> (ROOT_BITS + 3 * LEVEL_BITS)) & LEVEL_MASK];
+  }
+
+  // Add to the back of the slot's list
+  timer->next_ = head;
+  timer->prev_ = head->prev_;
+  head->prev_->next_ = timer;
+  head->prev_ = timer;
+}
+
+void TimerWheel::cascade(int level, int index) {
+  // Move the timers to the lower levels now that their slot has been reached
+  WheelTimer* head = &levels_[level][index];
+  while (head->next_ != head) {
+    WheelTimer* timer = head->next_;
+    timer->prev_->next_ = timer->next_;
+    timer->next_->prev_ = timer->prev_;
+    insert(timer);
+  }
+}
+
+void TimerWheel::run_slot(WheelTimer* head) {
+  // The callbacks can start and stop other timers (including those in this
+  // slot) so the timers are removed one at a time.
+  while (head->next_ != head) {
+    WheelTimer* timer = head->next_;
+    remove(timer);
+    timer->callback_(timer);
+  }
+}
+
+void TimerWheel::schedule() {
+  if (size_ == 0) {
+    timer_.stop();
+    return;
+  }
+
+  // Wake up for the next non-empty slot in the root level or, if there are
+  // none, when the next slot of the higher levels is cascaded.
+  uint64_t next_cascade_tick = (current_tick_ | ROOT_MASK) + 1;
+  uint64_t tick = current_tick_;
+  while (tick < next_cascade_tick) {
+    WheelTimer* head = &root_[tick & ROOT_MASK];
+    if (head->next_ != head) break;
+    ++tick;
+  }
+
+  if (timer_.is_running() && scheduled_tick_ == tick) {
+    return;
+  }
+
+  uint64_t now = uv_now(loop_);
+  scheduled_tick_ = tick;
+  timer_.start(loop_, tick > now ? tick - now : 0,
+               bind_callback(&TimerWheel::on_tick, this));
+}
+
+void TimerWheel::on_tick(Timer* timer) {
+  uint64_t now = uv_now(loop_);
+
+  is_ticking_ = true;
+  while (current_tick_ <= now && size_ > 0) {
+    int index = static_cast<int>(current_tick_ & ROOT_MASK);
+    if (index == 0) {
+      // Cascade each level whose slot wrapped around
+      for (int level = 0; level < NUM_LEVELS; ++level) {
+        int level_index = static_cast<int>((current_tick_ >> (ROOT_BITS + level * LEVEL_BITS)) & LEVEL_MASK);
+        cascade(level, level_index);
+        if (level_index != 0) break;
+      }
+    }
+    run_slot(&root_[index]);
+    ++current_tick_;
+  }
+  is_ticking_ = false;
+
+  schedule();
+}
+
+void LoopTimer::start(uv_loop_t* loop, uint64_t timeout, const Callback& callback) {
+  stop();
+  callback_ = callback;
+  EventLoop* event_loop = static_cast<EventLoop*>(loop->data);
+  if (event_loop) {
+    wheel_timer_.start(event_loop->timer_wheel(), timeout,
+                       bind_callback(&LoopTimer::on_wheel_timeout, this));
+  } else {
+    timer_.start(loop, timeout,
+                 bind_callback(&LoopTimer::on_timeout, this));
+  }
+}
+
+void LoopTimer::stop() {
+  wheel_timer_.stop();
+  timer_.stop();
+}
+
+void LoopTimer::on_wheel_timeout(WheelTimer* timer) {
+  callback_(this);
+}
+
+void LoopTimer::on_timeout(Timer* timer) {
+  callback_(this);
+}
+
+} // namespace cass
@@ -0,0 +1,183 @@
+/*
+  Copyright (c) DataStax, Inc.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef __CASS_TIMER_WHEEL_HPP_INCLUDED__
+#define __CASS_TIMER_WHEEL_HPP_INCLUDED__
+
+#include "callback.hpp"
+#include "macros.hpp"
+#include "timer.hpp"
+
+#include <uv.h>
+
+namespace cass {
+
+class TimerWheel;
+
+/**
+ * A millisecond timer that runs on a `TimerWheel`. Starting and stopping the
+ * timer are constant time operations which makes it a better fit than `Timer`
+ * for the large number of short-lived timers used by requests (e.g. request
+ * timeouts and speculative executions). It has the same interface as `Timer`.
+ */
+class WheelTimer {
+public:
+  typedef cass::Callback<void, WheelTimer*> Callback;
+
+  WheelTimer();
+  ~WheelTimer();
+
+  /**
+   * Start the timer. If the timer is already running it's restarted.
+   *
+   * @param wheel The wheel (event loop) where the timer should run.
+   * @param timeout The timeout in milliseconds.
+   * @param callback The callback that handles the timeout.
+   */
+  void start(TimerWheel* wheel, uint64_t timeout, const Callback& callback);
+
+  /**
+   * Stop the timer.
+   */
+  void stop();
+
+  bool is_running() const { return wheel_ != NULL; }
+
+private:
+  friend class TimerWheel;
+
+  // The timers in a wheel slot are kept in a circular, doubly-linked list
+  // so that they can be removed without searching.
+  WheelTimer* next_;
+  WheelTimer* prev_;
+
+  TimerWheel* wheel_;
+  uint64_t expires_; // In loop time (milliseconds)
+  Callback callback_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(WheelTimer);
+};
+
+/**
+ * A hierarchical timing wheel (Varghese and Lauck) for an event loop. The
+ * first level has a slot per millisecond for the next 256 milliseconds. Each
+ * of the other four levels has 64 slots that cover 64 times the range of the
+ * previous level. Timers in the higher levels are moved down (cascaded) as
+ * their slot is reached. A single libuv timer drives the wheel and it's only
+ * running while there are timers in the wheel.
+ */
+class TimerWheel {
+public:
+  TimerWheel();
+  ~TimerWheel();
+
+  /**
+   * Initialize the wheel. This doesn't create any libuv handles.
+   *
+   * @param loop The event loop used to drive the wheel.
+   */
+  void init(uv_loop_t* loop);
+
+  /**
+   * Close the libuv timer that drives the wheel. Timers that are still
+   * running are stopped without running their callbacks.
+   */
+  void close_handles();
+
+  /**
+   * The number of running timers.
+   */
+  size_t size() const { return size_; }
+
+private:
+  friend class WheelTimer;
+
+  static const int ROOT_BITS = 8;
+  static const int ROOT_SIZE = 1 << ROOT_BITS;
+  static const int ROOT_MASK = ROOT_SIZE - 1;
+  static const int LEVEL_BITS = 6;
+  static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+  static const int LEVEL_MASK = LEVEL_SIZE - 1;
+  static const int NUM_LEVELS = 4; // Not counting the root level
+
+  static void init_head(WheelTimer* head);
+
+  void add(WheelTimer* timer);
+  void remove(WheelTimer* timer);
+
+  void insert(WheelTimer* timer);
+  void cascade(int level, int index);
+  void run_slot(WheelTimer* head);
+
+  void schedule();
+  void on_tick(Timer* timer);
+
+private:
+  uv_loop_t* loop_;
+  Timer timer_;
+  uint64_t scheduled_tick_; // The tick the driving timer was started for
+  uint64_t current_tick_; // Ticks before this have already been run
+  size_t size_;
+  bool is_ticking_;
+
+  WheelTimer root_[ROOT_SIZE]; // List heads
+  WheelTimer levels_[NUM_LEVELS][LEVEL_SIZE];
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+/**
+ * A millisecond timer that runs on the `TimerWheel` of the event loop that
+ * runs a libuv loop. Loops that aren't run by an `EventLoop` (their user data
+ * isn't set) don't have a wheel so the timer falls back to a libuv `Timer`.
+ */
+class LoopTimer {
+public:
+  typedef cass::Callback<void, LoopTimer*> Callback;
+
+  /**
+   * Start the timer. If the timer is already running it's restarted.
+   *
+   * @param loop The loop where the timer should run.
+   * @param timeout The timeout in milliseconds.
+   * @param callback The callback that handles the timeout.
+   */
+  void start(uv_loop_t* loop, uint64_t timeout, const Callback& callback);
+
+  /**
+   * Stop the timer.
+   */
+  void stop();
+
+  bool is_running() const {
+    return wheel_timer_.is_running() || timer_.is_running();
+  }
+
+private:
+  void on_wheel_timeout(WheelTimer* timer);
+  void on_timeout(Timer* timer);
+
+private:
+  WheelTimer wheel_timer_;
+  Timer timer_;
+  Callback callback_;
+};
+
+} // namespace cass
+
+#endif
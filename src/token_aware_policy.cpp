@@ -16,6 +16,7 @@
 
 #include "token_aware_policy.hpp"
 
+#include "dc_aware_policy.hpp"
 #include "random.hpp"
 #include "request_handler.hpp"
 
@@ -35,13 +36,69 @@ static inline bool contains(const CopyOnWriteHostVec& replicas, const Address& a
   return false;
 }
 
+// The child plan of a token-aware plan for any type of child policy. The
+// child policy and plan are used through virtual calls.
+class TokenAwarePolicy::ChildPlan {
+public:
+  ChildPlan(LoadBalancingPolicy* policy,
+            const String& keyspace,
+            RequestHandler* request_handler,
+            const TokenMap* token_map)
+    : policy_(policy)
+    , plan_(policy->new_query_plan(keyspace, request_handler, token_map)) { }
+
+  bool is_host_up(const Address& address) const { return policy_->is_host_up(address); }
+  CassHostDistance distance(const Host::Ptr& host) const { return policy_->distance(host); }
+  Host::Ptr compute_next() { return plan_->compute_next(); }
+
+private:
+  LoadBalancingPolicy* policy_;
+  ScopedPtr<QueryPlan> plan_;
+};
+
+// The child plan of a token-aware plan for a DC-aware child policy (the
+// default). The child plan is embedded and both it and the child policy are
+// called directly.
+class TokenAwarePolicy::DCAwareChildPlan {
+public:
+  DCAwareChildPlan(DCAwarePolicy* policy,
+                   const String& keyspace,
+                   RequestHandler* request_handler,
+                   const TokenMap* token_map)
+    : policy_(policy)
+    , plan_(policy, request_handler) { }
+
+  bool is_host_up(const Address& address) const {
+    return policy_->DCAwarePolicy::is_host_up(address);
+  }
+
+  CassHostDistance distance(const Host::Ptr& host) const {
+    return policy_->DCAwarePolicy::distance(host);
+  }
+
+  Host::Ptr compute_next() { return plan_.DCAwarePolicy::DCAwareQueryPlan::compute_next(); }
+
+private:
+  const DCAwarePolicy* policy_;
+  DCAwarePolicy::DCAwareQueryPlan plan_;
+};
+
+TokenAwarePolicy::TokenAwarePolicy(LoadBalancingPolicy* child_policy, bool shuffle_replicas)
+  : ChainedLoadBalancingPolicy(child_policy)
+  , dc_aware_policy_(dynamic_cast<DCAwarePolicy*>(child_policy))
+  , index_(0)
+  , shuffle_replicas_(shuffle_replicas)
+  , token_map_instance_id_(0)
+  , keyspace_id_(0) { }
+
 void TokenAwarePolicy::init(const Host::Ptr& connected_host,
                             const HostMap& hosts,
                             Random* random) {
   if (random != NULL) {
     if (shuffle_replicas_) {
-      // Store random so that it can be used to shuffle replicas.
-      random_ = random;
+      // Use a generator owned by this instance so that shuffling replicas
+      // doesn't contend on the session's (locked) random number generator.
+      rng_.reset(Memory::allocate<MT19937_64>(random->next(CASS_UINT64_MAX)));
     } else {
       // Make sure that different instances of the token aware policy (e.g. different sessions)
       // don't use the same host order.
@@ -54,6 +111,13 @@ void TokenAwarePolicy::init(const Host::Ptr& connected_host,
 QueryPlan* TokenAwarePolicy::new_query_plan(const String& keyspace,
                                             RequestHandler* request_handler,
                                             const TokenMap* token_map) {
+  return emplace_query_plan(NULL, keyspace, request_handler, token_map);
+}
+
+QueryPlan* TokenAwarePolicy::emplace_query_plan(QueryPlanStorage* storage,
+                                                const String& keyspace,
+                                                RequestHandler* request_handler,
+                                                const TokenMap* token_map) {
   if (request_handler != NULL) {
     const RoutableRequest* request = static_cast<const RoutableRequest*>(request_handler->request());
     switch (request->opcode()) {
@@ -61,21 +125,20 @@ QueryPlan* TokenAwarePolicy::new_query_plan(const String& keyspace,
       case CQL_OPCODE_QUERY:
       case CQL_OPCODE_EXECUTE:
       case CQL_OPCODE_BATCH:
-        String routing_key;
-        if (request->get_routing_key(&routing_key) && !keyspace.empty()) {
-          if (token_map != NULL) {
-            CopyOnWriteHostVec replicas = token_map->get_replicas(keyspace, routing_key);
-            if (replicas && !replicas->empty()) {
-              if (random_ != NULL) {
-                random_shuffle(replicas->begin(), replicas->end(), random_);
-              }
-              return Memory::allocate<TokenAwareQueryPlan>(child_policy_.get(),
-                                                           child_policy_->new_query_plan(keyspace,
-                                                                                         request_handler,
-                                                                                         token_map),
-                                                           replicas,
-                                                           index_);
+        RoutingKey routing_key;
+        if (token_map != NULL && !keyspace.empty() &&
+            request->get_routing_key(&routing_key)) {
+          const CopyOnWriteHostVec& replicas = token_map->get_replicas(keyspace_id(keyspace, token_map),
+                                                                       routing_key.value());
+          if (replicas && !replicas->empty()) {
+            if (dc_aware_policy_ != NULL) {
+              return emplace_token_aware_query_plan<DCAwareChildPlan>(storage, dc_aware_policy_,
+                                                                      keyspace, request_handler, token_map,
+                                                                      replicas);
             }
+            return emplace_token_aware_query_plan<ChildPlan>(storage, child_policy_.get(),
+                                                             keyspace, request_handler, token_map,
+                                                             replicas);
           }
         }
         break;
@@ -85,25 +148,80 @@ QueryPlan* TokenAwarePolicy::new_query_plan(const String& keyspace,
         break;
     }
   }
-  return child_policy_->new_query_plan(keyspace,
-                                       request_handler,
-                                       token_map);
+  return child_policy_->emplace_query_plan(storage,
+                                           keyspace,
+                                           request_handler,
+                                           token_map);
+}
+
+template <class Child, class Policy>
+QueryPlan* TokenAwarePolicy::emplace_token_aware_query_plan(QueryPlanStorage* storage,
+                                                            Policy* child_policy,
+                                                            const String& keyspace,
+                                                            RequestHandler* request_handler,
+                                                            const TokenMap* token_map,
+                                                            const CopyOnWriteHostVec& replicas) {
+  return new (QueryPlanStorage::allocate(storage, sizeof(TokenAwareQueryPlan<Child>)))
+      TokenAwareQueryPlan<Child>(child_policy, keyspace, request_handler, token_map,
+                                 replicas, index_, rng_.get());
+}
+
+uint32_t TokenAwarePolicy::keyspace_id(const String& keyspace, const TokenMap* token_map) {
+  // Requests almost always use the same keyspace so this avoids looking up
+  // the keyspace by name for every request.
+  if (token_map->instance_id() != token_map_instance_id_ || keyspace != keyspace_) {
+    token_map_instance_id_ = token_map->instance_id();
+    keyspace_ = keyspace;
+    keyspace_id_ = token_map->get_keyspace_id(keyspace);
+  }
+  return keyspace_id_;
+}
+
+template <class Child>
+template <class Policy>
+TokenAwarePolicy::TokenAwareQueryPlan<Child>::TokenAwareQueryPlan(Policy* child_policy,
+                                                                  const String& keyspace,
+                                                                  RequestHandler* request_handler,
+                                                                  const TokenMap* token_map,
+                                                                  const CopyOnWriteHostVec& replicas,
+                                                                  size_t start_index,
+                                                                  MT19937_64* rng)
+  : child_(child_policy, keyspace, request_handler, token_map)
+  , replicas_(replicas)
+  , index_(start_index)
+  , remaining_(replicas_->size()) {
+  if (rng != NULL) {
+    // Shuffle the order the replicas are visited instead of the replicas
+    // themselves which would require a copy.
+    size_t size = replicas_->size();
+    order_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      order_[i] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = size - 1; i > 0; --i) {
+      std::swap(order_[i], order_[(*rng)() % (i + 1)]);
+    }
+    index_ = 0;
+  }
 }
 
-Host::Ptr TokenAwarePolicy::TokenAwareQueryPlan::compute_next()  {
+template <class Child>
+Host::Ptr TokenAwarePolicy::TokenAwareQueryPlan<Child>::compute_next()  {
+  const HostVec& replicas = *replicas_;
   while (remaining_ > 0) {
     --remaining_;
-    const Host::Ptr& host((*replicas_)[index_++ % replicas_->size()]);
-    if (child_policy_->is_host_up(host->address()) &&
-        child_policy_->distance(host) == CASS_HOST_DISTANCE_LOCAL) {
+    size_t index = index_++ % replicas.size();
+    const Host::Ptr& host(replicas[order_.empty() ? index : order_[index]]);
+    if (child_.is_host_up(host->address()) &&
+        child_.distance(host) == CASS_HOST_DISTANCE_LOCAL) {
       return host;
     }
   }
 
   Host::Ptr host;
-  while ((host = child_plan_->compute_next())) {
+  while ((host = child_.compute_next())) {
     if (!contains(replicas_, host->address()) ||
-        child_policy_->distance(host) != CASS_HOST_DISTANCE_LOCAL) {
+        child_.distance(host) != CASS_HOST_DISTANCE_LOCAL) {
       return host;
     }
   }
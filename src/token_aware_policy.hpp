@@ -21,16 +21,17 @@
 #include "load_balancing.hpp"
 #include "host.hpp"
 #include "scoped_ptr.hpp"
+#include "small_vector.hpp"
+
+#include "third_party/mt19937_64/mt19937_64.hpp"
 
 namespace cass {
 
+class DCAwarePolicy;
+
 class TokenAwarePolicy : public ChainedLoadBalancingPolicy {
 public:
-  TokenAwarePolicy(LoadBalancingPolicy* child_policy, bool shuffle_replicas)
-      : ChainedLoadBalancingPolicy(child_policy)
-      , random_(NULL)
-      , index_(0)
-      , shuffle_replicas_(shuffle_replicas) {}
+  TokenAwarePolicy(LoadBalancingPolicy* child_policy, bool shuffle_replicas);
 
   virtual ~TokenAwarePolicy() { }
 
@@ -40,37 +41,69 @@ public:
                                     RequestHandler* request_handler,
                                     const TokenMap* token_map);
 
+  virtual QueryPlan* emplace_query_plan(QueryPlanStorage* storage,
+                                        const String& keyspace,
+                                        RequestHandler* request_handler,
+                                        const TokenMap* token_map);
+
   LoadBalancingPolicy* new_instance() {
     return Memory::allocate<TokenAwarePolicy>(child_policy_->new_instance(), shuffle_replicas_);
   }
 
 private:
+  class ChildPlan;
+  class DCAwareChildPlan;
+
+  // The replicas are shared with the token map and are never modified. They
+  // are either visited in order from a starting index or, when shuffling, in
+  // a random order that's kept by the query plan. The child plan is embedded
+  // so that the common case of a DC-aware child policy doesn't need virtual
+  // calls or a separate allocation.
+  template <class Child>
   class TokenAwareQueryPlan : public QueryPlan {
   public:
-    TokenAwareQueryPlan(LoadBalancingPolicy* child_policy,
-                        QueryPlan* child_plan,
+    template <class Policy>
+    TokenAwareQueryPlan(Policy* child_policy,
+                        const String& keyspace,
+                        RequestHandler* request_handler,
+                        const TokenMap* token_map,
                         const CopyOnWriteHostVec& replicas,
-                        size_t start_index)
-      : child_policy_(child_policy)
-      , child_plan_(child_plan)
-      , replicas_(replicas)
-      , index_(start_index)
-      , remaining_(replicas->size()) { }
+                        size_t start_index,
+                        MT19937_64* rng);
 
-    Host::Ptr compute_next();
+    virtual Host::Ptr compute_next();
 
   private:
-    LoadBalancingPolicy* child_policy_;
-    ScopedPtr<QueryPlan> child_plan_;
-    CopyOnWriteHostVec replicas_;
+    Child child_;
+    const CopyOnWriteHostVec replicas_;
+    SmallVector<uint32_t, 16> order_; // Only used when shuffling
     size_t index_;
     size_t remaining_;
   };
 
-  Random* random_;
+  template <class Child, class Policy>
+  QueryPlan* emplace_token_aware_query_plan(QueryPlanStorage* storage,
+                                            Policy* child_policy,
+                                            const String& keyspace,
+                                            RequestHandler* request_handler,
+                                            const TokenMap* token_map,
+                                            const CopyOnWriteHostVec& replicas);
+
+  uint32_t keyspace_id(const String& keyspace, const TokenMap* token_map);
+
+  DCAwarePolicy* dc_aware_policy_; // The child policy if it's DC-aware
   size_t index_;
   bool shuffle_replicas_;
 
+  // Only used by a single thread (the policy is copied for each request
+  // processor) so it doesn't need to be synchronized.
+  ScopedPtr<MT19937_64> rng_;
+
+  // The identifier of the most recently used keyspace
+  uint64_t token_map_instance_id_;
+  String keyspace_;
+  uint32_t keyspace_id_;
+
 private:
   DISALLOW_COPY_AND_ASSIGN(TokenAwarePolicy);
 };
@@ -16,10 +16,17 @@
 
 #include "token_map.hpp"
 
+#include "atomic.hpp"
 #include "token_map_impl.hpp"
 
 namespace cass {
 
+static Atomic<uint64_t> instance_id__(0);
+
+uint64_t TokenMap::next_instance_id() {
+  return instance_id__.fetch_add(1) + 1;
+}
+
 TokenMap::Ptr TokenMap::from_partitioner(StringRef partitioner) {
   if (ends_with(partitioner, Murmur3Partitioner::name())) {
     return Ptr(Memory::allocate<TokenMapImpl<Murmur3Partitioner> >());
@@ -35,8 +35,20 @@ public:
 
   static TokenMap::Ptr from_partitioner(StringRef partitioner);
 
+  TokenMap()
+    : instance_id_(next_instance_id()) { }
+
   virtual ~TokenMap() { }
 
+  /**
+   * A unique identifier for this token map instance. Copies are given a new
+   * identifier so this can be used to determine when cached values (e.g.
+   * keyspace identifiers) need to be refreshed.
+   *
+   * @return The instance identifier.
+   */
+  uint64_t instance_id() const { return instance_id_; }
+
   virtual void add_host(const Host::Ptr& host) = 0;
   virtual void update_host_and_build(const Host::Ptr& host) = 0;
   virtual void remove_host_and_build(const Host::Ptr& host) = 0;
@@ -49,8 +61,34 @@ public:
 
   virtual TokenMap::Ptr copy() const = 0;
 
-  virtual const CopyOnWriteHostVec& get_replicas(const String& keyspace_name,
-                                                 const String& routing_key) const = 0;
+  /**
+   * Get the interned identifier for a keyspace.
+   *
+   * @param keyspace_name The keyspace's name.
+   * @return The keyspace's identifier or 0 if the keyspace doesn't exist.
+   */
+  virtual uint32_t get_keyspace_id(const String& keyspace_name) const = 0;
+
+  /**
+   * Get the replicas for a routing key. The replicas must not be modified.
+   *
+   * @param keyspace_id The keyspace's identifier (see get_keyspace_id()).
+   * @param routing_key The routing key.
+   * @return The replicas or an empty (NULL) vector if there are none.
+   */
+  virtual const CopyOnWriteHostVec& get_replicas(uint32_t keyspace_id,
+                                                 const StringRef& routing_key) const = 0;
+
+  const CopyOnWriteHostVec& get_replicas(const String& keyspace_name,
+                                         const StringRef& routing_key) const {
+    return get_replicas(get_keyspace_id(keyspace_name), routing_key);
+  }
+
+private:
+  static uint64_t next_instance_id();
+
+private:
+  const uint64_t instance_id_;
 };
 
 } // namespace cass
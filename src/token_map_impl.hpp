@@ -22,6 +22,7 @@
 #include "dense_hash_map.hpp"
 #include "dense_hash_set.hpp"
 #include "deque.hpp"
+#include "fork_join.hpp"
 #include "json.hpp"
 #include "map_iterator.hpp"
 #include "memory.hpp"
@@ -95,6 +96,15 @@ public:
     return id;
   }
 
+  uint32_t find(const String& key) const {
+    if (key.empty()) {
+      return 0;
+    }
+
+    IdMap::const_iterator i = ids_.find(key);
+    return i != ids_.end() ? i->second : 0;
+  }
+
 private:
   IdMap ids_;
 };
@@ -200,6 +210,101 @@ public:
   }
 };
 
+/**
+ * The changes between two versions of a token ring. This is used to
+ * determine which tokens' replicas need to be rebuilt after a host is added,
+ * updated or removed.
+ */
+class TokenRingChanges {
+public:
+  static const size_t NEW_TOKEN = static_cast<size_t>(-1);
+
+  void reset(size_t previous_num_tokens) {
+    previous_num_tokens_ = previous_num_tokens;
+    previous_indices_.clear();
+    removed_.assign(previous_num_tokens + 1, 0);
+    inserted_after_.assign(previous_num_tokens + 1, 0);
+  }
+
+  /**
+   * Record a token in the new ring.
+   *
+   * @param previous_index The token's index in the previous ring or
+   * NEW_TOKEN if it wasn't in the previous ring.
+   * @param last_previous_index The index of the last token in the previous
+   * ring that is before this token or NEW_TOKEN if there's none.
+   */
+  void add(size_t previous_index, size_t last_previous_index) {
+    previous_indices_.push_back(previous_index);
+    if (previous_index == NEW_TOKEN && previous_num_tokens_ > 0) {
+      // Tokens before the first token are after the last token of the ring
+      inserted_after_[last_previous_index == NEW_TOKEN
+                      ? previous_num_tokens_ - 1 : last_previous_index]++;
+    }
+  }
+
+  /**
+   * Record a token in the previous ring that was removed (or whose host was
+   * changed).
+   */
+  void remove(size_t previous_index) {
+    removed_[previous_index]++;
+  }
+
+  /**
+   * Convert the counts to prefix sums. This must be called before
+   * `is_affected()`.
+   */
+  void finish() {
+    accumulate(removed_);
+    accumulate(inserted_after_);
+  }
+
+  size_t previous_index(size_t index) const { return previous_indices_[index]; }
+
+  /**
+   * Determine if a change could affect the replicas of a token in the
+   * previous ring.
+   *
+   * @param previous_index The token's index in the previous ring.
+   * @param span The number of tokens after the token that were visited to
+   * find its replicas.
+   * @return true if a token was removed from, or added to, the visited part
+   * of the ring.
+   */
+  bool is_affected(size_t previous_index, size_t span) const {
+    if (span + 1 >= previous_num_tokens_) return true;
+    return sum(removed_, previous_index, span + 1) > 0 ||
+        sum(inserted_after_, previous_index, span) > 0;
+  }
+
+private:
+  static void accumulate(Vector<uint32_t>& counts) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+      uint32_t count = counts[i];
+      counts[i] = total;
+      total += count;
+    }
+  }
+
+  // The sum of `count` elements starting at `first`, wrapping around the ring
+  uint32_t sum(const Vector<uint32_t>& prefix_sums, size_t first, size_t count) const {
+    size_t last = first + count;
+    if (last <= previous_num_tokens_) {
+      return prefix_sums[last] - prefix_sums[first];
+    }
+    return prefix_sums[previous_num_tokens_] - prefix_sums[first] +
+        prefix_sums[last - previous_num_tokens_];
+  }
+
+private:
+  size_t previous_num_tokens_;
+  Vector<size_t> previous_indices_; // Indexed by the new ring's indices
+  Vector<uint32_t> removed_;
+  Vector<uint32_t> inserted_after_;
+};
+
 template <class Partitioner>
 class ReplicationStrategy {
 public:
@@ -211,6 +316,10 @@ public:
   typedef std::pair<Token, CopyOnWriteHostVec> TokenReplicas;
   typedef Vector<TokenReplicas> TokenReplicasVec;
 
+  // The number of tokens after each token that were visited to find its
+  // replicas
+  typedef Vector<uint32_t> TokenSpanVec;
+
   typedef Deque<typename TokenHostVec::const_iterator> TokenHostQueue;
 
   struct DatacenterRackInfo {
@@ -253,13 +362,62 @@ public:
   void build_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
                       TokenReplicasVec& result) const;
 
+  void build_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                      TokenReplicasVec& result, TokenSpanVec& spans) const;
+
+  /**
+   * Determine if replicas built for the previous ring can be reused for the
+   * tokens of the current ring that are unaffected by the changes. This is
+   * only possible if the number of replicas per datacenter (and the number
+   * of racks used to place them) didn't change.
+   */
+  bool can_update_replicas(const DatacenterMap& previous_datacenters, size_t previous_num_tokens,
+                           const DatacenterMap& datacenters, size_t num_tokens) const;
+
+  /**
+   * Build the replicas for a ring by rebuilding only the tokens that could
+   * be affected by the changes from the previous ring and reusing the
+   * previous replicas for the rest.
+   */
+  void update_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                       const TokenRingChanges& changes,
+                       const TokenReplicasVec& previous_replicas, const TokenSpanVec& previous_spans,
+                       TokenReplicasVec& result, TokenSpanVec& spans) const;
+
+  /**
+   * Size the result for building the replicas of ranges of tokens (see
+   * `build_replicas_range()`).
+   *
+   * @return false if there are no replicas for the ring. The result is left
+   * empty.
+   */
+  bool prepare_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                        TokenReplicasVec& result, TokenSpanVec& spans) const;
+
+  /**
+   * Build the replicas for the tokens in [first, last). The result must have
+   * been sized using `prepare_replicas()`. Disjoint ranges can be built
+   * concurrently.
+   */
+  void build_replicas_range(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                            size_t first, size_t last,
+                            TokenReplicasVec& result, TokenSpanVec& spans) const;
+
 private:
-  void build_replicas_network_topology(const TokenHostVec& tokens, const DatacenterMap& datacenters,
-                                       TokenReplicasVec& result) const;
-  void build_replicas_simple(const TokenHostVec& tokens, const DatacenterMap& datacenters,
-                             TokenReplicasVec& result) const ;
-  void build_replicas_non_replicated(const TokenHostVec& tokens, const DatacenterMap& datacenters,
-                                     TokenReplicasVec& result) const;
+  bool count_replicas(const DatacenterMap& datacenters, size_t num_tokens,
+                      DatacenterRackInfoMap& dc_racks, size_t& num_replicas) const;
+  void log_missing_datacenters(const DatacenterMap& datacenters) const;
+
+  size_t build_token_replicas(const TokenHostVec& tokens, typename TokenHostVec::const_iterator i,
+                              size_t num_replicas, DatacenterRackInfoMap& dc_racks,
+                              HostVec& replicas) const;
+  size_t build_token_replicas_network_topology(const TokenHostVec& tokens,
+                                               typename TokenHostVec::const_iterator i,
+                                               size_t num_replicas, DatacenterRackInfoMap& dc_racks,
+                                               HostVec& replicas) const;
+  size_t build_token_replicas_simple(const TokenHostVec& tokens,
+                                     typename TokenHostVec::const_iterator i,
+                                     size_t num_replicas, HostVec& replicas) const;
 
 private:
   Type type_;
@@ -344,166 +502,292 @@ void ReplicationStrategy<Partitioner>::init(IdGenerator& dc_ids,
 template <class Partitioner>
 void ReplicationStrategy<Partitioner>::build_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
                                                       TokenReplicasVec& result) const {
+  TokenSpanVec spans;
+  build_replicas(tokens, datacenters, result, spans);
+}
+
+template <class Partitioner>
+void ReplicationStrategy<Partitioner>::build_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                                                      TokenReplicasVec& result, TokenSpanVec& spans) const {
+  if (prepare_replicas(tokens, datacenters, result, spans)) {
+    build_replicas_range(tokens, datacenters, 0, tokens.size(), result, spans);
+  }
+}
+
+template <class Partitioner>
+bool ReplicationStrategy<Partitioner>::prepare_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                                                        TokenReplicasVec& result, TokenSpanVec& spans) const {
   result.clear();
-  result.reserve(tokens.size());
+  spans.clear();
+
+  log_missing_datacenters(datacenters);
+
+  DatacenterRackInfoMap dc_racks;
+  size_t num_replicas = 0;
+  if (!count_replicas(datacenters, tokens.size(), dc_racks, num_replicas)) {
+    return false;
+  }
+
+  result.resize(tokens.size(), TokenReplicas(Token(), CopyOnWriteHostVec(NULL)));
+  spans.resize(tokens.size());
+  return true;
+}
+
+template <class Partitioner>
+void ReplicationStrategy<Partitioner>::build_replicas_range(const TokenHostVec& tokens,
+                                                            const DatacenterMap& datacenters,
+                                                            size_t first, size_t last,
+                                                            TokenReplicasVec& result, TokenSpanVec& spans) const {
+  DatacenterRackInfoMap dc_racks;
+  size_t num_replicas = 0;
+  if (!count_replicas(datacenters, tokens.size(), dc_racks, num_replicas)) {
+    return;
+  }
+
+  for (size_t i = first; i < last; ++i) {
+    CopyOnWriteHostVec replicas(Memory::allocate<HostVec>());
+    replicas->reserve(num_replicas);
+    spans[i] = build_token_replicas(tokens, tokens.begin() + i, num_replicas, dc_racks, *replicas);
+    result[i] = TokenReplicas(tokens[i].first, replicas);
+  }
+}
 
+template <class Partitioner>
+bool ReplicationStrategy<Partitioner>::can_update_replicas(const DatacenterMap& previous_datacenters,
+                                                           size_t previous_num_tokens,
+                                                           const DatacenterMap& datacenters,
+                                                           size_t num_tokens) const {
   switch (type_) {
     case NETWORK_TOPOLOGY_STRATEGY:
-      build_replicas_network_topology(tokens, datacenters, result);
-      break;
-    case SIMPLE_STRATEGY:
-      build_replicas_simple(tokens, datacenters, result);
-      break;
+      for (ReplicationFactorMap::const_iterator i = replication_factors_.begin(),
+           end = replication_factors_.end(); i != end; ++i) {
+        DatacenterMap::const_iterator previous = previous_datacenters.find(i->first);
+        DatacenterMap::const_iterator current = datacenters.find(i->first);
+        if ((previous == previous_datacenters.end()) != (current == datacenters.end())) {
+          return false;
+        }
+        if (current != datacenters.end() &&
+            (std::min<size_t>(i->second.count, previous->second.num_nodes) !=
+             std::min<size_t>(i->second.count, current->second.num_nodes) ||
+             previous->second.racks.size() != current->second.racks.size())) {
+          return false;
+        }
+      }
+      return true;
+    case SIMPLE_STRATEGY: {
+      ReplicationFactorMap::const_iterator it = replication_factors_.find(1);
+      return it == replication_factors_.end() ||
+          std::min<size_t>(it->second.count, previous_num_tokens) ==
+          std::min<size_t>(it->second.count, num_tokens);
+    }
     default:
-      build_replicas_non_replicated(tokens, datacenters, result);
-      break;
+      return true;
   }
 }
 
 template <class Partitioner>
-void ReplicationStrategy<Partitioner>::build_replicas_network_topology(const TokenHostVec& tokens, const DatacenterMap& datacenters,
-                                                                       TokenReplicasVec& result) const {
-  if (replication_factors_.empty()) {
+void ReplicationStrategy<Partitioner>::update_replicas(const TokenHostVec& tokens, const DatacenterMap& datacenters,
+                                                       const TokenRingChanges& changes,
+                                                       const TokenReplicasVec& previous_replicas,
+                                                       const TokenSpanVec& previous_spans,
+                                                       TokenReplicasVec& result, TokenSpanVec& spans) const {
+  result.clear();
+  spans.clear();
+
+  log_missing_datacenters(datacenters);
+
+  DatacenterRackInfoMap dc_racks;
+  size_t num_replicas = 0;
+  if (!count_replicas(datacenters, tokens.size(), dc_racks, num_replicas)) {
     return;
   }
 
-  DatacenterRackInfoMap dc_racks;
-  dc_racks.resize(datacenters.size());
+  result.reserve(tokens.size());
+  spans.reserve(tokens.size());
+  for (typename TokenHostVec::const_iterator i = tokens.begin(),
+       end = tokens.end(); i != end; ++i) {
+    size_t previous_index = changes.previous_index(i - tokens.begin());
+    if (previous_index != TokenRingChanges::NEW_TOKEN &&
+        !changes.is_affected(previous_index, previous_spans[previous_index])) {
+      result.push_back(previous_replicas[previous_index]);
+      spans.push_back(previous_spans[previous_index]);
+    } else {
+      CopyOnWriteHostVec replicas(Memory::allocate<HostVec>());
+      replicas->reserve(num_replicas);
+      spans.push_back(build_token_replicas(tokens, i, num_replicas, dc_racks, *replicas));
+      result.push_back(TokenReplicas(i->first, replicas));
+    }
+  }
+}
 
-  size_t num_replicas = 0;
+template <class Partitioner>
+bool ReplicationStrategy<Partitioner>::count_replicas(const DatacenterMap& datacenters, size_t num_tokens,
+                                                      DatacenterRackInfoMap& dc_racks,
+                                                      size_t& num_replicas) const {
+  switch (type_) {
+    case NETWORK_TOPOLOGY_STRATEGY: {
+      if (replication_factors_.empty()) {
+        return false;
+      }
 
-  // Populate the datacenter and rack information. Only considering valid
-  // datacenters that actually have hosts. If there's a replication factor
-  // for a datacenter that doesn't exist or has no node then it will not
-  // be counted.
+      num_replicas = 0;
+      dc_racks.resize(datacenters.size());
+
+      // Populate the datacenter and rack information. Only considering valid
+      // datacenters that actually have hosts. If there's a replication factor
+      // for a datacenter that doesn't exist or has no node then it will not
+      // be counted.
+      for (ReplicationFactorMap::const_iterator i = replication_factors_.begin(),
+           end = replication_factors_.end(); i != end; ++i) {
+        DatacenterMap::const_iterator j = datacenters.find(i->first);
+        // Don't include datacenters that don't exist
+        if (j != datacenters.end()) {
+          // A replication factor cannot exceed the number of nodes in a datacenter
+          size_t replication_factor = std::min<size_t>(i->second.count, j->second.num_nodes);
+          num_replicas += replication_factor;
+          DatacenterRackInfo dc_rack_info;
+          dc_rack_info.replication_factor = replication_factor;
+          dc_rack_info.rack_count = j->second.racks.size();
+          dc_racks[j->first] = dc_rack_info;
+        }
+      }
+
+      return true;
+    }
+    case SIMPLE_STRATEGY: {
+      ReplicationFactorMap::const_iterator it = replication_factors_.find(1);
+      if (it == replication_factors_.end()) {
+        return false;
+      }
+      num_replicas = std::min<size_t>(it->second.count, num_tokens);
+      return true;
+    }
+    default:
+      num_replicas = 1;
+      return true;
+  }
+}
+
+template <class Partitioner>
+void ReplicationStrategy<Partitioner>::log_missing_datacenters(const DatacenterMap& datacenters) const {
+  if (type_ != NETWORK_TOPOLOGY_STRATEGY) return;
   for (ReplicationFactorMap::const_iterator i = replication_factors_.begin(),
        end = replication_factors_.end(); i != end; ++i) {
-    DatacenterMap::const_iterator j = datacenters.find(i->first);
-    // Don't include datacenters that don't exist
-    if (j != datacenters.end()) {
-      // A replication factor cannot exceed the number of nodes in a datacenter
-      size_t replication_factor = std::min<size_t>(i->second.count, j->second.num_nodes);
-      num_replicas += replication_factor;
-      DatacenterRackInfo dc_rack_info;
-      dc_rack_info.replication_factor = replication_factor;
-      dc_rack_info.rack_count = j->second.racks.size();
-      dc_racks[j->first] = dc_rack_info;
-    } else {
+    if (datacenters.find(i->first) == datacenters.end()) {
       LOG_WARN("No nodes in datacenter '%s'. Check your replication strategies.", i->second.name.c_str());
     }
   }
+}
 
-  if (num_replicas == 0) {
-    return;
+template <class Partitioner>
+size_t ReplicationStrategy<Partitioner>::build_token_replicas(const TokenHostVec& tokens,
+                                                              typename TokenHostVec::const_iterator i,
+                                                              size_t num_replicas,
+                                                              DatacenterRackInfoMap& dc_racks,
+                                                              HostVec& replicas) const {
+  switch (type_) {
+    case NETWORK_TOPOLOGY_STRATEGY:
+      return build_token_replicas_network_topology(tokens, i, num_replicas, dc_racks, replicas);
+    case SIMPLE_STRATEGY:
+      return build_token_replicas_simple(tokens, i, num_replicas, replicas);
+    default:
+      replicas.push_back(Host::Ptr(i->second));
+      return 0;
   }
+}
 
-  for (typename TokenHostVec::const_iterator i = tokens.begin(),
-       end = tokens.end(); i != end; ++i) {
-    Token token = i->first;
-    typename TokenHostVec::const_iterator token_it = i;
-
-    CopyOnWriteHostVec replicas(Memory::allocate<HostVec>());
-    replicas->reserve(num_replicas);
+template <class Partitioner>
+size_t ReplicationStrategy<Partitioner>::build_token_replicas_network_topology(const TokenHostVec& tokens,
+                                                                               typename TokenHostVec::const_iterator i,
+                                                                               size_t num_replicas,
+                                                                               DatacenterRackInfoMap& dc_racks,
+                                                                               HostVec& replicas) const {
+  typename TokenHostVec::const_iterator token_it = i;
+
+  // Clear datacenter and rack information for the next token
+  for (typename DatacenterRackInfoMap::iterator j = dc_racks.begin(),
+       end = dc_racks.end(); j != end; ++j) {
+    j->second.replica_count = 0;
+    j->second.racks_observed.clear();
+    j->second.skipped_endpoints.clear();
+  }
 
-    // Clear datacenter and rack information for the next token
-    for (typename DatacenterRackInfoMap::iterator j = dc_racks.begin(),
-         end = dc_racks.end(); j != end; ++j) {
-      j->second.replica_count = 0;
-      j->second.racks_observed.clear();
-      j->second.skipped_endpoints.clear();
+  size_t num_visited = 0;
+  for (typename TokenHostVec::const_iterator j = tokens.begin(),
+       end = tokens.end(); j != end && replicas.size() < num_replicas; ++j) {
+    typename TokenHostVec::const_iterator  curr_token_it = token_it;
+    Host* host = curr_token_it->second;
+    uint32_t dc = host->dc_id();
+    uint32_t rack = host->rack_id();
+
+    ++num_visited;
+    ++token_it;
+    if (token_it == tokens.end()) {
+      token_it = tokens.begin();
     }
 
-    for (typename TokenHostVec::const_iterator j = tokens.begin(),
-         end = tokens.end(); j != end && replicas->size() < num_replicas; ++j) {
-      typename TokenHostVec::const_iterator  curr_token_it = token_it;
-      Host* host = curr_token_it->second;
-      uint32_t dc = host->dc_id();
-      uint32_t rack = host->rack_id();
-
-      ++token_it;
-      if (token_it == tokens.end()) {
-        token_it = tokens.begin();
-      }
-
-      typename DatacenterRackInfoMap::iterator dc_rack_it = dc_racks.find(dc);
-      if (dc_rack_it == dc_racks.end()) {
-        continue;
-      }
+    typename DatacenterRackInfoMap::iterator dc_rack_it = dc_racks.find(dc);
+    if (dc_rack_it == dc_racks.end()) {
+      continue;
+    }
 
-      DatacenterRackInfo& dc_rack_info = dc_rack_it->second;
+    DatacenterRackInfo& dc_rack_info = dc_rack_it->second;
 
-      size_t& replica_count_this_dc = dc_rack_info.replica_count;
-      const size_t replication_factor = dc_rack_info.replication_factor;
+    size_t& replica_count_this_dc = dc_rack_info.replica_count;
+    const size_t replication_factor = dc_rack_info.replication_factor;
 
-      if (replica_count_this_dc >= replication_factor) {
-        continue;
-      }
+    if (replica_count_this_dc >= replication_factor) {
+      continue;
+    }
 
-      RackSet& racks_observed_this_dc = dc_rack_info.racks_observed;
-      const size_t rack_count_this_dc = dc_rack_info.rack_count;
+    RackSet& racks_observed_this_dc = dc_rack_info.racks_observed;
+    const size_t rack_count_this_dc = dc_rack_info.rack_count;
 
-      // First, attempt to distribute replicas over all possible racks in a
-      // datacenter only then consider hosts in the same rack
+    // First, attempt to distribute replicas over all possible racks in a
+    // datacenter only then consider hosts in the same rack
 
-      if (rack == 0 || racks_observed_this_dc.size() == rack_count_this_dc) {
-        ++replica_count_this_dc;
-        replicas->push_back(Host::Ptr(host));
+    if (rack == 0 || racks_observed_this_dc.size() == rack_count_this_dc) {
+      ++replica_count_this_dc;
+      replicas.push_back(Host::Ptr(host));
+    } else {
+      TokenHostQueue& skipped_endpoints_this_dc = dc_rack_info.skipped_endpoints;
+      if (racks_observed_this_dc.count(rack) > 0) {
+        skipped_endpoints_this_dc.push_back(curr_token_it);
       } else {
-        TokenHostQueue& skipped_endpoints_this_dc = dc_rack_info.skipped_endpoints;
-        if (racks_observed_this_dc.count(rack) > 0) {
-          skipped_endpoints_this_dc.push_back(curr_token_it);
-        } else {
-          ++replica_count_this_dc;
-          replicas->push_back(Host::Ptr(host));
-          racks_observed_this_dc.insert(rack);
-
-          // Once we visited every rack in the current datacenter then starting considering
-          // hosts we've already skipped.
-          if (racks_observed_this_dc.size() == rack_count_this_dc) {
-            while (!skipped_endpoints_this_dc.empty() && replica_count_this_dc < replication_factor) {
-              ++replica_count_this_dc;
-              replicas->push_back(Host::Ptr(skipped_endpoints_this_dc.front()->second));
-              skipped_endpoints_this_dc.pop_front();
-            }
+        ++replica_count_this_dc;
+        replicas.push_back(Host::Ptr(host));
+        racks_observed_this_dc.insert(rack);
+
+        // Once we visited every rack in the current datacenter then starting considering
+        // hosts we've already skipped.
+        if (racks_observed_this_dc.size() == rack_count_this_dc) {
+          while (!skipped_endpoints_this_dc.empty() && replica_count_this_dc < replication_factor) {
+            ++replica_count_this_dc;
+            replicas.push_back(Host::Ptr(skipped_endpoints_this_dc.front()->second));
+            skipped_endpoints_this_dc.pop_front();
           }
         }
       }
     }
-
-    result.push_back(TokenReplicas(token, replicas));
   }
-}
 
-template <class Partitioner>
-void ReplicationStrategy<Partitioner>::build_replicas_simple(const TokenHostVec& tokens, const DatacenterMap& not_used,
-                                                             TokenReplicasVec& result) const {
-  ReplicationFactorMap::const_iterator it = replication_factors_.find(1);
-  if (it == replication_factors_.end()) {
-    return;
-  }
-  size_t num_replicas = std::min<size_t>(it->second.count, tokens.size());
-  for (typename TokenHostVec::const_iterator i = tokens.begin(),
-       end = tokens.end(); i != end; ++i) {
-    CopyOnWriteHostVec replicas(Memory::allocate<HostVec>());
-    typename TokenHostVec::const_iterator token_it = i;
-    do {
-      replicas->push_back(Host::Ptr(token_it->second));
-      ++token_it;
-      if (token_it == tokens.end()) {
-        token_it = tokens.begin();
-      }
-    } while (replicas->size() < num_replicas);
-    result.push_back(TokenReplicas(i->first, replicas));
-  }
+  return num_visited > 0 ? num_visited - 1 : 0;
 }
 
 template <class Partitioner>
-void ReplicationStrategy<Partitioner>::build_replicas_non_replicated(const TokenHostVec& tokens, const DatacenterMap& not_used,
-                                                                     TokenReplicasVec& result) const {
-  for (typename TokenHostVec::const_iterator i = tokens.begin(); i != tokens.end(); ++i) {
-    CopyOnWriteHostVec replicas(Memory::allocate<HostVec>(1, Host::Ptr(i->second)));
-    result.push_back(TokenReplicas(i->first, replicas));
-  }
+size_t ReplicationStrategy<Partitioner>::build_token_replicas_simple(const TokenHostVec& tokens,
+                                                                     typename TokenHostVec::const_iterator i,
+                                                                     size_t num_replicas,
+                                                                     HostVec& replicas) const {
+  typename TokenHostVec::const_iterator token_it = i;
+  do {
+    replicas.push_back(Host::Ptr(token_it->second));
+    ++token_it;
+    if (token_it == tokens.end()) {
+      token_it = tokens.begin();
+    }
+  } while (replicas.size() < num_replicas);
+  return replicas.size() - 1;
 }
 
 template <class Partitioner>
@@ -543,13 +827,58 @@ public:
     }
   };
 
-  typedef DenseHashMap<String, TokenReplicasVec> KeyspaceReplicaMap;
+  typedef Vector<uint32_t> TokenSpanVec;
+
+  /**
+   * The replicas of every token for a replication strategy. These are
+   * immutable once built so they're shared by keyspaces that use the same
+   * replication strategy and by copies of the token map.
+   */
+  class ReplicaSet : public RefCounted<ReplicaSet> {
+  public:
+    typedef SharedRefPtr<const ReplicaSet> ConstPtr;
+
+    ReplicaSet(const ReplicationStrategy<Partitioner>& strategy)
+      : strategy(strategy) { }
+
+    const ReplicationStrategy<Partitioner> strategy;
+    TokenReplicasVec replicas;
+    TokenSpanVec spans;
+  };
+
+  typedef Vector<std::pair<const ReplicaSet*, typename ReplicaSet::ConstPtr> > ReplicaSetVec;
+
+  // The number of tokens built by each task when replicas are built in
+  // parallel
+  static const size_t BUILD_TASK_NUM_TOKENS = 4096;
+
+  struct BuildTask {
+    BuildTask(ReplicaSet* replica_set, size_t first, size_t last)
+      : replica_set(replica_set)
+      , first(first)
+      , last(last) { }
+
+    ReplicaSet* replica_set;
+    size_t first;
+    size_t last;
+  };
+
+  typedef Vector<BuildTask> BuildTaskVec;
+
+  struct BuildBatch {
+    BuildBatch(const TokenMapImpl* token_map)
+      : token_map(token_map) { }
+
+    const TokenMapImpl* token_map;
+    BuildTaskVec tasks;
+  };
+
+  // Indexed by keyspace identifier
+  typedef Vector<typename ReplicaSet::ConstPtr> KeyspaceReplicaVec;
   typedef DenseHashMap<String, ReplicationStrategy<Partitioner> > KeyspaceStrategyMap;
 
   TokenMapImpl()
     : no_replicas_dummy_(NULL) {
-    replicas_.set_empty_key(String());
-    replicas_.set_deleted_key(String(1, '\0'));
     strategies_.set_empty_key(String());
     strategies_.set_deleted_key(String(1, '\0'));
   }
@@ -559,6 +888,7 @@ public:
     , hosts_(other.hosts_)
     , replicas_(other.replicas_)
     , strategies_(other.strategies_)
+    , keyspace_ids_(other.keyspace_ids_)
     , rack_ids_(other.rack_ids_)
     , dc_ids_(other.dc_ids_)
     , no_replicas_dummy_(NULL) { }
@@ -575,8 +905,12 @@ public:
 
   virtual TokenMap::Ptr copy() const;
 
-  virtual const CopyOnWriteHostVec& get_replicas(const String& keyspace_name,
-                                                 const String& routing_key) const;
+  virtual uint32_t get_keyspace_id(const String& keyspace_name) const;
+
+  using TokenMap::get_replicas;
+
+  virtual const CopyOnWriteHostVec& get_replicas(uint32_t keyspace_id,
+                                                 const StringRef& routing_key) const;
 
   // Test only
   bool contains(const Token& token) const {
@@ -593,14 +927,25 @@ private:
                        bool should_build_replicas);
   void remove_host_tokens(const Host::Ptr& host);
   void update_host_ids(const Host::Ptr& host);
+  typename ReplicaSet::ConstPtr& keyspace_replicas(const String& keyspace_name);
+  typename ReplicaSet::ConstPtr find_replicas(const ReplicationStrategy<Partitioner>& strategy) const;
   void build_replicas();
+  void build_replica_sets(const Vector<ReplicaSet*>& replica_sets) const;
+  static void on_build_task(void* data, size_t index);
+  void update_replicas(const TokenHostVec& previous_tokens,
+                       const DatacenterMap& previous_datacenters,
+                       const Host::Ptr& changed_host);
+  void find_changes(const TokenHostVec& previous_tokens,
+                    const Host::Ptr& changed_host,
+                    TokenRingChanges& changes) const;
 
 private:
   TokenHostVec tokens_;
   HostSet hosts_;
   DatacenterMap datacenters_;
-  KeyspaceReplicaMap replicas_;
+  KeyspaceReplicaVec replicas_;
   KeyspaceStrategyMap strategies_;
+  IdGenerator keyspace_ids_;
   IdGenerator rack_ids_;
   IdGenerator dc_ids_;
   CopyOnWriteHostVec no_replicas_dummy_;
@@ -622,6 +967,10 @@ void TokenMapImpl<Partitioner>::add_host(const Host::Ptr& host) {
 template <class Partitioner>
 void TokenMapImpl<Partitioner>::update_host_and_build(const Host::Ptr& host) {
   uint64_t start = uv_hrtime();
+  TokenHostVec previous_tokens(tokens_);
+  DatacenterMap previous_datacenters;
+  build_datacenters(hosts_, previous_datacenters);
+
   remove_host_tokens(host);
 
   update_host_ids(host);
@@ -641,9 +990,9 @@ void TokenMapImpl<Partitioner>::update_host_and_build(const Host::Ptr& host) {
   std::merge(tokens_.begin(), tokens_.end(),
              new_tokens.begin(), new_tokens.end(),
              merged.begin(), TokenHostCompare());
-  tokens_ = merged;
+  tokens_.swap(merged);
 
-  build_replicas();
+  update_replicas(previous_tokens, previous_datacenters, host);
   LOG_DEBUG("Updated token map with host %s (%u tokens). Rebuilt token map with %u hosts and %u tokens in %f ms",
             host->address_string().c_str(),
             (unsigned int)new_tokens.size(),
@@ -656,9 +1005,13 @@ template <class Partitioner>
 void TokenMapImpl<Partitioner>::remove_host_and_build(const Host::Ptr& host) {
   if (hosts_.find(host) == hosts_.end()) return;
   uint64_t start = uv_hrtime();
+  TokenHostVec previous_tokens(tokens_);
+  DatacenterMap previous_datacenters;
+  build_datacenters(hosts_, previous_datacenters);
+
   remove_host_tokens(host);
   hosts_.erase(host);
-  build_replicas();
+  update_replicas(previous_tokens, previous_datacenters, host);
   LOG_DEBUG("Removed host %s from token map. Rebuilt token map with %u hosts and %u tokens in %f ms",
             host->address_string().c_str(),
             (unsigned int)hosts_.size(),
@@ -680,7 +1033,11 @@ void TokenMapImpl<Partitioner>::update_keyspaces_and_build(const VersionNumber&
 
 template <class Partitioner>
 void TokenMapImpl<Partitioner>::drop_keyspace(const String& keyspace_name) {
-  replicas_.erase(keyspace_name);
+  // The keyspace's identifier is kept in case the keyspace is recreated
+  uint32_t keyspace_id = keyspace_ids_.find(keyspace_name);
+  if (keyspace_id != 0 && keyspace_id < replicas_.size()) {
+    replicas_[keyspace_id] = typename ReplicaSet::ConstPtr();
+  }
   strategies_.erase(keyspace_name);
 }
 
@@ -701,13 +1058,20 @@ TokenMap::Ptr TokenMapImpl<Partitioner>::copy() const {
 }
 
 template <class Partitioner>
-const CopyOnWriteHostVec& TokenMapImpl<Partitioner>::get_replicas(const String& keyspace_name,
-                                                                  const String& routing_key) const {
-  typename KeyspaceReplicaMap::const_iterator ks_it = replicas_.find(keyspace_name);
+uint32_t TokenMapImpl<Partitioner>::get_keyspace_id(const String& keyspace_name) const {
+  return keyspace_ids_.find(keyspace_name);
+}
 
-  if (ks_it != replicas_.end()) {
+template <class Partitioner>
+const CopyOnWriteHostVec& TokenMapImpl<Partitioner>::get_replicas(uint32_t keyspace_id,
+                                                                  const StringRef& routing_key) const {
+  if (keyspace_id != 0 && keyspace_id < replicas_.size()) {
+    const ReplicaSet* replica_set = replicas_[keyspace_id].get();
+    if (replica_set == NULL) {
+      return no_replicas_dummy_;
+    }
     Token token = Partitioner::hash(routing_key);
-    const TokenReplicasVec& replicas = ks_it->second;
+    const TokenReplicasVec& replicas = replica_set->replicas;
     typename TokenReplicasVec::const_iterator replicas_it = std::upper_bound(replicas.begin(), replicas.end(),
                                                                              TokenReplicas(token, no_replicas_dummy_),
                                                                              TokenReplicasCompare());
@@ -750,7 +1114,16 @@ void TokenMapImpl<Partitioner>::update_keyspace(const VersionNumber& cassandra_v
       if (should_build_replicas) {
         uint64_t start = uv_hrtime();
         build_datacenters(hosts_, datacenters_);
-        strategy.build_replicas(tokens_, datacenters_, replicas_[keyspace_name]);
+        typename ReplicaSet::ConstPtr& replicas = keyspace_replicas(keyspace_name);
+        // Share the replicas of a keyspace with the same replication strategy
+        typename ReplicaSet::ConstPtr existing(find_replicas(strategy));
+        if (existing) {
+          replicas = existing;
+        } else {
+          ReplicaSet* replica_set = Memory::allocate<ReplicaSet>(strategy);
+          build_replica_sets(Vector<ReplicaSet*>(1, replica_set));
+          replicas = typename ReplicaSet::ConstPtr(replica_set);
+        }
         LOG_DEBUG("Updated token map with keyspace '%s'. Rebuilt token map with %u hosts and %u tokens in %f ms",
                   keyspace_name.c_str(),
                   (unsigned int)hosts_.size(),
@@ -774,16 +1147,191 @@ void TokenMapImpl<Partitioner>::update_host_ids(const Host::Ptr& host) {
   host->set_rack_and_dc_ids(rack_ids_.get(host->rack()), dc_ids_.get(host->dc()));
 }
 
+template <class Partitioner>
+typename TokenMapImpl<Partitioner>::ReplicaSet::ConstPtr&
+TokenMapImpl<Partitioner>::keyspace_replicas(const String& keyspace_name) {
+  uint32_t keyspace_id = keyspace_ids_.get(keyspace_name);
+  if (keyspace_id >= replicas_.size()) {
+    replicas_.resize(keyspace_id + 1);
+  }
+  return replicas_[keyspace_id];
+}
+
+template <class Partitioner>
+typename TokenMapImpl<Partitioner>::ReplicaSet::ConstPtr
+TokenMapImpl<Partitioner>::find_replicas(const ReplicationStrategy<Partitioner>& strategy) const {
+  for (typename KeyspaceReplicaVec::const_iterator i = replicas_.begin(),
+       end = replicas_.end(); i != end; ++i) {
+    if (*i && !((*i)->strategy != strategy)) {
+      return *i;
+    }
+  }
+  return typename ReplicaSet::ConstPtr();
+}
+
 template <class Partitioner>
 void TokenMapImpl<Partitioner>::build_replicas() {
   build_datacenters(hosts_, datacenters_);
+
+  // Keyspaces with the same replication strategy share the same replicas
+  ReplicaSetVec built;
+  Vector<ReplicaSet*> pending;
+  for (typename KeyspaceStrategyMap::const_iterator i = strategies_.begin(),
+       end = strategies_.end();
+       i != end; ++i) {
+    const String& keyspace_name = i->first;
+    const ReplicationStrategy<Partitioner>& strategy = i->second;
+
+    typename ReplicaSet::ConstPtr replicas;
+    for (typename ReplicaSetVec::const_iterator j = built.begin(),
+         end = built.end(); j != end; ++j) {
+      if (!(j->second->strategy != strategy)) {
+        replicas = j->second;
+        break;
+      }
+    }
+
+    if (!replicas) {
+      ReplicaSet* replica_set = Memory::allocate<ReplicaSet>(strategy);
+      pending.push_back(replica_set);
+      replicas = typename ReplicaSet::ConstPtr(replica_set);
+      built.push_back(typename ReplicaSetVec::value_type(NULL, replicas));
+    }
+
+    keyspace_replicas(keyspace_name) = replicas;
+  }
+
+  build_replica_sets(pending);
+}
+
+template <class Partitioner>
+void TokenMapImpl<Partitioner>::build_replica_sets(const Vector<ReplicaSet*>& replica_sets) const {
+  // The replicas of each token only depend on the ring so building is split
+  // into tasks by replication strategy and ranges of tokens.
+  BuildBatch batch(this);
+  for (typename Vector<ReplicaSet*>::const_iterator i = replica_sets.begin(),
+       end = replica_sets.end(); i != end; ++i) {
+    ReplicaSet* replica_set = *i;
+    if (!replica_set->strategy.prepare_replicas(tokens_, datacenters_,
+                                                replica_set->replicas, replica_set->spans)) {
+      continue;
+    }
+    for (size_t first = 0; first < tokens_.size(); first += BUILD_TASK_NUM_TOKENS) {
+      size_t last = first + BUILD_TASK_NUM_TOKENS;
+      batch.tasks.push_back(BuildTask(replica_set, first,
+                                      last < tokens_.size() ? last : tokens_.size()));
+    }
+  }
+
+  ForkJoin::run(batch.tasks.size(),
+                batch.tasks.size() > 1 ? ForkJoin::num_threads() : 1,
+                on_build_task, &batch);
+}
+
+template <class Partitioner>
+void TokenMapImpl<Partitioner>::on_build_task(void* data, size_t index) {
+  const BuildBatch* batch = static_cast<const BuildBatch*>(data);
+  const TokenMapImpl* token_map = batch->token_map;
+  const BuildTask& task = batch->tasks[index];
+  ReplicaSet* replica_set = task.replica_set;
+  replica_set->strategy.build_replicas_range(token_map->tokens_, token_map->datacenters_,
+                                             task.first, task.last,
+                                             replica_set->replicas, replica_set->spans);
+}
+
+template <class Partitioner>
+void TokenMapImpl<Partitioner>::update_replicas(const TokenHostVec& previous_tokens,
+                                                const DatacenterMap& previous_datacenters,
+                                                const Host::Ptr& changed_host) {
+  build_datacenters(hosts_, datacenters_);
+
+  TokenRingChanges changes;
+  find_changes(previous_tokens, changed_host, changes);
+
+  // Map the previous replicas to the updated replicas so that keyspaces that
+  // shared replicas before the change continue to share them
+  ReplicaSetVec updated;
+  Vector<ReplicaSet*> pending;
   for (typename KeyspaceStrategyMap::const_iterator i = strategies_.begin(),
        end = strategies_.end();
        i != end; ++i) {
     const String& keyspace_name = i->first;
     const ReplicationStrategy<Partitioner>& strategy = i->second;
-    strategy.build_replicas(tokens_, datacenters_, replicas_[keyspace_name]);
+
+    typename ReplicaSet::ConstPtr& replicas = keyspace_replicas(keyspace_name);
+    const ReplicaSet* previous = replicas.get();
+    if (previous != NULL && previous->strategy != strategy) {
+      previous = NULL;
+    }
+
+    typename ReplicaSet::ConstPtr result;
+    for (typename ReplicaSetVec::const_iterator j = updated.begin(),
+         end = updated.end(); j != end; ++j) {
+      if ((previous != NULL && j->first == previous) ||
+          !(j->second->strategy != strategy)) {
+        result = j->second;
+        break;
+      }
+    }
+
+    if (!result) {
+      ReplicaSet* replica_set = Memory::allocate<ReplicaSet>(strategy);
+      if (previous != NULL &&
+          !previous->replicas.empty() &&
+          previous->replicas.size() == previous_tokens.size() &&
+          strategy.can_update_replicas(previous_datacenters, previous_tokens.size(),
+                                       datacenters_, tokens_.size())) {
+        strategy.update_replicas(tokens_, datacenters_, changes,
+                                 previous->replicas, previous->spans,
+                                 replica_set->replicas, replica_set->spans);
+      } else {
+        pending.push_back(replica_set);
+      }
+      result = typename ReplicaSet::ConstPtr(replica_set);
+      updated.push_back(typename ReplicaSetVec::value_type(previous, result));
+    }
+
+    replicas = result;
+  }
+
+  build_replica_sets(pending);
+}
+
+template <class Partitioner>
+void TokenMapImpl<Partitioner>::find_changes(const TokenHostVec& previous_tokens,
+                                             const Host::Ptr& changed_host,
+                                             TokenRingChanges& changes) const {
+  changes.reset(previous_tokens.size());
+
+  // The tokens of the changed host are always considered changed because
+  // the host's datacenter or rack could be different.
+  RemoveTokenHostIf is_changed(changed_host);
+  TokenHostCompare compare;
+
+  size_t last_previous_index = TokenRingChanges::NEW_TOKEN;
+  typename TokenHostVec::const_iterator previous = previous_tokens.begin();
+  typename TokenHostVec::const_iterator previous_end = previous_tokens.end();
+  for (typename TokenHostVec::const_iterator i = tokens_.begin(),
+       end = tokens_.end(); i != end; ++i) {
+    while (previous != previous_end && compare(*previous, *i)) {
+      last_previous_index = previous - previous_tokens.begin();
+      changes.remove(last_previous_index);
+      ++previous;
+    }
+    if (previous != previous_end && !compare(*i, *previous) &&
+        previous->second == i->second && !is_changed(*i)) {
+      last_previous_index = previous - previous_tokens.begin();
+      changes.add(last_previous_index, last_previous_index);
+      ++previous;
+    } else {
+      changes.add(TokenRingChanges::NEW_TOKEN, last_previous_index);
+    }
+  }
+  for (; previous != previous_end; ++previous) {
+    changes.remove(previous - previous_tokens.begin());
   }
+
+  changes.finish();
 }
 
 } // namespace cass
@@ -29,6 +29,10 @@
   #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+  #include <pthread.h>
+#endif
+
 namespace cass {
 
 String opcode_to_string(int opcode) {
@@ -217,4 +221,29 @@ void set_thread_name(const String& thread_name) {
 #endif
 }
 
+bool set_thread_affinity(unsigned cpu) {
+#if defined(WIN32) || defined(_WIN32)
+  if (cpu >= sizeof(DWORD_PTR) * 8) return false;
+  return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+  if (cpu >= CPU_SETSIZE) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+int current_cpu() {
+#if defined(WIN32) || defined(_WIN32)
+  return static_cast<int>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
 } // namespace cass
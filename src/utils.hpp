@@ -118,6 +118,12 @@ int32_t get_pid();
 
 void set_thread_name(const String& thread_name);
 
+// Pin the calling thread to a CPU. Returns false if it's not supported.
+bool set_thread_affinity(unsigned cpu);
+
+// The CPU the calling thread is running on, or -1 if it's not supported
+int current_cpu();
+
 template <class C>
 static void set_pointer_keys(C& container) {
   container.set_empty_key(reinterpret_cast<typename C::key_type>(0x0));
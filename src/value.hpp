@@ -48,6 +48,20 @@ public:
       , decoder_(decoder)
       , is_null_(false) { }
 
+  // Used to decode rows in place. The data type is kept so its reference
+  // count isn't changed for every value.
+  void set(int32_t count, const Decoder& decoder) {
+    count_ = count;
+    decoder_ = decoder;
+    is_null_ = false;
+  }
+
+  void set_null() {
+    count_ = 0;
+    decoder_ = Decoder();
+    is_null_ = true;
+  }
+
   Decoder decoder() const { return decoder_; }
   ProtocolVersion protocol_version() const { return decoder_.protocol_version(); }
   int64_t size() const { return (is_null_ ? -1 : decoder_.remaining()); }